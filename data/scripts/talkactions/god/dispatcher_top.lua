@@ -0,0 +1,21 @@
+local dispatcherTop = TalkAction("/dispatchertop")
+
+function dispatcherTop.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	if param == "reset" then
+		Game.resetDispatcherProfile()
+		player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Dispatcher profile has been reset.")
+		return true
+	end
+
+	local limit = tonumber(param) or 20
+	logger.info("Dispatcher profile requested by {}:\n{}", player:getName(), Game.getDispatcherReport(limit))
+	player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Dispatcher profile has been written to the server log.")
+	return true
+end
+
+dispatcherTop:separator(" ")
+dispatcherTop:groupType("god")
+dispatcherTop:register()
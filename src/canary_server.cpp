@@ -19,6 +19,7 @@
 #include "declarations.hpp"
 #include "game/game.hpp"
 #include "game/scheduling/dispatcher.hpp"
+#include "game/scheduling/dispatcher_watchdog.hpp"
 #include "game/scheduling/events_scheduler.hpp"
 #include "game/zones/zone.hpp"
 #include "io/io_bosstiary.hpp"
@@ -72,6 +73,7 @@ int CanaryServer::run() {
 				if (metricsOptions.enableOStreamExporter) {
 					metricsOptions.ostreamOptions.export_interval_millis = std::chrono::milliseconds(g_configManager().getNumber(METRICS_OSTREAM_INTERVAL));
 				}
+				metricsOptions.latencySampleRate = static_cast<uint32_t>(std::max(1, g_configManager().getNumber(METRICS_LATENCY_SAMPLE_RATE)));
 				g_metrics().init(metricsOptions);
 #endif
 				rsa.start();
@@ -108,6 +110,7 @@ int CanaryServer::run() {
 					g_game().setGameState(GAME_STATE_NORMAL);
 					g_webhook().sendMessage(":green_circle: Server is now **online**");
 				}
+				g_dispatcherWatchdog().start(g_dispatcher(), std::chrono::milliseconds(g_configManager().getNumber(DISPATCHER_TICK_BUDGET)));
 
 				loaderStatus = LoaderStatus::LOADED;
 			} catch (FailedToInitializeCanary &err) {
@@ -391,6 +394,7 @@ void CanaryServer::modulesLoadHelper(bool loaded, std::string moduleName) {
 
 void CanaryServer::shutdown() {
 	g_database().createDatabaseBackup(true);
+	g_dispatcherWatchdog().stop();
 	g_dispatcher().shutdown();
 	g_metrics().shutdown();
 	inject<ThreadPool>().shutdown();
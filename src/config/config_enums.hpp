@@ -46,7 +46,10 @@ enum ConfigKey_t : uint16_t {
 	COMBAT_CHAIN_SKILL_FORMULA_CLUB,
 	COMBAT_CHAIN_SKILL_FORMULA_SWORD,
 	COMBAT_CHAIN_TARGETS,
+	COMPRESSION_ADAPTIVE,
+	COMPRESSION_DICTIONARY,
 	COMPRESSION_LEVEL,
+	COMPRESSION_NANOS_PER_SAVED_BYTE,
 	CONVERT_UNSAFE_SCRIPTS,
 	CORE_DIRECTORY,
 	CRITICALCHANCE,
@@ -65,6 +68,7 @@ enum ConfigKey_t : uint16_t {
 	DISCORD_SEND_FOOTER,
 	DISCORD_WEBHOOK_DELAY_MS,
 	DISCORD_WEBHOOK_URL,
+	DISPATCHER_TICK_BUDGET,
 	EMOTE_SPELLS,
 	ENABLE_PLAYER_PUT_ITEM_IN_AMMO_SLOT,
 	ENABLE_SUPPORT_OUTFIT,
@@ -161,6 +165,7 @@ enum ConfigKey_t : uint16_t {
 	MAX_SPEED_ATTACKONFIST,
 	METRICS_ENABLE_OSTREAM,
 	METRICS_ENABLE_PROMETHEUS,
+	METRICS_LATENCY_SAMPLE_RATE,
 	METRICS_OSTREAM_INTERVAL,
 	METRICS_PROMETHEUS_ADDRESS,
 	MIN_DELAY_BETWEEN_CONDITIONS,
@@ -175,6 +180,9 @@ enum ConfigKey_t : uint16_t {
 	MYSQL_DB_BACKUP,
 	MYSQL_HOST,
 	MYSQL_PASS,
+	MYSQL_POOL_SIZE,
+	MYSQL_REPLICA_HOST,
+	MYSQL_REPLICA_PORT,
 	MYSQL_SOCK,
 	MYSQL_USER,
 	OLD_PROTOCOL,
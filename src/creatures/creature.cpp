@@ -16,6 +16,7 @@
 #include "creatures/players/grouping/party.hpp"
 #include "game/game.hpp"
 #include "game/scheduling/dispatcher.hpp"
+#include "game/scheduling/pathfinding_service.hpp"
 #include "game/zones/zone.hpp"
 #include "lib/metrics/metrics.hpp"
 #include "lua/creature/creatureevent.hpp"
@@ -996,9 +997,26 @@ void Creature::goToFollowCreature() {
 	}
 
 	if (listDir.empty()) {
-		hasFollowPath = getPathTo(followCreature->getPosition(), listDir, fpp);
+		// The search is batched with everyone else's, the walk starts once the path comes back
+		g_pathfinding().request(getCreature(), followCreature->getPosition(), fpp, [weakSelf = std::weak_ptr<Creature>(getCreature()), weakFollow = std::weak_ptr<Creature>(followCreature), executeOnFollow](bool found, const std::vector<Direction> &dirList) {
+			const auto &self = weakSelf.lock();
+			const auto &follow = weakFollow.lock();
+			if (!self || !follow || self->isRemoved() || self->getFollowCreature() != follow) {
+				return;
+			}
+
+			self->hasFollowPath = found;
+			self->onFollowPathSearched(found);
+			self->startAutoWalk(dirList);
+
+			if (executeOnFollow) {
+				self->onFollowCreatureComplete(follow);
+			}
+		});
+		return;
 	}
 
+	onFollowPathSearched(true);
 	startAutoWalk(listDir);
 
 	if (executeOnFollow) {
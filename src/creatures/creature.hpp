@@ -344,6 +344,10 @@ public:
 	virtual void onFollowCreatureComplete(const std::shared_ptr<Creature> &) {
 		/* empty */
 	}
+	// hasFollowPath is only up to date from here, the search finishes on the pathfinding service
+	virtual void onFollowPathSearched(bool) {
+		/* empty */
+	}
 
 	// combat functions
 	std::shared_ptr<Creature> getAttackedCreature() const {
@@ -15,6 +15,7 @@
 #include "creatures/players/player.hpp"
 #include "game/game.hpp"
 #include "game/scheduling/dispatcher.hpp"
+#include "game/scheduling/pathfinding_service.hpp"
 #include "items/tile.hpp"
 #include "lua/callbacks/event_callback.hpp"
 #include "lua/callbacks/events_callbacks.hpp"
@@ -1550,12 +1551,24 @@ void Monster::doWalkBack(uint32_t &flags, Direction &nextDirection, bool &result
 			return;
 		}
 
-		std::vector<Direction> listDir;
-		if (!getPathTo(masterPos, listDir, 0, std::max<int32_t>(0, distance - 5), true, true, distance)) {
-			isWalkingBack = false;
-			return;
-		}
-		startAutoWalk(listDir);
+		FindPathParams fpp;
+		fpp.minTargetDist = 0;
+		fpp.maxTargetDist = std::max<int32_t>(0, distance - 5);
+		fpp.maxSearchDist = distance;
+
+		// Nobody is watching, so the search goes to the back of the pathfinding queue
+		g_pathfinding().request(getMonster(), masterPos, fpp, [weakSelf = std::weak_ptr<Monster>(getMonster())](bool found, const std::vector<Direction> &dirList) {
+			const auto &self = weakSelf.lock();
+			if (!self || self->isRemoved() || !self->isWalkingBack) {
+				return;
+			}
+
+			if (!found) {
+				self->isWalkingBack = false;
+				return;
+			}
+			self->startAutoWalk(dirList);
+		});
 	}
 }
 
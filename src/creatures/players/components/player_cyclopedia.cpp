@@ -75,7 +75,7 @@ void PlayerCyclopedia::loadDeathHistory(uint16_t page, uint16_t entriesPerPage)
 		} while (result->next());
 		player->sendCyclopediaCharacterRecentDeaths(page, static_cast<uint16_t>(pages), entries);
 	};
-	g_databaseTasks().store(query, callback);
+	g_databaseTasks().store(query, callback, DBTarget::Replica);
 	m_player.addAsyncOngoingTask(PlayerAsyncTask_RecentDeaths);
 
 	g_logger().debug("Loading death history from the player {} took {} milliseconds.", m_player.getName(), bm_check.duration());
@@ -127,7 +127,7 @@ void PlayerCyclopedia::loadRecentKills(uint16_t page, uint16_t entriesPerPage) c
 		} while (result->next());
 		player->sendCyclopediaCharacterRecentPvPKills(page, static_cast<uint16_t>(pages), entries);
 	};
-	g_databaseTasks().store(query, callback);
+	g_databaseTasks().store(query, callback, DBTarget::Replica);
 	m_player.addAsyncOngoingTask(PlayerAsyncTask_RecentPvPKills);
 
 	g_logger().debug("Loading recent kills from the player {} took {} milliseconds.", m_player.getName(), bm_check.duration());
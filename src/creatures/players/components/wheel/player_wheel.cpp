@@ -1826,10 +1826,7 @@ void PlayerWheel::loadDBPlayerSlotPointsOnLogin() {
 	}
 }
 
-bool PlayerWheel::saveDBPlayerSlotPointsOnLogout() const {
-	DBInsert insertWheelData("INSERT INTO `player_wheeldata` (`player_id`, `slot`) VALUES ");
-	insertWheelData.upsert({ "slot" });
-	PropWriteStream stream;
+void PlayerWheel::serializeSlotPoints(PropWriteStream &stream) const {
 	const auto wheelSlots = getSlots();
 	for (uint8_t i = 1; i < wheelSlots.size(); ++i) {
 		auto value = wheelSlots[i];
@@ -1838,23 +1835,6 @@ bool PlayerWheel::saveDBPlayerSlotPointsOnLogout() const {
 		stream.write<uint16_t>(value);
 		g_logger().debug("Player: {}, saved points {} to slot {}", m_player.getName(), value, i);
 	}
-
-	size_t attributesSize;
-	const char* attributes = stream.getStream(attributesSize);
-	if (attributesSize > 0) {
-		const auto query = fmt::format("{}, {}", m_player.getGUID(), g_database().escapeBlob(attributes, static_cast<uint32_t>(attributesSize)));
-		if (!insertWheelData.addRow(query)) {
-			g_logger().debug("[{}] failed to insert row data", __FUNCTION__);
-			return false;
-		}
-	}
-
-	if (!insertWheelData.execute()) {
-		g_logger().debug("[{}] failed to execute database insert", __FUNCTION__);
-		return false;
-	}
-
-	return true;
 }
 
 uint16_t PlayerWheel::getExtraPoints() const {
@@ -16,6 +16,7 @@ class Creature;
 class IOWheel;
 class KV;
 class NetworkMessage;
+class PropWriteStream;
 class Player;
 class Spell;
 class WheelModifierContext;
@@ -159,7 +160,7 @@ public:
 	 * Functions for load and save player database informations
 	 */
 	void loadDBPlayerSlotPointsOnLogin();
-	bool saveDBPlayerSlotPointsOnLogout() const;
+	void serializeSlotPoints(PropWriteStream &stream) const;
 
 	/*
 	 * Functions for manipulate the client bytes
@@ -1878,6 +1878,12 @@ void Player::sendCreatureHealth(const std::shared_ptr<Creature> &creature) const
 	}
 }
 
+void Player::sendCreatureHealth(const std::shared_ptr<Creature> &creature, BroadcastPacket &broadcast) const {
+	if (client) {
+		client->sendCreatureHealth(creature, broadcast);
+	}
+}
+
 void Player::sendPartyCreatureUpdate(const std::shared_ptr<Creature> &creature) const {
 	if (client) {
 		client->sendPartyCreatureUpdate(creature);
@@ -1932,6 +1938,12 @@ void Player::sendDistanceShoot(const Position &from, const Position &to, uint16_
 	}
 }
 
+void Player::sendDistanceShoot(const Position &from, const Position &to, uint16_t type, BroadcastPacket &broadcast) const {
+	if (client) {
+		client->sendDistanceShoot(from, to, type, broadcast);
+	}
+}
+
 void Player::sendHouseWindow(const std::shared_ptr<House> &house, uint32_t listId) const {
 	if (!client) {
 		return;
@@ -2027,6 +2039,12 @@ void Player::sendMagicEffect(const Position &pos, uint16_t type) const {
 	}
 }
 
+void Player::sendMagicEffect(const Position &pos, uint16_t type, BroadcastPacket &broadcast) const {
+	if (client) {
+		client->sendMagicEffect(pos, type, broadcast);
+	}
+}
+
 void Player::removeMagicEffect(const Position &pos, uint16_t type) const {
 	if (client) {
 		client->removeMagicEffect(pos, type);
@@ -5461,10 +5479,12 @@ void Player::goToFollowCreature() {
 		}
 
 		Creature::goToFollowCreature();
+	}
+}
 
-		if (getFollowCreature() && !hasFollowPath) {
-			lastFailedFollow = OTSYS_TIME();
-		}
+void Player::onFollowPathSearched(bool found) {
+	if (!found && getFollowCreature()) {
+		lastFailedFollow = OTSYS_TIME();
 	}
 }
 
@@ -7822,6 +7842,12 @@ void Player::sendCreatureMove(const std::shared_ptr<Creature> &creature, const P
 	}
 }
 
+void Player::sendCreatureMove(const std::shared_ptr<Creature> &creature, const Position &newPos, int32_t newStackPos, const Position &oldPos, int32_t oldStackPos, bool teleport, BroadcastPacket &broadcast) const {
+	if (client) {
+		client->sendMoveCreature(creature, newPos, newStackPos, oldPos, oldStackPos, teleport, broadcast);
+	}
+}
+
 void Player::sendCreatureTurn(const std::shared_ptr<Creature> &creature) {
 	if (!creature) {
 		return;
@@ -7846,6 +7872,12 @@ void Player::sendCreatureSay(const std::shared_ptr<Creature> &creature, SpeakCla
 	}
 }
 
+void Player::sendCreatureSay(const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, const Position* pos, BroadcastPacket &broadcast) const {
+	if (client) {
+		client->sendCreatureSay(creature, type, text, pos, broadcast);
+	}
+}
+
 void Player::sendCreatureReload(const std::shared_ptr<Creature> &creature) const {
 	if (client) {
 		client->reloadCreature(creature);
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "creatures/creature.hpp"
+#include "database/database_table_image.hpp"
 #include "enums/forge_conversion.hpp"
 #include "game/bank/bank.hpp"
 #include "grouping/guild.hpp"
@@ -30,6 +31,7 @@
 
 class House;
 class NetworkMessage;
+class BroadcastPacket;
 class Weapon;
 class ProtocolGame;
 class Party;
@@ -606,6 +608,7 @@ public:
 
 	// follow events
 	void onFollowCreature(const std::shared_ptr<Creature> &) override;
+	void onFollowPathSearched(bool found) override;
 
 	// walk events
 	void onWalk(Direction &dir) override;
@@ -763,8 +766,10 @@ public:
 	void sendChannelEvent(uint16_t channelId, const std::string &playerName, ChannelEvent_t channelEvent) const;
 	void sendCreatureAppear(const std::shared_ptr<Creature> &creature, const Position &pos, bool isLogin);
 	void sendCreatureMove(const std::shared_ptr<Creature> &creature, const Position &newPos, int32_t newStackPos, const Position &oldPos, int32_t oldStackPos, bool teleport) const;
+	void sendCreatureMove(const std::shared_ptr<Creature> &creature, const Position &newPos, int32_t newStackPos, const Position &oldPos, int32_t oldStackPos, bool teleport, BroadcastPacket &broadcast) const;
 	void sendCreatureTurn(const std::shared_ptr<Creature> &creature);
 	void sendCreatureSay(const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, const Position* pos = nullptr) const;
+	void sendCreatureSay(const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, const Position* pos, BroadcastPacket &broadcast) const;
 	void sendCreatureReload(const std::shared_ptr<Creature> &creature) const;
 	void sendPrivateMessage(const std::shared_ptr<Player> &speaker, SpeakClasses type, const std::string &text) const;
 	void sendCreatureSquare(const std::shared_ptr<Creature> &creature, SquareColor_t color) const;
@@ -846,6 +851,7 @@ public:
 	void sendCancelWalk() const;
 	void sendChangeSpeed(const std::shared_ptr<Creature> &creature, uint16_t newSpeed) const;
 	void sendCreatureHealth(const std::shared_ptr<Creature> &creature) const;
+	void sendCreatureHealth(const std::shared_ptr<Creature> &creature, BroadcastPacket &broadcast) const;
 	void sendPartyCreatureUpdate(const std::shared_ptr<Creature> &creature) const;
 	void sendPartyCreatureShield(const std::shared_ptr<Creature> &creature) const;
 	void sendPartyCreatureSkull(const std::shared_ptr<Creature> &creature) const;
@@ -855,6 +861,7 @@ public:
 	void sendPartyPlayerVocation(const std::shared_ptr<Player> &player) const;
 	void sendPlayerVocation(const std::shared_ptr<Player> &player) const;
 	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type) const;
+	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type, BroadcastPacket &broadcast) const;
 	void sendHouseWindow(const std::shared_ptr<House> &house, uint32_t listId) const;
 	void sendCreatePrivateChannel(uint16_t channelId, const std::string &channelName) const;
 	void sendClosePrivate(uint16_t channelId);
@@ -865,6 +872,7 @@ public:
 	void sendClientCheck() const;
 	void sendGameNews() const;
 	void sendMagicEffect(const Position &pos, uint16_t type) const;
+	void sendMagicEffect(const Position &pos, uint16_t type, BroadcastPacket &broadcast) const;
 	void removeMagicEffect(const Position &pos, uint16_t type) const;
 	void sendPing();
 	void sendPingBack() const;
@@ -1672,6 +1680,42 @@ private:
 	PlayerTitle m_playerTitle;
 	PlayerVIP m_playerVIP;
 	AnimusMastery m_animusMastery;
+
+	// What the last save wrote per table, see IOLoginDataSave::saveRows
+	struct SaveImage {
+		DBTableImage stash;
+		DBTableImage spells;
+		DBTableImage kills;
+		DBTableImage items;
+		DBTableImage depotItems;
+		DBTableImage rewards;
+		DBTableImage inboxItems;
+		DBTableImage prey;
+		DBTableImage taskHunting;
+		DBTableImage forgeHistory;
+		DBTableImage bosstiary;
+		DBTableImage wheel;
+		DBTableImage storage;
+
+		// The item tables of the last snapshot, dispatcher only
+		DBSnapshotRows itemRows;
+		DBSnapshotRows depotItemRows;
+		DBSnapshotRows rewardRows;
+		DBSnapshotRows inboxItemRows;
+
+		// Snapshots are taken in order but may be written out of it, an older one is dropped
+		std::atomic<uint64_t> snapshots = 0;
+		uint64_t written = 0;
+		// Held while a snapshot is written
+		std::mutex mutex;
+
+		void reset() {
+			for (auto* image : { &stash, &spells, &kills, &items, &depotItems, &rewards, &inboxItems, &prey, &taskHunting, &forgeHistory, &bosstiary, &wheel, &storage }) {
+				image->reset();
+			}
+		}
+	};
+	SaveImage m_saveImage;
 	PlayerAttachedEffects m_playerAttachedEffects;
 
 	std::mutex quickLootMutex;
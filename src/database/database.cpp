@@ -14,21 +14,64 @@
 #include "lib/metrics/metrics.hpp"
 #include "utils/tools.hpp"
 
-Database::~Database() {
-	if (handle != nullptr) {
-		mysql_close(handle);
-	}
+namespace {
+	// The connection a DBTransaction keeps for its thread until it ends
+	struct PinnedConnection {
+		const Database* database = nullptr;
+		DBConnection* connection = nullptr;
+		uint32_t depth = 0;
+	};
+
+	thread_local PinnedConnection pinned;
+	thread_local uint64_t lastInsertId = 0;
 }
 
-Database &Database::getInstance() {
-	return inject<Database>();
-}
+/**
+ * @brief A connection checked out for one call, handed back to its pool at the end of the scope.
+ * A connection pinned by a transaction has no pool here and stays with the thread.
+ */
+class Database::ConnectionLease {
+public:
+	ConnectionLease(DBConnectionPool* pool, DBConnection* connection) :
+		pool(pool), connection(connection) { }
+
+	~ConnectionLease() {
+		if (pool && connection) {
+			pool->release(connection);
+		}
+	}
 
-bool Database::connect() {
-	return connect(&g_configManager().getString(MYSQL_HOST), &g_configManager().getString(MYSQL_USER), &g_configManager().getString(MYSQL_PASS), &g_configManager().getString(MYSQL_DB), g_configManager().getNumber(SQL_PORT), &g_configManager().getString(MYSQL_SOCK));
+	// Non copyable
+	ConnectionLease(const ConnectionLease &) = delete;
+	ConnectionLease &operator=(const ConnectionLease &) = delete;
+
+	DBConnection* operator->() const {
+		return connection;
+	}
+
+	explicit operator bool() const {
+		return connection != nullptr;
+	}
+
+private:
+	DBConnectionPool* pool;
+	DBConnection* connection;
+};
+
+DBConnection::~DBConnection() {
+	for (const auto &[query, statement] : statements) {
+		mysql_stmt_close(statement);
+	}
+	for (const auto &[query, statement] : returnedStatements) {
+		mysql_stmt_close(statement);
+	}
+
+	if (handle != nullptr) {
+		mysql_close(handle);
+	}
 }
 
-bool Database::connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock) {
+bool DBConnection::connect(const DBEndpoint &endpoint) {
 	// connection handle initialization
 	handle = mysql_init(nullptr);
 	if (!handle) {
@@ -36,7 +79,7 @@ bool Database::connect(const std::string* host, const std::string* user, const s
 		return false;
 	}
 
-	if (host->empty() || user->empty() || password->empty() || database->empty() || port <= 0) {
+	if (endpoint.host.empty() || endpoint.user.empty() || endpoint.password.empty() || endpoint.database.empty() || endpoint.port <= 0) {
 		g_logger().warn("MySQL host, user, password, database or port not provided");
 	}
 
@@ -49,10 +92,82 @@ bool Database::connect(const std::string* host, const std::string* user, const s
 	mysql_options(handle, MYSQL_OPT_SSL_VERIFY_SERVER_CERT, &ssl_enabled);
 
 	// connects to database
-	if (!mysql_real_connect(handle, host->c_str(), user->c_str(), password->c_str(), database->c_str(), port, sock->c_str(), 0)) {
+	if (!mysql_real_connect(handle, endpoint.host.c_str(), endpoint.user.c_str(), endpoint.password.c_str(), endpoint.database.c_str(), endpoint.port, endpoint.sock.c_str(), 0)) {
 		g_logger().error("MySQL Error Message: {}", mysql_error(handle));
 		return false;
 	}
+	return true;
+}
+
+bool DBConnectionPool::open(const DBEndpoint &endpoint, size_t size) {
+	std::vector<std::unique_ptr<DBConnection>> opened;
+	opened.reserve(size);
+	for (size_t i = 0; i < std::max<size_t>(size, 1); ++i) {
+		auto connection = std::make_unique<DBConnection>();
+		if (!connection->connect(endpoint)) {
+			g_logger().error("[DBConnectionPool::open] - Failed to open connection {} of {} for the {} pool", i + 1, size, name);
+			return false;
+		}
+		opened.emplace_back(std::move(connection));
+	}
+
+	std::scoped_lock lock(mutex);
+	connections = std::move(opened);
+	idle.clear();
+	for (const auto &connection : connections) {
+		idle.emplace_back(connection.get());
+	}
+	return true;
+}
+
+DBConnection* DBConnectionPool::acquire() {
+	metrics::lock_latency measureWait(std::string_view(name));
+	std::unique_lock lock(mutex);
+	condition.wait(lock, [this] { return !idle.empty() || connections.empty(); });
+	if (connections.empty()) {
+		return nullptr;
+	}
+
+	DBConnection* connection = idle.back();
+	idle.pop_back();
+	lock.unlock();
+	measureWait.stop();
+
+	connection->reclaimStatements();
+	return connection;
+}
+
+void DBConnectionPool::release(DBConnection* connection) {
+	{
+		std::scoped_lock lock(mutex);
+		idle.emplace_back(connection);
+	}
+	condition.notify_one();
+}
+
+Database &Database::getInstance() {
+	return inject<Database>();
+}
+
+bool Database::connect() {
+	const auto poolSize = static_cast<size_t>(std::max(g_configManager().getNumber(MYSQL_POOL_SIZE), 1));
+	if (!connect(&g_configManager().getString(MYSQL_HOST), &g_configManager().getString(MYSQL_USER), &g_configManager().getString(MYSQL_PASS), &g_configManager().getString(MYSQL_DB), g_configManager().getNumber(SQL_PORT), &g_configManager().getString(MYSQL_SOCK), poolSize)) {
+		return false;
+	}
+
+	// Reads routed to the replica fall back to the primary when it can't be reached
+	const auto &replicaHost = g_configManager().getString(MYSQL_REPLICA_HOST);
+	if (!replicaHost.empty() && !connectReplica(&replicaHost, g_configManager().getNumber(MYSQL_REPLICA_PORT), poolSize)) {
+		g_logger().warn("MySQL replica {} unavailable, read-only queries will use the primary", replicaHost);
+	}
+	return true;
+}
+
+bool Database::connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock, size_t poolSize /* = 1*/) {
+	endpoint = { *host, *user, *password, *database, port, *sock };
+	if (!primary.open(endpoint, poolSize)) {
+		return false;
+	}
 
 	DBResult_ptr result = storeQuery("SHOW VARIABLES LIKE 'max_allowed_packet'");
 	if (result) {
@@ -61,6 +176,14 @@ bool Database::connect(const std::string* host, const std::string* user, const s
 	return true;
 }
 
+bool Database::connectReplica(const std::string* host, uint32_t port, size_t poolSize) {
+	auto replicaEndpoint = endpoint;
+	replicaEndpoint.host = *host;
+	replicaEndpoint.port = port;
+	replicaEndpoint.sock.clear();
+	return replica.open(replicaEndpoint, poolSize);
+}
+
 void Database::createDatabaseBackup(bool compress) const {
 	if (!g_configManager().getBoolean(MYSQL_DB_BACKUP)) {
 		return;
@@ -157,53 +280,163 @@ void Database::createDatabaseBackup(bool compress) const {
 	}
 }
 
-bool Database::beginTransaction() {
-	if (!executeQuery("BEGIN")) {
+Database::ConnectionLease Database::lease(DBTarget target) {
+	if (pinned.database == this) {
+		return { nullptr, pinned.connection };
+	}
+
+	auto &pool = target == DBTarget::Replica && replica.isOpen() ? replica : primary;
+	return { &pool, pool.acquire() };
+}
+
+bool Database::pinConnection() {
+	if (pinned.database == this) {
+		++pinned.depth;
+		return true;
+	}
+
+	if (pinned.database != nullptr) {
+		g_logger().error("[Database::pinConnection] - The thread already holds a connection of another database");
+		return false;
+	}
+
+	DBConnection* connection = primary.acquire();
+	if (!connection) {
+		g_logger().error("Database not initialized!");
 		return false;
 	}
-	metrics::lock_latency measureLock("database");
-	databaseLock.lock();
-	measureLock.stop();
 
+	pinned = { this, connection, 1 };
 	return true;
 }
 
-bool Database::rollback() {
-	if (!handle) {
+void Database::unpinConnection() {
+	if (pinned.database != this) {
+		g_logger().error("[Database::unpinConnection] - No connection pinned");
+		return;
+	}
+	endTransaction();
+}
+
+bool Database::beginTransaction() {
+	if (pinned.database == this) {
+		// Nested or inside a DBSession, the server commits an open transaction on BEGIN as it always did
+		++pinned.depth;
+		return pinned.connection->executeQuery("BEGIN");
+	}
+
+	if (pinned.database != nullptr) {
+		g_logger().error("[Database::beginTransaction] - The thread is already in a transaction of another database");
+		return false;
+	}
+
+	DBConnection* connection = primary.acquire();
+	if (!connection) {
 		g_logger().error("Database not initialized!");
 		return false;
 	}
 
-	if (mysql_rollback(handle) != 0) {
-		g_logger().error("Message: {}", mysql_error(handle));
-		databaseLock.unlock();
+	if (!connection->executeQuery("BEGIN")) {
+		primary.release(connection);
 		return false;
 	}
 
-	databaseLock.unlock();
+	pinned = { this, connection, 1 };
 	return true;
 }
 
+bool Database::rollback() {
+	if (pinned.database != this) {
+		g_logger().error("[Database::rollback] - No transaction in progress");
+		return false;
+	}
+
+	const bool success = pinned.connection->rollback();
+	endTransaction();
+	return success;
+}
+
 bool Database::commit() {
-	if (!handle) {
+	if (pinned.database != this) {
+		g_logger().error("[Database::commit] - No transaction in progress");
+		return false;
+	}
+
+	const bool success = pinned.connection->commit();
+	endTransaction();
+	return success;
+}
+
+void Database::endTransaction() {
+	if (--pinned.depth > 0) {
+		return;
+	}
+
+	primary.release(pinned.connection);
+	pinned = {};
+}
+
+bool Database::executeQuery(std::string_view query) {
+	const auto connection = lease(DBTarget::Primary);
+	if (!connection) {
 		g_logger().error("Database not initialized!");
 		return false;
 	}
-	if (mysql_commit(handle) != 0) {
+	return connection->executeQuery(query);
+}
+
+DBResult_ptr Database::storeQuery(std::string_view query, DBTarget target /* = DBTarget::Primary*/) {
+	const auto connection = lease(target);
+	if (!connection) {
+		g_logger().error("Database not initialized!");
+		return nullptr;
+	}
+	return connection->storeQuery(query);
+}
+
+bool Database::executeStatement(std::string_view query, std::initializer_list<DBParam> params) {
+	const auto connection = lease(DBTarget::Primary);
+	if (!connection) {
+		g_logger().error("Database not initialized!");
+		return false;
+	}
+	return connection->executeStatement(query, params);
+}
+
+DBStatementResult_ptr Database::storeStatement(std::string_view query, std::initializer_list<DBParam> params, DBTarget target /* = DBTarget::Primary*/) {
+	const auto connection = lease(target);
+	if (!connection) {
+		g_logger().error("Database not initialized!");
+		return nullptr;
+	}
+	return connection->storeStatement(query, params);
+}
+
+uint64_t Database::getLastInsertId() const {
+	return lastInsertId;
+}
+
+bool DBConnection::rollback() {
+	if (mysql_rollback(handle) != 0) {
 		g_logger().error("Message: {}", mysql_error(handle));
-		databaseLock.unlock();
 		return false;
 	}
+	return true;
+}
 
-	databaseLock.unlock();
+bool DBConnection::commit() {
+	if (mysql_commit(handle) != 0) {
+		g_logger().error("Message: {}", mysql_error(handle));
+		return false;
+	}
 	return true;
 }
 
-bool Database::isRecoverableError(unsigned int error) {
+bool DBConnection::isRecoverableError(unsigned int error) {
 	return error == CR_SERVER_LOST || error == CR_SERVER_GONE_ERROR || error == CR_CONN_HOST_ERROR || error == 1053 /*ER_SERVER_SHUTDOWN*/ || error == CR_CONNECTION_ERROR;
 }
 
-bool Database::retryQuery(std::string_view query, int retries) {
+bool DBConnection::retryQuery(std::string_view query, int retries) {
 	while (retries > 0 && mysql_query(handle, query.data()) != 0) {
 		g_logger().error("Query: {}", query.substr(0, 256));
 		g_logger().error("MySQL error [{}]: {}", mysql_errno(handle), mysql_error(handle));
@@ -221,36 +454,22 @@ bool Database::retryQuery(std::string_view query, int retries) {
 	return true;
 }
 
-bool Database::executeQuery(std::string_view query) {
-	if (!handle) {
-		g_logger().error("Database not initialized!");
-		return false;
-	}
-
+bool DBConnection::executeQuery(std::string_view query) {
 	g_logger().trace("Executing Query: {}", query);
 
-	metrics::lock_latency measureLock("database");
-	std::scoped_lock lock { databaseLock };
-	measureLock.stop();
-
 	metrics::query_latency measure(query.substr(0, 50));
 	bool success = retryQuery(query, 10);
 	mysql_free_result(mysql_store_result(handle));
+	if (success) {
+		lastInsertId = static_cast<uint64_t>(mysql_insert_id(handle));
+	}
 
 	return success;
 }
 
-DBResult_ptr Database::storeQuery(std::string_view query) {
-	if (!handle) {
-		g_logger().error("Database not initialized!");
-		return nullptr;
-	}
+DBResult_ptr DBConnection::storeQuery(std::string_view query) {
 	g_logger().trace("Storing Query: {}", query);
 
-	metrics::lock_latency measureLock("database");
-	std::scoped_lock lock { databaseLock };
-	measureLock.stop();
-
 	metrics::query_latency measure(query.substr(0, 50));
 retry:
 	if (mysql_query(handle, query.data()) != 0) {
@@ -275,6 +494,170 @@ retry:
 	return nullptr;
 }
 
+bool DBConnection::executeStatement(std::string_view query, std::initializer_list<DBParam> params) {
+	g_logger().trace("Executing Statement: {}", query);
+
+	metrics::query_latency measure(query.substr(0, 50));
+	MYSQL_STMT* statement = executePrepared(query, params);
+	if (!statement) {
+		return false;
+	}
+
+	lastInsertId = static_cast<uint64_t>(mysql_stmt_insert_id(statement));
+	releaseStatement(query, statement);
+	return true;
+}
+
+DBStatementResult_ptr DBConnection::storeStatement(std::string_view query, std::initializer_list<DBParam> params) {
+	g_logger().trace("Storing Statement: {}", query);
+
+	metrics::query_latency measure(query.substr(0, 50));
+	MYSQL_STMT* statement = executePrepared(query, params);
+	if (!statement) {
+		return nullptr;
+	}
+
+	// Sizes the string and blob buffers of the result to their longest value
+	const bool updateMaxLength = true;
+	mysql_stmt_attr_set(statement, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
+	if (mysql_stmt_store_result(statement) != 0) {
+		g_logger().error("Query: {}", query);
+		g_logger().error("Message: {}", mysql_stmt_error(statement));
+		mysql_stmt_close(statement);
+		return nullptr;
+	}
+
+	if (mysql_stmt_num_rows(statement) == 0) {
+		releaseStatement(query, statement);
+		return nullptr;
+	}
+
+	// Rows are buffered on the client, reading them never touches the connection again. Once read,
+	// the statement is handed back through returnStatement and released by the next holder
+	auto result = std::make_shared<DBStatementResult>(*this, statement, query);
+	if (!result->hasNext()) {
+		return nullptr;
+	}
+	return result;
+}
+
+MYSQL_STMT* DBConnection::executePrepared(std::string_view query, std::initializer_list<DBParam> params) {
+	std::vector<MYSQL_BIND> binds(params.size());
+	for (size_t i = 0; const auto &param : params) {
+		param.bind(binds[i++]);
+	}
+
+	for (int retries = 10; retries > 0; --retries) {
+		MYSQL_STMT* statement = takeStatement(query);
+		if (!statement) {
+			if (!isRecoverableError(mysql_errno(handle))) {
+				return nullptr;
+			}
+			std::this_thread::sleep_for(std::chrono::seconds(1));
+			continue;
+		}
+
+		if (mysql_stmt_param_count(statement) != binds.size()) {
+			g_logger().error("Query: {}", query.substr(0, 256));
+			g_logger().error("Statement expects {} parameters, {} given", mysql_stmt_param_count(statement), binds.size());
+			releaseStatement(query, statement);
+			return nullptr;
+		}
+
+		if (mysql_stmt_bind_param(statement, binds.data()) == 0 && mysql_stmt_execute(statement) == 0) {
+			return statement;
+		}
+
+		const auto error = mysql_stmt_errno(statement);
+		g_logger().error("Query: {}", query.substr(0, 256));
+		g_logger().error("MySQL error [{}]: {}", error, mysql_stmt_error(statement));
+		mysql_stmt_close(statement);
+
+		// A reconnect drops the statements prepared on the old session, preparing it again is enough
+		if (error == 1243 /*ER_UNKNOWN_STMT_HANDLER*/) {
+			continue;
+		}
+		if (!isRecoverableError(error)) {
+			return nullptr;
+		}
+		std::this_thread::sleep_for(std::chrono::seconds(1));
+	}
+
+	g_logger().error("Statement {} failed after {} retries.", query, 10);
+	return nullptr;
+}
+
+MYSQL_STMT* DBConnection::takeStatement(std::string_view query) {
+	// A pinned connection is never acquired again while pinned, results read meanwhile come back here
+	reclaimStatements();
+	if (const auto it = statements.find(query); it != statements.end()) {
+		MYSQL_STMT* statement = it->second;
+		statements.erase(it);
+		return statement;
+	}
+
+	MYSQL_STMT* statement = mysql_stmt_init(handle);
+	if (!statement) {
+		g_logger().error("Failed to initialize MySQL statement handle.");
+		return nullptr;
+	}
+
+	if (mysql_stmt_prepare(statement, query.data(), static_cast<unsigned long>(query.size())) != 0) {
+		g_logger().error("Query: {}", query.substr(0, 256));
+		g_logger().error("MySQL error [{}]: {}", mysql_stmt_errno(statement), mysql_stmt_error(statement));
+		mysql_stmt_close(statement);
+		return nullptr;
+	}
+	return statement;
+}
+
+void DBConnection::releaseStatement(std::string_view query, MYSQL_STMT* statement) {
+	mysql_stmt_free_result(statement);
+
+	// The same text may have been prepared again while this one was out, one of them is enough
+	if (!statements.try_emplace(std::string(query), statement).second) {
+		mysql_stmt_close(statement);
+	}
+}
+
+void DBConnection::returnStatement(std::string_view query, MYSQL_STMT* statement) {
+	std::scoped_lock lock { returnedLock };
+	returnedStatements.emplace_back(query, statement);
+}
+
+void DBConnection::reclaimStatements() {
+	std::vector<std::pair<std::string, MYSQL_STMT*>> returned;
+	{
+		std::scoped_lock lock { returnedLock };
+		returned.swap(returnedStatements);
+	}
+
+	for (const auto &[query, statement] : returned) {
+		releaseStatement(query, statement);
+	}
+}
+
+void DBParam::bind(MYSQL_BIND &bind) const {
+	bind.buffer_type = type;
+	bind.is_unsigned = isUnsigned;
+	switch (type) {
+		case MYSQL_TYPE_LONGLONG:
+			bind.buffer = const_cast<int64_t*>(&integer);
+			break;
+		case MYSQL_TYPE_DOUBLE:
+			bind.buffer = const_cast<double*>(&real);
+			break;
+		case MYSQL_TYPE_STRING:
+		case MYSQL_TYPE_BLOB:
+			bind.buffer = const_cast<char*>(data);
+			bind.buffer_length = length;
+			bind.length = const_cast<unsigned long*>(&length);
+			break;
+		default:
+			break;
+	}
+}
+
 std::string Database::escapeString(const std::string &s) const {
 	std::string::size_type len = s.length();
 	auto length = static_cast<uint32_t>(len);
@@ -293,8 +676,10 @@ std::string Database::escapeBlob(const char* s, uint32_t length) const {
 	escaped.push_back('\'');
 
 	if (length != 0) {
+		// Escaping only reads the character set of the session, any connection of the pool does
+		const auto* connection = primary.front();
 		std::string output(maxLength, '\0');
-		size_t escapedLength = mysql_real_escape_string(handle, &output[0], s, length);
+		size_t escapedLength = mysql_real_escape_string(connection ? connection->getHandle() : nullptr, &output[0], s, length);
 		output.resize(escapedLength);
 		escaped.append(output);
 	}
@@ -385,6 +770,133 @@ bool DBResult::next() {
 	return row != nullptr;
 }
 
+DBStatementResult::DBStatementResult(DBConnection &newConnection, MYSQL_STMT* newStatement, std::string_view newQuery) :
+	connection(newConnection), statement(newStatement), query(newQuery) {
+	MYSQL_RES* metadata = mysql_stmt_result_metadata(statement);
+	if (!metadata) {
+		g_logger().error("[DBStatementResult] - Statement has no result set: {}", query);
+		return;
+	}
+
+	const auto fieldCount = mysql_num_fields(metadata);
+	const MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+	binds.resize(fieldCount);
+	columns.resize(fieldCount);
+	for (size_t i = 0; i < fieldCount; ++i) {
+		const auto &field = fields[i];
+		auto &column = columns[i];
+		auto &bind = binds[i];
+		bind.is_null = &column.isNull;
+		bind.error = &column.error;
+		bind.length = &column.length;
+
+		switch (field.type) {
+			case MYSQL_TYPE_TINY:
+			case MYSQL_TYPE_SHORT:
+			case MYSQL_TYPE_INT24:
+			case MYSQL_TYPE_LONG:
+			case MYSQL_TYPE_LONGLONG:
+			case MYSQL_TYPE_YEAR:
+				column.kind = Column::Kind::Integer;
+				column.isUnsigned = (field.flags & UNSIGNED_FLAG) != 0;
+				bind.buffer_type = MYSQL_TYPE_LONGLONG;
+				bind.buffer = &column.integer;
+				bind.is_unsigned = column.isUnsigned;
+				break;
+			case MYSQL_TYPE_FLOAT:
+			case MYSQL_TYPE_DOUBLE:
+				column.kind = Column::Kind::Real;
+				bind.buffer_type = MYSQL_TYPE_DOUBLE;
+				bind.buffer = &column.real;
+				break;
+			default:
+				// Room for the terminator MySQL appends when it fits
+				column.buffer.resize(field.max_length + 1);
+				bind.buffer_type = MYSQL_TYPE_STRING;
+				bind.buffer = column.buffer.data();
+				bind.buffer_length = static_cast<unsigned long>(column.buffer.size());
+				break;
+		}
+	}
+	mysql_free_result(metadata);
+
+	if (mysql_stmt_bind_result(statement, binds.data()) != 0) {
+		g_logger().error("[DBStatementResult] - Failed to bind the result of: {}, error: {}", query, mysql_stmt_error(statement));
+		return;
+	}
+	next();
+}
+
+DBStatementResult::~DBStatementResult() {
+	// The connection may be back in its pool and in use by another thread
+	connection.returnStatement(query, statement);
+}
+
+std::string DBStatementResult::getString(size_t column) const {
+	if (column >= columns.size()) {
+		g_logger().error("[DBStatementResult::getString] - Column {} doesn't exist in the result set of: {}", column, query);
+		return {};
+	}
+
+	const auto &field = columns[column];
+	if (field.isNull) {
+		return {};
+	}
+
+	switch (field.kind) {
+		case Column::Kind::Integer:
+			return field.isUnsigned ? std::to_string(static_cast<uint64_t>(field.integer)) : std::to_string(field.integer);
+		case Column::Kind::Real:
+			return fmt::format("{}", field.real);
+		default:
+			return { field.buffer.data(), field.length };
+	}
+}
+
+const char* DBStatementResult::getStream(size_t column, unsigned long &size) const {
+	if (column >= columns.size() || columns[column].kind != Column::Kind::Text) {
+		g_logger().error("[DBStatementResult::getStream] - Column {} isn't a string or blob in the result set of: {}", column, query);
+		size = 0;
+		return nullptr;
+	}
+
+	const auto &field = columns[column];
+	if (field.isNull) {
+		size = 0;
+		return nullptr;
+	}
+
+	size = field.length;
+	return field.buffer.data();
+}
+
+bool DBStatementResult::isNull(size_t column) const {
+	return column >= columns.size() || columns[column].isNull;
+}
+
+size_t DBStatementResult::countResults() const {
+	return static_cast<size_t>(mysql_stmt_num_rows(statement));
+}
+
+bool DBStatementResult::hasNext() const {
+	return hasRow;
+}
+
+bool DBStatementResult::next() {
+	if (binds.empty()) {
+		hasRow = false;
+		return false;
+	}
+
+	// Buffers are as long as the longest value of each column, nothing can come truncated
+	const auto status = mysql_stmt_fetch(statement);
+	hasRow = status == 0 || status == MYSQL_DATA_TRUNCATED;
+	if (status == 1) {
+		g_logger().error("[DBStatementResult::next] - Failed to fetch a row of: {}, error: {}", query, mysql_stmt_error(statement));
+	}
+	return hasRow;
+}
+
 DBInsert::DBInsert(std::string insertQuery) :
 	query(std::move(insertQuery)) {
 	this->length = this->query.length();
@@ -10,22 +10,193 @@
 #pragma once
 
 #include "declarations.hpp"
+#include "utils/transparent_string_hash.hpp"
 
 #ifndef USE_PRECOMPILED_HEADERS
 	#include <mysql/mysql.h>
+	#include <condition_variable>
 	#include <mutex>
 	#include <utility>
 #endif
 
 class DBResult;
 using DBResult_ptr = std::shared_ptr<DBResult>;
+class DBStatementResult;
+using DBStatementResult_ptr = std::shared_ptr<DBStatementResult>;
+
+/**
+ * @brief Typed value for a `?` placeholder of a prepared statement.
+ * Numbers travel in binary and strings as they are, so nothing needs escaping.
+ * It points at the value it was made from, which must outlive the call.
+ */
+class DBParam {
+public:
+	DBParam(std::nullptr_t) :
+		type(MYSQL_TYPE_NULL) { }
+	DBParam(bool value) :
+		type(MYSQL_TYPE_LONGLONG), integer(value) { }
+	template <std::integral T>
+		requires(!std::is_same_v<T, bool>)
+	DBParam(T value) :
+		type(MYSQL_TYPE_LONGLONG), isUnsigned(std::is_unsigned_v<T>), integer(static_cast<int64_t>(value)) { }
+	template <typename T>
+		requires std::is_enum_v<T>
+	DBParam(T value) :
+		DBParam(std::to_underlying(value)) { }
+	DBParam(double value) :
+		type(MYSQL_TYPE_DOUBLE), real(value) { }
+	DBParam(std::string_view value) :
+		type(MYSQL_TYPE_STRING), data(value.data()), length(static_cast<unsigned long>(value.size())) { }
+	DBParam(const std::string &value) :
+		DBParam(std::string_view(value)) { }
+	DBParam(const char* value) :
+		DBParam(std::string_view(value)) { }
+
+	// Raw bytes, such as serialized item attributes
+	static DBParam blob(const char* bytes, size_t size) {
+		DBParam param(std::string_view(bytes, size));
+		param.type = MYSQL_TYPE_BLOB;
+		return param;
+	}
+
+private:
+	void bind(MYSQL_BIND &bind) const;
+
+	enum_field_types type;
+	bool isUnsigned = false;
+	union {
+		int64_t integer = 0;
+		double real;
+	};
+	const char* data = nullptr;
+	unsigned long length = 0;
+
+	friend class DBConnection;
+};
+
+/**
+ * @brief Where a query may run.
+ */
+enum class DBTarget : uint8_t {
+	// Writes, and reads that must see them
+	Primary,
+	// Reads that tolerate replication lag, such as highscores and market browsing
+	Replica,
+};
+
+struct DBEndpoint {
+	std::string host;
+	std::string user;
+	std::string password;
+	std::string database;
+	uint32_t port = 3306;
+	std::string sock;
+};
+
+/**
+ * @brief One MySQL session, used by a single thread at a time while it is checked out of its pool.
+ * The statements prepared on it are cached here by their text.
+ */
+class DBConnection {
+public:
+	DBConnection() = default;
+	~DBConnection();
+
+	// Non copyable
+	DBConnection(const DBConnection &) = delete;
+	DBConnection &operator=(const DBConnection &) = delete;
+
+	bool connect(const DBEndpoint &endpoint);
+
+	bool executeQuery(std::string_view query);
+	DBResult_ptr storeQuery(std::string_view query);
+	bool executeStatement(std::string_view query, std::initializer_list<DBParam> params);
+	DBStatementResult_ptr storeStatement(std::string_view query, std::initializer_list<DBParam> params);
+
+	bool commit();
+	bool rollback();
+
+	MYSQL* getHandle() const {
+		return handle;
+	}
+
+private:
+	static bool isRecoverableError(unsigned int error);
+
+	bool retryQuery(std::string_view query, int retries);
+
+	// Returns the statement executed and taken out of the cache
+	MYSQL_STMT* executePrepared(std::string_view query, std::initializer_list<DBParam> params);
+	MYSQL_STMT* takeStatement(std::string_view query);
+	// Frees the result and caches the statement again, only by the thread holding the connection
+	void releaseStatement(std::string_view query, MYSQL_STMT* statement);
+	// Queues a statement for the next holder of the connection, from any thread
+	void returnStatement(std::string_view query, MYSQL_STMT* statement);
+	// Releases the queued statements, only by the thread holding the connection
+	void reclaimStatements();
+
+	MYSQL* handle = nullptr;
+
+	// Idle prepared statements, a statement whose result is still being read is out of it
+	std::unordered_map<std::string, MYSQL_STMT*, TransparentStringHasher, std::equal_to<>> statements;
+
+	// Guards returnedStatements only
+	std::mutex returnedLock;
+	// Statements of results destroyed while another thread may hold the connection. Freeing their
+	// result resets state of the shared MYSQL session, so it waits for whoever holds it next
+	std::vector<std::pair<std::string, MYSQL_STMT*>> returnedStatements;
+
+	friend class DBConnectionPool;
+	friend class DBStatementResult;
+};
+
+/**
+ * @brief Fixed set of connections to one endpoint, each checked out by one thread at a time.
+ * The time spent waiting for a free connection goes to the lock latency of the pool name.
+ */
+class DBConnectionPool {
+public:
+	explicit DBConnectionPool(std::string name) :
+		name(std::move(name)) { }
+
+	// Non copyable
+	DBConnectionPool(const DBConnectionPool &) = delete;
+	DBConnectionPool &operator=(const DBConnectionPool &) = delete;
+
+	bool open(const DBEndpoint &endpoint, size_t size);
+
+	// Blocks until a connection is free, nullptr if the pool was never opened
+	DBConnection* acquire();
+	void release(DBConnection* connection);
+
+	bool isOpen() const {
+		return !connections.empty();
+	}
+
+	size_t size() const {
+		return connections.size();
+	}
+
+	// Any connection, for what only needs the session settings, such as escaping
+	DBConnection* front() const {
+		return connections.empty() ? nullptr : connections.front().get();
+	}
+
+private:
+	std::string name;
+	std::vector<std::unique_ptr<DBConnection>> connections;
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::vector<DBConnection*> idle;
+};
 
 class Database {
 public:
 	static const size_t MAX_QUERY_SIZE = 8 * 1024 * 1024; // 8 Mb -- half the default MySQL max_allowed_packet size
 
 	Database() = default;
-	~Database();
+	~Database() = default;
 
 	// Singleton - ensures we don't accidentally copy it.
 	Database(const Database &) = delete;
@@ -35,7 +206,16 @@ public:
 
 	bool connect();
 
-	bool connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock);
+	/**
+	 * @brief Opens the pool of primary connections.
+	 * Each query checks out a connection of its own, only a DBTransaction keeps one for
+	 * the thread until it ends. Queries that rely on session state, such as a raw "BEGIN"
+	 * or LOCK TABLES through executeQuery, need a DBSession or a pool of one connection.
+	 */
+	bool connect(const std::string* host, const std::string* user, const std::string* password, const std::string* database, uint32_t port, const std::string* sock, size_t poolSize = 1);
+
+	// Opens the pool that serves DBTarget::Replica, with the credentials of the primary
+	bool connectReplica(const std::string* host, uint32_t port, size_t poolSize);
 
 	/**
 	 * @brief Creates a backup of the database.
@@ -54,18 +234,24 @@ public:
 	 */
 	void createDatabaseBackup(bool compress) const;
 
-	bool retryQuery(std::string_view query, int retries);
 	bool executeQuery(std::string_view query);
 
-	DBResult_ptr storeQuery(std::string_view query);
+	DBResult_ptr storeQuery(std::string_view query, DBTarget target = DBTarget::Primary);
+
+	/**
+	 * @brief Runs a statement with `?` placeholders bound to the given parameters.
+	 * Each statement is prepared once per connection and kept by its text, later
+	 * calls only send the parameters, and results come back in binary.
+	 */
+	bool executeStatement(std::string_view query, std::initializer_list<DBParam> params = {});
+	DBStatementResult_ptr storeStatement(std::string_view query, std::initializer_list<DBParam> params = {}, DBTarget target = DBTarget::Primary);
 
 	std::string escapeString(const std::string &s) const;
 
 	std::string escapeBlob(const char* s, uint32_t length) const;
 
-	uint64_t getLastInsertId() const {
-		return static_cast<uint64_t>(mysql_insert_id(handle));
-	}
+	// Id generated by the last insert of the calling thread
+	uint64_t getLastInsertId() const;
 
 	static const char* getClientVersion() {
 		return mysql_get_client_info();
@@ -75,18 +261,30 @@ public:
 		return maxPacketSize;
 	}
 
+	size_t getPoolSize() const {
+		return primary.size();
+	}
+
 private:
+	class ConnectionLease;
+
+	ConnectionLease lease(DBTarget target);
+
+	bool pinConnection();
+	void unpinConnection();
+
 	bool beginTransaction();
 	bool rollback();
 	bool commit();
+	void endTransaction();
 
-	static bool isRecoverableError(unsigned int error);
-
-	MYSQL* handle = nullptr;
-	std::recursive_mutex databaseLock;
+	DBEndpoint endpoint;
+	DBConnectionPool primary { "database" };
+	DBConnectionPool replica { "database replica" };
 	uint64_t maxPacketSize = 1048576;
 
 	friend class DBTransaction;
+	friend class DBSession;
 };
 
 constexpr auto g_database = Database::getInstance;
@@ -193,6 +391,99 @@ private:
 	friend class Database;
 };
 
+/**
+ * @brief Rows of a prepared statement, read by column index in the order of the select list.
+ * Columns arrive typed, numbers are read as they are instead of parsed from text.
+ */
+class DBStatementResult {
+public:
+	DBStatementResult(DBConnection &connection, MYSQL_STMT* statement, std::string_view query);
+	~DBStatementResult();
+
+	// Non copyable
+	DBStatementResult(const DBStatementResult &) = delete;
+	DBStatementResult &operator=(const DBStatementResult &) = delete;
+
+	template <typename T>
+	T getNumber(size_t column) const {
+		if (column >= columns.size()) {
+			g_logger().error("[DBStatementResult::getNumber] - Column {} doesn't exist in the result set of: {}", column, query);
+			return T();
+		}
+
+		const auto &field = columns[column];
+		if (field.isNull) {
+			return T();
+		}
+
+		if constexpr (std::is_enum_v<T>) {
+			return static_cast<T>(getNumber<std::underlying_type_t<T>>(column));
+		} else {
+			switch (field.kind) {
+				case Column::Kind::Integer:
+					return field.isUnsigned ? static_cast<T>(static_cast<uint64_t>(field.integer)) : static_cast<T>(field.integer);
+				case Column::Kind::Real:
+					return static_cast<T>(field.real);
+				default:
+					break;
+			}
+
+			// Decimals, such as sums, come as text
+			const auto* begin = field.buffer.data();
+			const auto* end = begin + field.length;
+			if constexpr (std::is_same_v<T, bool>) {
+				int64_t value = 0;
+				std::from_chars(begin, end, value);
+				return value != 0;
+			} else {
+				T value {};
+				if (std::from_chars(begin, end, value).ec != std::errc {}) {
+					g_logger().error("[DBStatementResult::getNumber] - Column {} has an invalid value set, of: {}", column, query);
+					return T();
+				}
+				return value;
+			}
+		}
+	}
+
+	std::string getString(size_t column) const;
+	const char* getStream(size_t column, unsigned long &size) const;
+	bool isNull(size_t column) const;
+
+	size_t countResults() const;
+	bool hasNext() const;
+	bool next();
+
+private:
+	using BindFlag = decltype(MYSQL_BIND::is_null_value);
+
+	struct Column {
+		enum class Kind : uint8_t {
+			Integer,
+			Real,
+			Text,
+		};
+
+		Kind kind = Kind::Text;
+		bool isUnsigned = false;
+		int64_t integer = 0;
+		double real = 0;
+		std::vector<char> buffer;
+		unsigned long length = 0;
+		BindFlag isNull = 0;
+		BindFlag error = 0;
+	};
+
+	// The statement goes back to the cache of the connection it came from
+	DBConnection &connection;
+	MYSQL_STMT* statement;
+	std::string query;
+	// Bound to the columns below, neither moves once the result is set up
+	std::vector<MYSQL_BIND> binds;
+	std::vector<Column> columns;
+	bool hasRow = false;
+};
+
 /**
  * INSERT statement.
  */
@@ -211,6 +502,35 @@ private:
 	size_t length;
 };
 
+/**
+ * @brief Keeps one primary connection for the calling thread until the scope ends.
+ * For work that relies on session state across separate queries, such as LOCK TABLES or
+ * user variables. A DBTransaction inside the scope runs on the same connection.
+ */
+class DBSession {
+public:
+	explicit DBSession(Database &database = Database::getInstance()) :
+		database(database), pinned(database.pinConnection()) { }
+
+	~DBSession() {
+		if (pinned) {
+			database.unpinConnection();
+		}
+	}
+
+	// Non copyable
+	DBSession(const DBSession &) = delete;
+	DBSession &operator=(const DBSession &) = delete;
+
+	explicit operator bool() const {
+		return pinned;
+	}
+
+private:
+	Database &database;
+	bool pinned;
+};
+
 class DBTransaction {
 public:
 	explicit DBTransaction() = default;
@@ -0,0 +1,75 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "database/database_table_image.hpp"
+
+namespace {
+	uint64_t hashTable(const std::vector<DBTableImage::Row> &rows, uint64_t (*hashRow)(const DBTableImage::Row &)) {
+		// Order matters, a table without a key is written back in the same order
+		uint64_t hash = rows.size();
+		for (const auto &row : rows) {
+			hash ^= hashRow(row) + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+		}
+		return hash;
+	}
+}
+
+uint64_t DBTableImage::hashRow(const Row &row) {
+	const auto keyHash = std::hash<std::string_view> {}(row.key);
+	const auto valuesHash = std::hash<std::string_view> {}(row.values);
+	return keyHash ^ (valuesHash + 0x9E3779B97F4A7C15ULL + (keyHash << 6) + (keyHash >> 2));
+}
+
+DBTableImage::Changes DBTableImage::diff(const std::vector<Row> &rows, bool keyed) const {
+	Changes changes;
+	if (!tracked) {
+		changes.rewrite = true;
+		return changes;
+	}
+
+	if (!keyed) {
+		changes.rewrite = hashTable(rows, &DBTableImage::hashRow) != tableHash;
+		return changes;
+	}
+
+	phmap::flat_hash_set<std::string_view> keys;
+	keys.reserve(rows.size());
+	for (size_t i = 0; i < rows.size(); ++i) {
+		const auto &row = rows[i];
+		keys.emplace(row.key);
+
+		const auto it = hashes.find(row.key);
+		if (it == hashes.end() || it->second != hashRow(row)) {
+			changes.upserts.emplace_back(i);
+		}
+	}
+
+	for (const auto &[key, hash] : hashes) {
+		if (!keys.contains(key)) {
+			changes.deletes.emplace_back(key);
+		}
+	}
+	return changes;
+}
+
+void DBTableImage::commit(const std::vector<Row> &rows, bool keyed) {
+	tracked = true;
+	hashes.clear();
+	tableHash = 0;
+
+	if (!keyed) {
+		tableHash = hashTable(rows, &DBTableImage::hashRow);
+		return;
+	}
+
+	hashes.reserve(rows.size());
+	for (const auto &row : rows) {
+		hashes.insert_or_assign(row.key, hashRow(row));
+	}
+}
@@ -0,0 +1,80 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#ifndef USE_PRECOMPILED_HEADERS
+	#include <memory>
+	#include <parallel_hashmap/phmap.h>
+	#include <string>
+	#include <vector>
+#endif
+
+/**
+ * @brief What the last save wrote to one table for one owner, so the next save only sends what changed.
+ * Rows are told apart by the SQL literals of their key columns and compared by a hash of the whole
+ * row. Until a save has been committed, or after reset(), the table is rewritten in full.
+ */
+class DBTableImage {
+public:
+	struct Row {
+		// Comma separated SQL literals of the key columns, empty for tables without one
+		std::string key;
+		// Comma separated SQL literals of the remaining columns
+		std::string values;
+	};
+
+	struct Changes {
+		// Delete every row of the owner, then insert all rows
+		bool rewrite = false;
+		// Indexes of the rows to insert or update
+		std::vector<size_t> upserts;
+		// Keys of the rows to delete
+		std::vector<std::string> deletes;
+
+		bool empty() const {
+			return !rewrite && upserts.empty() && deletes.empty();
+		}
+	};
+
+	/**
+	 * @brief Compares rows with the image.
+	 * Tables without key columns can't be updated row by row, any change rewrites them.
+	 */
+	Changes diff(const std::vector<Row> &rows, bool keyed) const;
+
+	// Makes rows the image, once they were written
+	void commit(const std::vector<Row> &rows, bool keyed);
+
+	void reset() {
+		tracked = false;
+		hashes.clear();
+		tableHash = 0;
+	}
+
+	bool isTracked() const {
+		return tracked;
+	}
+
+private:
+	static uint64_t hashRow(const Row &row);
+
+	bool tracked = false;
+	phmap::flat_hash_map<std::string, uint64_t> hashes;
+	uint64_t tableHash = 0;
+};
+
+/**
+ * @brief Rows an earlier snapshot serialized, with a signature of the state they came from.
+ * A snapshot that finds the same signature hands the rows over again instead of serializing them.
+ */
+struct DBSnapshotRows {
+	size_t signature = 0;
+	std::shared_ptr<const std::vector<DBTableImage::Row>> rows;
+};
@@ -95,6 +95,9 @@ void DatabaseManager::updateDatabase() {
 	luaL_openlibs(L);
 	CoreLibsFunctions::init(L);
 
+	// Migrations may rely on session state across queries, such as LOCK TABLES, so they all run on one connection
+	DBSession session;
+
 	int32_t currentVersion = getDatabaseVersion();
 	std::string migrationDirectory = g_configManager().getString(DATA_DIRECTORY) + "/migrations/";
 
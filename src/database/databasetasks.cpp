@@ -30,9 +30,9 @@ void DatabaseTasks::execute(const std::string &query, const std::function<void(D
 	});
 }
 
-void DatabaseTasks::store(const std::string &query, const std::function<void(DBResult_ptr, bool)> &callback /* nullptr */) {
-	threadPool.detach_task([this, query, callback]() {
-		DBResult_ptr result = db.storeQuery(query);
+void DatabaseTasks::store(const std::string &query, const std::function<void(DBResult_ptr, bool)> &callback /* nullptr */, DBTarget target /* = DBTarget::Primary*/) {
+	threadPool.detach_task([this, query, callback, target]() {
+		DBResult_ptr result = db.storeQuery(query, target);
 		if (callback != nullptr) {
 			g_dispatcher().addEvent([callback, result]() { callback(result, true); }, __FUNCTION__);
 		}
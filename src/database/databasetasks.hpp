@@ -23,7 +23,7 @@ public:
 	static DatabaseTasks &getInstance();
 
 	void execute(const std::string &query, const std::function<void(DBResult_ptr, bool)> &callback = nullptr);
-	void store(const std::string &query, const std::function<void(DBResult_ptr, bool)> &callback = nullptr);
+	void store(const std::string &query, const std::function<void(DBResult_ptr, bool)> &callback = nullptr, DBTarget target = DBTarget::Primary);
 
 private:
 	Database &db;
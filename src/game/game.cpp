@@ -41,6 +41,7 @@
 #include "items/containers/rewards/reward.hpp"
 #include "items/containers/rewards/rewardchest.hpp"
 #include "items/items.hpp"
+#include "kv/kv.hpp"
 #include "items/items_classification.hpp"
 #include "lua/callbacks/event_callback.hpp"
 #include "lua/callbacks/events_callbacks.hpp"
@@ -56,6 +57,7 @@
 #include "server/network/protocol/protocolgame.hpp"
 #include "server/network/webhook/webhook.hpp"
 #include "server/server.hpp"
+#include "utils/slab_allocator.hpp"
 #include "utils/tools.hpp"
 #include "utils/wildcardtree.hpp"
 #include "creatures/players/vocations/vocation.hpp"
@@ -555,6 +557,18 @@ void Game::start(ServiceManager* manager) {
 	g_dispatcher().cycleEvent(
 		EVENT_LUA_GARBAGE_COLLECTION, [this] { g_luaEnvironment().collectGarbage(); }, "Calling GC"
 	);
+	g_dispatcher().cycleEvent(
+		EVENT_SPECTATORS_PRUNE_INTERVAL, [] { Spectators::pruneCache(); }, "Spectators::pruneCache"
+	);
+	g_dispatcher().cycleEvent(
+		EVENT_SLAB_METRICS_INTERVAL, [] { SlabSizeClass::reportMetrics(); }, "SlabSizeClass::reportMetrics"
+	);
+	g_dispatcher().cycleEvent(
+		KVStore::FLUSH_INTERVAL_MS, [] { g_kv().scheduleFlush(); }, "KVStore::scheduleFlush"
+	);
+	g_dispatcher().cycleEvent(
+		EVENT_KV_METRICS_INTERVAL, [] { g_kv().reportMetrics(); }, "KVStore::reportMetrics"
+	);
 	auto marketItemsPriceIntervalMinutes = g_configManager().getNumber(MARKET_REFRESH_PRICES);
 	if (marketItemsPriceIntervalMinutes > 0) {
 		auto marketItemsPriceIntervalMS = marketItemsPriceIntervalMinutes * 60000;
@@ -4486,6 +4500,7 @@ void Game::playerSetShowOffSocket(uint32_t playerId, Outfit_t &outfit, const Pos
 	}
 
 	// Send to client
+	tile->touch();
 	for (const auto &spectator : Spectators().find<Player>(pos, true)) {
 		spectator->getPlayer()->sendUpdateTileItem(tile, pos, item);
 	}
@@ -6565,10 +6580,11 @@ bool Game::internalCreatureSay(const std::shared_ptr<Creature> &creature, SpeakC
 	}
 
 	// Send to client
+	BroadcastPacket broadcast;
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
 			if (!ghostMode || tmpPlayer->canSeeCreature(creature)) {
-				tmpPlayer->sendCreatureSay(creature, type, text, pos);
+				tmpPlayer->sendCreatureSay(creature, type, text, pos, broadcast);
 			}
 		}
 	}
@@ -8138,9 +8154,10 @@ void Game::addCreatureHealth(const CreatureVector &spectators, const std::shared
 			}
 		}
 	}
+	BroadcastPacket broadcast;
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendCreatureHealth(target);
+			tmpPlayer->sendCreatureHealth(target, broadcast);
 		}
 	}
 }
@@ -8168,9 +8185,10 @@ void Game::addMagicEffect(const Position &pos, uint16_t effect) {
 }
 
 void Game::addMagicEffect(const CreatureVector &spectators, const Position &pos, uint16_t effect) {
+	BroadcastPacket broadcast;
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendMagicEffect(pos, effect);
+			tmpPlayer->sendMagicEffect(pos, effect, broadcast);
 		}
 	}
 }
@@ -8194,9 +8212,10 @@ void Game::addDistanceEffect(const Position &fromPos, const Position &toPos, uin
 }
 
 void Game::addDistanceEffect(const CreatureVector &spectators, const Position &fromPos, const Position &toPos, uint16_t effect) {
+	BroadcastPacket broadcast;
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendDistanceShoot(fromPos, toPos, effect);
+			tmpPlayer->sendDistanceShoot(fromPos, toPos, effect, broadcast);
 		}
 	}
 }
@@ -8880,7 +8899,7 @@ void Game::playerHighscores(const std::shared_ptr<Player> &player, HighscoreType
 		processHighscoreResults(result, playerID, category, vocation, entriesPerPage);
 	};
 
-	g_databaseTasks().store(query, callback);
+	g_databaseTasks().store(query, callback, DBTarget::Replica);
 	player->addAsyncOngoingTask(PlayerAsyncTask_Highscore);
 }
 
@@ -9027,8 +9046,9 @@ void Game::playerBrowseMarket(uint32_t playerId, uint16_t itemId, uint8_t tier)
 		return;
 	}
 
-	const MarketOfferList &buyOffers = IOMarket::getActiveOffers(MARKETACTION_BUY, it.id, tier);
-	const MarketOfferList &sellOffers = IOMarket::getActiveOffers(MARKETACTION_SELL, it.id, tier);
+	// Browsing tolerates replication lag, the refresh after a player's own offer does not
+	const MarketOfferList &buyOffers = IOMarket::getActiveOffers(MARKETACTION_BUY, it.id, tier, DBTarget::Replica);
+	const MarketOfferList &sellOffers = IOMarket::getActiveOffers(MARKETACTION_SELL, it.id, tier, DBTarget::Replica);
 	player->sendMarketBrowseItem(it.id, buyOffers, sellOffers, tier);
 	player->sendMarketDetail(it.id, tier);
 }
@@ -9912,6 +9932,7 @@ void Game::playerSetMonsterPodium(uint32_t playerId, uint32_t monsterRaceId, con
 		item->removeAttribute(ItemAttribute_t::NAME);
 	}
 
+	tile->touch();
 	for (const auto &spectator : Spectators().find<Player>(pos, true)) {
 		spectator->getPlayer()->sendUpdateTileItem(tile, pos, item);
 	}
@@ -11213,6 +11234,7 @@ void Game::refreshItem(const std::shared_ptr<Item> &item) {
 		return;
 	}
 	if (const auto &tile = parent->getTile()) {
+		tile->touch();
 		const auto spectators = Spectators().find<Player>(tile->getPosition(), true);
 		// send to client
 		for (const auto &spectator : spectators) {
@@ -31,8 +31,9 @@ public:
 	const Position &getDestPos() const {
 		return destPos;
 	}
-	void constexpr setDestPos(const Position pos) {
+	void setDestPos(const Position pos) {
 		destPos = pos;
+		touchRevision();
 	}
 
 	bool checkInfinityLoop(const std::shared_ptr<Tile> &destTile);
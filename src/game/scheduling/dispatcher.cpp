@@ -11,6 +11,7 @@
 
 #include "lib/thread/thread_pool.hpp"
 #include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
 #include "utils/tools.hpp"
 
 thread_local DispatcherContext Dispatcher::dispacherContext;
@@ -22,23 +23,43 @@ Dispatcher &Dispatcher::getInstance() {
 void Dispatcher::init() {
 	UPDATE_OTSYS_TIME();
 
+	scheduledTasks.rebase(OTSYS_TIME());
+
 	threadPool.detach_task([this] {
 		std::unique_lock asyncLock(dummyMutex);
+		dispatcherThreadId = ThreadPool::getThreadId();
 
 		while (!threadPool.isStopped()) {
 			UPDATE_OTSYS_TIME();
+			const auto tickStart = std::chrono::steady_clock::now();
+			tickCycle.store(dispatcherCycle, std::memory_order_relaxed);
+			tickStartedAt.store(std::chrono::duration_cast<std::chrono::nanoseconds>(tickStart.time_since_epoch()).count(), std::memory_order_release);
 
 			executeEvents();
 			executeScheduledEvents();
 			mergeEvents();
 
+			profiler.endTick(dispatcherCycle, std::chrono::steady_clock::now() - tickStart);
+			collectTickStats();
+
 			if (!hasPendingTasks) {
+				tickStartedAt.store(0, std::memory_order_release);
 				signalSchedule.wait_for(asyncLock, timeUntilNextScheduledTask());
 			}
 		}
 	});
 }
 
+bool Dispatcher::executeTask(const Task &task, TaskGroup group) {
+	const auto start = std::chrono::steady_clock::now();
+	if (!task.execute()) {
+		return false;
+	}
+
+	profiler.record(ThreadPool::getThreadId(), task.getContext(), group, start - task.getDueTime(), std::chrono::steady_clock::now() - start);
+	return true;
+}
+
 void Dispatcher::executeSerialEvents(const uint8_t groupId) {
 	auto &tasks = m_tasks[groupId];
 	if (tasks.empty()) {
@@ -50,7 +71,7 @@ void Dispatcher::executeSerialEvents(const uint8_t groupId) {
 
 	for (const auto &task : tasks) {
 		dispacherContext.taskName = task.getContext();
-		if (task.execute()) {
+		if (executeTask(task, dispacherContext.group)) {
 			++dispatcherCycle;
 		}
 	}
@@ -65,10 +86,10 @@ void Dispatcher::executeParallelEvents(const uint8_t groupId) {
 		return;
 	}
 
-	asyncWait(tasks.size(), [groupId, &tasks](size_t i) {
+	asyncWait(tasks.size(), [this, groupId, &tasks](size_t i) {
 		dispacherContext.type = DispatcherType::AsyncEvent;
 		dispacherContext.group = static_cast<TaskGroup>(groupId);
-		tasks[i].execute();
+		executeTask(tasks[i], dispacherContext.group);
 
 		dispacherContext.reset();
 	});
@@ -77,38 +98,28 @@ void Dispatcher::executeParallelEvents(const uint8_t groupId) {
 }
 
 void Dispatcher::asyncWait(size_t requestSize, std::function<void(size_t i)> &&f) {
-	if (requestSize == 0) {
-		return;
-	}
-
-	// This prevents an async call from running inside another async call.
-	if (asyncWaitDisabled) {
-		for (uint_fast64_t i = 0; i < requestSize; ++i) {
-			f(i);
-		}
-		return;
-	}
-
-	const auto &partitions = generatePartition(requestSize);
-	const auto pSize = partitions.size();
-
-	BS::multi_future<void> retFuture;
+	// Work is split in small chunks that idle threads steal from each other,
+	// the caller takes part in the loop, which makes nested calls safe.
+	parallelExecutor.parallelFor(requestSize, f);
+}
 
-	if (pSize > 1) {
-		asyncWaitDisabled = true;
-		const auto min = partitions[1].first;
-		const auto max = partitions[partitions.size() - 1].second;
-		retFuture = threadPool.submit_loop(min, max, [&f](const unsigned int i) { f(i); });
+void Dispatcher::collectTickStats() {
+	asyncWaitStats = parallelExecutor.collectStats();
+	if (asyncWaitStats.loops > 0) {
+		g_metrics().addCounter("dispatcher_async_steals", static_cast<double>(asyncWaitStats.steals));
+		g_metrics().addCounter("dispatcher_async_idle_us", static_cast<double>(asyncWaitStats.idleMicros));
 	}
 
-	const auto &[min, max] = partitions[0];
-	for (uint_fast64_t i = min; i < max; ++i) {
-		f(i);
+	const auto spilledEvents = getSpilledEvents();
+	if (spilledEvents != lastSpilledEvents) {
+		g_metrics().addCounter("dispatcher_inbox_spilled", static_cast<double>(spilledEvents - lastSpilledEvents));
+		lastSpilledEvents = spilledEvents;
 	}
 
-	if (pSize > 1) {
-		retFuture.wait();
-		asyncWaitDisabled = false;
+	const auto now = std::chrono::steady_clock::now();
+	if (now - lastProfilerReport >= std::chrono::milliseconds(DISPATCHER_PROFILER_METRICS_INTERVAL)) {
+		profiler.reportMetrics();
+		lastProfilerReport = now;
 	}
 }
 
@@ -127,32 +138,20 @@ void Dispatcher::executeEvents(const TaskGroup startGroup) {
 }
 
 void Dispatcher::executeScheduledEvents() {
-	auto &threadScheduledTasks = getThreadTask()->scheduledTasks;
-
-	auto it = scheduledTasks.begin();
-	while (it != scheduledTasks.end()) {
-		const auto &task = *it;
-		if (task->getTime() > OTSYS_TIME()) {
-			break;
-		}
+	auto &thread = *getThreadTask();
 
+	scheduledTasks.advance(OTSYS_TIME(), [this, &thread](std::shared_ptr<Task> &&task) {
 		dispacherContext.type = task->isCycle() ? DispatcherType::CycleEvent : DispatcherType::ScheduledEvent;
 		dispacherContext.group = TaskGroup::Serial;
 		dispacherContext.taskName = task->getContext();
 
-		if (task->execute() && task->isCycle()) {
+		if (executeTask(*task, TaskGroup::Serial) && task->isCycle()) {
 			task->updateTime();
-			threadScheduledTasks.emplace_back(task);
+			pushToInbox(thread, thread.scheduledTasks, thread.spilledScheduledTasks, std::move(task));
 		} else {
 			scheduledTasksRef.erase(task->getId());
 		}
-
-		++it;
-	}
-
-	if (it != scheduledTasks.begin()) {
-		scheduledTasks.erase(scheduledTasks.begin(), it);
-	}
+	});
 
 	dispacherContext.reset();
 
@@ -162,26 +161,57 @@ void Dispatcher::executeScheduledEvents() {
 
 void Dispatcher::__mergeEvents(const std::array<uint8_t, 2> &groups, const bool mergeScheduledEvents) {
 	for (const auto &thread : threads) {
-		std::scoped_lock lock(thread->mutex);
 		for (const auto group : groups) {
-			auto &threadTasks = thread->tasks[group];
 			auto &tasks = m_tasks[group];
+			thread->tasks[group].consume([&tasks](Task &&task) {
+				tasks.emplace_back(std::move(task));
+			});
+		}
 
-			if (threadTasks.size() > tasks.size()) {
-				tasks.swap(threadTasks);
-			}
+		if (mergeScheduledEvents) {
+			thread->scheduledTasks.consume([this](std::shared_ptr<Task> &&task) {
+				if (!task->isCanceled()) {
+					scheduledTasks.insert(task);
+				}
+			});
+
+			thread->canceledTasks.consume([this](std::shared_ptr<Task> &&task) {
+				scheduledTasks.erase(task.get());
+			});
+		}
+
+		if (thread->hasSpilled.load(std::memory_order_acquire)) {
+			mergeSpilledEvents(*thread, groups, mergeScheduledEvents);
+		}
+	}
+}
 
-			if (!threadTasks.empty()) {
-				tasks.insert(tasks.end(), make_move_iterator(threadTasks.begin()), make_move_iterator(threadTasks.end()));
-				threadTasks.clear();
+void Dispatcher::mergeSpilledEvents(ThreadTask &thread, const std::array<uint8_t, 2> &groups, const bool mergeScheduledEvents) {
+	std::scoped_lock lock(thread.spillMutex);
+	for (const auto group : groups) {
+		auto &spilledTasks = thread.spilledTasks[group];
+		auto &tasks = m_tasks[group];
+		tasks.insert(tasks.end(), make_move_iterator(spilledTasks.begin()), make_move_iterator(spilledTasks.end()));
+		spilledTasks.clear();
+	}
+
+	if (mergeScheduledEvents) {
+		for (const auto &task : thread.spilledScheduledTasks) {
+			if (!task->isCanceled()) {
+				scheduledTasks.insert(task);
 			}
 		}
+		thread.spilledScheduledTasks.clear();
 
-		if (mergeScheduledEvents && !thread->scheduledTasks.empty()) {
-			scheduledTasks.insert(make_move_iterator(thread->scheduledTasks.begin()), make_move_iterator(thread->scheduledTasks.end()));
-			thread->scheduledTasks.clear();
+		for (const auto &task : thread.spilledCanceledTasks) {
+			scheduledTasks.erase(task.get());
 		}
+		thread.spilledCanceledTasks.clear();
 	}
+
+	const auto hasSpilled = !thread.spilledScheduledTasks.empty() || !thread.spilledCanceledTasks.empty()
+		|| std::ranges::any_of(thread.spilledTasks, [](const auto &tasks) { return !tasks.empty(); });
+	thread.hasSpilled.store(hasSpilled, std::memory_order_release);
 }
 
 // Merge only async thread events with main dispatch events
@@ -205,50 +235,54 @@ std::chrono::milliseconds Dispatcher::timeUntilNextScheduledTask() const {
 		return CHRONO_MILI_MAX;
 	}
 
-	const auto &task = *scheduledTasks.begin();
-	const auto timeRemaining = std::chrono::milliseconds(task->getTime() - OTSYS_TIME());
+	const auto timeRemaining = std::chrono::milliseconds(scheduledTasks.getNextTime() - OTSYS_TIME());
 	return std::max<std::chrono::milliseconds>(timeRemaining, CHRONO_0);
 }
 
 void Dispatcher::addEvent(std::function<void(void)> &&f, std::string_view context, uint32_t expiresAfterMs) {
-	const auto &thread = getThreadTask();
-	std::scoped_lock lock(thread->mutex);
-	thread->tasks[static_cast<uint8_t>(TaskGroup::Serial)].emplace_back(expiresAfterMs, std::move(f), context);
-	notify();
+	auto &thread = *getThreadTask();
+	constexpr auto group = static_cast<uint8_t>(TaskGroup::Serial);
+	pushToInbox(thread, thread.tasks[group], thread.spilledTasks[group], expiresAfterMs, std::move(f), context);
 }
 
 void Dispatcher::addWalkEvent(std::function<void(void)> &&f, uint32_t expiresAfterMs) {
-	const auto &thread = getThreadTask();
-	std::scoped_lock lock(thread->mutex);
-	thread->tasks[static_cast<uint8_t>(TaskGroup::Walk)].emplace_back(expiresAfterMs, std::move(f), this->context().taskName);
-	notify();
+	auto &thread = *getThreadTask();
+	constexpr auto group = static_cast<uint8_t>(TaskGroup::Walk);
+	pushToInbox(thread, thread.tasks[group], thread.spilledTasks[group], expiresAfterMs, std::move(f), this->context().taskName);
 }
 
 uint64_t Dispatcher::scheduleEvent(const std::shared_ptr<Task> &task) {
-	const auto &thread = getThreadTask();
-	std::scoped_lock lock(thread->mutex);
+	auto &thread = *getThreadTask();
 
-	auto eventId = scheduledTasksRef
-					   .emplace(task->getId(), thread->scheduledTasks.emplace_back(task))
-					   .first->first;
-
-	notify();
+	const auto eventId = scheduledTasksRef.emplace(task->getId(), task).first->first;
+	pushToInbox(thread, thread.scheduledTasks, thread.spilledScheduledTasks, task);
 	return eventId;
 }
 
 void Dispatcher::asyncEvent(std::function<void(void)> &&f, TaskGroup group) {
-	const auto &thread = getThreadTask();
-	std::scoped_lock lock(thread->mutex);
-	thread->tasks[static_cast<uint8_t>(group)].emplace_back(0, std::move(f), dispacherContext.taskName);
-	notify();
+	auto &thread = *getThreadTask();
+	const auto groupId = static_cast<uint8_t>(group);
+	pushToInbox(thread, thread.tasks[groupId], thread.spilledTasks[groupId], 0u, std::move(f), dispacherContext.taskName);
 }
 
 void Dispatcher::stopEvent(uint64_t eventId) {
 	auto it = scheduledTasksRef.find(eventId);
-	if (it != scheduledTasksRef.end()) {
-		it->second->cancel();
-		scheduledTasksRef.erase(it);
+	if (it == scheduledTasksRef.end()) {
+		return;
 	}
+
+	const auto task = it->second;
+	task->cancel();
+	scheduledTasksRef.erase(it);
+
+	// Only the dispatcher thread owns the timing wheel, other threads defer the unlink to the next merge.
+	if (isDispatcherThread()) {
+		scheduledTasks.erase(task.get());
+		return;
+	}
+
+	auto &thread = *getThreadTask();
+	pushToInbox(thread, thread.canceledTasks, thread.spilledCanceledTasks, task);
 }
 
 void Dispatcher::safeCall(std::function<void(void)> &&f) {
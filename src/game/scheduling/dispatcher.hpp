@@ -10,19 +10,15 @@
 #pragma once
 
 #include "task.hpp"
+#include "dispatcher_profiler.hpp"
+#include "timing_wheel.hpp"
 #include "lib/thread/thread_pool.hpp"
+#include "lib/thread/work_stealing_executor.hpp"
+#include "utils/lockfree.hpp"
 
 static constexpr uint16_t DISPATCHER_TASK_EXPIRATION = 2000;
 static constexpr uint16_t SCHEDULER_MINTICKS = 50;
-
-enum class TaskGroup : int8_t {
-	ThreadPool = -1,
-	Walk,
-	WalkParallel,
-	Serial,
-	GenericParallel,
-	Last
-};
+static constexpr uint32_t DISPATCHER_PROFILER_METRICS_INTERVAL = 10000;
 
 enum class DispatcherType : uint8_t {
 	None,
@@ -77,7 +73,7 @@ private:
 class Dispatcher {
 public:
 	explicit Dispatcher(ThreadPool &threadPool) :
-		threadPool(threadPool) {
+		threadPool(threadPool), parallelExecutor(threadPool), profiler(threadPool.get_thread_count() + 1) {
 		threads.reserve(threadPool.get_thread_count() + 1);
 		for (uint_fast16_t i = 0; i < threads.capacity(); ++i) {
 			threads.emplace_back(std::make_unique<ThreadTask>());
@@ -137,6 +133,46 @@ public:
 		return dispatcherCycle;
 	}
 
+	/**
+	 * @brief Returns when the running tick started, in steady clock nanoseconds, or 0 while the dispatcher waits.
+	 * Safe to read from any thread, it is what the watchdog follows.
+	 */
+	[[nodiscard]] int64_t getTickStartedAt() const {
+		return tickStartedAt.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * @brief Returns the dispatcher cycle at the start of the running tick, safe to read from any thread.
+	 */
+	[[nodiscard]] uint64_t getTickCycle() const {
+		return tickCycle.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Returns the work-stealing stats of the parallel loops run during the last dispatcher tick.
+	 */
+	[[nodiscard]] const WorkStealingStats &getAsyncWaitStats() const {
+		return asyncWaitStats;
+	}
+
+	/**
+	 * @brief Returns how many events overflowed a full thread inbox since startup.
+	 */
+	[[nodiscard]] uint64_t getSpilledEvents() const {
+		uint64_t spilled = 0;
+		for (const auto &thread : threads) {
+			spilled += thread->spilled.load(std::memory_order_relaxed);
+		}
+		return spilled;
+	}
+
+	/**
+	 * @brief Returns the per-context accounting of executed tasks, only to be used from the dispatcher thread.
+	 */
+	[[nodiscard]] DispatcherProfiler &getProfiler() {
+		return profiler;
+	}
+
 	void stopEvent(uint64_t eventId);
 
 	const auto &context() const {
@@ -154,6 +190,10 @@ private:
 		return scheduleEvent(std::make_shared<Task>(std::move(f), context, delay, cycle, log));
 	}
 
+	bool isDispatcherThread() const {
+		return ThreadPool::getThreadId() == dispatcherThreadId.load(std::memory_order_relaxed);
+	}
+
 	void init();
 	void shutdown() {
 		signalSchedule.notify_all();
@@ -166,6 +206,7 @@ private:
 	inline void executeEvents(const TaskGroup startGroup = TaskGroup::Walk);
 	inline void executeScheduledEvents();
 
+	inline bool executeTask(const Task &task, TaskGroup group);
 	inline void executeSerialEvents(const uint8_t groupId);
 	inline void executeParallelEvents(const uint8_t groupId);
 	inline std::chrono::milliseconds timeUntilNextScheduledTask() const;
@@ -187,52 +228,64 @@ private:
 		}
 	}
 
-	std::vector<std::pair<uint64_t, uint64_t>> generatePartition(size_t size) const {
-		if (size == 0) {
-			return {};
-		}
-
-		std::vector<std::pair<uint64_t, uint64_t>> list;
-		list.reserve(threadPool.get_thread_count());
-
-		const auto size_per_block = std::ceil(size / static_cast<float>(threadPool.get_thread_count()));
-		for (uint_fast64_t i = 0; i < size; i += size_per_block) {
-			list.emplace_back(i, std::min<uint64_t>(size, i + size_per_block));
-		}
-
-		return list;
-	}
+	inline void collectTickStats();
 
 	uint_fast64_t dispatcherCycle = 0;
+	std::atomic_int16_t dispatcherThreadId = -1;
+
+	// Heartbeat read by the watchdog
+	std::atomic_int64_t tickStartedAt = 0;
+	std::atomic_uint64_t tickCycle = 0;
 
 	ThreadPool &threadPool;
+	WorkStealingExecutor parallelExecutor;
+	WorkStealingStats asyncWaitStats;
+	uint64_t lastSpilledEvents = 0;
+	DispatcherProfiler profiler;
+	std::chrono::steady_clock::time_point lastProfilerReport = std::chrono::steady_clock::now();
 	std::condition_variable signalSchedule;
 	std::atomic_bool hasPendingTasks = false;
 	std::mutex dummyMutex; // This is only used for signaling the condition variable and not as an actual lock.
 
+	static constexpr size_t INBOX_CAPACITY = 512;
+
 	// Thread Events
+	// Each thread only ever pushes to its own inbox, which the dispatcher drains without locking.
 	struct ThreadTask {
-		ThreadTask() {
-			for (auto &task : tasks) {
-				task.reserve(2000);
-			}
-			scheduledTasks.reserve(2000);
+		std::array<MpscRing<Task, INBOX_CAPACITY>, static_cast<uint8_t>(TaskGroup::Last)> tasks;
+		MpscRing<std::shared_ptr<Task>, INBOX_CAPACITY> scheduledTasks;
+		MpscRing<std::shared_ptr<Task>, INBOX_CAPACITY> canceledTasks;
+
+		// Only used once a ring is full, until the dispatcher catches up
+		std::array<std::vector<Task>, static_cast<uint8_t>(TaskGroup::Last)> spilledTasks;
+		std::vector<std::shared_ptr<Task>> spilledScheduledTasks;
+		std::vector<std::shared_ptr<Task>> spilledCanceledTasks;
+		std::atomic_bool hasSpilled = false;
+		std::atomic_uint64_t spilled = 0;
+		std::mutex spillMutex;
+	};
+
+	template <typename T, typename... Args>
+	void pushToInbox(ThreadTask &thread, MpscRing<T, INBOX_CAPACITY> &ring, std::vector<T> &spill, Args &&... args) {
+		// Keeps spilling while there is something spilled, so events from a thread are never reordered
+		if (thread.hasSpilled.load(std::memory_order_acquire) || !ring.try_emplace(std::forward<Args>(args)...)) {
+			std::scoped_lock lock(thread.spillMutex);
+			spill.emplace_back(std::forward<Args>(args)...);
+			thread.hasSpilled.store(true, std::memory_order_release);
+			thread.spilled.fetch_add(1, std::memory_order_relaxed);
 		}
+		notify();
+	}
 
-		std::array<std::vector<Task>, static_cast<uint8_t>(TaskGroup::Last)> tasks;
-		std::vector<std::shared_ptr<Task>> scheduledTasks;
-		std::mutex mutex;
-	};
+	void mergeSpilledEvents(ThreadTask &thread, const std::array<uint8_t, 2> &groups, const bool mergeScheduledEvents);
 
 	std::vector<std::unique_ptr<ThreadTask>> threads;
 
 	// Main Events
 	std::array<std::vector<Task>, static_cast<uint8_t>(TaskGroup::Last)> m_tasks;
-	phmap::btree_multiset<std::shared_ptr<Task>, Task::Compare> scheduledTasks {};
+	TimingWheel scheduledTasks;
 	phmap::parallel_flat_hash_map_m<uint64_t, std::shared_ptr<Task>> scheduledTasksRef {};
 
-	bool asyncWaitDisabled = false;
-
 	friend class CanaryServer;
 };
 
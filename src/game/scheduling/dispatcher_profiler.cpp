@@ -0,0 +1,231 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "game/scheduling/dispatcher_profiler.hpp"
+
+#include "lib/metrics/metrics.hpp"
+
+namespace {
+	constexpr auto GROUPS = static_cast<uint8_t>(TaskGroup::Last);
+
+	double toMs(uint64_t ns) {
+		return static_cast<double>(ns) / 1'000'000;
+	}
+
+	double toUs(uint64_t ns) {
+		return static_cast<double>(ns) / 1'000;
+	}
+
+	void formatRow(std::back_insert_iterator<std::string> out, std::string_view name, std::string_view group, const DurationStats &execution, const DurationStats &queue) {
+		fmt::format_to(
+			out, "{:<48} {:<16} {:>10} {:>12.2f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f}\n",
+			name, group, execution.count, toMs(execution.total), toUs(execution.average()), toUs(execution.percentile(0.99)), toUs(execution.max),
+			toUs(queue.percentile(0.99)), toUs(queue.max)
+		);
+	}
+}
+
+void DurationStats::merge(const DurationStats &other) {
+	count += other.count;
+	total += other.total;
+	max = std::max(max, other.max);
+	for (size_t i = 0; i < buckets.size(); ++i) {
+		buckets[i] += other.buckets[i];
+	}
+}
+
+uint64_t DurationStats::percentile(double q) const {
+	if (count == 0) {
+		return 0;
+	}
+
+	const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(count))));
+	uint64_t seen = 0;
+	for (uint32_t i = 0; i < buckets.size(); ++i) {
+		seen += buckets[i];
+		if (seen >= target) {
+			const auto middle = (metrics::LatencyBuckets::lowerBound(i) + metrics::LatencyBuckets::upperBound(i)) / 2;
+			return std::min(middle, max);
+		}
+	}
+	return max;
+}
+
+DispatcherProfiler::DispatcherProfiler(size_t threadCount) {
+	threads.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; ++i) {
+		threads.emplace_back(std::make_unique<ThreadProfile>());
+	}
+}
+
+void DispatcherProfiler::record(size_t threadId, std::string_view context, TaskGroup group, std::chrono::nanoseconds queueDelay, std::chrono::nanoseconds execution) {
+	auto &thread = *threads[threadId];
+	const auto groupId = static_cast<uint8_t>(group);
+	auto &contexts = thread.contexts[groupId];
+
+	auto it = contexts.find(context);
+	if (it == contexts.end()) {
+		it = contexts.try_emplace(std::string(context)).first;
+	}
+
+	const auto executionNs = static_cast<uint64_t>(std::max<int64_t>(0, execution.count()));
+	it->second.execution.add(executionNs);
+	it->second.queue.add(static_cast<uint64_t>(std::max<int64_t>(0, queueDelay.count())));
+
+	thread.tickGroups[groupId] += executionNs;
+	++thread.tickTasks;
+	if (executionNs > thread.slowestDuration) {
+		thread.slowestDuration = executionNs;
+		thread.slowestContext = context;
+	}
+}
+
+void DispatcherProfiler::endTick(uint64_t cycle, std::chrono::nanoseconds duration) {
+	TickProfile tick;
+	for (const auto &thread : threads) {
+		if (thread->tickTasks == 0) {
+			continue;
+		}
+
+		tick.tasks += thread->tickTasks;
+		for (uint8_t group = 0; group < GROUPS; ++group) {
+			tick.groups[group] += thread->tickGroups[group];
+		}
+		if (thread->slowestDuration > tick.slowestDuration) {
+			tick.slowestDuration = thread->slowestDuration;
+			tick.slowestContext = thread->slowestContext;
+		}
+
+		thread->tickGroups.fill(0);
+		thread->tickTasks = 0;
+		thread->slowestDuration = 0;
+	}
+
+	if (tick.tasks == 0) {
+		return;
+	}
+
+	tick.cycle = cycle;
+	tick.duration = static_cast<uint64_t>(std::max<int64_t>(0, duration.count()));
+	ticks.add(tick.duration);
+	if (tick.duration > worstTick.duration) {
+		worstTick = std::move(tick);
+	}
+}
+
+std::vector<ContextProfile> DispatcherProfiler::collect() const {
+	std::vector<ContextProfile> profiles;
+	std::array<phmap::flat_hash_map<std::string_view, size_t>, GROUPS> indexes;
+	for (const auto &thread : threads) {
+		for (uint8_t group = 0; group < GROUPS; ++group) {
+			for (const auto &[context, stats] : thread->contexts[group]) {
+				const auto [it, inserted] = indexes[group].try_emplace(context, profiles.size());
+				if (inserted) {
+					profiles.emplace_back(context, static_cast<TaskGroup>(group));
+				}
+				auto &profile = profiles[it->second];
+				profile.execution.merge(stats.execution);
+				profile.queue.merge(stats.queue);
+			}
+		}
+	}
+
+	std::ranges::sort(profiles, std::greater {}, [](const ContextProfile &profile) { return profile.execution.total; });
+	return profiles;
+}
+
+std::string DispatcherProfiler::report(size_t limit) const {
+	const auto profiles = collect();
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+
+	std::string output;
+	auto out = std::back_inserter(output);
+	fmt::format_to(out, "Dispatcher profile over the last {:.1f} s\n", elapsed);
+	fmt::format_to(
+		out, "Ticks: {} with tasks, avg {:.2f} ms, p99 {:.2f} ms, max {:.2f} ms\n",
+		ticks.count, toMs(ticks.average()), toMs(ticks.percentile(0.99)), toMs(ticks.max)
+	);
+	if (worstTick.tasks > 0) {
+		fmt::format_to(
+			out, "Worst tick: cycle {}, {:.2f} ms, {} tasks, slowest {} ({:.2f} ms)",
+			worstTick.cycle, toMs(worstTick.duration), worstTick.tasks, worstTick.slowestContext, toMs(worstTick.slowestDuration)
+		);
+		for (uint8_t group = 0; group < GROUPS; ++group) {
+			if (worstTick.groups[group] > 0) {
+				fmt::format_to(out, ", {} {:.2f} ms", magic_enum::enum_name(static_cast<TaskGroup>(group)), toMs(worstTick.groups[group]));
+			}
+		}
+		fmt::format_to(out, "\n");
+	}
+
+	constexpr auto header = "{:<48} {:<16} {:>10} {:>12} {:>10} {:>10} {:>10} {:>10} {:>10}\n";
+	fmt::format_to(out, "\n");
+	fmt::format_to(out, header, "group", "", "count", "total ms", "avg us", "p99 us", "max us", "queue p99", "queue max");
+	std::array<std::pair<DurationStats, DurationStats>, GROUPS> groups;
+	for (const auto &profile : profiles) {
+		auto &[execution, queue] = groups[static_cast<uint8_t>(profile.group)];
+		execution.merge(profile.execution);
+		queue.merge(profile.queue);
+	}
+	for (uint8_t group = 0; group < GROUPS; ++group) {
+		if (groups[group].first.count > 0) {
+			formatRow(out, magic_enum::enum_name(static_cast<TaskGroup>(group)), "", groups[group].first, groups[group].second);
+		}
+	}
+
+	fmt::format_to(out, "\n");
+	fmt::format_to(out, header, "context", "group", "count", "total ms", "avg us", "p99 us", "max us", "queue p99", "queue max");
+	for (const auto &profile : profiles | std::views::take(limit)) {
+		formatRow(out, profile.context, magic_enum::enum_name(profile.group), profile.execution, profile.queue);
+	}
+	return output;
+}
+
+void DispatcherProfiler::reportMetrics() {
+	for (const auto &thread : threads) {
+		for (uint8_t group = 0; group < GROUPS; ++group) {
+			for (auto &[context, stats] : thread->contexts[group]) {
+				if (stats.execution.count == stats.reportedCount) {
+					continue;
+				}
+
+				const std::map<std::string, std::string> attrs {
+					{ "context", context },
+					{ "group", std::string(magic_enum::enum_name(static_cast<TaskGroup>(group))) },
+				};
+				g_metrics().addCounter("dispatcher_task_executions", static_cast<double>(stats.execution.count - stats.reportedCount), attrs);
+				g_metrics().addCounter("dispatcher_task_execution_us", toUs(stats.execution.total - stats.reportedExecution), attrs);
+				g_metrics().addCounter("dispatcher_task_queue_us", toUs(stats.queue.total - stats.reportedQueue), attrs);
+				stats.reportedCount = stats.execution.count;
+				stats.reportedExecution = stats.execution.total;
+				stats.reportedQueue = stats.queue.total;
+			}
+		}
+	}
+
+	if (ticks.count != reportedTicks) {
+		g_metrics().addCounter("dispatcher_ticks", static_cast<double>(ticks.count - reportedTicks));
+		g_metrics().addCounter("dispatcher_tick_us", toUs(ticks.total - reportedTickTime));
+		reportedTicks = ticks.count;
+		reportedTickTime = ticks.total;
+	}
+}
+
+void DispatcherProfiler::reset() {
+	for (auto &thread : threads) {
+		for (auto &contexts : thread->contexts) {
+			contexts.clear();
+		}
+	}
+	ticks = {};
+	worstTick = {};
+	reportedTicks = 0;
+	reportedTickTime = 0;
+	since = std::chrono::steady_clock::now();
+}
@@ -0,0 +1,138 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/scheduling/task.hpp"
+#include "lib/metrics/latency_recorder.hpp"
+#include "utils/transparent_string_hash.hpp"
+
+/**
+ * @brief Count, total, max and a log-linear histogram of durations in nanoseconds.
+ */
+struct DurationStats {
+	uint64_t count = 0;
+	uint64_t total = 0;
+	uint64_t max = 0;
+	std::array<uint32_t, metrics::LatencyBuckets::COUNT> buckets {};
+
+	void add(uint64_t ns) {
+		++count;
+		total += ns;
+		max = std::max(max, ns);
+		++buckets[metrics::LatencyBuckets::indexOf(ns)];
+	}
+
+	void merge(const DurationStats &other);
+
+	[[nodiscard]] uint64_t average() const {
+		return count > 0 ? total / count : 0;
+	}
+
+	[[nodiscard]] uint64_t percentile(double q) const;
+};
+
+struct ContextProfile {
+	std::string context;
+	TaskGroup group = TaskGroup::Serial;
+	DurationStats execution;
+	DurationStats queue;
+};
+
+struct TickProfile {
+	uint64_t cycle = 0;
+	uint64_t duration = 0;
+	uint64_t tasks = 0;
+	std::array<uint64_t, static_cast<uint8_t>(TaskGroup::Last)> groups {};
+	std::string slowestContext;
+	uint64_t slowestDuration = 0;
+};
+
+/**
+ * @brief Always-on accounting of what runs in the dispatcher, per task context, group and tick.
+ *
+ * Tasks only run inside the dispatcher tick, either on the dispatcher thread or on the
+ * pool threads joined by asyncWait, so every thread fills its own tables without any
+ * locking and the dispatcher thread reads them between ticks. Reports and resets must
+ * therefore come from the dispatcher thread, e.g. from an event or a Lua script.
+ */
+class DispatcherProfiler {
+public:
+	static constexpr size_t DEFAULT_REPORT_LIMIT = 20;
+
+	explicit DispatcherProfiler(size_t threads);
+
+	// Ensures that we don't accidentally copy it
+	DispatcherProfiler(const DispatcherProfiler &) = delete;
+	DispatcherProfiler &operator=(const DispatcherProfiler &) = delete;
+
+	/**
+	 * @brief Accounts a task executed by the calling thread.
+	 */
+	void record(size_t threadId, std::string_view context, TaskGroup group, std::chrono::nanoseconds queueDelay, std::chrono::nanoseconds execution);
+
+	/**
+	 * @brief Closes the current tick, ticks in which no task ran are not accounted.
+	 */
+	void endTick(uint64_t cycle, std::chrono::nanoseconds duration);
+
+	/**
+	 * @brief Returns every context profile merged across threads, sorted by total execution time.
+	 */
+	[[nodiscard]] std::vector<ContextProfile> collect() const;
+
+	/**
+	 * @brief Renders the top contexts, the groups and the tick stats as a text table.
+	 */
+	[[nodiscard]] std::string report(size_t limit = DEFAULT_REPORT_LIMIT) const;
+
+	/**
+	 * @brief Publishes what changed since the previous call to the metrics subsystem.
+	 */
+	void reportMetrics();
+
+	void reset();
+
+	[[nodiscard]] const DurationStats &getTickStats() const {
+		return ticks;
+	}
+
+	[[nodiscard]] const TickProfile &getWorstTick() const {
+		return worstTick;
+	}
+
+private:
+	struct ContextStats {
+		DurationStats execution;
+		DurationStats queue;
+		uint64_t reportedCount = 0;
+		uint64_t reportedExecution = 0;
+		uint64_t reportedQueue = 0;
+	};
+
+	using ContextMap = phmap::flat_hash_map<std::string, ContextStats, TransparentStringHasher, std::equal_to<>>;
+
+	struct ThreadProfile {
+		std::array<ContextMap, static_cast<uint8_t>(TaskGroup::Last)> contexts;
+
+		// Current tick only
+		std::array<uint64_t, static_cast<uint8_t>(TaskGroup::Last)> tickGroups {};
+		uint64_t tickTasks = 0;
+		std::string slowestContext;
+		uint64_t slowestDuration = 0;
+	};
+
+	std::vector<std::unique_ptr<ThreadProfile>> threads;
+
+	DurationStats ticks;
+	TickProfile worstTick;
+	uint64_t reportedTicks = 0;
+	uint64_t reportedTickTime = 0;
+	std::chrono::steady_clock::time_point since = std::chrono::steady_clock::now();
+};
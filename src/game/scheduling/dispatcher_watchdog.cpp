@@ -0,0 +1,272 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "game/scheduling/dispatcher_watchdog.hpp"
+
+#include "game/scheduling/dispatcher.hpp"
+#include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
+#include "lua/scripts/lua_environment.hpp"
+
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/rotating_file_sink.h>
+
+#ifndef _WIN32
+	#include <csignal>
+	#include <cxxabi.h>
+	#include <execinfo.h>
+	#include <pthread.h>
+#endif
+
+namespace {
+#ifndef _WIN32
+	// Filled by the dispatcher thread from inside the signal handler, so only plain copies here
+	struct NativeSample {
+		std::array<void*, DispatcherWatchdog::MAX_NATIVE_FRAMES> frames {};
+		int frameCount = 0;
+		std::array<char, 128> context {};
+		std::atomic_bool ready = false;
+	};
+
+	NativeSample nativeSample;
+	std::atomic<const Dispatcher*> sampledDispatcher = nullptr;
+	pthread_t dispatcherThread;
+
+	int sampleSignal() {
+	#ifdef SIGRTMIN
+		return SIGRTMIN;
+	#else
+		return SIGPROF;
+	#endif
+	}
+
+	std::string demangle(const char* symbol) {
+		// glibc renders frames as "binary(mangled+offset) [address]"
+		std::string_view frame(symbol);
+		const auto open = frame.find('(');
+		const auto plus = frame.find('+', open);
+		if (open == std::string_view::npos || plus == std::string_view::npos || plus == open + 1) {
+			return std::string(frame);
+		}
+
+		const std::string mangled(frame.substr(open + 1, plus - open - 1));
+		int status = 0;
+		std::unique_ptr<char, decltype(&std::free)> demangled(abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status), &std::free);
+		if (status != 0 || !demangled) {
+			return std::string(frame);
+		}
+		return fmt::format("{}{}{}", frame.substr(0, open + 1), demangled.get(), frame.substr(plus));
+	}
+#endif
+
+	template <typename Predicate>
+	bool waitFor(Predicate &&predicate) {
+		const auto deadline = std::chrono::steady_clock::now() + DispatcherWatchdog::SAMPLE_TIMEOUT;
+		while (!predicate()) {
+			if (std::chrono::steady_clock::now() >= deadline) {
+				return false;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+}
+
+DispatcherWatchdog &DispatcherWatchdog::getInstance() {
+	return inject<DispatcherWatchdog>();
+}
+
+DispatcherWatchdog::~DispatcherWatchdog() {
+	stop();
+}
+
+void DispatcherWatchdog::start(Dispatcher &watchedDispatcher, std::chrono::milliseconds budget) {
+	if (budget.count() <= 0 || thread.joinable()) {
+		return;
+	}
+
+	dispatcher = &watchedDispatcher;
+	try {
+		auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(LOG_FILE, LOG_MAX_SIZE, LOG_MAX_FILES);
+		log = std::make_shared<spdlog::logger>("slow_ticks", std::move(sink));
+		log->set_pattern("[%Y-%m-%d %H:%M:%S.%e] %v");
+		log->flush_on(spdlog::level::warn);
+	} catch (const spdlog::spdlog_ex &ex) {
+		g_logger().error("[{}] - Slow tick log initialization failed: {}", __FUNCTION__, ex.what());
+	}
+
+#ifndef _WIN32
+	dispatcherThread = pthread_self();
+	sampledDispatcher = dispatcher;
+
+	// The first backtrace may allocate while loading the unwinder, which must not happen inside the handler
+	std::array<void*, 1> warmup {};
+	backtrace(warmup.data(), static_cast<int>(warmup.size()));
+
+	struct sigaction action {};
+	action.sa_handler = onSampleSignal;
+	sigemptyset(&action.sa_mask);
+	action.sa_flags = SA_RESTART;
+	sigaction(sampleSignal(), &action, nullptr);
+#endif
+
+	watch(budget);
+	g_logger().info("Dispatcher watchdog started, tick budget of {} ms", budget.count());
+}
+
+void DispatcherWatchdog::watch(std::chrono::milliseconds budget) {
+	thread = std::jthread([this, budget, startedTick = getTickStartedAt()](const std::stop_token &stopToken) {
+		run(stopToken, budget, startedTick);
+	});
+}
+
+void DispatcherWatchdog::stop() {
+	if (thread.joinable()) {
+		thread.request_stop();
+		thread.join();
+	}
+}
+
+int64_t DispatcherWatchdog::getTickStartedAt() const {
+	return dispatcher ? dispatcher->getTickStartedAt() : 0;
+}
+
+uint64_t DispatcherWatchdog::getTickCycle() const {
+	return dispatcher ? dispatcher->getTickCycle() : 0;
+}
+
+void DispatcherWatchdog::run(const std::stop_token &stopToken, std::chrono::milliseconds budget, int64_t startedTick) {
+	const auto interval = std::max(std::chrono::milliseconds(10), budget / 4);
+	std::mutex mutex;
+	std::condition_variable_any condition;
+	// The tick that started the watchdog ran before it was watched, it is treated as reported
+	int64_t reportedTick = startedTick;
+
+	while (!stopToken.stop_requested()) {
+		{
+			std::unique_lock lock(mutex);
+			condition.wait_for(lock, stopToken, interval, [] { return false; });
+		}
+
+		// Healthy ticks end before the budget and cost nothing more than these loads
+		const auto startedAt = getTickStartedAt();
+		if (startedAt == 0 || startedAt == reportedTick) {
+			continue;
+		}
+
+		const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::nanoseconds(now - startedAt));
+		if (elapsed < budget) {
+			continue;
+		}
+
+		reportedTick = startedAt;
+		slowTicks.fetch_add(1, std::memory_order_relaxed);
+		auto tick = sample(getTickCycle(), elapsed);
+		if (getTickStartedAt() != startedAt) {
+			tick.context += " (the tick ended while sampling, stacks may belong to the next one)";
+		}
+		write(tick);
+		g_metrics().addCounter("dispatcher_slow_ticks", 1);
+	}
+}
+
+SlowTick DispatcherWatchdog::sample(uint64_t cycle, std::chrono::milliseconds elapsed) {
+	SlowTick tick;
+	tick.cycle = cycle;
+	tick.elapsed = elapsed;
+
+#ifndef _WIN32
+	nativeSample.ready.store(false, std::memory_order_release);
+	if (pthread_kill(dispatcherThread, sampleSignal()) == 0 && waitFor([] { return nativeSample.ready.load(std::memory_order_acquire); })) {
+		tick.context = nativeSample.context.data();
+
+		std::unique_ptr<char*, decltype(&std::free)> symbols(backtrace_symbols(nativeSample.frames.data(), nativeSample.frameCount), &std::free);
+		// The first frame is the signal handler itself
+		for (int i = 1; symbols && i < nativeSample.frameCount; ++i) {
+			fmt::format_to(std::back_inserter(tick.nativeStack), "  #{} {}\n", i - 1, demangle(symbols.get()[i]));
+		}
+	}
+#endif
+	if (tick.nativeStack.empty()) {
+		tick.nativeStack = "  (not available)\n";
+	}
+
+	// A count hook fires on the next instruction the Lua VM runs; lua_sethook is safe to call asynchronously
+	auto* L = g_luaEnvironment().getLuaState();
+	if (L) {
+		luaSampled.store(false, std::memory_order_release);
+		luaArmed.store(true, std::memory_order_release);
+		lua_sethook(L, onLuaHook, LUA_MASKCOUNT, 1);
+
+		const auto isSampled = [this] { return luaSampled.load(std::memory_order_acquire); };
+		const auto sampled = waitFor(isSampled);
+		if (!sampled && luaArmed.exchange(false)) {
+			// No script running, the tick is stuck in native code
+			lua_sethook(L, nullptr, 0, 0);
+		} else if (sampled || waitFor(isSampled)) {
+			std::scoped_lock lock(luaMutex);
+			tick.luaStack = luaStack;
+			if (tick.context.empty()) {
+				tick.context = luaContext;
+			}
+		}
+	}
+	if (tick.luaStack.empty()) {
+		tick.luaStack = "  (no script running)\n";
+	}
+	if (tick.context.empty()) {
+		tick.context = "(unknown)";
+	}
+	return tick;
+}
+
+void DispatcherWatchdog::write(const SlowTick &tick) const {
+	g_logger().warn("[{}] - Dispatcher tick at cycle {} has been running for {} ms, task: {}. Stacks written to {}", __FUNCTION__, tick.cycle, tick.elapsed.count(), tick.context, LOG_FILE);
+	if (log) {
+		log->warn("Tick at cycle {} running for {} ms\nTask: {}\nLua stack:\n{}Native stack:\n{}", tick.cycle, tick.elapsed.count(), tick.context, tick.luaStack, tick.nativeStack);
+	}
+}
+
+void DispatcherWatchdog::onSampleSignal([[maybe_unused]] int signal) {
+#ifndef _WIN32
+	const auto savedErrno = errno;
+	nativeSample.frameCount = backtrace(nativeSample.frames.data(), static_cast<int>(nativeSample.frames.size()));
+
+	nativeSample.context.fill(0);
+	if (const auto* watched = sampledDispatcher.load(std::memory_order_acquire)) {
+		const auto name = watched->context().getName();
+		std::memcpy(nativeSample.context.data(), name.data(), std::min(name.size(), nativeSample.context.size() - 1));
+	}
+
+	nativeSample.ready.store(true, std::memory_order_release);
+	errno = savedErrno;
+#endif
+}
+
+void DispatcherWatchdog::onLuaHook(lua_State* L, [[maybe_unused]] lua_Debug* ar) {
+	lua_sethook(L, nullptr, 0, 0);
+
+	auto &watchdog = getInstance();
+	if (!watchdog.luaArmed.exchange(false)) {
+		return;
+	}
+
+	std::string stack;
+	lua_Debug frame {};
+	for (int level = 0; level < MAX_LUA_FRAMES && lua_getstack(L, level, &frame) == 1; ++level) {
+		lua_getinfo(L, "Sln", &frame);
+		fmt::format_to(std::back_inserter(stack), "  #{} {}:{} in {}\n", level, frame.short_src, frame.currentline, frame.name ? frame.name : frame.what);
+	}
+
+	std::scoped_lock lock(watchdog.luaMutex);
+	watchdog.luaStack = std::move(stack);
+	watchdog.luaContext = watchdog.dispatcher ? std::string(watchdog.dispatcher->context().getName()) : std::string();
+	watchdog.luaSampled.store(true, std::memory_order_release);
+}
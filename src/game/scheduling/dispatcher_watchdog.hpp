@@ -0,0 +1,93 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class Dispatcher;
+struct lua_State;
+struct lua_Debug;
+
+namespace spdlog {
+	class logger;
+}
+
+struct SlowTick {
+	uint64_t cycle = 0;
+	std::chrono::milliseconds elapsed {};
+	std::string context;
+	std::string luaStack;
+	std::string nativeStack;
+};
+
+/**
+ * @brief Watches the dispatcher heartbeat from its own thread and reports ticks that run over budget.
+ *
+ * While ticks are healthy the dispatcher only publishes when each tick starts. Once a
+ * tick runs past the budget, the watchdog samples the dispatcher thread: a signal makes
+ * it record its native backtrace and task context, and a one-shot Lua hook records the
+ * Lua call stack if a script is running. Every slow tick is written, once, to a rotating log.
+ */
+class DispatcherWatchdog {
+public:
+	static constexpr auto LOG_FILE = "log/slow_ticks.txt";
+	static constexpr size_t LOG_MAX_SIZE = 10 * 1024 * 1024;
+	static constexpr size_t LOG_MAX_FILES = 5;
+	static constexpr size_t MAX_NATIVE_FRAMES = 64;
+	static constexpr int MAX_LUA_FRAMES = 32;
+	static constexpr auto SAMPLE_TIMEOUT = std::chrono::milliseconds(100);
+
+	DispatcherWatchdog() = default;
+	virtual ~DispatcherWatchdog();
+
+	// Ensures that we don't accidentally copy it
+	DispatcherWatchdog(const DispatcherWatchdog &) = delete;
+	DispatcherWatchdog &operator=(const DispatcherWatchdog &) = delete;
+
+	static DispatcherWatchdog &getInstance();
+
+	/**
+	 * @brief Starts watching, must be called from the dispatcher thread. A budget of 0 keeps it off.
+	 * Start it once the server is up, the tick that loads the server is far over any budget.
+	 */
+	void start(Dispatcher &dispatcher, std::chrono::milliseconds budget);
+	void stop();
+
+	[[nodiscard]] uint64_t getSlowTicks() const {
+		return slowTicks.load(std::memory_order_relaxed);
+	}
+
+protected:
+	// Starts the watch thread, the tick already running is never reported
+	void watch(std::chrono::milliseconds budget);
+
+	// When the running tick started in steady clock nanoseconds, 0 while the dispatcher is idle
+	virtual int64_t getTickStartedAt() const;
+	virtual uint64_t getTickCycle() const;
+	virtual SlowTick sample(uint64_t cycle, std::chrono::milliseconds elapsed);
+	virtual void write(const SlowTick &tick) const;
+
+private:
+	void run(const std::stop_token &stopToken, std::chrono::milliseconds budget, int64_t startedTick);
+
+	static void onSampleSignal(int signal);
+	static void onLuaHook(lua_State* L, lua_Debug* ar);
+
+	Dispatcher* dispatcher = nullptr;
+	std::shared_ptr<spdlog::logger> log;
+	std::jthread thread;
+	std::atomic_uint64_t slowTicks = 0;
+
+	std::atomic_bool luaArmed = false;
+	std::atomic_bool luaSampled = false;
+	std::mutex luaMutex;
+	std::string luaStack;
+	std::string luaContext;
+};
+
+constexpr auto g_dispatcherWatchdog = DispatcherWatchdog::getInstance;
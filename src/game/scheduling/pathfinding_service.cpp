@@ -0,0 +1,172 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "game/scheduling/pathfinding_service.hpp"
+
+#include "creatures/creature.hpp"
+#include "creatures/players/player.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
+#include "map/spectators.hpp"
+#include "utils/tools.hpp"
+
+PathfindingService &PathfindingService::getInstance() {
+	return inject<PathfindingService>();
+}
+
+void PathfindingService::request(const std::shared_ptr<Creature> &creature, const Position &targetPos, const FindPathParams &fpp, Callback &&callback) {
+	submit(PathCacheKey(creature->getID(), creature->getPosition(), targetPos, fpp), creature, fpp, std::move(callback));
+}
+
+bool PathfindingService::submit(const PathCacheKey &key, const std::weak_ptr<Creature> &creature, const FindPathParams &fpp, Callback &&callback) {
+	requests.fetch_add(1, std::memory_order_relaxed);
+
+	std::scoped_lock lock(mutex);
+	auto &request = pending[key];
+	if (request) {
+		request->callbacks.emplace_back(std::move(callback));
+		coalesced.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	request = std::make_shared<Request>();
+	request->key = key;
+	request->creature = creature;
+	request->fpp = fpp;
+	request->submittedAt = OTSYS_TIME();
+	request->sequence = nextSequence++;
+	request->callbacks.emplace_back(std::move(callback));
+	incoming.emplace_back(request);
+
+	if (!processScheduled) {
+		processScheduled = true;
+		scheduleProcess(0);
+	}
+	return true;
+}
+
+size_t PathfindingService::process(std::chrono::steady_clock::duration budget) {
+	const auto start = std::chrono::steady_clock::now();
+	collectIncoming(OTSYS_TIME());
+
+	size_t done = 0;
+	while (done < backlog.size()) {
+		const auto batch = std::span(backlog).subspan(done, std::min(BATCH_SIZE, backlog.size() - done));
+		parallelFor(batch.size(), [this, &batch](size_t i) {
+			solve(*batch[i]);
+		});
+		deliver(batch);
+		done += batch.size();
+
+		if (std::chrono::steady_clock::now() - start >= budget) {
+			break;
+		}
+	}
+
+	backlog.erase(backlog.begin(), backlog.begin() + static_cast<std::ptrdiff_t>(done));
+	solved.fetch_add(done, std::memory_order_relaxed);
+	deferred.fetch_add(backlog.size(), std::memory_order_relaxed);
+
+	if (done > 0) {
+		g_metrics().addCounter("pathfinding_solved", static_cast<double>(done));
+	}
+	if (!backlog.empty()) {
+		g_metrics().addCounter("pathfinding_deferred", static_cast<double>(backlog.size()));
+	}
+
+	std::scoped_lock lock(mutex);
+	const auto remaining = backlog.size() + incoming.size();
+	processScheduled = remaining > 0;
+	if (processScheduled) {
+		// Leftovers wait for the next tick, fresh requests only for the events already queued
+		scheduleProcess(backlog.empty() ? 0 : SCHEDULER_MINTICKS);
+	}
+	return remaining;
+}
+
+void PathfindingService::collectIncoming(int64_t now) {
+	std::vector<std::shared_ptr<Request>> fresh;
+	{
+		std::scoped_lock lock(mutex);
+		fresh.swap(incoming);
+	}
+
+	for (auto &request : fresh) {
+		request->urgent = isUrgent(*request);
+		backlog.emplace_back(std::move(request));
+	}
+
+	const auto rank = [now](const std::shared_ptr<Request> &request) {
+		const bool promoted = request->urgent || now - request->submittedAt >= MAX_DEFER_MS;
+		return std::make_pair(promoted ? 0 : 1, request->sequence);
+	};
+
+	std::ranges::sort(backlog, {}, rank);
+}
+
+void PathfindingService::deliver(std::span<const std::shared_ptr<Request>> batch) {
+	std::vector<Callback> callbacks;
+	for (const auto &request : batch) {
+		{
+			// Once erased, an identical submission starts a new search instead of joining this one
+			std::scoped_lock lock(mutex);
+			const auto it = pending.find(request->key);
+			if (it != pending.end() && it->second == request) {
+				pending.erase(it);
+			}
+			callbacks.swap(request->callbacks);
+		}
+
+		for (const auto &callback : callbacks) {
+			callback(request->found, request->dirList);
+		}
+		callbacks.clear();
+	}
+}
+
+size_t PathfindingService::getPendingCount() const {
+	std::scoped_lock lock(mutex);
+	return pending.size();
+}
+
+PathfindingStats PathfindingService::collectStats() {
+	return {
+		.requests = requests.exchange(0, std::memory_order_relaxed),
+		.coalesced = coalesced.exchange(0, std::memory_order_relaxed),
+		.solved = solved.exchange(0, std::memory_order_relaxed),
+		.deferred = deferred.exchange(0, std::memory_order_relaxed),
+	};
+}
+
+void PathfindingService::solve(Request &request) {
+	const auto creature = request.creature.lock();
+	if (!creature || creature->isRemoved() || creature->isDead()) {
+		request.found = false;
+		return;
+	}
+
+	request.found = creature->getPathTo(request.key.targetPos, request.dirList, request.fpp);
+}
+
+bool PathfindingService::isUrgent(const Request &request) {
+	return !Spectators().find<Player>(request.key.startPos, true).empty();
+}
+
+void PathfindingService::parallelFor(size_t size, const std::function<void(size_t i)> &f) {
+	g_dispatcher().asyncWait(size, [&f](size_t i) { f(i); });
+}
+
+void PathfindingService::scheduleProcess(uint32_t delay) {
+	if (delay == 0) {
+		g_dispatcher().addEvent([this] { process(); }, "PathfindingService::process");
+	} else {
+		g_dispatcher().scheduleEvent(delay, [this] { process(); }, "PathfindingService::process");
+	}
+}
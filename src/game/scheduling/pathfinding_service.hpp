@@ -0,0 +1,126 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "creatures/creatures_definitions.hpp"
+#include "map/utils/pathcache.hpp"
+
+class Creature;
+
+struct PathfindingStats {
+	uint64_t requests = 0;
+	uint64_t coalesced = 0;
+	uint64_t solved = 0;
+	uint64_t deferred = 0;
+};
+
+/**
+ * @brief Queue of path searches solved in batches on the dispatcher tick.
+ *
+ * Creatures submit a request from any thread and receive the resulting directions
+ * through a callback that always runs on the dispatcher thread.
+ * Identical requests that are still pending share a single search.
+ * Every tick the queue is ordered so creatures with players around go first,
+ * then it is solved in parallel batches until the tick budget is spent;
+ * whatever is left waits for the next tick. Requests deferred for too long are
+ * promoted, so idle creatures are delayed but never starved.
+ */
+class PathfindingService {
+public:
+	using Callback = std::function<void(bool found, const std::vector<Direction> &dirList)>;
+
+	static constexpr auto TICK_BUDGET = std::chrono::milliseconds(8);
+	static constexpr size_t BATCH_SIZE = 64;
+	static constexpr int64_t MAX_DEFER_MS = 1000;
+
+	struct Request {
+		PathCacheKey key;
+		std::weak_ptr<Creature> creature;
+		FindPathParams fpp;
+		int64_t submittedAt = 0;
+		uint64_t sequence = 0;
+		bool urgent = true;
+
+		bool found = false;
+		std::vector<Direction> dirList;
+
+		// Guarded by the service mutex, coalesced requests append to it
+		std::vector<Callback> callbacks;
+	};
+
+	PathfindingService() = default;
+	virtual ~PathfindingService() = default;
+
+	// Ensures that we don't accidentally copy it
+	PathfindingService(const PathfindingService &) = delete;
+	PathfindingService &operator=(const PathfindingService &) = delete;
+
+	static PathfindingService &getInstance();
+
+	/**
+	 * @brief Queues a search from the creature position towards targetPos.
+	 * Can be called from any thread.
+	 */
+	void request(const std::shared_ptr<Creature> &creature, const Position &targetPos, const FindPathParams &fpp, Callback &&callback);
+
+	/**
+	 * @brief Queues a search identified by key.
+	 * @return false when an identical search was already pending and the callback joined it.
+	 */
+	bool submit(const PathCacheKey &key, const std::weak_ptr<Creature> &creature, const FindPathParams &fpp, Callback &&callback);
+
+	/**
+	 * @brief Solves pending requests in priority order until the budget is spent.
+	 * At least one batch is always solved. Must run on the dispatcher thread.
+	 * @return how many requests are still pending.
+	 */
+	size_t process(std::chrono::steady_clock::duration budget = TICK_BUDGET);
+
+	[[nodiscard]] size_t getPendingCount() const;
+
+	/**
+	 * @brief Returns the stats accumulated since the last call and resets them.
+	 */
+	PathfindingStats collectStats();
+
+protected:
+	/**
+	 * @brief Runs the search of a request, called concurrently from the thread pool.
+	 */
+	virtual void solve(Request &request);
+
+	/**
+	 * @brief Whether any player can see the searching creature, called on the dispatcher thread.
+	 */
+	virtual bool isUrgent(const Request &request);
+
+	virtual void parallelFor(size_t size, const std::function<void(size_t i)> &f);
+	virtual void scheduleProcess(uint32_t delay);
+
+private:
+	void collectIncoming(int64_t now);
+	void deliver(std::span<const std::shared_ptr<Request>> batch);
+
+	mutable std::mutex mutex;
+	phmap::flat_hash_map<PathCacheKey, std::shared_ptr<Request>> pending;
+	std::vector<std::shared_ptr<Request>> incoming;
+	uint64_t nextSequence = 0;
+	bool processScheduled = false;
+
+	// Only touched by the dispatcher thread
+	std::vector<std::shared_ptr<Request>> backlog;
+
+	std::atomic_uint64_t requests = 0;
+	std::atomic_uint64_t coalesced = 0;
+	std::atomic_uint64_t solved = 0;
+	std::atomic_uint64_t deferred = 0;
+};
+
+constexpr auto g_pathfinding = PathfindingService::getInstance;
@@ -12,12 +12,33 @@
 #include "config/configmanager.hpp"
 #include "creatures/players/grouping/guild.hpp"
 #include "game/game.hpp"
+#include "io/functions/iologindata_save_player.hpp"
 #include "io/ioguild.hpp"
 #include "io/iologindata.hpp"
+#include "io/iomapserialize.hpp"
 #include "kv/kv.hpp"
 #include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
 #include "creatures/players/player.hpp"
 
+struct SaveManager::Snapshot {
+	std::chrono::steady_clock::time_point scheduledAt;
+	std::vector<std::shared_ptr<PlayerSaveSnapshot>> players;
+	std::vector<std::pair<uint32_t, uint64_t>> guilds;
+	std::shared_ptr<HouseSaveSnapshot> houses;
+
+	// Every player, then the guilds, the houses and the key-value store
+	size_t size() const {
+		return players.size() + 3;
+	}
+
+	std::atomic<size_t> next = 0;
+	std::atomic<size_t> written = 0;
+	Benchmark benchmark;
+	// From the snapshot until the last writer lets go of it
+	metrics::method_latency latency { "SaveManager::saveAll" };
+};
+
 SaveManager::SaveManager(ThreadPool &threadPool, KVStore &kvStore, Logger &logger, Game &game) :
 	threadPool(threadPool), kv(kvStore), logger(logger), game(game) { }
 
@@ -26,42 +47,126 @@ SaveManager &SaveManager::getInstance() {
 }
 
 void SaveManager::saveAll() {
-	Benchmark bm_saveAll;
 	logger.info("Saving server...");
-	const auto players = game.getPlayers();
+	writeAll(snapshotAll(), true);
+}
+
+void SaveManager::scheduleAll() {
+	// Disable save async if the config is set to false
+	if (!g_configManager().getBoolean(TOGGLE_SAVE_ASYNC)) {
+		saveAll();
+		return;
+	}
+
+	logger.info("Saving server...");
+	writeAll(snapshotAll(), false);
+}
+
+SaveManager::Progress SaveManager::getProgress() const {
+	return { m_progressTotal.load(), m_progressWritten.load() };
+}
+
+std::shared_ptr<SaveManager::Snapshot> SaveManager::snapshotAll() {
+	metrics::method_latency measure(__METRICS_METHOD_NAME__);
+	Benchmark bm_snapshot;
+
+	auto snapshot = std::make_shared<Snapshot>();
+	snapshot->scheduledAt = std::chrono::steady_clock::now();
+	m_scheduledAt = snapshot->scheduledAt;
 
+	const auto players = game.getPlayers();
+	snapshot->players.reserve(players.size());
 	for (const auto &[_, player] : players) {
+		Player::PlayerLock lock(player);
 		player->loginPosition = player->getPosition();
-		doSavePlayer(player);
+		if (auto playerSnapshot = IOLoginData::snapshotPlayer(player)) {
+			snapshot->players.emplace_back(std::move(playerSnapshot));
+		} else {
+			logger.error("Failed to save player {}.", player->getName());
+		}
 	}
 
-	auto guilds = game.getGuilds();
-	for (const auto &[_, guild] : guilds) {
-		saveGuild(guild);
+	for (const auto &[_, guild] : game.getGuilds()) {
+		if (guild) {
+			snapshot->guilds.emplace_back(guild->getId(), guild->getBankBalance());
+		}
 	}
 
-	saveMap();
-	saveKV();
-	logger.info("Server saved in {} milliseconds.", bm_saveAll.duration());
+	snapshot->houses = IOMapSerialize::snapshotHouses();
+	logger.debug("Server snapshot taken in {} milliseconds.", bm_snapshot.duration());
+	return snapshot;
 }
 
-void SaveManager::scheduleAll() {
-	auto scheduledAt = std::chrono::steady_clock::now();
-	m_scheduledAt = scheduledAt;
+void SaveManager::writeAll(const std::shared_ptr<Snapshot> &snapshot, bool wait) {
+	const auto size = snapshot->size();
+	m_progressTotal = size;
+	m_progressWritten = 0;
+	g_metrics().addUpDownCounter("save_pending", static_cast<int>(size));
 
-	// Disable save async if the config is set to false
-	if (!g_configManager().getBoolean(TOGGLE_SAVE_ASYNC)) {
-		saveAll();
+	// Workers claim one entity at a time until none are left, a slow player doesn't hold up a whole batch
+	const auto drain = [this, snapshot, size] {
+		for (auto index = snapshot->next++; index < size; index = snapshot->next++) {
+			if (m_scheduledAt.load() != snapshot->scheduledAt) {
+				if (index == 0) {
+					logger.warn("Skipping save for server because another save has been scheduled.");
+				}
+			} else {
+				writeEntity(*snapshot, index);
+			}
+
+			++m_progressWritten;
+			g_metrics().addUpDownCounter("save_pending", -1);
+			if (++snapshot->written == size) {
+				logger.info("Server saved in {} milliseconds.", snapshot->benchmark.duration());
+				snapshot->written.notify_all();
+			}
+		}
+	};
+
+	const auto workers = std::min<size_t>(threadPool.get_thread_count(), size);
+	for (size_t i = wait ? 1 : 0; i < workers; ++i) {
+		threadPool.detach_task(drain);
+	}
+
+	if (!wait) {
 		return;
 	}
 
-	threadPool.detach_task([this, scheduledAt]() {
-		if (m_scheduledAt.load() != scheduledAt) {
-			logger.warn("Skipping save for server because another save has been scheduled.");
-			return;
+	// Help out rather than block, the pool may be busy or shutting down
+	drain();
+	for (auto written = snapshot->written.load(); written < size; written = snapshot->written.load()) {
+		snapshot->written.wait(written);
+	}
+}
+
+void SaveManager::writeEntity(const Snapshot &snapshot, size_t index) {
+	const auto players = snapshot.players.size();
+	if (index < players) {
+		const auto &playerSnapshot = *snapshot.players[index];
+		if (!IOLoginData::saveSnapshot(playerSnapshot)) {
+			logger.error("Failed to save player {}.", playerSnapshot.name);
 		}
-		saveAll();
-	});
+		return;
+	}
+
+	if (index == players) {
+		for (const auto &[guildId, balance] : snapshot.guilds) {
+			IOGuild::saveGuildBalance(guildId, balance);
+		}
+		return;
+	}
+
+	if (index == players + 1) {
+		Benchmark bm_saveMap;
+		logger.debug("Saving map...");
+		if (!Map::save(*snapshot.houses)) {
+			logger.error("Failed to save map.");
+		}
+		logger.debug("Map saved in {} milliseconds.", bm_saveMap.duration());
+		return;
+	}
+
+	saveKV();
 }
 
 void SaveManager::schedulePlayer(std::weak_ptr<Player> playerPtr) {
@@ -81,19 +186,34 @@ void SaveManager::schedulePlayer(std::weak_ptr<Player> playerPtr) {
 	}
 
 	logger.debug("Scheduling player {} for saving.", playerToSave->getName());
+	std::shared_ptr<PlayerSaveSnapshot> snapshot;
+	{
+		Player::PlayerLock lock(playerToSave);
+		snapshot = IOLoginData::snapshotPlayer(playerToSave);
+	}
+	if (!snapshot) {
+		logger.error("Failed to save player {}.", playerToSave->getName());
+		return;
+	}
+
 	auto scheduledAt = std::chrono::steady_clock::now();
-	m_playerMap[playerToSave->getGUID()] = scheduledAt;
-	threadPool.detach_task([this, playerPtr, scheduledAt]() {
-		auto player = playerPtr.lock();
-		if (!player) {
-			logger.debug("Skipping save for player because player is no longer online.");
-			return;
-		}
-		if (m_playerMap[player->getGUID()] != scheduledAt) {
+	m_playerMap[snapshot->guid] = scheduledAt;
+	threadPool.detach_task([this, snapshot, scheduledAt]() {
+		bool latest = false;
+		m_playerMap.erase_if(snapshot->guid, [&latest, scheduledAt](const auto &entry) {
+			latest = entry.second == scheduledAt;
+			return latest;
+		});
+		if (!latest) {
 			logger.warn("Skipping save for player because another save has been scheduled.");
 			return;
 		}
-		doSavePlayer(player);
+
+		Benchmark bm_savePlayer;
+		if (!IOLoginData::saveSnapshot(*snapshot)) {
+			logger.error("Failed to save player {}.", snapshot->name);
+		}
+		logger.debug("Saving player {} took {} milliseconds.", snapshot->name, bm_savePlayer.duration());
 	});
 }
 
@@ -104,13 +224,17 @@ bool SaveManager::doSavePlayer(std::shared_ptr<Player> player) {
 	}
 
 	Benchmark bm_savePlayer;
-	Player::PlayerLock lock(player);
-	m_playerMap.erase(player->getGUID());
-	if (g_game().getGameState() == GAME_STATE_NORMAL) {
-		logger.debug("Saving player {}.", player->getName());
+	std::shared_ptr<PlayerSaveSnapshot> snapshot;
+	{
+		Player::PlayerLock lock(player);
+		m_playerMap.erase(player->getGUID());
+		if (g_game().getGameState() == GAME_STATE_NORMAL) {
+			logger.debug("Saving player {}.", player->getName());
+		}
+		snapshot = IOLoginData::snapshotPlayer(player);
 	}
 
-	bool saveSuccess = IOLoginData::savePlayer(player);
+	bool saveSuccess = snapshot && IOLoginData::saveSnapshot(*snapshot);
 	if (!saveSuccess) {
 		logger.error("Failed to save player {}.", player->getName());
 	}
@@ -142,18 +266,6 @@ void SaveManager::saveGuild(std::shared_ptr<Guild> guild) {
 	logger.debug("Saving guild {} took {} milliseconds.", guild->getName(), duration);
 }
 
-void SaveManager::saveMap() {
-	Benchmark bm_saveMap;
-	logger.debug("Saving map...");
-	bool saveSuccess = Map::save();
-	if (!saveSuccess) {
-		logger.error("Failed to save map.");
-	}
-
-	auto duration = bm_saveMap.duration();
-	logger.debug("Map saved in {} milliseconds.", duration);
-}
-
 void SaveManager::saveKV() {
 	Benchmark bm_saveKV;
 	logger.debug("Saving key-value store...");
@@ -26,14 +26,27 @@ public:
 
 	static SaveManager &getInstance();
 
+	struct Progress {
+		size_t total = 0;
+		size_t written = 0;
+	};
+
+	// Snapshots on the dispatcher, then waits until everything is written
 	void saveAll();
+	// Snapshots on the dispatcher, the writes run on the thread pool
 	void scheduleAll();
+	// Entities written by the last server save so far
+	Progress getProgress() const;
 
 	bool savePlayer(std::shared_ptr<Player> player);
 	void saveGuild(std::shared_ptr<Guild> guild);
 
 private:
-	void saveMap();
+	struct Snapshot;
+
+	std::shared_ptr<Snapshot> snapshotAll();
+	void writeAll(const std::shared_ptr<Snapshot> &snapshot, bool wait);
+	void writeEntity(const Snapshot &snapshot, size_t index);
 	void saveKV();
 
 	void schedulePlayer(std::weak_ptr<Player> player);
@@ -41,6 +54,8 @@ private:
 
 	std::atomic<std::chrono::steady_clock::time_point> m_scheduledAt;
 	phmap::parallel_flat_hash_map<uint32_t, std::chrono::steady_clock::time_point> m_playerMap;
+	std::atomic<size_t> m_progressTotal = 0;
+	std::atomic<size_t> m_progressWritten = 0;
 
 	ThreadPool &threadPool;
 	KVStore &kv;
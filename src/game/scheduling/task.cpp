@@ -16,7 +16,7 @@
 std::atomic_uint_fast64_t Task::LAST_EVENT_ID = 0;
 
 Task::Task(uint32_t expiresAfterMs, std::function<void(void)> &&f, std::string_view context) :
-	func(std::move(f)), context(context), utime(OTSYS_TIME()),
+	func(std::move(f)), context(context), dueTime(std::chrono::steady_clock::now()), utime(OTSYS_TIME()),
 	expiration(expiresAfterMs > 0 ? OTSYS_TIME() + expiresAfterMs : 0) {
 	if (this->context.empty()) {
 		g_logger().error("[{}]: task context cannot be empty!", __FUNCTION__);
@@ -27,7 +27,7 @@ Task::Task(uint32_t expiresAfterMs, std::function<void(void)> &&f, std::string_v
 }
 
 Task::Task(std::function<void(void)> &&f, std::string_view context, uint32_t delay, bool cycle /* = false*/, bool log /*= true*/) :
-	func(std::move(f)), context(context), utime(OTSYS_TIME() + delay), delay(delay),
+	func(std::move(f)), context(context), dueTime(std::chrono::steady_clock::now() + std::chrono::milliseconds(delay)), utime(OTSYS_TIME() + delay), delay(delay),
 	cycle(cycle), log(log) {
 	if (this->context.empty()) {
 		g_logger().error("[{}]: task context cannot be empty!", __FUNCTION__);
@@ -65,5 +65,6 @@ bool Task::execute() const {
 }
 
 void Task::updateTime() {
+	dueTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay);
 	utime = OTSYS_TIME() + delay;
 }
@@ -10,6 +10,17 @@
 #pragma once
 
 class Dispatcher;
+class TimingWheel;
+struct TimingWheelNode;
+
+enum class TaskGroup : int8_t {
+	ThreadPool = -1,
+	Walk,
+	WalkParallel,
+	Serial,
+	GenericParallel,
+	Last
+};
 
 class Task {
 public:
@@ -41,6 +52,13 @@ public:
 		return utime;
 	}
 
+	/**
+	 * @brief Returns when the task became ready to run, the time spent queued is measured from it.
+	 */
+	[[nodiscard]] auto getDueTime() const {
+		return dueTime;
+	}
+
 	[[nodiscard]] bool hasExpired() const;
 
 	[[nodiscard]] bool isCycle() const {
@@ -94,15 +112,13 @@ private:
 		return tasksContext.contains(context);
 	}
 
-	struct Compare {
-		bool operator()(const std::shared_ptr<Task> &a, const std::shared_ptr<Task> &b) const {
-			return a->getTime() < b->getTime();
-		}
-	};
-
 	std::function<void(void)> func;
 	std::string context;
 
+	// Node holding this task while it is linked into the dispatcher timing wheel
+	TimingWheelNode* wheelNode = nullptr;
+
+	std::chrono::steady_clock::time_point dueTime;
 	int64_t utime = 0;
 	int64_t expiration = 0;
 	uint64_t id = 0;
@@ -111,4 +127,5 @@ private:
 	bool log = true;
 
 	friend class Dispatcher;
+	friend class TimingWheel;
 };
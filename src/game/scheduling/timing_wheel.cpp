@@ -0,0 +1,200 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "game/scheduling/timing_wheel.hpp"
+
+TimingWheel::TimingWheel() {
+	for (uint_fast8_t level = 0; level < LEVELS; ++level) {
+		slots[level] = std::vector<Link>(LEVEL_SLOTS[level]);
+		occupied[level].resize((LEVEL_SLOTS[level] + 63) / 64, 0);
+	}
+}
+
+TimingWheel::~TimingWheel() {
+	clear();
+}
+
+TimingWheel::Node* TimingWheel::acquireNode() {
+	if (!freeNodes) {
+		auto &chunk = chunks.emplace_back(std::make_unique<Node[]>(NODES_PER_CHUNK));
+		for (size_t i = 0; i < NODES_PER_CHUNK; ++i) {
+			chunk[i].next = freeNodes;
+			freeNodes = &chunk[i];
+		}
+	}
+
+	auto* node = freeNodes;
+	freeNodes = static_cast<Node*>(node->next);
+	node->prev = node->next = node;
+	return node;
+}
+
+void TimingWheel::releaseNode(Node* node) {
+	node->task.reset();
+	node->level = UNLINKED;
+	node->next = freeNodes;
+	freeNodes = node;
+}
+
+void TimingWheel::insert(const std::shared_ptr<Task> &task) {
+	if (task->wheelNode) {
+		erase(task.get());
+	}
+
+	auto* node = acquireNode();
+	node->task = task;
+	node->time = std::max(task->getTime(), cursor);
+	task->wheelNode = node;
+
+	place(node);
+	++count;
+}
+
+bool TimingWheel::erase(Task* task) {
+	auto* node = task->wheelNode;
+	if (!node || node->task.get() != task) {
+		return false;
+	}
+
+	unlink(node);
+	task->wheelNode = nullptr;
+	releaseNode(node);
+	--count;
+	return true;
+}
+
+void TimingWheel::place(Node* node) {
+	// Beyond the range, the node is cascaded from the furthest slot and placed again from there
+	const auto time = std::min(node->time, cursor + RANGE - 1);
+	const auto delta = time - cursor;
+	for (uint_fast8_t level = 0; level < LEVELS; ++level) {
+		const auto shift = LEVEL_SHIFT[level];
+		if (delta < (int64_t { LEVEL_SLOTS[level] } << shift)) {
+			const auto slot = static_cast<uint16_t>((time >> shift) & (LEVEL_SLOTS[level] - 1));
+			node->level = level;
+			node->slot = slot;
+			linkBack(slots[level][slot], node);
+			setOccupied(level, slot);
+			return;
+		}
+	}
+}
+
+void TimingWheel::unlink(Node* node) {
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+	node->prev = node->next = node;
+
+	if (node->level < LEVELS) {
+		const auto &head = slots[node->level][node->slot];
+		if (head.next == &head) {
+			clearOccupied(node->level, node->slot);
+		}
+	}
+
+	node->level = UNLINKED;
+}
+
+void TimingWheel::detach(Link &head, Link &out) {
+	if (head.next == &head) {
+		return;
+	}
+
+	for (auto* link = head.next; link != &head; link = link->next) {
+		static_cast<Node*>(link)->level = DETACHED;
+	}
+
+	// Splice the whole list at the end of the output list
+	head.next->prev = out.prev;
+	out.prev->next = head.next;
+	head.prev->next = &out;
+	out.prev = head.prev;
+	head.prev = head.next = &head;
+}
+
+void TimingWheel::detachSlot(uint8_t level, uint16_t slot, Link &out) {
+	detach(slots[level][slot], out);
+	clearOccupied(level, slot);
+}
+
+void TimingWheel::cascade(int64_t time) {
+	Link pending;
+	for (auto level = static_cast<uint8_t>(LEVELS - 1); level > 0; --level) {
+		const auto shift = LEVEL_SHIFT[level];
+		if ((time & ((int64_t { 1 } << shift) - 1)) == 0) {
+			detachSlot(level, static_cast<uint16_t>((time >> shift) & (LEVEL_SLOTS[level] - 1)), pending);
+		}
+	}
+
+	while (pending.next != &pending) {
+		auto* node = static_cast<Node*>(pending.next);
+		node->prev->next = node->next;
+		node->next->prev = node->prev;
+		place(node);
+	}
+}
+
+uint16_t TimingWheel::findOccupied(uint8_t level, uint16_t from) const {
+	const auto &bits = occupied[level];
+	const auto slotCount = LEVEL_SLOTS[level];
+
+	// Scan forward from the starting slot, wrapping around once
+	for (uint16_t scanned = 0; scanned < slotCount;) {
+		const auto slot = static_cast<uint16_t>((from + scanned) & (slotCount - 1));
+		const auto word = bits[slot >> 6] >> (slot & 63);
+		if (word != 0) {
+			return static_cast<uint16_t>(scanned + std::countr_zero(word));
+		}
+		scanned += 64 - (slot & 63);
+	}
+
+	return slotCount;
+}
+
+int64_t TimingWheel::getNextTime() const {
+	if (count == 0) {
+		return std::numeric_limits<int64_t>::max();
+	}
+
+	auto next = std::numeric_limits<int64_t>::max();
+
+	// The lowest tier holds exact expiration times for the next 1024 ms
+	const auto distance = findOccupied(0, static_cast<uint16_t>(cursor & (LEVEL_SLOTS[0] - 1)));
+	if (distance < LEVEL_SLOTS[0]) {
+		next = cursor + distance;
+	}
+
+	// Higher tiers only need to be visited when their slot starts, to cascade it down
+	for (uint_fast8_t level = 1; level < LEVELS; ++level) {
+		const auto shift = LEVEL_SHIFT[level];
+		const auto block = (cursor + (int64_t { 1 } << shift) - 1) >> shift;
+		const auto blockDistance = findOccupied(level, static_cast<uint16_t>(block & (LEVEL_SLOTS[level] - 1)));
+		if (blockDistance < LEVEL_SLOTS[level]) {
+			next = std::min(next, (block + blockDistance) << shift);
+		}
+	}
+
+	return next;
+}
+
+void TimingWheel::clear() {
+	Link pending;
+	for (uint_fast8_t level = 0; level < LEVELS; ++level) {
+		for (uint16_t slot = 0; slot < LEVEL_SLOTS[level]; ++slot) {
+			detachSlot(level, slot, pending);
+		}
+	}
+
+	while (auto* node = popFront(pending)) {
+		node->task->wheelNode = nullptr;
+		releaseNode(node);
+	}
+
+	count = 0;
+}
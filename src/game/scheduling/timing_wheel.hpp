@@ -0,0 +1,190 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/scheduling/task.hpp"
+
+struct TimingWheelLink {
+	TimingWheelLink* prev = this;
+	TimingWheelLink* next = this;
+};
+
+/**
+ * @brief Intrusive node linking a scheduled task into one of the wheel slots.
+ * The task keeps a back-pointer to it, which is what makes cancellation O(1).
+ */
+struct TimingWheelNode : TimingWheelLink {
+	std::shared_ptr<Task> task;
+	int64_t time = 0;
+	uint16_t slot = 0;
+	uint8_t level = 0;
+};
+
+/**
+ * @brief Hierarchical timing wheel used by the Dispatcher to hold scheduled tasks.
+ *
+ * Tasks are kept in intrusive, pool-allocated nodes spread across four tiers:
+ * 1024 slots of 1 ms, 64 slots of ~1 s, 64 slots of ~1 min and 1024 slots of ~70 min.
+ * Together they span 2^32 ms (~49.7 days), every delay a Task can have, so memory
+ * is bounded by the tasks themselves and there is no unbounded spill list. A time
+ * further ahead, only possible while the wheel lags behind the clock, waits in the
+ * furthest top tier slot and is placed again when that slot comes up.
+ * Insertion and cancellation are O(1), higher tiers are cascaded down lazily
+ * as the wheel advances, so no ordered structure is ever maintained.
+ *
+ * @note The wheel is not thread-safe, it must only be touched by the dispatcher thread.
+ */
+class TimingWheel {
+public:
+	TimingWheel();
+	~TimingWheel();
+
+	// Ensures that we don't accidentally copy it
+	TimingWheel(const TimingWheel &) = delete;
+	TimingWheel &operator=(const TimingWheel &) = delete;
+
+	/**
+	 * @brief Links the task into the wheel using its current execution time.
+	 * Tasks scheduled in the past are clamped to the current wheel time.
+	 */
+	void insert(const std::shared_ptr<Task> &task);
+
+	/**
+	 * @brief Unlinks the task from the wheel in O(1).
+	 * @return false if the task is not linked into this wheel.
+	 */
+	bool erase(Task* task);
+
+	/**
+	 * @brief Fires, in time order, every task whose execution time is <= now.
+	 * The callback receives ownership of the expired task and may freely
+	 * insert or erase other tasks.
+	 */
+	template <typename F>
+	void advance(int64_t now, F &&onExpire);
+
+	/**
+	 * @brief Moves the wheel time forward while it holds no task,
+	 * avoiding a long catch-up on the first advance.
+	 */
+	void rebase(int64_t now) {
+		if (count == 0) {
+			cursor = std::max(cursor, now);
+		}
+	}
+
+	/**
+	 * @brief Returns the next time the wheel has work to do, either an expiration
+	 * or the cascade of a higher tier, or INT64_MAX when it is empty.
+	 */
+	[[nodiscard]] int64_t getNextTime() const;
+
+	[[nodiscard]] size_t size() const {
+		return count;
+	}
+
+	[[nodiscard]] bool empty() const {
+		return count == 0;
+	}
+
+	void clear();
+
+private:
+	using Link = TimingWheelLink;
+	using Node = TimingWheelNode;
+
+	static constexpr uint8_t LEVELS = 4;
+	static constexpr uint8_t DETACHED = LEVELS;
+	static constexpr uint8_t UNLINKED = 0xFF;
+
+	static constexpr std::array<uint8_t, LEVELS> LEVEL_SHIFT = { 0, 10, 16, 22 };
+	static constexpr std::array<uint16_t, LEVELS> LEVEL_SLOTS = { 1024, 64, 64, 1024 };
+	// How far ahead of the cursor the wheel reaches, the full range of a uint32_t delay
+	static constexpr int64_t RANGE = int64_t { LEVEL_SLOTS[LEVELS - 1] } << LEVEL_SHIFT[LEVELS - 1];
+
+	static constexpr size_t NODES_PER_CHUNK = 1024;
+
+	static void linkBack(Link &head, Node* node) {
+		node->prev = head.prev;
+		node->next = &head;
+		head.prev->next = node;
+		head.prev = node;
+	}
+
+	static Node* popFront(Link &head) {
+		if (head.next == &head) {
+			return nullptr;
+		}
+
+		auto* node = static_cast<Node*>(head.next);
+		node->prev->next = node->next;
+		node->next->prev = node->prev;
+		node->prev = node->next = node;
+		node->level = UNLINKED;
+		return node;
+	}
+
+	Node* acquireNode();
+	void releaseNode(Node* node);
+
+	void place(Node* node);
+	void unlink(Node* node);
+	void detach(Link &head, Link &out);
+	void detachSlot(uint8_t level, uint16_t slot, Link &out);
+	void cascade(int64_t time);
+
+	void setOccupied(uint8_t level, uint16_t slot) {
+		occupied[level][slot >> 6] |= uint64_t { 1 } << (slot & 63);
+	}
+
+	void clearOccupied(uint8_t level, uint16_t slot) {
+		occupied[level][slot >> 6] &= ~(uint64_t { 1 } << (slot & 63));
+	}
+
+	[[nodiscard]] uint16_t findOccupied(uint8_t level, uint16_t from) const;
+
+	std::array<std::vector<Link>, LEVELS> slots;
+	std::array<std::vector<uint64_t>, LEVELS> occupied;
+
+	std::vector<std::unique_ptr<Node[]>> chunks;
+	Node* freeNodes = nullptr;
+
+	// Every time lower than the cursor has already been processed.
+	int64_t cursor = 0;
+	size_t count = 0;
+};
+
+template <typename F>
+void TimingWheel::advance(int64_t now, F &&onExpire) {
+	Link expired;
+	while (count > 0) {
+		const auto time = getNextTime();
+		if (time > now) {
+			break;
+		}
+
+		cursor = time;
+		cascade(time);
+		detachSlot(0, static_cast<uint16_t>(time & (LEVEL_SLOTS[0] - 1)), expired);
+
+		// Anything inserted from the callbacks must land after the slot being fired.
+		cursor = time + 1;
+
+		while (auto* node = popFront(expired)) {
+			--count;
+			auto task = std::move(node->task);
+			task->wheelNode = nullptr;
+			releaseNode(node);
+			onExpire(std::move(task));
+		}
+	}
+
+	cursor = std::max(cursor, now + 1);
+}
@@ -28,15 +28,26 @@
 #include "creatures/players/player.hpp"
 #include "utils/tools.hpp"
 
-void IOLoginDataLoad::loadItems(ItemsMap &itemsMap, const DBResult_ptr &result, const std::shared_ptr<Player> &player) {
+namespace {
+	// Select list of every item table, the loader reads the columns by index
+	enum ItemColumn : size_t {
+		ITEM_COLUMN_PID,
+		ITEM_COLUMN_SID,
+		ITEM_COLUMN_TYPE,
+		ITEM_COLUMN_COUNT,
+		ITEM_COLUMN_ATTRIBUTES,
+	};
+}
+
+void IOLoginDataLoad::loadItems(ItemsMap &itemsMap, const DBStatementResult_ptr &result, const std::shared_ptr<Player> &player) {
 	try {
 		do {
-			auto sid = result->getNumber<uint32_t>("sid");
-			auto pid = result->getNumber<uint32_t>("pid");
-			auto type = result->getNumber<uint16_t>("itemtype");
-			auto count = result->getNumber<uint16_t>("count");
+			auto sid = result->getNumber<uint32_t>(ITEM_COLUMN_SID);
+			auto pid = result->getNumber<uint32_t>(ITEM_COLUMN_PID);
+			auto type = result->getNumber<uint16_t>(ITEM_COLUMN_TYPE);
+			auto count = result->getNumber<uint16_t>(ITEM_COLUMN_COUNT);
 			unsigned long attrSize;
-			const char* attr = result->getStream("attributes", attrSize);
+			const char* attr = result->getStream(ITEM_COLUMN_ATTRIBUTES, attrSize);
 			PropStream propStream;
 			propStream.init(attr, attrSize);
 
@@ -64,26 +75,24 @@ void IOLoginDataLoad::loadItems(ItemsMap &itemsMap, const DBResult_ptr &result,
 bool IOLoginDataLoad::preLoadPlayer(const std::shared_ptr<Player> &player, const std::string &name) {
 	Database &db = Database::getInstance();
 
-	std::ostringstream query;
-	query << "SELECT `id`, `account_id`, `group_id`, `deletion` FROM `players` WHERE `name` = " << db.escapeString(name);
-	DBResult_ptr result = db.storeQuery(query.str());
+	const auto result = db.storeStatement("SELECT `id`, `account_id`, `group_id`, `deletion` FROM `players` WHERE `name` = ?", { name });
 	if (!result) {
 		return false;
 	}
 
-	if (result->getNumber<uint64_t>("deletion") != 0) {
+	if (result->getNumber<uint64_t>(3) != 0) {
 		return false;
 	}
 
-	player->setGUID(result->getNumber<uint32_t>("id"));
-	const auto &group = g_game().groups.getGroup(result->getNumber<uint16_t>("group_id"));
+	player->setGUID(result->getNumber<uint32_t>(0));
+	const auto &group = g_game().groups.getGroup(result->getNumber<uint16_t>(2));
 	if (!group) {
-		g_logger().error("Player {} has group id {} which doesn't exist", player->name, result->getNumber<uint16_t>("group_id"));
+		g_logger().error("Player {} has group id {} which doesn't exist", player->name, result->getNumber<uint16_t>(2));
 		return false;
 	}
 	player->setGroup(group);
 
-	auto accountId = result->getNumber<uint32_t>("account_id");
+	auto accountId = result->getNumber<uint32_t>(1);
 	if (!player->setAccount(accountId)) {
 		g_logger().error("Player {} has account id {} which doesn't exist", player->name, accountId);
 		return false;
@@ -364,16 +373,14 @@ void IOLoginDataLoad::loadPlayerKills(const std::shared_ptr<Player> &player, DBR
 		return;
 	}
 
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `player_id`, `time`, `target`, `unavenged` FROM `player_kills` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	const auto kills = g_database().storeStatement("SELECT `time`, `target`, `unavenged` FROM `player_kills` WHERE `player_id` = ?", { player->getGUID() });
+	if (kills) {
 		do {
-			auto killTime = result->getNumber<time_t>("time");
+			auto killTime = kills->getNumber<time_t>(0);
 			if ((time(nullptr) - killTime) <= g_configManager().getNumber(FRAG_TIME)) {
-				player->unjustifiedKills.emplace_back(result->getNumber<uint32_t>("target"), killTime, result->getNumber<bool>("unavenged"));
+				player->unjustifiedKills.emplace_back(kills->getNumber<uint32_t>(1), killTime, kills->getNumber<bool>(2));
 			}
-		} while (result->next());
+		} while (kills->next());
 	}
 }
 
@@ -384,12 +391,10 @@ void IOLoginDataLoad::loadPlayerGuild(const std::shared_ptr<Player> &player, DBR
 	}
 
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `guild_id`, `rank_id`, `nick` FROM `guild_membership` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
-		auto guildId = result->getNumber<uint32_t>("guild_id");
-		auto playerRankId = result->getNumber<uint32_t>("rank_id");
-		player->guildNick = result->getString("nick");
+	if (const auto membership = db.storeStatement("SELECT `guild_id`, `rank_id`, `nick` FROM `guild_membership` WHERE `player_id` = ?", { player->getGUID() })) {
+		auto guildId = membership->getNumber<uint32_t>(0);
+		auto playerRankId = membership->getNumber<uint32_t>(1);
+		player->guildNick = membership->getString(2);
 
 		auto guild = g_game().getGuild(guildId);
 		if (!guild) {
@@ -401,11 +406,8 @@ void IOLoginDataLoad::loadPlayerGuild(const std::shared_ptr<Player> &player, DBR
 			player->guild = guild;
 			GuildRank_ptr rank = guild->getRankById(playerRankId);
 			if (!rank) {
-				query.str("");
-				query << "SELECT `id`, `name`, `level` FROM `guild_ranks` WHERE `id` = " << playerRankId;
-
-				if ((result = db.storeQuery(query.str()))) {
-					guild->addRank(result->getNumber<uint32_t>("id"), result->getString("name"), static_cast<uint8_t>(result->getNumber<uint16_t>("level")));
+				if (const auto rankResult = db.storeStatement("SELECT `id`, `name`, `level` FROM `guild_ranks` WHERE `id` = ?", { playerRankId })) {
+					guild->addRank(rankResult->getNumber<uint32_t>(0), rankResult->getString(1), static_cast<uint8_t>(rankResult->getNumber<uint16_t>(2)));
 				}
 
 				rank = guild->getRankById(playerRankId);
@@ -418,10 +420,8 @@ void IOLoginDataLoad::loadPlayerGuild(const std::shared_ptr<Player> &player, DBR
 
 			IOGuild::getWarList(guildId, player->guildWarVector);
 
-			query.str("");
-			query << "SELECT COUNT(*) AS `members` FROM `guild_membership` WHERE `guild_id` = " << guildId;
-			if ((result = db.storeQuery(query.str()))) {
-				guild->setMemberCount(result->getNumber<uint32_t>("members"));
+			if (const auto members = db.storeStatement("SELECT COUNT(*) AS `members` FROM `guild_membership` WHERE `guild_id` = ?", { guildId })) {
+				guild->setMemberCount(members->getNumber<uint32_t>(0));
 			}
 		}
 	}
@@ -433,13 +433,11 @@ void IOLoginDataLoad::loadPlayerStashItems(const std::shared_ptr<Player> &player
 		return;
 	}
 
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `item_count`, `item_id`  FROM `player_stash` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	const auto stash = g_database().storeStatement("SELECT `item_count`, `item_id` FROM `player_stash` WHERE `player_id` = ?", { player->getGUID() });
+	if (stash) {
 		do {
-			player->addItemOnStash(result->getNumber<uint16_t>("item_id"), result->getNumber<uint32_t>("item_count"));
-		} while (result->next());
+			player->addItemOnStash(stash->getNumber<uint16_t>(1), stash->getNumber<uint32_t>(0));
+		} while (stash->next());
 	}
 }
 
@@ -502,13 +500,11 @@ void IOLoginDataLoad::loadPlayerInstantSpellList(const std::shared_ptr<Player> &
 		return;
 	}
 
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `player_id`, `name` FROM `player_spells` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	const auto spells = g_database().storeStatement("SELECT `name` FROM `player_spells` WHERE `player_id` = ?", { player->getGUID() });
+	if (spells) {
 		do {
-			player->learnedInstantSpellList.emplace_back(result->getString("name"));
-		} while (result->next());
+			player->learnedInstantSpellList.emplace_back(spells->getString(0));
+		} while (spells->next());
 	}
 }
 
@@ -519,15 +515,14 @@ void IOLoginDataLoad::loadPlayerInventoryItems(const std::shared_ptr<Player> &pl
 	}
 
 	bool oldProtocol = g_configManager().getBoolean(OLD_PROTOCOL) && player->getProtocolVersion() < 1200;
-	auto query = fmt::format("SELECT pid, sid, itemtype, count, attributes FROM player_items WHERE player_id = {} ORDER BY sid DESC", player->getGUID());
 
 	ItemsMap inventoryItems;
 	std::vector<std::pair<uint8_t, std::shared_ptr<Container>>> openContainersList;
 	std::vector<std::shared_ptr<Item>> itemsToStartDecaying;
 
 	try {
-		if ((result = g_database().storeQuery(query))) {
-			loadItems(inventoryItems, result, player);
+		if (const auto items = g_database().storeStatement("SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_items` WHERE `player_id` = ? ORDER BY `sid` DESC", { player->getGUID() })) {
+			loadItems(inventoryItems, items, player);
 
 			for (auto it = inventoryItems.rbegin(), end = inventoryItems.rend(); it != end; ++it) {
 				const std::pair<std::shared_ptr<Item>, int32_t> &pair = it->second;
@@ -617,11 +612,7 @@ void IOLoginDataLoad::loadRewardItems(const std::shared_ptr<Player> &player) {
 	}
 
 	ItemsMap rewardItems;
-	std::ostringstream query;
-	query.str(std::string());
-	query << "SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_rewards` WHERE `player_id` = "
-		  << player->getGUID() << " ORDER BY `pid`, `sid` ASC";
-	if (auto result = Database::getInstance().storeQuery(query.str())) {
+	if (const auto result = g_database().storeStatement("SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_rewards` WHERE `player_id` = ? ORDER BY `pid`, `sid` ASC", { player->getGUID() })) {
 		loadItems(rewardItems, result, player);
 		bindRewardBag(player, rewardItems);
 		insertItemsIntoRewardBag(rewardItems);
@@ -636,9 +627,8 @@ void IOLoginDataLoad::loadPlayerDepotItems(const std::shared_ptr<Player> &player
 
 	ItemsMap depotItems;
 	std::vector<std::shared_ptr<Item>> itemsToStartDecaying;
-	auto query = fmt::format("SELECT pid, sid, itemtype, count, attributes FROM player_depotitems WHERE player_id = {} ORDER BY sid DESC", player->getGUID());
-	if ((result = g_database().storeQuery(query))) {
-		loadItems(depotItems, result, player);
+	if (const auto items = g_database().storeStatement("SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_depotitems` WHERE `player_id` = ? ORDER BY `sid` DESC", { player->getGUID() })) {
+		loadItems(depotItems, items, player);
 		for (auto it = depotItems.rbegin(), end = depotItems.rend(); it != end; ++it) {
 			const std::pair<std::shared_ptr<Item>, int32_t> &pair = it->second;
 			const auto &item = pair.first;
@@ -682,10 +672,9 @@ void IOLoginDataLoad::loadPlayerInboxItems(const std::shared_ptr<Player> &player
 	}
 
 	std::vector<std::shared_ptr<Item>> itemsToStartDecaying;
-	auto query = fmt::format("SELECT pid, sid, itemtype, count, attributes FROM player_inboxitems WHERE player_id = {} ORDER BY sid DESC", player->getGUID());
-	if ((result = g_database().storeQuery(query))) {
+	if (const auto items = g_database().storeStatement("SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_inboxitems` WHERE `player_id` = ? ORDER BY `sid` DESC", { player->getGUID() })) {
 		ItemsMap inboxItems;
-		loadItems(inboxItems, result, player);
+		loadItems(inboxItems, items, player);
 
 		const auto &playerInbox = player->getInbox();
 		if (!playerInbox) {
@@ -731,13 +720,11 @@ void IOLoginDataLoad::loadPlayerStorageMap(const std::shared_ptr<Player> &player
 		return;
 	}
 
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "SELECT `key`, `value` FROM `player_storage` WHERE `player_id` = " << player->getGUID();
-	if ((result = db.storeQuery(query.str()))) {
+	const auto storages = g_database().storeStatement("SELECT `key`, `value` FROM `player_storage` WHERE `player_id` = ?", { player->getGUID() });
+	if (storages) {
 		do {
-			player->addStorageValue(result->getNumber<uint32_t>("key"), result->getNumber<int32_t>("value"), true);
-		} while (result->next());
+			player->addStorageValue(storages->getNumber<uint32_t>(0), storages->getNumber<int32_t>(1), true);
+		} while (storages->next());
 	}
 }
 
@@ -750,32 +737,29 @@ void IOLoginDataLoad::loadPlayerVip(const std::shared_ptr<Player> &player, DBRes
 	uint32_t accountId = player->getAccountId();
 
 	Database &db = Database::getInstance();
-	std::string query = fmt::format("SELECT `player_id` FROM `account_viplist` WHERE `account_id` = {}", accountId);
-	if ((result = db.storeQuery(query))) {
+	if (const auto vips = db.storeStatement("SELECT `player_id` FROM `account_viplist` WHERE `account_id` = ?", { accountId })) {
 		do {
-			player->vip().addInternal(result->getNumber<uint32_t>("player_id"));
-		} while (result->next());
+			player->vip().addInternal(vips->getNumber<uint32_t>(0));
+		} while (vips->next());
 	}
 
-	query = fmt::format("SELECT `id`, `name`, `customizable` FROM `account_vipgroups` WHERE `account_id` = {}", accountId);
-	if ((result = db.storeQuery(query))) {
+	if (const auto groups = db.storeStatement("SELECT `id`, `name`, `customizable` FROM `account_vipgroups` WHERE `account_id` = ?", { accountId })) {
 		do {
 			player->vip().addGroupInternal(
-				result->getNumber<uint8_t>("id"),
-				result->getString("name"),
-				result->getNumber<uint8_t>("customizable") == 0 ? false : true
+				groups->getNumber<uint8_t>(0),
+				groups->getString(1),
+				groups->getNumber<uint8_t>(2) == 0 ? false : true
 			);
-		} while (result->next());
+		} while (groups->next());
 	}
 
-	query = fmt::format("SELECT `player_id`, `vipgroup_id` FROM `account_vipgrouplist` WHERE `account_id` = {}", accountId);
-	if ((result = db.storeQuery(query))) {
+	if (const auto groupList = db.storeStatement("SELECT `player_id`, `vipgroup_id` FROM `account_vipgrouplist` WHERE `account_id` = ?", { accountId })) {
 		do {
 			player->vip().addGuidToGroupInternal(
-				result->getNumber<uint8_t>("vipgroup_id"),
-				result->getNumber<uint32_t>("player_id")
+				groupList->getNumber<uint8_t>(1),
+				groupList->getNumber<uint32_t>(0)
 			);
-		} while (result->next());
+		} while (groupList->next());
 	}
 }
 
@@ -882,22 +866,17 @@ void IOLoginDataLoad::loadPlayerForgeHistory(const std::shared_ptr<Player> &play
 		return;
 	}
 
-	auto playerGUID = player->getGUID();
-
-	auto query = fmt::format(
-		"SELECT id, action_type, description, done_at, is_success FROM forge_history WHERE player_id = {}",
-		playerGUID
-	);
-	if ((result = Database::getInstance().storeQuery(query))) {
+	const auto history = g_database().storeStatement("SELECT `action_type`, `description`, `done_at`, `is_success` FROM `forge_history` WHERE `player_id` = ?", { player->getGUID() });
+	if (history) {
 		do {
-			auto actionEnum = magic_enum::enum_value<ForgeAction_t>(result->getNumber<uint16_t>("action_type"));
-			ForgeHistory history;
-			history.actionType = actionEnum;
-			history.description = result->getString("description");
-			history.createdAt = result->getNumber<time_t>("done_at");
-			history.success = result->getNumber<bool>("is_success");
-			player->setForgeHistory(history);
-		} while (result->next());
+			auto actionEnum = magic_enum::enum_value<ForgeAction_t>(history->getNumber<uint16_t>(0));
+			ForgeHistory entry;
+			entry.actionType = actionEnum;
+			entry.description = history->getString(1);
+			entry.createdAt = history->getNumber<time_t>(2);
+			entry.success = history->getNumber<bool>(3);
+			player->setForgeHistory(entry);
+		} while (history->next());
 	}
 }
 
@@ -912,17 +891,16 @@ void IOLoginDataLoad::loadPlayerBosstiary(const std::shared_ptr<Player> &player,
 		return;
 	}
 
-	std::ostringstream query;
-	query << "SELECT * FROM `player_bosstiary` WHERE `player_id` = " << player->getGUID();
-	if ((result = Database::getInstance().storeQuery(query.str()))) {
+	const auto bosstiary = g_database().storeStatement("SELECT `bossIdSlotOne`, `bossIdSlotTwo`, `removeTimes`, `tracker` FROM `player_bosstiary` WHERE `player_id` = ?", { player->getGUID() });
+	if (bosstiary) {
 		do {
-			player->setSlotBossId(1, result->getNumber<uint16_t>("bossIdSlotOne"));
-			player->setSlotBossId(2, result->getNumber<uint16_t>("bossIdSlotTwo"));
-			player->setRemoveBossTime(result->getU8FromString(result->getString("removeTimes"), __FUNCTION__));
+			player->setSlotBossId(1, bosstiary->getNumber<uint16_t>(0));
+			player->setSlotBossId(2, bosstiary->getNumber<uint16_t>(1));
+			player->setRemoveBossTime(DBResult::getU8FromString(bosstiary->getString(2), __FUNCTION__));
 
 			// Tracker
 			unsigned long size;
-			const char* chars = result->getStream("tracker", size);
+			const char* chars = bosstiary->getStream(3, size);
 			PropStream stream;
 			stream.init(chars, size);
 			uint16_t bossid;
@@ -934,7 +912,7 @@ void IOLoginDataLoad::loadPlayerBosstiary(const std::shared_ptr<Player> &player,
 
 				player->addMonsterToCyclopediaTrackerList(monsterType, true, false);
 			}
-		} while (result->next());
+		} while (bosstiary->next());
 	}
 }
 
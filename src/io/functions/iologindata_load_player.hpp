@@ -14,6 +14,8 @@
 class Player;
 class DBResult;
 using DBResult_ptr = std::shared_ptr<DBResult>;
+class DBStatementResult;
+using DBStatementResult_ptr = std::shared_ptr<DBStatementResult>;
 
 class IOLoginDataLoad : public IOLoginData {
 public:
@@ -51,5 +53,5 @@ private:
 	static void bindRewardBag(const std::shared_ptr<Player> &player, ItemsMap &rewardItemsMap);
 	static void insertItemsIntoRewardBag(const ItemsMap &rewardItemsMap);
 
-	static void loadItems(ItemsMap &itemsMap, const DBResult_ptr &result, const std::shared_ptr<Player> &player);
+	static void loadItems(ItemsMap &itemsMap, const DBStatementResult_ptr &result, const std::shared_ptr<Player> &player);
 };
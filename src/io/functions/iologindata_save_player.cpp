@@ -19,23 +19,128 @@
 #include "items/containers/inbox/inbox.hpp"
 #include "items/containers/rewards/reward.hpp"
 #include "creatures/players/player.hpp"
+#include "utils/hash.hpp"
+
+bool IOLoginDataSave::saveRows(const PlayerSaveSnapshot &snapshot, const PlayerSaveSnapshot::Table &table, size_t &rowsWritten) {
+	auto &image = *table.image;
+	const auto &name = table.name;
+	const auto &keyColumns = table.keyColumns;
+	const auto &valueColumns = table.valueColumns;
+	const auto &rows = *table.rows;
+	const bool keyed = !keyColumns.empty();
+	const auto changes = image.diff(rows, keyed);
+	if (changes.empty()) {
+		return true;
+	}
+
+	const auto joinColumns = [](std::string &joined, const std::vector<std::string> &columns) {
+		for (const auto &column : columns) {
+			joined += fmt::format("{}`{}`", joined.empty() ? "" : ", ", column);
+		}
+	};
 
-bool IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, const ItemBlockList &itemList, DBInsert &query_insert, PropWriteStream &propWriteStream) {
+	Database &db = Database::getInstance();
+	if (changes.rewrite) {
+		if (!db.executeStatement(fmt::format("DELETE FROM `{}` WHERE `player_id` = ?", name), { snapshot.guid })) {
+			g_logger().warn("[IOLoginData::savePlayer] - Error delete query '{}' from player: {}", name, snapshot.name);
+			return false;
+		}
+	} else if (!changes.deletes.empty()) {
+		std::string keys;
+		joinColumns(keys, keyColumns);
+
+		// A few hundred keys per query keeps a large clean-up far below max_allowed_packet
+		constexpr size_t deleteBatch = 500;
+		for (size_t first = 0; first < changes.deletes.size(); first += deleteBatch) {
+			const auto last = std::min(first + deleteBatch, changes.deletes.size());
+			std::string tuples;
+			for (size_t i = first; i < last; ++i) {
+				tuples += fmt::format("{}({})", tuples.empty() ? "" : ",", changes.deletes[i]);
+			}
+
+			if (!db.executeQuery(fmt::format("DELETE FROM `{}` WHERE `player_id` = {} AND ({}) IN ({})", name, snapshot.guid, keys, tuples))) {
+				g_logger().warn("[IOLoginData::savePlayer] - Error delete query '{}' from player: {}", name, snapshot.name);
+				return false;
+			}
+		}
+		rowsWritten += changes.deletes.size();
+	}
+
+	std::string columns = "`player_id`";
+	joinColumns(columns, keyColumns);
+	joinColumns(columns, valueColumns);
+
+	DBInsert insertQuery(fmt::format("INSERT INTO `{}` ({}) VALUES ", name, columns));
+	if (!changes.rewrite && !valueColumns.empty()) {
+		insertQuery.upsert(valueColumns);
+	}
+
+	const auto addRow = [&](const DBTableImage::Row &row) {
+		auto values = std::to_string(snapshot.guid);
+		for (const auto &part : { std::string_view(row.key), std::string_view(row.values) }) {
+			if (!part.empty()) {
+				values.push_back(',');
+				values.append(part);
+			}
+		}
+		return insertQuery.addRow(values);
+	};
+
+	if (changes.rewrite) {
+		for (const auto &row : rows) {
+			if (!addRow(row)) {
+				return false;
+			}
+		}
+		rowsWritten += rows.size();
+	} else {
+		for (const auto index : changes.upserts) {
+			if (!addRow(rows[index])) {
+				return false;
+			}
+		}
+		rowsWritten += changes.upserts.size();
+	}
+
+	if (!insertQuery.execute()) {
+		g_logger().warn("[IOLoginData::savePlayer] - Error insert query '{}' from player: {}", name, snapshot.name);
+		return false;
+	}
+
+	image.commit(rows, keyed);
+	return true;
+}
+
+bool IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, std::vector<DBTableImage::Row> &rows, const ItemBlockList &itemList, PropWriteStream &propWriteStream) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
 	const Database &db = Database::getInstance();
-	std::ostringstream ss;
 
 	// Initialize variables
 	using ContainerBlock = std::pair<std::shared_ptr<Container>, int32_t>;
 	std::list<ContainerBlock> queue;
 	int32_t runningId = 100;
 
-	// Loop through each item in itemList
+	// Only written when it changes, writing it gives the container a new revision
 	const auto &openContainers = player->getOpenContainers();
+	const auto updateOpenContainer = [&openContainers](const std::shared_ptr<Container> &container) {
+		int64_t openContainer = 0;
+		for (const auto &[cid, open] : openContainers) {
+			if (open.container == container) {
+				openContainer = cid + 1;
+				break;
+			}
+		}
+
+		if (container->getAttribute<int64_t>(ItemAttribute_t::OPENCONTAINER) != openContainer) {
+			container->setAttribute(ItemAttribute_t::OPENCONTAINER, openContainer);
+		}
+	};
+
+	// Loop through each item in itemList
 	for (const auto &it : itemList) {
 		const auto &item = it.second;
 		if (!item) {
@@ -52,21 +157,7 @@ bool IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, const Ite
 				continue;
 			}
 
-			if (container->getAttribute<int64_t>(ItemAttribute_t::OPENCONTAINER) > 0) {
-				container->setAttribute(ItemAttribute_t::OPENCONTAINER, 0);
-			}
-
-			if (!openContainers.empty()) {
-				for (const auto &its : openContainers) {
-					auto openContainer = its.second;
-					auto opcontainer = openContainer.container;
-
-					if (opcontainer == container) {
-						container->setAttribute(ItemAttribute_t::OPENCONTAINER, ((int)its.first) + 1);
-						break;
-					}
-				}
-			}
+			updateOpenContainer(container);
 
 			// Add container to queue
 			queue.emplace_back(container, runningId);
@@ -79,12 +170,11 @@ bool IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, const Ite
 		size_t attributesSize;
 		const char* attributes = propWriteStream.getStream(attributesSize);
 
-		// Build query string and add row
-		ss << player->getGUID() << ',' << pid << ',' << runningId << ',' << item->getID() << ',' << item->getSubType() << ',' << db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize));
-		if (!query_insert.addRow(ss)) {
-			g_logger().error("Error adding row to query.");
-			return false;
-		}
+		// Keyed by (pid, sid), every item table is unique on it
+		rows.push_back({
+			fmt::format("{},{}", pid, runningId),
+			fmt::format("{},{},{}", item->getID(), item->getSubType(), db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize)))
+		});
 	}
 
 	// Loop through containers in queue
@@ -109,21 +199,7 @@ bool IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, const Ite
 			const auto &subContainer = item->getContainer();
 			if (subContainer) {
 				queue.emplace_back(subContainer, runningId);
-				if (subContainer->getAttribute<int64_t>(ItemAttribute_t::OPENCONTAINER) > 0) {
-					subContainer->setAttribute(ItemAttribute_t::OPENCONTAINER, 0);
-				}
-
-				if (!openContainers.empty()) {
-					for (const auto &it : openContainers) {
-						auto openContainer = it.second;
-						auto opcontainer = openContainer.container;
-
-						if (opcontainer == subContainer) {
-							subContainer->setAttribute(ItemAttribute_t::OPENCONTAINER, (it.first) + 1);
-							break;
-						}
-					}
-				}
+				updateOpenContainer(subContainer);
 			}
 
 			// Serialize item attributes
@@ -133,27 +209,51 @@ bool IOLoginDataSave::saveItems(const std::shared_ptr<Player> &player, const Ite
 			size_t attributesSize;
 			const char* attributes = propWriteStream.getStream(attributesSize);
 
-			// Build query string and add row
-			ss << player->getGUID() << ',' << parentId << ',' << runningId << ',' << item->getID() << ',' << item->getSubType() << ',' << db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize));
-			if (!query_insert.addRow(ss)) {
-				g_logger().error("Error adding row to query for container item.");
-				return false;
-			}
+			rows.push_back({
+				fmt::format("{},{}", parentId, runningId),
+				fmt::format("{},{},{}", item->getID(), item->getSubType(), db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize)))
+			});
 		}
 
 		// Removes the object after processing everything, avoiding memory usage after freeing
 		queue.pop_front();
 	}
 
-	// Execute query
-	if (!query_insert.execute()) {
-		g_logger().error("Error executing query.");
+	return true;
+}
+
+bool IOLoginDataSave::saveItemTable(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot, DBTableImage &image, DBSnapshotRows &last, std::string_view name, const ItemBlockList &itemList) {
+	// A walk over revisions, far cheaper than serializing and escaping every item
+	size_t signature = itemList.size();
+	for (const auto &[pid, item] : itemList) {
+		if (item) {
+			stdext::hash_combine(signature, static_cast<uint32_t>(pid));
+			stdext::hash_union(signature, item->getSaveSignature());
+		}
+	}
+	// saveItems records which containers are open
+	for (const auto &[cid, open] : player->getOpenContainers()) {
+		stdext::hash_combine(signature, cid);
+		stdext::hash_combine(signature, reinterpret_cast<uintptr_t>(open.container.get()));
+	}
+
+	if (last.rows && last.signature == signature) {
+		snapshot.addTable(image, name, { "pid", "sid" }, { "itemtype", "count", "attributes" }, last.rows);
+		return true;
+	}
+
+	auto rows = std::make_shared<std::vector<DBTableImage::Row>>();
+	PropWriteStream propWriteStream;
+	if (!saveItems(player, *rows, itemList, propWriteStream)) {
 		return false;
 	}
+
+	snapshot.addTable(image, name, { "pid", "sid" }, { "itemtype", "count", "attributes" }, rows);
+	last = { signature, std::move(rows) };
 	return true;
 }
 
-bool IOLoginDataSave::savePlayerFirst(const std::shared_ptr<Player> &player) {
+bool IOLoginDataSave::savePlayerFirst(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
@@ -163,24 +263,12 @@ bool IOLoginDataSave::savePlayerFirst(const std::shared_ptr<Player> &player) {
 		player->changeHealth(1);
 	}
 
-	Database &db = Database::getInstance();
-
-	std::ostringstream query;
-	query << "SELECT `save` FROM `players` WHERE `id` = " << player->getGUID();
-	DBResult_ptr result = db.storeQuery(query.str());
-	if (!result) {
-		g_logger().warn("[IOLoginData::savePlayer] - Error for select result query from player: {}", player->getName());
-		return false;
-	}
-
-	if (result->getNumber<uint16_t>("save") == 0) {
-		query.str("");
-		query << "UPDATE `players` SET `lastlogin` = " << player->lastLoginSaved << ", `lastip` = " << player->lastIP << " WHERE `id` = " << player->getGUID();
-		return db.executeQuery(query.str());
-	}
+	const Database &db = Database::getInstance();
+	snapshot.lastLoginSaved = player->lastLoginSaved;
+	snapshot.lastIP = player->lastIP;
 
 	// First, an UPDATE query to write the player itself
-	query.str("");
+	std::ostringstream query;
 	query << "UPDATE `players` SET ";
 	query << "`name` = " << db.escapeString(player->name) << ",";
 	query << "`level` = " << player->level << ",";
@@ -323,106 +411,58 @@ bool IOLoginDataSave::savePlayerFirst(const std::shared_ptr<Player> &player) {
 	}
 	query << " WHERE `id` = " << player->getGUID();
 
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
+	snapshot.playerQuery = query.str();
 	return true;
 }
 
-bool IOLoginDataSave::savePlayerStash(const std::shared_ptr<Player> &player) {
+bool IOLoginDataSave::savePlayerStash(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "DELETE FROM `player_stash` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-
-	DBInsert stashQuery("INSERT INTO `player_stash` (`player_id`,`item_id`,`item_count`) VALUES ");
+	auto &rows = snapshot.addTable(player->m_saveImage.stash, "player_stash", { "item_id" }, { "item_count" });
 	for (const auto &[itemId, itemCount] : player->getStashItems()) {
-		query << player->getGUID() << ',' << itemId << ',' << itemCount;
-		if (!stashQuery.addRow(query)) {
-			return false;
-		}
-	}
-
-	if (!stashQuery.execute()) {
-		return false;
+		rows.push_back({ std::to_string(itemId), std::to_string(itemCount) });
 	}
 	return true;
 }
 
-bool IOLoginDataSave::savePlayerSpells(const std::shared_ptr<Player> &player) {
+bool IOLoginDataSave::savePlayerSpells(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "DELETE FROM `player_spells` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-
-	DBInsert spellsQuery("INSERT INTO `player_spells` (`player_id`, `name` ) VALUES ");
+	const Database &db = Database::getInstance();
+	auto &rows = snapshot.addTable(player->m_saveImage.spells, "player_spells", { "name" }, {});
 	for (const std::string &spellName : player->learnedInstantSpellList) {
-		query << player->getGUID() << ',' << db.escapeString(spellName);
-		if (!spellsQuery.addRow(query)) {
-			return false;
-		}
-	}
-
-	if (!spellsQuery.execute()) {
-		return false;
+		rows.push_back({ db.escapeString(spellName), {} });
 	}
 	return true;
 }
 
-bool IOLoginDataSave::savePlayerKills(const std::shared_ptr<Player> &player) {
+bool IOLoginDataSave::savePlayerKills(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "DELETE FROM `player_kills` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-
-	DBInsert killsQuery("INSERT INTO `player_kills` (`player_id`, `target`, `time`, `unavenged`) VALUES");
+	// Kills have no key of their own, any change rewrites them
+	auto &rows = snapshot.addTable(player->m_saveImage.kills, "player_kills", {}, { "target", "time", "unavenged" });
 	for (const auto &kill : player->unjustifiedKills) {
-		query << player->getGUID() << ',' << kill.target << ',' << kill.time << ',' << kill.unavenged;
-		if (!killsQuery.addRow(query)) {
-			return false;
-		}
-	}
-
-	if (!killsQuery.execute()) {
-		return false;
+		rows.push_back({ {}, fmt::format("{},{},{}", kill.target, kill.time, static_cast<uint16_t>(kill.unavenged)) });
 	}
 	return true;
 }
 
-bool IOLoginDataSave::savePlayerBestiarySystem(const std::shared_ptr<Player> &player) {
+bool IOLoginDataSave::savePlayerBestiarySystem(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
-	Database &db = Database::getInstance();
+	const Database &db = Database::getInstance();
 
 	std::ostringstream query;
 	query << "UPDATE `player_charms` SET ";
@@ -459,30 +499,16 @@ bool IOLoginDataSave::savePlayerBestiarySystem(const std::shared_ptr<Player> &pl
 	query << " `tracker list` = " << db.escapeBlob(trackerList, static_cast<uint32_t>(trackerSize));
 	query << " WHERE `player_guid` = " << player->getGUID();
 
-	if (!db.executeQuery(query.str())) {
-		g_logger().warn("[IOLoginData::savePlayer] - Error saving bestiary data from player: {}", player->getName());
-		return false;
-	}
+	snapshot.bestiaryQuery = query.str();
 	return true;
 }
 
-bool IOLoginDataSave::savePlayerItem(const std::shared_ptr<Player> &player) {
+bool IOLoginDataSave::savePlayerItem(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
-	Database &db = Database::getInstance();
-	PropWriteStream propWriteStream;
-	std::ostringstream query;
-	query << "DELETE FROM `player_items` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		g_logger().warn("[IOLoginData::savePlayer] - Error delete query 'player_items' from player: {}", player->getName());
-		return false;
-	}
-
-	DBInsert itemsQuery("INSERT INTO `player_items` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-
 	ItemBlockList itemList;
 	for (int32_t slotId = CONST_SLOT_FIRST; slotId <= CONST_SLOT_LAST; ++slotId) {
 		const auto &item = player->inventory[slotId];
@@ -491,41 +517,28 @@ bool IOLoginDataSave::savePlayerItem(const std::shared_ptr<Player> &player) {
 		}
 	}
 
-	if (!saveItems(player, itemList, itemsQuery, propWriteStream)) {
+	if (!saveItemTable(player, snapshot, player->m_saveImage.items, player->m_saveImage.itemRows, "player_items", itemList)) {
 		g_logger().warn("[IOLoginData::savePlayer] - Failed for save items from player: {}", player->getName());
 		return false;
 	}
 	return true;
 }
 
-bool IOLoginDataSave::savePlayerDepotItems(const std::shared_ptr<Player> &player) {
+bool IOLoginDataSave::savePlayerDepotItems(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
-	Database &db = Database::getInstance();
-	PropWriteStream propWriteStream;
 	ItemDepotList depotList;
 	if (player->lastDepotId != -1) {
-		std::ostringstream query;
-		query << "DELETE FROM `player_depotitems` WHERE `player_id` = " << player->getGUID();
-
-		if (!db.executeQuery(query.str())) {
-			return false;
-		}
-
-		query.str("");
-
-		DBInsert depotQuery("INSERT INTO `player_depotitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-
 		for (const auto &[pid, depotChest] : player->depotChests) {
 			for (const std::shared_ptr<Item> &item : depotChest->getItemList()) {
 				depotList.emplace_back(pid, item);
 			}
 		}
 
-		if (!saveItems(player, depotList, depotQuery, propWriteStream)) {
+		if (!saveItemTable(player, snapshot, player->m_saveImage.depotItems, player->m_saveImage.depotItemRows, "player_depotitems", depotList)) {
 			return false;
 		}
 		return true;
@@ -533,92 +546,57 @@ bool IOLoginDataSave::savePlayerDepotItems(const std::shared_ptr<Player> &player
 	return true;
 }
 
-bool IOLoginDataSave::saveRewardItems(const std::shared_ptr<Player> &player) {
+bool IOLoginDataSave::saveRewardItems(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
-	std::ostringstream query;
-	query << "DELETE FROM `player_rewards` WHERE `player_id` = " << player->getGUID();
-
-	if (!Database::getInstance().executeQuery(query.str())) {
-		return false;
-	}
-
 	std::vector<uint64_t> rewardList;
 	player->getRewardList(rewardList);
 
 	ItemRewardList rewardListItems;
-	if (!rewardList.empty()) {
-		for (const auto &rewardId : rewardList) {
-			auto reward = player->getReward(rewardId, false);
-			if (!reward->empty() && (getTimeMsNow() - rewardId <= 1000 * 60 * 60 * 24 * 7)) {
-				rewardListItems.emplace_back(0, reward);
-			}
+	for (const auto &rewardId : rewardList) {
+		auto reward = player->getReward(rewardId, false);
+		if (!reward->empty() && (getTimeMsNow() - rewardId <= 1000 * 60 * 60 * 24 * 7)) {
+			rewardListItems.emplace_back(0, reward);
 		}
+	}
 
-		DBInsert rewardQuery("INSERT INTO `player_rewards` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-		PropWriteStream propWriteStream;
-		if (!saveItems(player, rewardListItems, rewardQuery, propWriteStream)) {
-			return false;
-		}
+	if (!saveItemTable(player, snapshot, player->m_saveImage.rewards, player->m_saveImage.rewardRows, "player_rewards", rewardListItems)) {
+		return false;
 	}
 	return true;
 }
 
-bool IOLoginDataSave::savePlayerInbox(const std::shared_ptr<Player> &player) {
+bool IOLoginDataSave::savePlayerInbox(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
-	Database &db = Database::getInstance();
-	PropWriteStream propWriteStream;
 	ItemInboxList inboxList;
-	std::ostringstream query;
-	query << "DELETE FROM `player_inboxitems` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-	DBInsert inboxQuery("INSERT INTO `player_inboxitems` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES ");
-
 	for (const auto &item : player->getInbox()->getItemList()) {
 		inboxList.emplace_back(0, item);
 	}
 
-	if (!saveItems(player, inboxList, inboxQuery, propWriteStream)) {
+	if (!saveItemTable(player, snapshot, player->m_saveImage.inboxItems, player->m_saveImage.inboxItemRows, "player_inboxitems", inboxList)) {
 		return false;
 	}
 	return true;
 }
 
-bool IOLoginDataSave::savePlayerPreyClass(const std::shared_ptr<Player> &player) {
+bool IOLoginDataSave::savePlayerPreyClass(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
-	Database &db = Database::getInstance();
 	if (g_configManager().getBoolean(PREY_ENABLED)) {
-		std::ostringstream query;
+		const Database &db = Database::getInstance();
+		auto &rows = snapshot.addTable(player->m_saveImage.prey, "player_prey", { "slot" }, { "state", "raceid", "option", "bonus_type", "bonus_rarity", "bonus_percentage", "bonus_time", "free_reroll", "monster_list" });
 		for (uint8_t slotId = PreySlot_First; slotId <= PreySlot_Last; slotId++) {
 			if (const auto &slot = player->getPreySlotById(static_cast<PreySlot_t>(slotId))) {
-				query.str(std::string());
-				query << "INSERT INTO player_prey (`player_id`, `slot`, `state`, `raceid`, `option`, `bonus_type`, `bonus_rarity`, `bonus_percentage`, `bonus_time`, `free_reroll`, `monster_list`) "
-					  << "VALUES (" << player->getGUID() << ", "
-					  << static_cast<uint16_t>(slot->id) << ", "
-					  << static_cast<uint16_t>(slot->state) << ", "
-					  << slot->selectedRaceId << ", "
-					  << static_cast<uint16_t>(slot->option) << ", "
-					  << static_cast<uint16_t>(slot->bonus) << ", "
-					  << static_cast<uint16_t>(slot->bonusRarity) << ", "
-					  << slot->bonusPercentage << ", "
-					  << slot->bonusTimeLeft << ", "
-					  << slot->freeRerollTimeStamp << ", ";
-
 				PropWriteStream propPreyStream;
 				std::ranges::for_each(slot->raceIdList, [&propPreyStream](uint16_t raceId) {
 					propPreyStream.write<uint16_t>(raceId);
@@ -626,52 +604,24 @@ bool IOLoginDataSave::savePlayerPreyClass(const std::shared_ptr<Player> &player)
 
 				size_t preySize;
 				const char* preyList = propPreyStream.getStream(preySize);
-				query << db.escapeBlob(preyList, static_cast<uint32_t>(preySize)) << ")";
-
-				query << " ON DUPLICATE KEY UPDATE "
-					  << "`state` = VALUES(`state`), "
-					  << "`raceid` = VALUES(`raceid`), "
-					  << "`option` = VALUES(`option`), "
-					  << "`bonus_type` = VALUES(`bonus_type`), "
-					  << "`bonus_rarity` = VALUES(`bonus_rarity`), "
-					  << "`bonus_percentage` = VALUES(`bonus_percentage`), "
-					  << "`bonus_time` = VALUES(`bonus_time`), "
-					  << "`free_reroll` = VALUES(`free_reroll`), "
-					  << "`monster_list` = VALUES(`monster_list`)";
-
-				if (!db.executeQuery(query.str())) {
-					g_logger().warn("[IOLoginData::savePlayer] - Error saving prey slot data from player: {}", player->getName());
-					return false;
-				}
+				rows.push_back({ std::to_string(slotId), fmt::format("{},{},{},{},{},{},{},{},{}", static_cast<uint16_t>(slot->state), slot->selectedRaceId, static_cast<uint16_t>(slot->option), static_cast<uint16_t>(slot->bonus), slot->bonusRarity, slot->bonusPercentage, slot->bonusTimeLeft, slot->freeRerollTimeStamp, db.escapeBlob(preyList, static_cast<uint32_t>(preySize))) });
 			}
 		}
 	}
 	return true;
 }
 
-bool IOLoginDataSave::savePlayerTaskHuntingClass(const std::shared_ptr<Player> &player) {
+bool IOLoginDataSave::savePlayerTaskHuntingClass(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
-	Database &db = Database::getInstance();
 	if (g_configManager().getBoolean(TASK_HUNTING_ENABLED)) {
-		std::ostringstream query;
+		const Database &db = Database::getInstance();
+		auto &rows = snapshot.addTable(player->m_saveImage.taskHunting, "player_taskhunt", { "slot" }, { "state", "raceid", "upgrade", "rarity", "kills", "disabled_time", "free_reroll", "monster_list" });
 		for (uint8_t slotId = PreySlot_First; slotId <= PreySlot_Last; slotId++) {
 			if (const auto &slot = player->getTaskHuntingSlotById(static_cast<PreySlot_t>(slotId))) {
-				query.str("");
-				query << "INSERT INTO `player_taskhunt` (`player_id`, `slot`, `state`, `raceid`, `upgrade`, `rarity`, `kills`, `disabled_time`, `free_reroll`, `monster_list`) VALUES (";
-				query << player->getGUID() << ", ";
-				query << static_cast<uint16_t>(slot->id) << ", ";
-				query << static_cast<uint16_t>(slot->state) << ", ";
-				query << slot->selectedRaceId << ", ";
-				query << (slot->upgrade ? 1 : 0) << ", ";
-				query << static_cast<uint16_t>(slot->rarity) << ", ";
-				query << slot->currentKills << ", ";
-				query << slot->disabledUntilTimeStamp << ", ";
-				query << slot->freeRerollTimeStamp << ", ";
-
 				PropWriteStream propTaskHuntingStream;
 				std::ranges::for_each(slot->raceIdList, [&propTaskHuntingStream](uint16_t raceId) {
 					propTaskHuntingStream.write<uint16_t>(raceId);
@@ -679,77 +629,33 @@ bool IOLoginDataSave::savePlayerTaskHuntingClass(const std::shared_ptr<Player> &
 
 				size_t taskHuntingSize;
 				const char* taskHuntingList = propTaskHuntingStream.getStream(taskHuntingSize);
-				query << db.escapeBlob(taskHuntingList, static_cast<uint32_t>(taskHuntingSize)) << ")";
-
-				query << " ON DUPLICATE KEY UPDATE "
-					  << "`state` = VALUES(`state`), "
-					  << "`raceid` = VALUES(`raceid`), "
-					  << "`upgrade` = VALUES(`upgrade`), "
-					  << "`rarity` = VALUES(`rarity`), "
-					  << "`kills` = VALUES(`kills`), "
-					  << "`disabled_time` = VALUES(`disabled_time`), "
-					  << "`free_reroll` = VALUES(`free_reroll`), "
-					  << "`monster_list` = VALUES(`monster_list`)";
-
-				if (!db.executeQuery(query.str())) {
-					g_logger().warn("[IOLoginData::savePlayer] - Error saving task hunting slot data from player: {}", player->getName());
-					return false;
-				}
+				rows.push_back({ std::to_string(slotId), fmt::format("{},{},{},{},{},{},{},{}", static_cast<uint16_t>(slot->state), slot->selectedRaceId, static_cast<uint16_t>(slot->upgrade), slot->rarity, slot->currentKills, slot->disabledUntilTimeStamp, slot->freeRerollTimeStamp, db.escapeBlob(taskHuntingList, static_cast<uint32_t>(taskHuntingSize))) });
 			}
 		}
 	}
 	return true;
 }
 
-bool IOLoginDataSave::savePlayerForgeHistory(const std::shared_ptr<Player> &player) {
+bool IOLoginDataSave::savePlayerForgeHistory(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
-	std::ostringstream query;
-	query << "DELETE FROM `forge_history` WHERE `player_id` = " << player->getGUID();
-	if (!Database::getInstance().executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-	DBInsert insertQuery("INSERT INTO `forge_history` (`player_id`, `action_type`, `description`, `done_at`, `is_success`) VALUES");
+	const Database &db = Database::getInstance();
+	auto &rows = snapshot.addTable(player->m_saveImage.forgeHistory, "forge_history", {}, { "action_type", "description", "done_at", "is_success" });
 	for (const auto &history : player->getForgeHistory()) {
-		const auto stringDescription = Database::getInstance().escapeString(history.description);
-		auto actionString = magic_enum::enum_integer(history.actionType);
-		// Append query informations
-		query << player->getGUID() << ','
-			  << std::to_string(actionString) << ','
-			  << stringDescription << ','
-			  << history.createdAt << ','
-			  << history.success;
-
-		if (!insertQuery.addRow(query)) {
-			return false;
-		}
-	}
-	if (!insertQuery.execute()) {
-		return false;
+		rows.push_back({ {}, fmt::format("{},{},{},{}", magic_enum::enum_integer(history.actionType), db.escapeString(history.description), history.createdAt, static_cast<uint16_t>(history.success)) });
 	}
 	return true;
 }
 
-bool IOLoginDataSave::savePlayerBosstiary(const std::shared_ptr<Player> &player) {
+bool IOLoginDataSave::savePlayerBosstiary(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
-	std::ostringstream query;
-	query << "DELETE FROM `player_bosstiary` WHERE `player_id` = " << player->getGUID();
-	if (!Database::getInstance().executeQuery(query.str())) {
-		return false;
-	}
-
-	query.str("");
-	DBInsert insertQuery("INSERT INTO `player_bosstiary` (`player_id`, `bossIdSlotOne`, `bossIdSlotTwo`, `removeTimes`, `tracker`) VALUES");
-
 	// Bosstiary tracker
 	PropWriteStream stream;
 	for (const auto &monsterType : player->getCyclopediaMonsterTrackerSet(true)) {
@@ -761,51 +667,77 @@ bool IOLoginDataSave::savePlayerBosstiary(const std::shared_ptr<Player> &player)
 	}
 	size_t size;
 	const char* chars = stream.getStream(size);
-	// Append query informations
-	query << player->getGUID() << ','
-		  << player->getSlotBossId(1) << ','
-		  << player->getSlotBossId(2) << ','
-		  << std::to_string(player->getRemoveTimes()) << ','
-		  << Database::getInstance().escapeBlob(chars, static_cast<uint32_t>(size));
-
-	if (!insertQuery.addRow(query)) {
-		return false;
-	}
 
-	if (!insertQuery.execute()) {
+	auto &rows = snapshot.addTable(player->m_saveImage.bosstiary, "player_bosstiary", {}, { "bossIdSlotOne", "bossIdSlotTwo", "removeTimes", "tracker" });
+	rows.push_back({ {}, fmt::format("{},{},{},{}", player->getSlotBossId(1), player->getSlotBossId(2), player->getRemoveTimes(), Database::getInstance().escapeBlob(chars, static_cast<uint32_t>(size))) });
+	return true;
+}
+bool IOLoginDataSave::savePlayerStorage(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
+	if (!player) {
+		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
+	player->genReservedStorageRange();
+
+	auto &rows = snapshot.addTable(player->m_saveImage.storage, "player_storage", { "key" }, { "value" });
+	rows.reserve(player->storageMap.size());
+	for (const auto &[key, value] : player->storageMap) {
+		rows.push_back({ std::to_string(key), std::to_string(value) });
+	}
 	return true;
 }
 
-bool IOLoginDataSave::savePlayerStorage(const std::shared_ptr<Player> &player) {
+bool IOLoginDataSave::savePlayerWheel(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
-	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "DELETE FROM `player_storage` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
+	PropWriteStream stream;
+	player->wheel().serializeSlotPoints(stream);
+
+	size_t attributesSize;
+	const char* attributes = stream.getStream(attributesSize);
+	auto &rows = snapshot.addTable(player->m_saveImage.wheel, "player_wheeldata", {}, { "slot" });
+	if (attributesSize > 0) {
+		rows.push_back({ {}, Database::getInstance().escapeBlob(attributes, static_cast<uint32_t>(attributesSize)) });
 	}
 
-	query.str("");
+	// Gems, grades and scrolls live in the KV store, which has its own flush
+	player->wheel().saveRevealedGems();
+	player->wheel().saveActiveGems();
+	player->wheel().saveKVModGrades();
+	player->wheel().saveKVScrolls();
+	return true;
+}
+
+bool IOLoginDataSave::saveSnapshot(const PlayerSaveSnapshot &snapshot, size_t &rowsWritten) {
+	Database &db = Database::getInstance();
 
-	DBInsert storageQuery("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES ");
-	player->genReservedStorageRange();
+	const auto result = db.storeStatement("SELECT `save` FROM `players` WHERE `id` = ?", { snapshot.guid });
+	if (!result) {
+		g_logger().warn("[IOLoginData::savePlayer] - Error for select result query from player: {}", snapshot.name);
+		return false;
+	}
 
-	for (const auto &[key, value] : player->storageMap) {
-		query << player->getGUID() << ',' << key << ',' << value;
-		if (!storageQuery.addRow(query)) {
+	if (result->getNumber<uint16_t>(0) == 0) {
+		if (!db.executeStatement("UPDATE `players` SET `lastlogin` = ?, `lastip` = ? WHERE `id` = ?", { snapshot.lastLoginSaved, snapshot.lastIP, snapshot.guid })) {
 			return false;
 		}
+	} else if (!db.executeQuery(snapshot.playerQuery)) {
+		return false;
 	}
 
-	if (!storageQuery.execute()) {
+	if (!db.executeQuery(snapshot.bestiaryQuery)) {
+		g_logger().warn("[IOLoginData::savePlayer] - Error saving bestiary data from player: {}", snapshot.name);
 		return false;
 	}
+
+	for (const auto &table : snapshot.tables) {
+		if (!saveRows(snapshot, table, rowsWritten)) {
+			return false;
+		}
+	}
 	return true;
 }
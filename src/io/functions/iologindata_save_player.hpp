@@ -9,27 +9,71 @@
 
 #pragma once
 
+#include "database/database_table_image.hpp"
 #include "io/iologindata.hpp"
 
 class PropWriteStream;
-class DBInsert;
+
+/**
+ * @brief Everything a player save writes, taken on the dispatcher.
+ * Rows are already serialized to SQL literals, so the database work can run on any thread
+ * without reading the live player.
+ */
+struct PlayerSaveSnapshot {
+	struct Table {
+		DBTableImage* image;
+		std::string_view name;
+		std::vector<std::string> keyColumns;
+		std::vector<std::string> valueColumns;
+		// Shared with later snapshots of the same rows
+		std::shared_ptr<const std::vector<DBTableImage::Row>> rows;
+	};
+
+	std::vector<DBTableImage::Row> &addTable(DBTableImage &image, std::string_view name, std::vector<std::string> keyColumns, std::vector<std::string> valueColumns) {
+		auto rows = std::make_shared<std::vector<DBTableImage::Row>>();
+		auto &added = *rows;
+		addTable(image, name, std::move(keyColumns), std::move(valueColumns), std::move(rows));
+		return added;
+	}
+
+	void addTable(DBTableImage &image, std::string_view name, std::vector<std::string> keyColumns, std::vector<std::string> valueColumns, std::shared_ptr<const std::vector<DBTableImage::Row>> rows) {
+		tables.push_back({ &image, name, std::move(keyColumns), std::move(valueColumns), std::move(rows) });
+	}
+
+	// Owns the save images the tables point to, the writer reads nothing else from it
+	std::shared_ptr<Player> player;
+	uint64_t sequence = 0;
+	uint32_t guid = 0;
+	std::string name;
+
+	time_t lastLoginSaved = 0;
+	uint32_t lastIP = 0;
+	std::string playerQuery;
+	std::string bestiaryQuery;
+	std::vector<Table> tables;
+};
 
 class IOLoginDataSave : public IOLoginData {
 public:
-	static bool savePlayerFirst(const std::shared_ptr<Player> &player);
-	static bool savePlayerStash(const std::shared_ptr<Player> &player);
-	static bool savePlayerSpells(const std::shared_ptr<Player> &player);
-	static bool savePlayerKills(const std::shared_ptr<Player> &player);
-	static bool savePlayerBestiarySystem(const std::shared_ptr<Player> &player);
-	static bool savePlayerItem(const std::shared_ptr<Player> &player);
-	static bool savePlayerDepotItems(const std::shared_ptr<Player> &player);
-	static bool saveRewardItems(const std::shared_ptr<Player> &player);
-	static bool savePlayerInbox(const std::shared_ptr<Player> &player);
-	static bool savePlayerPreyClass(const std::shared_ptr<Player> &player);
-	static bool savePlayerTaskHuntingClass(const std::shared_ptr<Player> &player);
-	static bool savePlayerForgeHistory(const std::shared_ptr<Player> &player);
-	static bool savePlayerBosstiary(const std::shared_ptr<Player> &player);
-	static bool savePlayerStorage(const std::shared_ptr<Player> &player);
+	// Fill the snapshot from the live player, dispatcher only
+	static bool savePlayerFirst(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static bool savePlayerStash(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static bool savePlayerSpells(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static bool savePlayerKills(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static bool savePlayerBestiarySystem(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static bool savePlayerItem(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static bool savePlayerDepotItems(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static bool saveRewardItems(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static bool savePlayerInbox(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static bool savePlayerPreyClass(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static bool savePlayerTaskHuntingClass(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static bool savePlayerForgeHistory(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static bool savePlayerBosstiary(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static bool savePlayerWheel(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+	static bool savePlayerStorage(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
+
+	// Writes a snapshot, any thread, inside a transaction
+	static bool saveSnapshot(const PlayerSaveSnapshot &snapshot, size_t &rowsWritten);
 
 protected:
 	using ItemBlockList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
@@ -37,5 +81,16 @@ protected:
 	using ItemRewardList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
 	using ItemInboxList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
 
-	static bool saveItems(const std::shared_ptr<Player> &player, const ItemBlockList &itemList, DBInsert &query_insert, PropWriteStream &stream);
+	/**
+	 * @brief Writes a table of the snapshot, only what changed since its image was committed.
+	 * Rows whose key is gone are deleted and new or changed rows are upserted. The first save after
+	 * login, and tables without key columns, delete all rows of the player and insert them again.
+	 */
+	static bool saveRows(const PlayerSaveSnapshot &snapshot, const PlayerSaveSnapshot::Table &table, size_t &rowsWritten);
+	static bool saveItems(const std::shared_ptr<Player> &player, std::vector<DBTableImage::Row> &rows, const ItemBlockList &itemList, PropWriteStream &stream);
+	/**
+	 * @brief Adds an item table, serialized by saveItems unless the items and open containers are the
+	 * same as in the last snapshot, whose rows are then added again.
+	 */
+	static bool saveItemTable(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot, DBTableImage &image, DBSnapshotRows &last, std::string_view name, const ItemBlockList &itemList);
 };
@@ -36,11 +36,15 @@ void IOGuild::saveGuild(const std::shared_ptr<Guild> &guild) {
 	if (!guild) {
 		return;
 	}
+	saveGuildBalance(guild->getId(), guild->getBankBalance());
+}
+
+void IOGuild::saveGuildBalance(uint32_t guildId, uint64_t balance) {
 	Database &db = Database::getInstance();
 	std::ostringstream updateQuery;
 	updateQuery << "UPDATE `guilds` SET ";
-	updateQuery << "`balance` = " << guild->getBankBalance();
-	updateQuery << " WHERE `id` = " << guild->getId();
+	updateQuery << "`balance` = " << balance;
+	updateQuery << " WHERE `id` = " << guildId;
 	db.executeQuery(updateQuery.str());
 }
 
@@ -16,6 +16,7 @@ class IOGuild {
 public:
 	static std::shared_ptr<Guild> loadGuild(uint32_t guildId);
 	static void saveGuild(const std::shared_ptr<Guild> &guild);
+	static void saveGuildBalance(uint32_t guildId, uint64_t balance);
 	static uint32_t getGuildIdByName(const std::string &name);
 	static void getWarList(uint32_t guildId, GuildWarVector &guildWarVector);
 };
@@ -14,6 +14,7 @@
 #include "database/database.hpp"
 #include "io/functions/iologindata_load_player.hpp"
 #include "io/functions/iologindata_save_player.hpp"
+#include "kv/kv.hpp"
 #include "game/game.hpp"
 #include "creatures/monsters/monster.hpp"
 #include "creatures/players/player.hpp"
@@ -170,6 +171,9 @@ bool IOLoginData::loadPlayer(const std::shared_ptr<Player> &player, const DBResu
 			return true;
 		}
 
+		// key-value entries read by the systems below, in one query
+		g_kv().prefetch(fmt::format("player.{}.", player->getGUID()));
+
 		// load forge history
 		IOLoginDataLoad::loadPlayerForgeHistory(player, result);
 
@@ -190,94 +194,123 @@ bool IOLoginData::loadPlayer(const std::shared_ptr<Player> &player, const DBResu
 }
 
 bool IOLoginData::savePlayer(const std::shared_ptr<Player> &player) {
+	const auto snapshot = snapshotPlayer(player);
+	return snapshot && saveSnapshot(*snapshot);
+}
+
+std::shared_ptr<PlayerSaveSnapshot> IOLoginData::snapshotPlayer(const std::shared_ptr<Player> &player) {
+	metrics::method_latency measure(__METRICS_METHOD_NAME__);
 	try {
-		bool success = DBTransaction::executeWithinTransaction([player]() {
-			return savePlayerGuard(player);
+		auto snapshot = std::make_shared<PlayerSaveSnapshot>();
+		snapshotPlayerGuard(player, *snapshot);
+		return snapshot;
+	} catch (const DatabaseException &e) {
+		g_logger().error("[{}] Exception occurred: {}", __FUNCTION__, e.what());
+	}
+	return nullptr;
+}
+
+bool IOLoginData::saveSnapshot(const PlayerSaveSnapshot &snapshot) {
+	metrics::method_latency measure(__METRICS_METHOD_NAME__);
+	auto &saveImage = snapshot.player->m_saveImage;
+	std::scoped_lock lock(saveImage.mutex);
+	if (snapshot.sequence < saveImage.written) {
+		g_logger().debug("[{}] Skipping save of player {}, a newer snapshot was already written", __FUNCTION__, snapshot.name);
+		return true;
+	}
+
+	size_t rowsWritten = 0;
+	try {
+		bool success = DBTransaction::executeWithinTransaction([&snapshot, &rowsWritten]() {
+			return IOLoginDataSave::saveSnapshot(snapshot, rowsWritten);
 		});
 
-		if (!success) {
-			g_logger().error("[{}] Error occurred saving player", __FUNCTION__);
+		if (success) {
+			saveImage.written = snapshot.sequence;
+			g_metrics().addCounter("player_save_rows", static_cast<double>(rowsWritten));
+			return true;
 		}
 
-		return success;
+		g_logger().error("[{}] Error occurred saving player", __FUNCTION__);
 	} catch (const DatabaseException &e) {
 		g_logger().error("[{}] Exception occurred: {}", __FUNCTION__, e.what());
 	}
 
+	// The transaction was rolled back, the next save can't trust what this one recorded
+	saveImage.reset();
 	return false;
 }
 
-bool IOLoginData::savePlayerGuard(const std::shared_ptr<Player> &player) {
+void IOLoginData::snapshotPlayerGuard(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot) {
 	if (!player) {
 		throw DatabaseException("Player nullptr in function: " + std::string(__FUNCTION__));
 	}
 
-	if (!IOLoginDataSave::savePlayerFirst(player)) {
+	snapshot.player = player;
+	snapshot.sequence = ++player->m_saveImage.snapshots;
+	snapshot.guid = player->getGUID();
+	snapshot.name = player->getName();
+	snapshot.tables.reserve(15);
+
+	if (!IOLoginDataSave::savePlayerFirst(player, snapshot)) {
 		throw DatabaseException("[" + std::string(__FUNCTION__) + "] - Failed to save player first: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerStash(player)) {
+	if (!IOLoginDataSave::savePlayerStash(player, snapshot)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerFirst] - Failed to save player stash: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerSpells(player)) {
+	if (!IOLoginDataSave::savePlayerSpells(player, snapshot)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerSpells] - Failed to save player spells: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerKills(player)) {
+	if (!IOLoginDataSave::savePlayerKills(player, snapshot)) {
 		throw DatabaseException("IOLoginDataSave::savePlayerKills] - Failed to save player kills: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerBestiarySystem(player)) {
+	if (!IOLoginDataSave::savePlayerBestiarySystem(player, snapshot)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerBestiarySystem] - Failed to save player bestiary system: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerItem(player)) {
+	if (!IOLoginDataSave::savePlayerItem(player, snapshot)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerItem] - Failed to save player item: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerDepotItems(player)) {
+	if (!IOLoginDataSave::savePlayerDepotItems(player, snapshot)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerDepotItems] - Failed to save player depot items: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::saveRewardItems(player)) {
+	if (!IOLoginDataSave::saveRewardItems(player, snapshot)) {
 		throw DatabaseException("[IOLoginDataSave::saveRewardItems] - Failed to save player reward items: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerInbox(player)) {
+	if (!IOLoginDataSave::savePlayerInbox(player, snapshot)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerInbox] - Failed to save player inbox: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerPreyClass(player)) {
+	if (!IOLoginDataSave::savePlayerPreyClass(player, snapshot)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerPreyClass] - Failed to save player prey class: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerTaskHuntingClass(player)) {
+	if (!IOLoginDataSave::savePlayerTaskHuntingClass(player, snapshot)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerTaskHuntingClass] - Failed to save player task hunting class: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerForgeHistory(player)) {
+	if (!IOLoginDataSave::savePlayerForgeHistory(player, snapshot)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerForgeHistory] - Failed to save player forge history: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerBosstiary(player)) {
+	if (!IOLoginDataSave::savePlayerBosstiary(player, snapshot)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerBosstiary] - Failed to save player bosstiary: " + player->getName());
 	}
 
-	if (!player->wheel().saveDBPlayerSlotPointsOnLogout()) {
-		throw DatabaseException("[PlayerWheel::saveDBPlayerSlotPointsOnLogout] - Failed to save player wheel info: " + player->getName());
+	if (!IOLoginDataSave::savePlayerWheel(player, snapshot)) {
+		throw DatabaseException("[IOLoginDataSave::savePlayerWheel] - Failed to save player wheel info: " + player->getName());
 	}
 
-	player->wheel().saveRevealedGems();
-	player->wheel().saveActiveGems();
-	player->wheel().saveKVModGrades();
-	player->wheel().saveKVScrolls();
-
-	if (!IOLoginDataSave::savePlayerStorage(player)) {
+	if (!IOLoginDataSave::savePlayerStorage(player, snapshot)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerStorage] - Failed to save player storage: " + player->getName());
 	}
-
-	return true;
 }
 
 std::string IOLoginData::getNameByGuid(uint32_t guid) {
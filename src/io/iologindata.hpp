@@ -13,6 +13,8 @@ class Player;
 class Item;
 class DBResult;
 
+struct PlayerSaveSnapshot;
+
 struct VIPEntry;
 struct VIPGroupEntry;
 
@@ -26,6 +28,12 @@ public:
 	static bool loadPlayerByName(const std::shared_ptr<Player> &player, const std::string &name, bool disableIrrelevantInfo = true);
 	static bool loadPlayer(const std::shared_ptr<Player> &player, const std::shared_ptr<DBResult> &result, bool disableIrrelevantInfo = false);
 	static bool savePlayer(const std::shared_ptr<Player> &player);
+	/**
+	 * @brief Serializes what a save writes, on the dispatcher.
+	 * The snapshot can then be written with saveSnapshot from any thread.
+	 */
+	static std::shared_ptr<PlayerSaveSnapshot> snapshotPlayer(const std::shared_ptr<Player> &player);
+	static bool saveSnapshot(const PlayerSaveSnapshot &snapshot);
 	static uint32_t getGuidByName(const std::string &name);
 	static bool getGuidByNameEx(uint32_t &guid, bool &specialVip, std::string &name);
 	static std::string getNameByGuid(uint32_t guid);
@@ -45,5 +53,5 @@ public:
 	static void removeGuidVIPGroupEntry(uint32_t accountId, uint32_t guid);
 
 private:
-	static bool savePlayerGuard(const std::shared_ptr<Player> &player);
+	static void snapshotPlayerGuard(const std::shared_ptr<Player> &player, PlayerSaveSnapshot &snapshot);
 };
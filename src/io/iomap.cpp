@@ -80,6 +80,9 @@ void IOMap::loadMap(Map* map, const Position &pos) {
 
 		map->flush();
 
+		// Custom maps loaded later are indexed together with everything already loaded
+		map->buildDenseGrid();
+
 		g_logger().debug("Map Loaded {} ({}x{}) in {} milliseconds", map->path.filename().string(), map->width, map->height, bm_mapLoad.duration());
 	} catch (const std::exception &e) {
 		g_logger().error("Failed to load map: {}\nStacktrace: {}", e.what(), std::to_string(std::stacktrace::current()));
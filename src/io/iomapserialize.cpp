@@ -13,6 +13,49 @@
 #include "io/iologindata.hpp"
 #include "game/game.hpp"
 #include "items/bed.hpp"
+#include "utils/hash.hpp"
+
+namespace {
+	// What the last house save wrote, guarded by houseSaveMutex
+	std::mutex houseSaveMutex;
+	DBTableImage houseItemsImage;
+	uint64_t housesWritten = 0;
+
+	// The tile rows of each house in the last snapshot, with the signature of the tiles they came from, dispatcher only
+	struct SnapshotTiles {
+		size_t signature = 0;
+		std::shared_ptr<const std::vector<std::string>> tiles;
+	};
+	phmap::flat_hash_map<uint32_t, SnapshotTiles> houseTilesSnapshots;
+
+	// Covers every item saveTile could write, the tile version alone misses container contents and attributes
+	size_t houseTilesSignature(const std::shared_ptr<House> &house) {
+		size_t signature = house->getTiles().size();
+		for (const auto &tile : house->getTiles()) {
+			stdext::hash_combine(signature, tile->getVersion());
+			if (const TileItemVector* tileItems = tile->getItemList()) {
+				for (const auto &item : *tileItems) {
+					stdext::hash_union(signature, item->getSaveSignature());
+				}
+			}
+		}
+		return signature;
+	}
+
+	// The image compares one row per house, keyed by its id, by a hash over all of its tile rows
+	std::vector<DBTableImage::Row> houseItemsRows(const HouseSaveSnapshot &snapshot) {
+		std::vector<DBTableImage::Row> rows;
+		rows.reserve(snapshot.items.size());
+		for (const auto &house : snapshot.items) {
+			uint64_t hash = house.tiles->size();
+			for (const auto &tile : *house.tiles) {
+				hash ^= std::hash<std::string_view> {}(tile) + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+			}
+			rows.push_back({ std::to_string(house.houseId), std::to_string(hash) });
+		}
+		return rows;
+	}
+}
 
 void IOMapSerialize::loadHouseItems(Map* map) {
 	Benchmark bm_context;
@@ -62,43 +105,54 @@ void IOMapSerialize::loadHouseItems(Map* map) {
 	g_logger().info("Loaded house items in {} milliseconds", bm_context.duration());
 }
 
-bool IOMapSerialize::saveHouseItems() {
-	const bool success = DBTransaction::executeWithinTransaction([]() {
-		return SaveHouseItemsGuard();
-	});
-
-	if (!success) {
-		g_logger().error("[{}] Error occurred saving houses", __FUNCTION__);
+bool IOMapSerialize::SaveHouseItemsGuard(const HouseSaveSnapshot &snapshot) {
+	Database &db = Database::getInstance();
+	const auto rows = houseItemsRows(snapshot);
+	const auto changes = houseItemsImage.diff(rows, true);
+	if (changes.empty()) {
+		return true;
 	}
 
-	return success;
-}
-
-bool IOMapSerialize::SaveHouseItemsGuard() {
-	Database &db = Database::getInstance();
-	std::ostringstream query;
+	if (changes.rewrite) {
+		// clear old tile data
+		if (!db.executeQuery("DELETE FROM `tile_store`")) {
+			return false;
+		}
+	} else {
+		// tile_store has no key of its own, a changed house gets all of its tiles replaced
+		std::string houseIds;
+		for (const auto index : changes.upserts) {
+			houseIds += fmt::format("{}{}", houseIds.empty() ? "" : ",", rows[index].key);
+		}
+		for (const auto &houseId : changes.deletes) {
+			houseIds += fmt::format("{}{}", houseIds.empty() ? "" : ",", houseId);
+		}
 
-	// clear old tile data
-	if (!db.executeQuery("DELETE FROM `tile_store`")) {
-		return false;
+		if (!db.executeQuery(fmt::format("DELETE FROM `tile_store` WHERE `house_id` IN ({})", houseIds))) {
+			return false;
+		}
 	}
 
 	DBInsert stmt("INSERT INTO `tile_store` (`house_id`, `data`) VALUES ");
+	const auto addTiles = [&stmt](const HouseSaveSnapshot::HouseItems &house) {
+		for (const auto &tile : *house.tiles) {
+			if (!stmt.addRow(tile)) {
+				return false;
+			}
+		}
+		return true;
+	};
 
-	PropWriteStream stream;
-	for (const auto &house : g_game().map.houses.getHouses() | std::views::values) {
-		// save house items
-		for (const auto &tile : house->getTiles()) {
-			saveTile(stream, tile);
-
-			size_t attributesSize;
-			const char* attributes = stream.getStream(attributesSize);
-			if (attributesSize > 0) {
-				query << house->getId() << ',' << db.escapeBlob(attributes, attributesSize);
-				if (!stmt.addRow(query)) {
-					return false;
-				}
-				stream.clear();
+	if (changes.rewrite) {
+		for (const auto &house : snapshot.items) {
+			if (!addTiles(house)) {
+				return false;
+			}
+		}
+	} else {
+		for (const auto index : changes.upserts) {
+			if (!addTiles(snapshot.items[index])) {
+				return false;
 			}
 		}
 	}
@@ -107,6 +161,7 @@ bool IOMapSerialize::SaveHouseItemsGuard() {
 		return false;
 	}
 
+	houseItemsImage.commit(rows, true);
 	return true;
 }
 
@@ -365,29 +420,97 @@ bool IOMapSerialize::loadHouseInfo() {
 	return true;
 }
 
-bool IOMapSerialize::saveHouseInfo() {
-	const bool success = DBTransaction::executeWithinTransaction([]() {
-		return SaveHouseInfoGuard();
-	});
+std::shared_ptr<HouseSaveSnapshot> IOMapSerialize::snapshotHouses() {
+	static std::atomic<uint64_t> snapshots = 0;
 
-	if (!success) {
+	const Database &db = Database::getInstance();
+	auto snapshot = std::make_shared<HouseSaveSnapshot>();
+	snapshot->sequence = ++snapshots;
+
+	PropWriteStream stream;
+	for (const auto &house : g_game().map.houses.getHouses() | std::views::values) {
+		auto stateValue = magic_enum::enum_integer(house->getState());
+		snapshot->infoRows.emplace_back(fmt::format("{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{}", house->getId(), house->getOwner(), house->getPaidUntil(), house->getPayRentWarnings(), db.escapeString(house->getName()), house->getTownId(), house->getRent(), house->getSize(), house->getBedCount(), house->getBidder(), db.escapeString(house->getBidderName()), house->getHighestBid(), house->getInternalBid(), house->getBidEndDate(), std::to_string(stateValue), (house->getTransferStatus() ? 1 : 0)));
+
+		std::string listText;
+		if (house->getAccessList(GUEST_LIST, listText) && !listText.empty()) {
+			snapshot->listRows.emplace_back(fmt::format("{},{},{}", house->getId(), GUEST_LIST, db.escapeString(listText)));
+			listText.clear();
+		}
+
+		if (house->getAccessList(SUBOWNER_LIST, listText) && !listText.empty()) {
+			snapshot->listRows.emplace_back(fmt::format("{},{},{}", house->getId(), SUBOWNER_LIST, db.escapeString(listText)));
+			listText.clear();
+		}
+
+		for (const std::shared_ptr<Door> &door : house->getDoors()) {
+			if (door->getAccessList(listText) && !listText.empty()) {
+				snapshot->listRows.emplace_back(fmt::format("{},{},{}", house->getId(), door->getDoorId(), db.escapeString(listText)));
+				listText.clear();
+			}
+		}
+
+		// save house items, serialized again only when one of its tiles changed
+		auto &last = houseTilesSnapshots[house->getId()];
+		const auto signature = houseTilesSignature(house);
+		if (!last.tiles || last.signature != signature) {
+			auto tiles = std::make_shared<std::vector<std::string>>();
+			for (const auto &tile : house->getTiles()) {
+				saveTile(stream, tile);
+
+				size_t attributesSize;
+				const char* attributes = stream.getStream(attributesSize);
+				if (attributesSize > 0) {
+					tiles->emplace_back(fmt::format("{},{}", house->getId(), db.escapeBlob(attributes, static_cast<uint32_t>(attributesSize))));
+					stream.clear();
+				}
+			}
+			last = { signature, std::move(tiles) };
+		}
+
+		if (!last.tiles->empty()) {
+			snapshot->items.push_back({ house->getId(), last.tiles });
+		}
+	}
+	return snapshot;
+}
+
+bool IOMapSerialize::saveHouses(const HouseSaveSnapshot &snapshot) {
+	std::scoped_lock lock(houseSaveMutex);
+	if (snapshot.sequence < housesWritten) {
+		g_logger().debug("[{}] Skipping houses save, a newer snapshot was already written", __FUNCTION__);
+		return true;
+	}
+
+	const bool infoSaved = DBTransaction::executeWithinTransaction([&snapshot]() {
+		return SaveHouseInfoGuard(snapshot);
+	});
+	if (!infoSaved) {
 		g_logger().error("[{}] Error occurred saving houses info", __FUNCTION__);
+		return false;
 	}
 
-	return success;
+	const bool itemsSaved = DBTransaction::executeWithinTransaction([&snapshot]() {
+		return SaveHouseItemsGuard(snapshot);
+	});
+	if (!itemsSaved) {
+		g_logger().error("[{}] Error occurred saving houses", __FUNCTION__);
+		// Rolled back, the next save can't trust what this one recorded
+		houseItemsImage.reset();
+		return false;
+	}
+
+	housesWritten = snapshot.sequence;
+	return true;
 }
 
-bool IOMapSerialize::SaveHouseInfoGuard() {
+bool IOMapSerialize::SaveHouseInfoGuard(const HouseSaveSnapshot &snapshot) {
 	Database &db = Database::getInstance();
 
-	std::ostringstream query;
 	DBInsert houseUpdate("INSERT INTO `houses` (`id`, `owner`, `paid`, `warnings`, `name`, `town_id`, `rent`, `size`, `beds`, `bidder`, `bidder_name`, `highest_bid`, `internal_bid`, `bid_end_date`, `state`, `transfer_status`) VALUES ");
 	houseUpdate.upsert({ "owner", "paid", "warnings", "name", "town_id", "rent", "size", "beds", "bidder", "bidder_name", "highest_bid", "internal_bid", "bid_end_date", "state", "transfer_status" });
 
-	for (const auto &house : g_game().map.houses.getHouses() | std::views::values) {
-		auto stateValue = magic_enum::enum_integer(house->getState());
-		std::string values = fmt::format("{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{}", house->getId(), house->getOwner(), house->getPaidUntil(), house->getPayRentWarnings(), db.escapeString(house->getName()), house->getTownId(), house->getRent(), house->getSize(), house->getBedCount(), house->getBidder(), db.escapeString(house->getBidderName()), house->getHighestBid(), house->getInternalBid(), house->getBidEndDate(), std::to_string(stateValue), (house->getTransferStatus() ? 1 : 0));
-
+	for (const auto &values : snapshot.infoRows) {
 		if (!houseUpdate.addRow(values)) {
 			return false;
 		}
@@ -401,35 +524,9 @@ bool IOMapSerialize::SaveHouseInfoGuard() {
 	listUpdate.upsert({ "list", "version" });
 	auto version = getTimeUsNow();
 
-	for (const auto &house : g_game().map.houses.getHouses() | std::views::values) {
-		std::string listText;
-		if (house->getAccessList(GUEST_LIST, listText) && !listText.empty()) {
-			query << house->getId() << ',' << GUEST_LIST << ',' << db.escapeString(listText) << ',' << version;
-			if (!listUpdate.addRow(query)) {
-				return false;
-			}
-
-			listText.clear();
-		}
-
-		if (house->getAccessList(SUBOWNER_LIST, listText) && !listText.empty()) {
-			query << house->getId() << ',' << SUBOWNER_LIST << ',' << db.escapeString(listText) << ',' << version;
-			if (!listUpdate.addRow(query)) {
-				return false;
-			}
-
-			listText.clear();
-		}
-
-		for (const std::shared_ptr<Door> &door : house->getDoors()) {
-			if (door->getAccessList(listText) && !listText.empty()) {
-				query << house->getId() << ',' << door->getDoorId() << ',' << db.escapeString(listText) << ',' << version;
-				if (!listUpdate.addRow(query)) {
-					return false;
-				}
-
-				listText.clear();
-			}
+	for (const auto &values : snapshot.listRows) {
+		if (!listUpdate.addRow(fmt::format("{},{}", values, version))) {
+			return false;
 		}
 	}
 
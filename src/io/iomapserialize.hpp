@@ -9,16 +9,34 @@
 
 #pragma once
 
+#include "database/database_table_image.hpp"
+
+/**
+ * @brief House rows serialized on the dispatcher, written by IOMapSerialize::saveHouses from any thread.
+ */
+struct HouseSaveSnapshot {
+	uint64_t sequence = 0;
+	std::vector<std::string> infoRows;
+	// House id, list id and list, the version is added when written
+	std::vector<std::string> listRows;
+	// The tile_store rows of one house, one per tile holding items, shared with later snapshots while the house is unchanged
+	struct HouseItems {
+		uint32_t houseId = 0;
+		std::shared_ptr<const std::vector<std::string>> tiles;
+	};
+	std::vector<HouseItems> items;
+};
+
 class IOMapSerialize {
 public:
 	static void loadHouseItems(Map* map);
-	static bool saveHouseItems();
 	static bool loadHouseInfo();
-	static bool saveHouseInfo();
+	static std::shared_ptr<HouseSaveSnapshot> snapshotHouses();
+	static bool saveHouses(const HouseSaveSnapshot &snapshot);
 
 private:
-	static bool SaveHouseInfoGuard();
-	static bool SaveHouseItemsGuard();
+	static bool SaveHouseInfoGuard(const HouseSaveSnapshot &snapshot);
+	static bool SaveHouseItemsGuard(const HouseSaveSnapshot &snapshot);
 	static void saveItem(PropWriteStream &stream, const std::shared_ptr<Item> &item);
 	static void saveTile(PropWriteStream &stream, const std::shared_ptr<Tile> &tile);
 
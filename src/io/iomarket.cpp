@@ -63,13 +63,13 @@ MarketOfferList IOMarket::getActiveOffers(MarketAction_t action) {
 	return offerList;
 }
 
-MarketOfferList IOMarket::getActiveOffers(MarketAction_t action, uint16_t itemId, uint8_t tier) {
+MarketOfferList IOMarket::getActiveOffers(MarketAction_t action, uint16_t itemId, uint8_t tier, DBTarget target /* = DBTarget::Primary*/) {
 	MarketOfferList offerList;
 
 	std::ostringstream query;
 	query << "SELECT `id`, `amount`, `price`, `tier`, `created`, `anonymous`, (SELECT `name` FROM `players` WHERE `id` = `player_id`) AS `player_name` FROM `market_offers` WHERE `sale` = " << action << " AND `itemtype` = " << itemId << " AND `tier` = " << std::to_string(tier);
 
-	DBResult_ptr result = Database::getInstance().storeQuery(query.str());
+	DBResult_ptr result = Database::getInstance().storeQuery(query.str(), target);
 	if (!result) {
 		return offerList;
 	}
@@ -351,7 +351,7 @@ void IOMarket::updateStatistics() {
 		OFFERSTATE_ACCEPTED
 	);
 
-	DBResult_ptr result = g_database().storeQuery(query);
+	DBResult_ptr result = g_database().storeQuery(query, DBTarget::Replica);
 	if (!result) {
 		return;
 	}
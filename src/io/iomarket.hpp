@@ -22,7 +22,7 @@ public:
 	}
 
 	static MarketOfferList getActiveOffers(MarketAction_t action);
-	static MarketOfferList getActiveOffers(MarketAction_t action, uint16_t itemId, uint8_t tier);
+	static MarketOfferList getActiveOffers(MarketAction_t action, uint16_t itemId, uint8_t tier, DBTarget target = DBTarget::Primary);
 	static MarketOfferList getOwnOffers(MarketAction_t action, uint32_t playerId);
 	static HistoryMarketOfferList getOwnHistory(MarketAction_t action, uint32_t playerId);
 
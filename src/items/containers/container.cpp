@@ -13,6 +13,8 @@
 #include "creatures/players/player.hpp"
 #include "game/game.hpp"
 #include "map/spectators.hpp"
+#include "utils/hash.hpp"
+#include "utils/slab_allocator.hpp"
 
 Container::Container(uint16_t type) :
 	Container(type, items[type].maxItems) {
@@ -37,11 +39,11 @@ Container::Container(uint16_t initType, uint16_t initSize, bool initUnlocked /*=
 	pagination(initPagination) { }
 
 std::shared_ptr<Container> Container::create(uint16_t type) {
-	return std::make_shared<Container>(type);
+	return makeSlabShared<Container>(type);
 }
 
 std::shared_ptr<Container> Container::create(uint16_t type, uint16_t size, bool unlocked /*= true*/, bool pagination /*= false*/) {
-	return std::make_shared<Container>(type, size, unlocked, pagination);
+	return makeSlabShared<Container>(type, size, unlocked, pagination);
 }
 
 std::shared_ptr<Container> Container::createBrowseField(const std::shared_ptr<Tile> &tile) {
@@ -179,6 +181,15 @@ Attr_ReadValue Container::readAttr(AttrTypes_t attr, PropStream &propStream) {
 	return Item::readAttr(attr, propStream);
 }
 
+size_t Container::getSaveSignature() const {
+	auto signature = Item::getSaveSignature();
+	stdext::hash_combine(signature, itemlist.size());
+	for (const auto &item : itemlist) {
+		stdext::hash_union(signature, item->getSaveSignature());
+	}
+	return signature;
+}
+
 bool Container::unserializeItemNode(OTB::Loader &loader, const OTB::Node &node, PropStream &propStream, Position &itemPosition) {
 	const bool ret = Item::unserializeItemNode(loader, node, propStream, itemPosition);
 	if (!ret) {
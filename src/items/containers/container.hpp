@@ -194,6 +194,7 @@ public:
 
 	Attr_ReadValue readAttr(AttrTypes_t attr, PropStream &propStream) override;
 	bool unserializeItemNode(OTB::Loader &loader, const OTB::Node &node, PropStream &propStream, Position &itemPosition) override;
+	size_t getSaveSignature() const override;
 	std::string getContentDescription(bool oldProtocol);
 
 	uint32_t getMaxCapacity() const;
@@ -11,6 +11,7 @@
 
 #include "enums/item_attribute.hpp"
 #include "items/functions/item/custom_attribute.hpp"
+#include "utils/slab_allocator.hpp"
 
 class ItemAttributeHelper {
 public:
@@ -127,6 +128,19 @@ class ItemAttribute : public ItemAttributeHelper {
 public:
 	ItemAttribute() = default;
 
+	// Owned through unique_ptr by every item with attributes, so blocks come from the slabs
+	static void* operator new(size_t size) {
+		return SlabSizeClass::fits(size, alignof(ItemAttribute)) ? SlabSizeClass::get(size).allocate() : ::operator new(size);
+	}
+
+	static void operator delete(void* p, size_t size) noexcept {
+		if (SlabSizeClass::fits(size, alignof(ItemAttribute))) {
+			SlabSizeClass::get(size).deallocate(p);
+		} else {
+			::operator delete(p);
+		}
+	}
+
 	// CustomAttribute map methods
 	const std::map<std::string, CustomAttribute, std::less<>> &getCustomAttributeMap() const;
 	// CustomAttribute object methods
@@ -27,6 +27,8 @@
 #include "items/trashholder.hpp"
 #include "lua/creature/actions.hpp"
 #include "map/house/house.hpp"
+#include "utils/hash.hpp"
+#include "utils/slab_allocator.hpp"
 
 #define ITEM_IMBUEMENT_SLOT 500
 
@@ -56,29 +58,29 @@ std::shared_ptr<Item> Item::CreateItem(const uint16_t type, uint16_t count /*= 0
 
 	if (it.id != 0) {
 		if (it.isDepot()) {
-			newItem = std::make_shared<DepotLocker>(type, 4);
+			newItem = makeSlabShared<DepotLocker>(type, 4);
 		} else if (it.isRewardChest()) {
-			newItem = std::make_shared<RewardChest>(type);
+			newItem = makeSlabShared<RewardChest>(type);
 		} else if (it.isContainer()) {
-			newItem = std::make_shared<Container>(type);
+			newItem = makeSlabShared<Container>(type);
 		} else if (it.isTeleport()) {
-			newItem = std::make_shared<Teleport>(type);
+			newItem = makeSlabShared<Teleport>(type);
 		} else if (it.isMagicField()) {
-			newItem = std::make_shared<MagicField>(type);
+			newItem = makeSlabShared<MagicField>(type);
 		} else if (it.isDoor()) {
-			newItem = std::make_shared<Door>(type);
+			newItem = makeSlabShared<Door>(type);
 		} else if (it.isTrashHolder()) {
-			newItem = std::make_shared<TrashHolder>(type);
+			newItem = makeSlabShared<TrashHolder>(type);
 		} else if (it.isMailbox()) {
-			newItem = std::make_shared<Mailbox>(type);
+			newItem = makeSlabShared<Mailbox>(type);
 		} else if (it.isBed()) {
-			newItem = std::make_shared<BedItem>(type);
+			newItem = makeSlabShared<BedItem>(type);
 		} else {
 			const auto itemMap = ItemTransformationMap.find(static_cast<ItemID_t>(it.id));
 			if (itemMap != ItemTransformationMap.end()) {
-				newItem = std::make_shared<Item>(itemMap->second, count);
+				newItem = makeSlabShared<Item>(itemMap->second, count);
 			} else {
-				newItem = std::make_shared<Item>(type, count);
+				newItem = makeSlabShared<Item>(type, count);
 			}
 		}
 	} else if (type > 0 && itemPosition) {
@@ -242,7 +244,7 @@ std::shared_ptr<Container> Item::CreateItemAsContainer(const uint16_t type, uint
 		return nullptr;
 	}
 
-	auto newItem = std::make_shared<Container>(type, size);
+	auto newItem = makeSlabShared<Container>(type, size);
 	return newItem;
 }
 
@@ -311,6 +313,7 @@ Item::Item(const std::shared_ptr<Item> &i) :
 	Thing(), id(i->id), count(i->count), loadedFromMap(i->loadedFromMap) {
 	if (i->attributePtr) {
 		attributePtr = std::make_unique<ItemAttribute>(*i->attributePtr);
+		touchRevision();
 	}
 }
 
@@ -323,6 +326,7 @@ std::shared_ptr<Item> Item::clone() const {
 
 	if (attributePtr) {
 		item->attributePtr = std::make_unique<ItemAttribute>(*attributePtr);
+		item->touchRevision();
 	}
 
 	return item;
@@ -1124,6 +1128,19 @@ void Item::serializeAttr(PropWriteStream &propWriteStream) const {
 	}
 }
 
+size_t Item::getSaveSignature() const {
+	size_t signature = 0;
+	stdext::hash_combine(signature, id);
+	stdext::hash_combine(signature, count);
+	stdext::hash_combine(signature, getRevision());
+	if (const auto decayState = getDecaying();
+	    decayState == DECAYING_TRUE || decayState == DECAYING_STOPPING) {
+		// getDuration counts down from the clock, the same millisecond writes the same duration
+		stdext::hash_combine(signature, static_cast<uint64_t>(OTSYS_TIME()));
+	}
+	return signature;
+}
+
 void Item::setOwner(const std::shared_ptr<Creature> &owner) {
 	auto ownerId = owner->getID();
 	if (owner->getPlayer()) {
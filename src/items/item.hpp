@@ -57,12 +57,14 @@ public:
 	void removeAttribute(ItemAttribute_t type) const {
 		if (attributePtr) {
 			attributePtr->removeAttribute(type);
+			touchRevision();
 		}
 	}
 
 	template <typename GenericAttribute>
 	void setAttribute(ItemAttribute_t type, GenericAttribute genericAttribute) {
 		initAttributePtr()->setAttribute(type, genericAttribute);
+		touchRevision();
 	}
 
 	bool isAttributeInteger(ItemAttribute_t type) const {
@@ -86,10 +88,12 @@ public:
 	template <typename GenericType>
 	void setCustomAttribute(const std::string &key, GenericType value) {
 		initAttributePtr()->setCustomAttribute(key, value);
+		touchRevision();
 	}
 
 	void addCustomAttribute(const std::string &key, const CustomAttribute &customAttribute) {
 		initAttributePtr()->addCustomAttribute(key, customAttribute);
+		touchRevision();
 	}
 
 	bool hasCustomAttribute() const {
@@ -101,6 +105,7 @@ public:
 			return false;
 		}
 
+		touchRevision();
 		return attributePtr->removeCustomAttribute(attributeName);
 	}
 
@@ -147,7 +152,21 @@ public:
 
 	std::string getShader() const;
 
+	/**
+	 * @brief Changes whenever an attribute is set or removed.
+	 * Drawn from a single counter, so two items only share a revision when neither was ever given an attribute.
+	 */
+	[[nodiscard]] uint64_t getRevision() const {
+		return revision;
+	}
+
 protected:
+	// For state an item serializes outside of its attributes
+	void touchRevision() const {
+		static std::atomic_uint64_t revisions = 0;
+		revision = revisions.fetch_add(1, std::memory_order_relaxed) + 1;
+	}
+
 	std::unique_ptr<ItemAttribute> &initAttributePtr() {
 		if (!attributePtr) {
 			attributePtr = std::make_unique<ItemAttribute>();
@@ -198,6 +217,7 @@ protected:
 
 private:
 	std::unique_ptr<ItemAttribute> attributePtr;
+	mutable uint64_t revision = 0;
 
 	friend class Item;
 };
@@ -308,6 +328,11 @@ public:
 	virtual bool unserializeItemNode(OTB::Loader &, const OTB::Node &, PropStream &propStream, Position &itemPosition);
 
 	virtual void serializeAttr(PropWriteStream &propWriteStream) const;
+	/**
+	 * @brief Sums up what serializeAttr writes, and for containers the items inside.
+	 * Equal signatures serialize alike, a decaying item never matches an earlier one as its duration runs down.
+	 */
+	virtual size_t getSaveSignature() const;
 
 	bool isPushable() final {
 		return isMovable();
@@ -1025,7 +1025,9 @@ void Tile::addThing(int32_t, const std::shared_ptr<Thing> &thing) {
 
 	const auto &creature = thing->getCreature();
 	if (creature) {
-		Spectators::clearCache();
+		if (const auto sector = g_game().map.getMapSector(tilePos.x, tilePos.y)) {
+			sector->updateCreature(creature, tilePos);
+		}
 		creature->setParent(static_self_cast<Tile>());
 
 		CreatureVector* creatures = makeCreatures();
@@ -1036,6 +1038,8 @@ void Tile::addThing(int32_t, const std::shared_ptr<Thing> &thing) {
 			return /*RETURNVALUE_NOTPOSSIBLE*/;
 		}
 
+		touch();
+
 		TileItemVector* items = getItemList();
 		if (items && items->size() >= 0xFFFF) {
 			return /*RETURNVALUE_NOTPOSSIBLE*/;
@@ -1136,6 +1140,8 @@ void Tile::updateThing(const std::shared_ptr<Thing> &thing, uint16_t itemId, uin
 		return /*RETURNVALUE_NOTPOSSIBLE*/;
 	}
 
+	touch();
+
 	const int32_t index = getThingIndex(thing);
 	if (index == -1) {
 		return /*RETURNVALUE_NOTPOSSIBLE*/;
@@ -1167,6 +1173,8 @@ void Tile::replaceThing(uint32_t index, const std::shared_ptr<Thing> &thing) {
 		return /*RETURNVALUE_NOTPOSSIBLE*/;
 	}
 
+	touch();
+
 	std::shared_ptr<Item> oldItem = nullptr;
 	bool isInserted = false;
 
@@ -1241,7 +1249,7 @@ void Tile::removeThing(const std::shared_ptr<Thing> &thing, uint32_t count) {
 		if (creatures) {
 			const auto it = std::ranges::find(*creatures, thing);
 			if (it != creatures->end()) {
-				Spectators::clearCache();
+				Spectators::invalidate(tilePos);
 				creatures->erase(it);
 			}
 		}
@@ -1253,6 +1261,8 @@ void Tile::removeThing(const std::shared_ptr<Thing> &thing, uint32_t count) {
 		return;
 	}
 
+	touch();
+
 	const int32_t index = getThingIndex(item);
 	if (index == -1) {
 		return;
@@ -1639,6 +1649,7 @@ void Tile::internalAddThing(uint32_t, const std::shared_ptr<Thing> &thing) {
 	if (!thing) {
 		return;
 	}
+
 	for (const auto &zone : getZones()) {
 		zone->thingAdded(thing);
 	}
@@ -1647,7 +1658,9 @@ void Tile::internalAddThing(uint32_t, const std::shared_ptr<Thing> &thing) {
 
 	const auto &creature = thing->getCreature();
 	if (creature) {
-		Spectators::clearCache();
+		if (const auto sector = g_game().map.getMapSector(tilePos.x, tilePos.y)) {
+			sector->updateCreature(creature, tilePos);
+		}
 
 		CreatureVector* creatures = makeCreatures();
 		creatures->insert(creatures->begin(), creature);
@@ -1657,6 +1670,8 @@ void Tile::internalAddThing(uint32_t, const std::shared_ptr<Thing> &thing) {
 			return;
 		}
 
+		touch();
+
 		const ItemType &itemType = Item::items[item->getID()];
 		if (itemType.isGroundTile()) {
 			if (ground == nullptr) {
@@ -1698,7 +1713,16 @@ void Tile::updateTileFlags(const std::shared_ptr<Item> &item) {
 	setTileFlags(item);
 }
 
+void Tile::onTileFlagsChanged() const {
+	// Walkability changed, cached paths crossing this sector are no longer valid
+	if (const auto sector = g_game().map.getMapSector(tilePos.x, tilePos.y)) {
+		sector->touchTiles();
+	}
+}
+
 void Tile::setTileFlags(const std::shared_ptr<Item> &item) {
+	const auto previousFlags = flags;
+
 	if (!hasFlag(TILESTATE_FLOORCHANGE)) {
 		const auto &it = Item::items[item->getID()];
 		if (it.floorChange != 0) {
@@ -1783,9 +1807,15 @@ void Tile::setTileFlags(const std::shared_ptr<Item> &item) {
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		setFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	if (flags != previousFlags) {
+		onTileFlagsChanged();
+	}
 }
 
 void Tile::resetTileFlags(const std::shared_ptr<Item> &item) {
+	const auto previousFlags = flags;
+
 	const ItemType &it = Item::items[item->getID()];
 	if (it.floorChange != 0) {
 		resetFlag(TILESTATE_FLOORCHANGE);
@@ -1864,6 +1894,10 @@ void Tile::resetTileFlags(const std::shared_ptr<Item> &item) {
 	if (item->hasProperty(CONST_PROP_SUPPORTHANGABLE)) {
 		resetFlag(TILESTATE_SUPPORTS_HANGABLE);
 	}
+
+	if (flags != previousFlags) {
+		onTileFlagsChanged();
+	}
 }
 
 bool Tile::isMovableBlocking() const {
@@ -22,6 +22,7 @@ class Zone;
 class Cylinder;
 class Item;
 class ItemType;
+class TileItemsEncoding;
 
 using CreatureVector = std::vector<std::shared_ptr<Creature>>;
 using ItemVector = std::vector<std::shared_ptr<Item>>;
@@ -250,6 +251,7 @@ public:
 		return ground;
 	}
 	void setGround(const std::shared_ptr<Item> &item) {
+		touch();
 		if (ground) {
 			resetTileFlags(ground);
 		}
@@ -262,21 +264,75 @@ public:
 	// This method maintains safety in asynchronous calls, avoiding competition between threads.
 	void safeCall(std::function<void(void)> &&action) const;
 
+	/**
+	 * @brief Changes whenever the items clients see on this tile change.
+	 * Drawn from a single counter, so no two tiles ever share a version and an
+	 * encoding cached for a version stays valid for as long as the tile keeps it.
+	 * Creatures coming and going leave it alone, they are never part of those encodings.
+	 */
+	[[nodiscard]] uint32_t getVersion() const {
+		return version;
+	}
+
+	/**
+	 * @brief Gives the tile a new version, for changes made to its items in place.
+	 */
+	void touch() {
+		version = nextVersion();
+		staticItems = false;
+		staticEncoding = nullptr;
+	}
+
+	/**
+	 * @brief Whether the tile still holds the items it was loaded with from the map.
+	 */
+	[[nodiscard]] bool hasStaticItems() const {
+		return staticItems;
+	}
+
+	void setStaticItems(bool value) {
+		staticItems = value;
+		staticEncoding = nullptr;
+	}
+
+	/**
+	 * @brief Encoding of the items the tile was loaded with, shared with the tiles loaded with the same ones.
+	 * Null until the tile is first described, and dropped for good once its items change.
+	 */
+	[[nodiscard]] const TileItemsEncoding* getStaticEncoding() const {
+		return staticEncoding;
+	}
+
+	void setStaticEncoding(const TileItemsEncoding* encoding) {
+		staticEncoding = staticItems ? encoding : nullptr;
+	}
+
 private:
 	void onAddTileItem(const std::shared_ptr<Item> &item);
 	void onUpdateTileItem(const std::shared_ptr<Item> &oldItem, const ItemType &oldType, const std::shared_ptr<Item> &newItem, const ItemType &newType);
 	void onRemoveTileItem(const CreatureVector &spectators, const std::vector<int32_t> &oldStackPosVector, const std::shared_ptr<Item> &item);
 	void onUpdateTile(const CreatureVector &spectators);
 
+	static uint32_t nextVersion() {
+		static std::atomic_uint32_t versions = 0;
+		const uint32_t next = versions.fetch_add(1, std::memory_order_relaxed) + 1;
+		// Zero marks the empty slots of version keyed caches, skipped when the counter wraps
+		return next != 0 ? next : versions.fetch_add(1, std::memory_order_relaxed) + 1;
+	}
+
 	void setTileFlags(const std::shared_ptr<Item> &item);
 	void resetTileFlags(const std::shared_ptr<Item> &item);
+	void onTileFlagsChanged() const;
 	bool hasHarmfulField() const;
 	ReturnValue checkNpcCanWalkIntoTile() const;
 
 protected:
 	std::shared_ptr<Item> ground = nullptr;
 	Position tilePos;
+	bool staticItems = false;
 	uint32_t flags = 0;
+	uint32_t version = nextVersion();
+	const TileItemsEncoding* staticEncoding = nullptr;
 	std::unordered_set<std::shared_ptr<Zone>> zones {};
 };
 
@@ -11,6 +11,7 @@
 
 #include "lib/di/container.hpp"
 #include "database/database.hpp"
+#include "lib/metrics/metrics.hpp"
 
 int64_t KV::lastTimestamp_ = 0;
 uint64_t KV::counter_ = 0;
@@ -31,63 +32,279 @@ void KVStore::set(const std::string &key, const std::initializer_list<std::pair<
 }
 
 void KVStore::set(const std::string &key, const ValueWrapper &value) {
-	std::scoped_lock lock(mutex_);
-	return setLocked(key, value);
+	logger.trace("KVStore::set({})", key);
+	auto &shard = shardFor(key);
+	size_t pending = 0;
+	{
+		std::scoped_lock lock(shard.mutex);
+		cacheLocked(shard, key, value);
+		if (!shard.loading.empty()) {
+			if (const auto it = shard.loading.find(key); it != shard.loading.end()) {
+				it->second.overwritten = true;
+			}
+		}
+		if (shard.dirty.insert_or_assign(key, Pending { value, ++shard.version }).second) {
+			pending = ++pending_;
+		}
+	}
+
+	if (pending >= FLUSH_SIZE) {
+		scheduleFlush();
+	}
 }
 
-void KVStore::setLocked(const std::string &key, const ValueWrapper &value) {
-	logger.trace("KVStore::set({})", key);
-	const auto it = store_.find(key);
-	if (it != store_.end()) {
-		it->second.first = value;
-		lruQueue_.splice(lruQueue_.begin(), lruQueue_, it->second.second);
-	} else {
-		if (store_.size() >= MAX_SIZE) {
-			logger.debug("KVStore::set() - MAX_SIZE reached, removing last element");
-			auto last = lruQueue_.end();
-			last--;
-			save(*last, store_[*last].first);
-			store_.erase(*last);
-			lruQueue_.pop_back();
+KVStore::Shard &KVStore::shardFor(const std::string &key) {
+	// The top bits, the shard maps index their buckets with the low ones
+	const size_t hash = phmap::Hash<std::string> {}(key);
+	return shards_[hash >> (std::numeric_limits<size_t>::digits - SHARD_BITS)];
+}
+
+void KVStore::cacheLocked(Shard &shard, const std::string &key, const ValueWrapper &value) {
+	if (const auto it = shard.entries.find(key); it != shard.entries.end()) {
+		it->second.value = value;
+		it->second.referenced.store(true, std::memory_order_relaxed);
+		return;
+	}
+
+	if (shard.entries.size() < shardCapacity) {
+		const auto [it, _] = shard.entries.try_emplace(key, value);
+		shard.clock.push_back(&*it);
+		return;
+	}
+
+	const auto slot = evictLocked(shard);
+	const auto [it, _] = shard.entries.try_emplace(key, value);
+	shard.clock[slot] = &*it;
+}
+
+size_t KVStore::evictLocked(Shard &shard) {
+	// Every entry owns a slot, a full sweep clears all the bits so the second one always finds a victim
+	while (true) {
+		const auto slot = shard.hand;
+		shard.hand = (shard.hand + 1) % shard.clock.size();
+		const auto* node = shard.clock[slot];
+		if (node->second.referenced.exchange(false, std::memory_order_relaxed)) {
+			continue;
 		}
 
-		lruQueue_.push_front(key);
-		store_.try_emplace(key, std::make_pair(value, lruQueue_.begin()));
+		// A changed value stays in the dirty set until it is written
+		shard.entries.erase(shard.entries.find(node->first));
+		shard.evictions.fetch_add(1, std::memory_order_relaxed);
+		return slot;
 	}
 }
 
 std::optional<ValueWrapper> KVStore::get(const std::string &key, bool forceLoad /*= false */) {
 	logger.trace("KVStore::get({})", key);
-	std::scoped_lock lock(mutex_);
-	if (forceLoad || !store_.contains(key)) {
-		auto value = load(key);
-		if (value) {
-			setLocked(key, *value);
+	auto &shard = shardFor(key);
+	const auto cached = [&shard](const Entry &entry) -> std::optional<ValueWrapper> {
+		shard.hits.fetch_add(1, std::memory_order_relaxed);
+		if (entry.value.isDeleted()) {
+			// Left unreferenced, the hand takes removed keys first
+			return std::nullopt;
+		}
+		entry.referenced.store(true, std::memory_order_relaxed);
+		return entry.value;
+	};
+
+	if (!forceLoad) {
+		std::shared_lock lock(shard.mutex);
+		if (const auto it = shard.entries.find(key); it != shard.entries.end()) {
+			return cached(it->second);
 		}
-		return value;
 	}
 
-	auto &[value, lruIt] = store_[key];
-	if (value.isDeleted()) {
-		lruQueue_.splice(lruQueue_.end(), lruQueue_, lruIt);
-		return std::nullopt;
+	std::unique_lock lock(shard.mutex);
+	if (!forceLoad) {
+		// Cached by another reader between the two locks
+		if (const auto it = shard.entries.find(key); it != shard.entries.end()) {
+			return cached(it->second);
+		}
 	}
-	lruQueue_.splice(lruQueue_.begin(), lruQueue_, lruIt);
+
+	// Evicted or not, a change that was not written yet is newer than the database
+	if (const auto it = shard.dirty.find(key); it != shard.dirty.end()) {
+		shard.hits.fetch_add(1, std::memory_order_relaxed);
+		const auto value = it->second.value;
+		cacheLocked(shard, key, value);
+		return value.isDeleted() ? std::nullopt : std::make_optional(value);
+	}
+
+	shard.misses.fetch_add(1, std::memory_order_relaxed);
+	return loadShared(shard, key, lock);
+}
+
+std::optional<ValueWrapper> KVStore::loadShared(Shard &shard, const std::string &key, std::unique_lock<std::shared_mutex> &lock) {
+	if (const auto it = shard.loading.find(key); it != shard.loading.end()) {
+		const auto result = it->second.result;
+		lock.unlock();
+		return result.get();
+	}
+
+	std::promise<std::optional<ValueWrapper>> promise;
+	shard.loading.try_emplace(key, Load { promise.get_future().share() });
+	lock.unlock();
+
+	// Only readers of this key wait for the query
+	std::optional<ValueWrapper> value;
+	try {
+		value = load(key);
+	} catch (...) {
+		lock.lock();
+		shard.loading.erase(key);
+		promise.set_exception(std::current_exception());
+		throw;
+	}
+
+	lock.lock();
+	const auto it = shard.loading.find(key);
+	const bool overwritten = it->second.overwritten;
+	shard.loading.erase(it);
+	if (!overwritten) {
+		if (value) {
+			cacheLocked(shard, key, *value);
+		}
+	} else if (const auto entry = shard.entries.find(key); entry != shard.entries.end()) {
+		// set() while the query ran, its value wins over what the query returned
+		value = entry->second.value.isDeleted() ? std::nullopt : std::make_optional(entry->second.value);
+	} else if (const auto dirty = shard.dirty.find(key); dirty != shard.dirty.end()) {
+		value = dirty->second.value.isDeleted() ? std::nullopt : std::make_optional(dirty->second.value);
+	}
+	promise.set_value(value);
 	return value;
 }
 
-std::unordered_set<std::string> KVStore::keys(const std::string &prefix /*= ""*/) {
-	std::scoped_lock lock(mutex_);
-	std::unordered_set<std::string> keys;
-	for (const auto &[key, value] : store_) {
-		if (key.find(prefix) == 0) {
-			std::string suffix = key.substr(prefix.size());
-			keys.insert(suffix);
+void KVStore::prefetch(const std::string &prefix) {
+	metrics::method_latency measure(__METRICS_METHOD_NAME__);
+	logger.trace("KVStore::prefetch({})", prefix);
+	for (const auto &[key, value] : loadAll(prefix)) {
+		auto &shard = shardFor(key);
+		std::scoped_lock lock(shard.mutex);
+		// Whatever is cached or changed already is at least as new as the database
+		if (shard.entries.contains(key) || shard.dirty.contains(key)) {
+			continue;
 		}
+		cacheLocked(shard, key, value);
 	}
+}
+
+bool KVStore::saveAll() {
+	return writePending();
+}
+
+void KVStore::flush() {
+	saveAll();
+	for (auto &shard : shards_) {
+		std::scoped_lock lock(shard.mutex);
+		shard.entries.clear();
+		shard.clock.clear();
+		shard.hand = 0;
+	}
+}
+
+KVStore::CacheStats KVStore::getCacheStats() {
+	CacheStats stats;
+	for (auto &shard : shards_) {
+		stats.hits += shard.hits.load(std::memory_order_relaxed);
+		stats.misses += shard.misses.load(std::memory_order_relaxed);
+		stats.evictions += shard.evictions.load(std::memory_order_relaxed);
+		std::shared_lock lock(shard.mutex);
+		stats.entries += shard.entries.size();
+	}
+	return stats;
+}
+
+void KVStore::reportMetrics() {
+	// Counters and up-down counters take deltas, only what changed since the last report is sent
+	const auto stats = getCacheStats();
+	const auto pending = pendingWrites();
+	g_metrics().addCounter("kv_cache_hits", static_cast<double>(stats.hits - reportedStats_.hits));
+	g_metrics().addCounter("kv_cache_misses", static_cast<double>(stats.misses - reportedStats_.misses));
+	g_metrics().addCounter("kv_cache_evictions", static_cast<double>(stats.evictions - reportedStats_.evictions));
+	g_metrics().addUpDownCounter("kv_cache_entries", static_cast<int>(static_cast<int64_t>(stats.entries) - static_cast<int64_t>(reportedStats_.entries)));
+	g_metrics().addUpDownCounter("kv_pending_writes", static_cast<int>(static_cast<int64_t>(pending) - static_cast<int64_t>(reportedPending_)));
+	reportedStats_ = stats;
+	reportedPending_ = pending;
+}
+
+void KVStore::scheduleFlush() {
+	if (pending_.load(std::memory_order_relaxed) == 0 || flushScheduled_.exchange(true)) {
+		return;
+	}
+
+	runAsync([this] {
+		if (!writePending()) {
+			logger.error("[KVStore::scheduleFlush] - Failed to write key-value changes, retrying on the next flush");
+		}
+		flushScheduled_ = false;
+	});
+}
+
+bool KVStore::writePending() {
+	std::scoped_lock flushLock(flushMutex_);
+	// Copies, the dirty set keeps serving the values until they are written
+	std::vector<std::pair<std::string, ValueWrapper>> changes;
+	std::vector<uint64_t> versions;
+	for (auto &shard : shards_) {
+		std::scoped_lock lock(shard.mutex);
+		changes.reserve(changes.size() + shard.dirty.size());
+		versions.reserve(versions.size() + shard.dirty.size());
+		for (const auto &[key, pending] : shard.dirty) {
+			changes.emplace_back(key, pending.value);
+			versions.push_back(pending.version);
+		}
+	}
+
+	bool success = true;
+	const std::span<const std::pair<std::string, ValueWrapper>> all(changes);
+	for (size_t offset = 0; offset < all.size(); offset += FLUSH_BATCH) {
+		const auto batch = all.subspan(offset, std::min(FLUSH_BATCH, all.size() - offset));
+		if (!saveBatch(batch)) {
+			// Left in the dirty set for the next flush
+			success = false;
+			continue;
+		}
+
+		for (size_t i = 0; i < batch.size(); ++i) {
+			const auto &key = batch[i].first;
+			auto &shard = shardFor(key);
+			std::scoped_lock lock(shard.mutex);
+			// A set() since the copy is still to be written
+			if (const auto it = shard.dirty.find(key); it != shard.dirty.end() && it->second.version == versions[offset + i]) {
+				shard.dirty.erase(it);
+				--pending_;
+			}
+		}
+	}
+	return success;
+}
+
+std::unordered_set<std::string> KVStore::keys(const std::string &prefix /*= ""*/) {
+	std::unordered_set<std::string> keys;
 	for (const auto &key : loadPrefix(prefix)) {
 		keys.insert(key);
 	}
+
+	const auto visit = [&keys, &prefix](const std::string &key, const ValueWrapper &value) {
+		if (!key.starts_with(prefix)) {
+			return;
+		}
+		auto suffix = key.substr(prefix.size());
+		if (value.isDeleted()) {
+			keys.erase(suffix);
+		} else {
+			keys.insert(std::move(suffix));
+		}
+	};
+	for (auto &shard : shards_) {
+		std::shared_lock lock(shard.mutex);
+		for (const auto &[key, entry] : shard.entries) {
+			visit(key, entry.value);
+		}
+		for (const auto &[key, pending] : shard.dirty) {
+			visit(key, pending.value);
+		}
+	}
 	return keys;
 }
 
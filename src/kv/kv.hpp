@@ -17,8 +17,12 @@
 	#include <optional>
 	#include <unordered_set>
 	#include <iomanip>
-	#include <list>
 	#include <utility>
+	#include <future>
+	#include <shared_mutex>
+	#include <atomic>
+	#include <array>
+	#include <span>
 #endif
 
 #include "kv/value_wrapper.hpp"
@@ -75,10 +79,27 @@ private:
 class KVStore : public KV {
 public:
 	static constexpr size_t MAX_SIZE = 1000000;
+	static constexpr size_t SHARD_BITS = 4;
+	static constexpr size_t SHARDS = 1 << SHARD_BITS;
+	// Pending writes that make set() start a background flush
+	static constexpr size_t FLUSH_SIZE = 2000;
+	// Rows per write when flushing
+	static constexpr size_t FLUSH_BATCH = 500;
+	// How long a pending write may wait for the size threshold, see Game::start
+	static constexpr uint32_t FLUSH_INTERVAL_MS = 5000;
+
 	static KVStore &getInstance();
 
-	explicit KVStore(Logger &logger) :
-		logger(logger) { }
+	struct CacheStats {
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;
+		size_t entries = 0;
+	};
+
+	// capacity is split evenly between the shards
+	explicit KVStore(Logger &logger, size_t capacity = MAX_SIZE) :
+		logger(logger), shardCapacity(std::max<size_t>(capacity / SHARDS, 1)) { }
 
 	void set(const std::string &key, const std::initializer_list<ValueWrapper> &init_list) override;
 	void set(const std::string &key, const std::initializer_list<std::pair<const std::string, ValueWrapper>> &init_list) override;
@@ -86,38 +107,94 @@ public:
 
 	std::optional<ValueWrapper> get(const std::string &key, bool forceLoad = false) override;
 
-	void flush() override {
-		std::scoped_lock lock(mutex_);
-		KV::flush();
-		store_.clear();
+	// Writes every pending change and waits for it
+	bool saveAll() override;
+
+	void flush() override;
+
+	// Loads every stored key under prefix with one query, e.g. "player.<guid>." on login
+	void prefetch(const std::string &prefix);
+	// Starts a background flush of the pending changes unless one is already running
+	void scheduleFlush();
+	size_t pendingWrites() const {
+		return pending_.load(std::memory_order_relaxed);
 	}
 
+	CacheStats getCacheStats();
+	// Sends what changed since the last report, see Game::start
+	void reportMetrics();
+
 	std::shared_ptr<KV> scoped(const std::string &scope) final;
 	std::unordered_set<std::string> keys(const std::string &prefix = "") override;
 
-protected:
-	phmap::parallel_flat_hash_map<std::string, std::pair<ValueWrapper, std::list<std::string>::iterator>> getStore() {
-		std::scoped_lock lock(mutex_);
-		phmap::parallel_flat_hash_map<std::string, std::pair<ValueWrapper, std::list<std::string>::iterator>> copy;
-		for (const auto &[key, value] : store_) {
-			copy.try_emplace(key, value);
-		}
-		return copy;
-	}
-
 protected:
 	Logger &logger;
 
 	virtual std::optional<ValueWrapper> load(const std::string &key) = 0;
-	virtual bool save(const std::string &key, const ValueWrapper &value) = 0;
+	virtual std::vector<std::pair<std::string, ValueWrapper>> loadAll(const std::string &prefix) = 0;
 	virtual std::vector<std::string> loadPrefix(const std::string &prefix = "") = 0;
+	// Writes a batch of changed keys, deleted values remove their key
+	virtual bool saveBatch(std::span<const std::pair<std::string, ValueWrapper>> batch) = 0;
+	// Runs a background flush, stores without a thread pool flush inline
+	virtual void runAsync(std::function<void(void)> &&task) {
+		task();
+	}
 
 private:
-	void setLocked(const std::string &key, const ValueWrapper &value);
-
-	phmap::parallel_flat_hash_map<std::string, std::pair<ValueWrapper, std::list<std::string>::iterator>> store_;
-	std::list<std::string> lruQueue_;
-	std::mutex mutex_;
+	struct Entry {
+		explicit Entry(const ValueWrapper &value) :
+			value(value) { }
+
+		ValueWrapper value;
+		// Second chance, set by readers under the shared lock and cleared by the clock hand
+		mutable std::atomic<bool> referenced = true;
+	};
+
+	// Nodes never move, so the clock ring points at them instead of copying keys
+	using EntryMap = phmap::node_hash_map<std::string, Entry>;
+
+	struct Load {
+		std::shared_future<std::optional<ValueWrapper>> result;
+		// set() ran while the query did, the loaded value is stale
+		bool overwritten = false;
+	};
+
+	struct Pending {
+		ValueWrapper value;
+		uint64_t version = 0;
+	};
+
+	struct alignas(64) Shard {
+		std::shared_mutex mutex;
+		EntryMap entries;
+		std::vector<EntryMap::value_type*> clock;
+		size_t hand = 0;
+		// Latest value of every key not written yet, survives eviction and stays until its write lands
+		phmap::flat_hash_map<std::string, Pending> dirty;
+		// Bumped by every set(), a flush only drops the changes it wrote
+		uint64_t version = 0;
+		// Loads in flight, other readers of the same key wait on them instead of querying again
+		phmap::flat_hash_map<std::string, Load> loading;
+
+		std::atomic<uint64_t> hits = 0;
+		std::atomic<uint64_t> misses = 0;
+		std::atomic<uint64_t> evictions = 0;
+	};
+
+	Shard &shardFor(const std::string &key);
+	void cacheLocked(Shard &shard, const std::string &key, const ValueWrapper &value);
+	size_t evictLocked(Shard &shard);
+	std::optional<ValueWrapper> loadShared(Shard &shard, const std::string &key, std::unique_lock<std::shared_mutex> &lock);
+	bool writePending();
+
+	const size_t shardCapacity;
+	std::array<Shard, SHARDS> shards_;
+	CacheStats reportedStats_;
+	size_t reportedPending_ = 0;
+	std::atomic<size_t> pending_ = 0;
+	std::atomic<bool> flushScheduled_ = false;
+	// Keeps flushes in order, a key is never written by two of them at once
+	std::mutex flushMutex_;
 };
 
 class ScopedKV final : public KV {
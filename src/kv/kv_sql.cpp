@@ -11,12 +11,13 @@
 
 #include "database/database.hpp"
 #include "kv/value_wrapper_proto.hpp"
+#include "lib/thread/thread_pool.hpp"
 #include "utils/tools.hpp"
 
 #include <kv.pb.h>
 
-KVSQL::KVSQL(Database &db, Logger &logger) :
-	KVStore(logger), db(db) { }
+KVSQL::KVSQL(Database &db, ThreadPool &threadPool, Logger &logger) :
+	KVStore(logger), db(db), threadPool(threadPool) { }
 
 std::optional<ValueWrapper> KVSQL::load(const std::string &key) {
 	const auto query = fmt::format("SELECT `key_name`, `timestamp`, `value` FROM `kv_store` WHERE `key_name` = {}", db.escapeString(key));
@@ -24,19 +25,38 @@ std::optional<ValueWrapper> KVSQL::load(const std::string &key) {
 	if (result == nullptr) {
 		return std::nullopt;
 	}
+	return readValue(result, key);
+}
+
+std::vector<std::pair<std::string, ValueWrapper>> KVSQL::loadAll(const std::string &prefix) {
+	std::vector<std::pair<std::string, ValueWrapper>> values;
+	const auto query = fmt::format("SELECT `key_name`, `timestamp`, `value` FROM `kv_store` WHERE `key_name` LIKE {}", db.escapeString(prefix + "%"));
+	const auto result = db.storeQuery(query);
+	if (result == nullptr) {
+		return values;
+	}
+
+	do {
+		auto key = result->getString("key_name");
+		if (auto value = readValue(result, key)) {
+			values.emplace_back(std::move(key), std::move(*value));
+		}
+	} while (result->next());
+
+	return values;
+}
 
+std::optional<ValueWrapper> KVSQL::readValue(const DBResult_ptr &result, const std::string &key) const {
 	unsigned long size;
 	const auto data = result->getStream("value", size);
 	if (data == nullptr) {
 		return std::nullopt;
 	}
 
-	ValueWrapper valueWrapper;
 	const auto timestamp = result->getNumber<uint64_t>("timestamp");
 	Canary::protobuf::kv::ValueWrapper protoValue;
 	if (protoValue.ParseFromArray(data, static_cast<int>(size))) {
-		valueWrapper = ProtoSerializable::fromProto(protoValue, timestamp);
-		return valueWrapper;
+		return ProtoSerializable::fromProto(protoValue, timestamp);
 	}
 	logger.error("Failed to deserialize value for key {}", key);
 	return std::nullopt;
@@ -60,47 +80,45 @@ std::vector<std::string> KVSQL::loadPrefix(const std::string &prefix /* = ""*/)
 	return keys;
 }
 
-bool KVSQL::save(const std::string &key, const ValueWrapper &value) {
-	auto update = dbUpdate();
-	prepareSave(key, value, update);
-	return update.execute();
-}
-
-bool KVSQL::prepareSave(const std::string &key, const ValueWrapper &value, DBInsert &update) const {
-	const auto protoValue = ProtoSerializable::toProto(value);
-	std::string data;
-	if (!protoValue.SerializeToString(&data)) {
-		return false;
-	}
-	if (value.isDeleted()) {
-		const auto query = fmt::format("DELETE FROM `kv_store` WHERE `key_name` = {}", db.escapeString(key));
-		return db.executeQuery(query);
-	}
-
-	update.addRow(fmt::format("{}, {}, {}", db.escapeString(key), value.getTimestamp(), db.escapeString(data)));
-	return true;
-}
-
-bool KVSQL::saveAll() {
-	auto store = getStore();
-	const bool success = DBTransaction::executeWithinTransaction([this, &store]() {
+bool KVSQL::saveBatch(std::span<const std::pair<std::string, ValueWrapper>> batch) {
+	const bool success = DBTransaction::executeWithinTransaction([this, &batch]() {
 		auto update = dbUpdate();
-		if (!std::ranges::all_of(store, [this, &update](const auto &kv) {
-				const auto &[key, value] = kv;
-				return prepareSave(key, value.first, update);
-			})) {
+		std::string deleted;
+		for (const auto &[key, value] : batch) {
+			if (value.isDeleted()) {
+				deleted += fmt::format("{}{}", deleted.empty() ? "" : ", ", db.escapeString(key));
+				continue;
+			}
+
+			const auto protoValue = ProtoSerializable::toProto(value);
+			std::string data;
+			if (!protoValue.SerializeToString(&data)) {
+				// Retrying would fail the same way and hold back the rest of the batch
+				logger.error("Failed to serialize value for key {}, dropping the change", key);
+				continue;
+			}
+			if (!update.addRow(fmt::format("{}, {}, {}", db.escapeString(key), value.getTimestamp(), db.escapeString(data)))) {
+				return false;
+			}
+		}
+
+		if (!deleted.empty() && !db.executeQuery(fmt::format("DELETE FROM `kv_store` WHERE `key_name` IN ({})", deleted))) {
 			return false;
 		}
 		return update.execute();
 	});
 
 	if (!success) {
-		g_logger().error("[{}] Error occurred saving player", __FUNCTION__);
+		g_logger().error("[{}] Error occurred saving key-value store", __FUNCTION__);
 	}
 
 	return success;
 }
 
+void KVSQL::runAsync(std::function<void(void)> &&task) {
+	threadPool.detach_task(std::move(task));
+}
+
 DBInsert KVSQL::dbUpdate() {
 	auto insert = DBInsert("INSERT INTO `kv_store` (`key_name`, `timestamp`, `value`) VALUES");
 	insert.upsert({ "key_name", "timestamp", "value" });
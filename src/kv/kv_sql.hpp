@@ -12,23 +12,27 @@
 #include "kv/kv.hpp"
 
 class Database;
+class DBResult;
 class Logger;
 class DBInsert;
+class ThreadPool;
 class ValueWrapper;
 
 class KVSQL final : public KVStore {
 public:
-	explicit KVSQL(Database &db, Logger &logger);
-
-	bool saveAll() override;
+	explicit KVSQL(Database &db, ThreadPool &threadPool, Logger &logger);
 
 private:
 	std::vector<std::string> loadPrefix(const std::string &prefix = "") override;
 	std::optional<ValueWrapper> load(const std::string &key) override;
-	bool save(const std::string &key, const ValueWrapper &value) override;
-	bool prepareSave(const std::string &key, const ValueWrapper &value, DBInsert &update) const;
+	std::vector<std::pair<std::string, ValueWrapper>> loadAll(const std::string &prefix) override;
+	bool saveBatch(std::span<const std::pair<std::string, ValueWrapper>> batch) override;
+	void runAsync(std::function<void(void)> &&task) override;
+
+	std::optional<ValueWrapper> readValue(const std::shared_ptr<DBResult> &result, const std::string &key) const;
 
 	DBInsert dbUpdate();
 
 	Database &db;
+	ThreadPool &threadPool;
 };
@@ -0,0 +1,180 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "lib/metrics/latency_recorder.hpp"
+
+#include "utils/transparent_string_hash.hpp"
+
+using namespace metrics;
+
+namespace {
+	using NameMap = phmap::flat_hash_map<std::string, uint32_t, TransparentStringHasher, std::equal_to<>>;
+
+	struct Scope {
+		LatencyKind kind;
+		std::string name;
+		// Merged bucket counts as of the previous aggregation
+		std::array<uint64_t, LatencyBuckets::COUNT> previous {};
+		uint64_t previousSum = 0;
+	};
+
+	double toMicroseconds(uint64_t ns) {
+		return static_cast<double>(ns) / 1000;
+	}
+
+	double quantile(const std::array<uint64_t, LatencyBuckets::COUNT> &buckets, uint64_t count, double q) {
+		const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(count))));
+		uint64_t seen = 0;
+		for (uint32_t i = 0; i < buckets.size(); ++i) {
+			seen += buckets[i];
+			if (seen >= target) {
+				return toMicroseconds((LatencyBuckets::lowerBound(i) + LatencyBuckets::upperBound(i)) / 2);
+			}
+		}
+		return 0;
+	}
+}
+
+struct LatencyRecorder::Registry {
+	std::mutex mutex;
+	std::array<NameMap, LATENCY_KINDS> names;
+	// A deque keeps the names in place, so the stats can hand out views of them
+	std::deque<Scope> scopes;
+	std::vector<std::pair<uint32_t, std::unique_ptr<Shard>>> shards;
+
+	uint32_t intern(LatencyKind kind, std::string_view name) {
+		std::scoped_lock lock(mutex);
+		auto &kindNames = names[static_cast<size_t>(kind)];
+		if (const auto it = kindNames.find(name); it != kindNames.end()) {
+			return it->second;
+		}
+
+		if (scopes.size() >= MAX_SCOPES && name != OVERFLOW_SCOPE) {
+			if (const auto it = kindNames.find(OVERFLOW_SCOPE); it != kindNames.end()) {
+				return it->second;
+			}
+			name = OVERFLOW_SCOPE;
+		}
+
+		const auto id = static_cast<uint32_t>(scopes.size());
+		scopes.emplace_back(kind, std::string(name));
+		kindNames.emplace(std::string(name), id);
+		return id;
+	}
+};
+
+// Never destroyed: threads may still record or exit after main returns
+LatencyRecorder::Registry &LatencyRecorder::registry() {
+	static auto* instance = new Registry();
+	return *instance;
+}
+
+uint32_t LatencyRecorder::intern(LatencyKind kind, const char* literal) {
+	thread_local std::array<phmap::flat_hash_map<const char*, uint32_t>, LATENCY_KINDS> literals;
+	auto &cache = literals[static_cast<size_t>(kind)];
+	if (const auto it = cache.find(literal); it != cache.end()) [[likely]] {
+		return it->second;
+	}
+
+	const auto id = intern(kind, std::string_view(literal));
+	cache.emplace(literal, id);
+	return id;
+}
+
+uint32_t LatencyRecorder::intern(LatencyKind kind, std::string_view name) {
+	thread_local std::array<NameMap, LATENCY_KINDS> localNames;
+	auto &cache = localNames[static_cast<size_t>(kind)];
+	if (const auto it = cache.find(name); it != cache.end()) [[likely]] {
+		return it->second;
+	}
+
+	const auto id = registry().intern(kind, name);
+	if (cache.size() < MAX_SCOPES) {
+		cache.emplace(std::string(name), id);
+	}
+	return id;
+}
+
+std::vector<LatencyRecorder::Shard*> &LatencyRecorder::localShards() {
+	thread_local std::vector<Shard*> shards;
+	return shards;
+}
+
+LatencyRecorder::Shard &LatencyRecorder::createShard(uint32_t id) {
+	auto &shards = localShards();
+	if (id >= shards.size()) {
+		shards.resize(std::max<size_t>(id + 1, shards.size() * 2), nullptr);
+	}
+
+	auto &instance = registry();
+	std::scoped_lock lock(instance.mutex);
+	auto &[shardId, shard] = instance.shards.emplace_back(id, std::make_unique<Shard>());
+	shards[id] = shard.get();
+	return *shard;
+}
+
+std::vector<LatencyStats> LatencyRecorder::aggregate() {
+	auto &instance = registry();
+	const auto rate = sampleRate.load(std::memory_order_relaxed);
+
+	std::scoped_lock lock(instance.mutex);
+	std::vector<std::vector<const Shard*>> shardsById(instance.scopes.size());
+	for (const auto &[id, shard] : instance.shards) {
+		shardsById[id].emplace_back(shard.get());
+	}
+
+	std::vector<LatencyStats> stats;
+	std::array<uint64_t, LatencyBuckets::COUNT> merged {};
+	std::array<uint64_t, LatencyBuckets::COUNT> window {};
+	for (uint32_t id = 0; id < shardsById.size(); ++id) {
+		if (shardsById[id].empty()) {
+			continue;
+		}
+
+		merged.fill(0);
+		uint64_t mergedSum = 0;
+		for (const auto* shard : shardsById[id]) {
+			for (uint32_t i = 0; i < merged.size(); ++i) {
+				merged[i] += shard->buckets[i].load(std::memory_order_relaxed);
+			}
+			mergedSum += shard->sum.load(std::memory_order_relaxed);
+		}
+
+		auto &scope = instance.scopes[id];
+		uint64_t count = 0;
+		uint64_t total = 0;
+		uint32_t highest = 0;
+		for (uint32_t i = 0; i < merged.size(); ++i) {
+			window[i] = merged[i] - scope.previous[i];
+			count += window[i];
+			total += merged[i];
+			if (window[i] > 0) {
+				highest = i;
+			}
+		}
+
+		auto &entry = stats.emplace_back();
+		entry.kind = scope.kind;
+		entry.scope = scope.name;
+		entry.count = count * rate;
+		entry.sum = toMicroseconds(mergedSum - scope.previousSum) * rate;
+		entry.totalCount = total * rate;
+		entry.totalSum = toMicroseconds(mergedSum) * rate;
+		if (count > 0) {
+			entry.p50 = quantile(window, count, 0.5);
+			entry.p90 = quantile(window, count, 0.9);
+			entry.p99 = quantile(window, count, 0.99);
+			entry.max = toMicroseconds(LatencyBuckets::upperBound(highest));
+		}
+
+		scope.previous = merged;
+		scope.previousSum = mergedSum;
+	}
+	return stats;
+}
@@ -0,0 +1,160 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+namespace metrics {
+	enum class LatencyKind : uint8_t {
+		Method,
+		Lua,
+		Query,
+		Task,
+		Lock,
+
+		Last = Lock,
+	};
+
+	constexpr size_t LATENCY_KINDS = static_cast<size_t>(LatencyKind::Last) + 1;
+
+	/**
+	 * @brief Log-linear buckets in the spirit of HDR histograms.
+	 * Every power of two of nanoseconds is split into SUB_BUCKETS linear steps, which bounds
+	 * the relative error of any reported value to 1 / SUB_BUCKETS while covering everything
+	 * from a few nanoseconds to several minutes in a few hundred counters.
+	 */
+	struct LatencyBuckets {
+		static constexpr uint32_t SUB_BUCKET_BITS = 3;
+		static constexpr uint32_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+		static constexpr uint32_t MAX_EXPONENT = 40;
+		static constexpr uint32_t COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+		static constexpr uint64_t MAX_VALUE = (uint64_t { 1 } << MAX_EXPONENT) - 1;
+
+		static constexpr uint32_t indexOf(uint64_t ns) {
+			ns = std::min(ns, MAX_VALUE);
+			if (ns < SUB_BUCKETS) {
+				return static_cast<uint32_t>(ns);
+			}
+			const auto exponent = static_cast<uint32_t>(std::bit_width(ns)) - 1;
+			const auto sub = static_cast<uint32_t>(ns >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+			return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+		}
+
+		static constexpr uint64_t lowerBound(uint32_t index) {
+			if (index < SUB_BUCKETS) {
+				return index;
+			}
+			const auto group = index / SUB_BUCKETS;
+			return static_cast<uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << (group - 1);
+		}
+
+		static constexpr uint64_t upperBound(uint32_t index) {
+			return lowerBound(index + 1) - 1;
+		}
+	};
+
+	/**
+	 * @brief What a latency scope recorded since the previous aggregation.
+	 * Counts and sums are already scaled back by the sample rate; times are in microseconds.
+	 */
+	struct LatencyStats {
+		LatencyKind kind = LatencyKind::Method;
+		std::string_view scope;
+		uint64_t count = 0;
+		double sum = 0;
+		double p50 = 0;
+		double p90 = 0;
+		double p99 = 0;
+		double max = 0;
+		uint64_t totalCount = 0;
+		double totalSum = 0;
+	};
+
+	/**
+	 * @brief Lock-free backend of ScopedLatency.
+	 *
+	 * Scope names are interned once into small integer ids and cached per thread: string
+	 * literals, like the function names given by __METRICS_METHOD_NAME__, are looked up by
+	 * address, dynamic names by value. Each thread records into its own bucket shard per id,
+	 * so recording is a couple of relaxed stores with no lock and no allocation; the only
+	 * slow path is the first time a thread sees a scope. aggregate() merges the shards and
+	 * is meant to be called periodically from a single thread.
+	 */
+	class LatencyRecorder {
+	public:
+		// Dynamic names, like truncated queries, past this limit are folded into OVERFLOW_SCOPE
+		static constexpr uint32_t MAX_SCOPES = 4096;
+		static constexpr std::string_view OVERFLOW_SCOPE = "other";
+
+		/**
+		 * @brief Returns the id of a scope named by a string literal or any string with static storage.
+		 */
+		static uint32_t intern(LatencyKind kind, const char* literal);
+		static uint32_t intern(LatencyKind kind, std::string_view name);
+
+		static void record(uint32_t id, std::chrono::nanoseconds elapsed) {
+			auto &shard = localShard(id);
+			const auto ns = static_cast<uint64_t>(std::max<int64_t>(0, elapsed.count()));
+			// Only the owning thread writes a shard, so plain load and store suffice
+			auto &bucket = shard.buckets[LatencyBuckets::indexOf(ns)];
+			bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			shard.sum.store(shard.sum.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Whether the next measurement should be taken, honouring the sample rate.
+		 */
+		static bool sample() {
+			if (!enabled.load(std::memory_order_relaxed)) {
+				return false;
+			}
+			const auto rate = sampleRate.load(std::memory_order_relaxed);
+			if (rate <= 1) {
+				return true;
+			}
+			thread_local uint32_t counter = 0;
+			return ++counter % rate == 0;
+		}
+
+		static void setEnabled(bool value) {
+			enabled.store(value, std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Measures one in every rate scopes; rates of 0 and 1 measure all of them.
+		 */
+		static void setSampleRate(uint32_t rate) {
+			sampleRate.store(std::max<uint32_t>(1, rate), std::memory_order_relaxed);
+		}
+
+		static std::vector<LatencyStats> aggregate();
+
+	private:
+		struct Shard {
+			std::array<std::atomic_uint64_t, LatencyBuckets::COUNT> buckets {};
+			std::atomic_uint64_t sum = 0;
+		};
+
+		struct Registry;
+		static Registry &registry();
+
+		static Shard &localShard(uint32_t id) {
+			auto &shards = localShards();
+			if (id < shards.size() && shards[id]) [[likely]] {
+				return *shards[id];
+			}
+			return createShard(id);
+		}
+
+		static std::vector<Shard*> &localShards();
+		static Shard &createShard(uint32_t id);
+
+		inline static std::atomic_bool enabled = false;
+		inline static std::atomic_uint32_t sampleRate = 1;
+	};
+}
@@ -11,6 +11,7 @@
 
 #ifdef FEATURE_METRICS
 	#include "game/scheduling/dispatcher.hpp"
+	#include "lib/metrics/latency_recorder.hpp"
 	#include <opentelemetry/exporters/ostream/metric_exporter_factory.h>
 	#include <opentelemetry/sdk/metrics/export/periodic_exporting_metric_reader_factory.h>
 	#include <opentelemetry/exporters/prometheus/exporter_factory.h>
@@ -50,47 +51,73 @@ namespace metrics {
 
 		metrics_sdk::PeriodicExportingMetricReaderOptions ostreamOptions;
 		metrics_exporter::PrometheusExporterOptions prometheusOptions;
+
+		uint32_t latencySampleRate = 1;
+		std::chrono::milliseconds latencyAggregationInterval { 1000 };
 	};
 
+	/**
+	 * @brief Measures the time until stop() or the end of the scope.
+	 * Recording goes to the thread-local shards of LatencyRecorder, the exporters
+	 * only see the periodic aggregation of them.
+	 */
 	class ScopedLatency {
 	public:
-		explicit ScopedLatency(std::string_view name, const std::string &histogramName, const std::string &scopeKey);
-		explicit ScopedLatency([[maybe_unused]] std::string_view name, Histogram<double> &histogram, std::map<std::string, std::string> attrs = {}, opentelemetry::context::Context context = opentelemetry::context::Context()) :
-			begin(std::chrono::steady_clock::now()), histogram(histogram), attrs(std::move(attrs)), context(std::move(context)) {
+		// Names taken as const char* must have static storage, as string literals and __METRICS_METHOD_NAME__ do
+		ScopedLatency(LatencyKind kind, const char* name) {
+			if (LatencyRecorder::sample()) {
+				start(LatencyRecorder::intern(kind, name));
+			}
 		}
 
-		void stop();
+		ScopedLatency(LatencyKind kind, std::string_view name) {
+			if (LatencyRecorder::sample()) {
+				start(LatencyRecorder::intern(kind, name));
+			}
+		}
 
-		~ScopedLatency();
+		// Ensures that we don't accidentally copy it
+		ScopedLatency(const ScopedLatency &) = delete;
+		ScopedLatency &operator=(const ScopedLatency &) = delete;
+
+		void stop() {
+			if (stopped) {
+				return;
+			}
+			stopped = true;
+			LatencyRecorder::record(id, std::chrono::steady_clock::now() - begin);
+		}
+
+		~ScopedLatency() {
+			stop();
+		}
 
 	private:
+		void start(uint32_t scopeId) {
+			id = scopeId;
+			stopped = false;
+			begin = std::chrono::steady_clock::now();
+		}
+
 		std::chrono::steady_clock::time_point begin;
-		Histogram<double> &histogram;
-		std::map<std::string, std::string> attrs;
-		opentelemetry::context::Context context;
-		bool stopped { false };
+		uint32_t id = 0;
+		bool stopped { true };
 	};
 
-	#define DEFINE_LATENCY_CLASS(class_name, histogram_name, category)       \
-		class class_name##_latency final : public ScopedLatency {            \
-		public:                                                              \
-			class_name##_latency(std::string_view name) :                    \
-				ScopedLatency(name, histogram_name "_latency", category) { } \
+	#define DEFINE_LATENCY_CLASS(class_name, kind)                  \
+		class class_name##_latency final : public ScopedLatency {   \
+		public:                                                     \
+			class_name##_latency(const char* name) :                \
+				ScopedLatency(LatencyKind::kind, name) { }          \
+			class_name##_latency(std::string_view name) :           \
+				ScopedLatency(LatencyKind::kind, name) { }          \
 		}
 
-	DEFINE_LATENCY_CLASS(method, "method", "method");
-	DEFINE_LATENCY_CLASS(lua, "lua", "scope");
-	DEFINE_LATENCY_CLASS(query, "query", "truncated_query");
-	DEFINE_LATENCY_CLASS(task, "task", "task");
-	DEFINE_LATENCY_CLASS(lock, "lock", "scope");
-
-	const std::vector<std::string> latencyNames {
-		"method_latency",
-		"lua_latency",
-		"query_latency",
-		"task_latency",
-		"lock_latency",
-	};
+	DEFINE_LATENCY_CLASS(method, Method);
+	DEFINE_LATENCY_CLASS(lua, Lua);
+	DEFINE_LATENCY_CLASS(query, Query);
+	DEFINE_LATENCY_CLASS(task, Task);
+	DEFINE_LATENCY_CLASS(lock, Lock);
 
 	class Metrics final {
 	public:
@@ -129,11 +156,16 @@ namespace metrics {
 			upDownCounters[name]->Add(value, attrskv);
 		}
 
-		friend class ScopedLatency;
+		/**
+		 * @brief Returns the latency stats of the last aggregation.
+		 */
+		std::vector<LatencyStats> getLatencyStats() {
+			std::scoped_lock lock(latencyMutex);
+			return latencyStats;
+		}
 
 	protected:
-		opentelemetry::context::Context defaultContext {};
-		phmap::parallel_flat_hash_map<std::string, Histogram<double>> latencyHistograms;
+		std::vector<opentelemetry::nostd::shared_ptr<metrics_api::ObservableInstrument>> latencyInstruments;
 		phmap::flat_hash_map<std::string, UpDownCounter<int64_t>> upDownCounters;
 		phmap::flat_hash_map<std::string, Counter<double>> counters;
 
@@ -146,8 +178,15 @@ namespace metrics {
 		}
 
 	private:
+		void aggregateLatencies(const std::stop_token &stopToken, std::chrono::milliseconds interval);
+
 		std::mutex mutex_;
 
+		std::mutex latencyMutex;
+		std::condition_variable_any latencyCondition;
+		std::vector<LatencyStats> latencyStats;
+		std::jthread latencyAggregator;
+
 		std::string meterName { "stats" };
 		std::string otelVersion { "1.2.0" };
 		std::string otelSchema { "https://opentelemetry.io/schemas/1.2.0" };
@@ -0,0 +1,184 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "lib/thread/work_stealing_executor.hpp"
+
+#include "lib/thread/thread_pool.hpp"
+
+namespace {
+	// Each participant gets roughly this many chunks, enough to balance uneven items
+	constexpr uint32_t CHUNKS_PER_PARTICIPANT = 8;
+
+	constexpr uint64_t pack(uint32_t begin, uint32_t end) {
+		return static_cast<uint64_t>(begin) << 32 | end;
+	}
+
+	constexpr std::pair<uint32_t, uint32_t> unpack(uint64_t range) {
+		return { static_cast<uint32_t>(range >> 32), static_cast<uint32_t>(range) };
+	}
+}
+
+struct WorkStealingExecutor::Job {
+	struct alignas(64) Slot {
+		std::atomic_uint64_t range = 0;
+	};
+
+	Job(const std::function<void(size_t i)> &f, uint32_t size, uint32_t participants) :
+		f(f), slots(std::make_unique<Slot[]>(participants)), participants(participants), size(size),
+		grain(std::max<uint32_t>(1, size / (participants * CHUNKS_PER_PARTICIPANT))) {
+		const auto perSlot = size / participants;
+		const auto remainder = size % participants;
+
+		uint32_t begin = 0;
+		for (uint32_t i = 0; i < participants; ++i) {
+			const auto end = begin + perSlot + (i < remainder ? 1 : 0);
+			slots[i].range.store(pack(begin, end), std::memory_order_relaxed);
+			begin = end;
+		}
+	}
+
+	// Takes a chunk from the front of the own slot
+	bool takeFront(uint32_t slotId, uint32_t &begin, uint32_t &end) {
+		auto &range = slots[slotId].range;
+		auto current = range.load(std::memory_order_acquire);
+		while (true) {
+			const auto [b, e] = unpack(current);
+			if (b >= e) {
+				return false;
+			}
+
+			const auto next = std::min(e, b + grain);
+			if (range.compare_exchange_weak(current, pack(next, e), std::memory_order_acq_rel)) {
+				begin = b;
+				end = next;
+				return true;
+			}
+		}
+	}
+
+	// Takes the back half of a victim slot
+	bool stealBack(uint32_t victimId, uint32_t &begin, uint32_t &end) {
+		auto &range = slots[victimId].range;
+		auto current = range.load(std::memory_order_acquire);
+		while (true) {
+			const auto [b, e] = unpack(current);
+			if (b >= e) {
+				return false;
+			}
+
+			const auto middle = b + (e - b) / 2;
+			if (range.compare_exchange_weak(current, pack(b, middle), std::memory_order_acq_rel)) {
+				begin = middle;
+				end = e;
+				return true;
+			}
+		}
+	}
+
+	void complete(uint32_t count) {
+		if (done.fetch_add(count, std::memory_order_acq_rel) + count == size) {
+			done.notify_all();
+		}
+	}
+
+	const std::function<void(size_t i)> &f;
+	std::unique_ptr<Slot[]> slots;
+	std::atomic_uint32_t nextSlot = 1; // Slot 0 belongs to the caller
+	std::atomic_uint32_t done = 0;
+	const uint32_t participants;
+	const uint32_t size;
+	const uint32_t grain;
+};
+
+void WorkStealingExecutor::parallelFor(size_t size, const std::function<void(size_t i)> &f) {
+	if (size == 0) {
+		return;
+	}
+
+	const auto threads = static_cast<uint32_t>(threadPool.get_thread_count());
+	if (size == 1 || threads <= 1 || size > std::numeric_limits<uint32_t>::max()) {
+		for (size_t i = 0; i < size; ++i) {
+			f(i);
+		}
+		return;
+	}
+
+	const auto participants = std::min<uint32_t>(threads, static_cast<uint32_t>(size));
+	const auto job = std::make_shared<Job>(f, static_cast<uint32_t>(size), participants);
+
+	// Helpers only touch the callback after claiming work, so it's fine if they start after we return
+	for (uint32_t i = 1; i < participants; ++i) {
+		threadPool.detach_task([this, job] {
+			const auto slotId = job->nextSlot.fetch_add(1, std::memory_order_relaxed);
+			if (slotId < job->participants) {
+				run(*job, slotId);
+			}
+		});
+	}
+
+	run(*job, 0);
+
+	// Everything has been claimed, wait only for chunks that are still running on other threads
+	auto current = job->done.load(std::memory_order_acquire);
+	if (current < job->size) {
+		const auto idleStart = std::chrono::steady_clock::now();
+		while (current < job->size) {
+			job->done.wait(current, std::memory_order_acquire);
+			current = job->done.load(std::memory_order_acquire);
+		}
+		idleMicros.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - idleStart).count(), std::memory_order_relaxed);
+	}
+
+	loops.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WorkStealingExecutor::run(Job &job, uint32_t slotId) {
+	uint32_t begin = 0;
+	uint32_t end = 0;
+	uint64_t localChunks = 0;
+	uint64_t localSteals = 0;
+
+	while (true) {
+		while (job.takeFront(slotId, begin, end)) {
+			for (auto i = begin; i < end; ++i) {
+				job.f(i);
+			}
+			job.complete(end - begin);
+			++localChunks;
+		}
+
+		bool stolen = false;
+		for (uint32_t offset = 1; offset < job.participants; ++offset) {
+			const auto victimId = (slotId + offset) % job.participants;
+			if (job.stealBack(victimId, begin, end)) {
+				// Our slot is empty, so only thieves may be looking at it and they will fail their CAS
+				job.slots[slotId].range.store(pack(begin, end), std::memory_order_release);
+				++localSteals;
+				stolen = true;
+				break;
+			}
+		}
+
+		if (!stolen) {
+			break;
+		}
+	}
+
+	chunks.fetch_add(localChunks, std::memory_order_relaxed);
+	steals.fetch_add(localSteals, std::memory_order_relaxed);
+}
+
+WorkStealingStats WorkStealingExecutor::collectStats() {
+	return {
+		.loops = loops.exchange(0, std::memory_order_relaxed),
+		.chunks = chunks.exchange(0, std::memory_order_relaxed),
+		.steals = steals.exchange(0, std::memory_order_relaxed),
+		.idleMicros = idleMicros.exchange(0, std::memory_order_relaxed),
+	};
+}
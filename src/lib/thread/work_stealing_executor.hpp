@@ -0,0 +1,58 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class ThreadPool;
+
+struct WorkStealingStats {
+	uint64_t loops = 0;
+	uint64_t chunks = 0;
+	uint64_t steals = 0;
+	uint64_t idleMicros = 0;
+};
+
+/**
+ * @brief Runs parallel loops on the thread pool using range stealing.
+ *
+ * Each participant owns a slot holding a [begin, end) range packed into one atomic.
+ * The owner consumes small chunks from the front of its range, while idle participants
+ * steal half of what is left from the back of someone else's range.
+ * The caller always takes part in the loop and only ever waits for chunks that are
+ * already running, so nested parallel loops are safe: helpers that start late simply
+ * find no work left and return.
+ */
+class WorkStealingExecutor {
+public:
+	explicit WorkStealingExecutor(ThreadPool &threadPool) :
+		threadPool(threadPool) { }
+
+	// Ensures that we don't accidentally copy it
+	WorkStealingExecutor(const WorkStealingExecutor &) = delete;
+	WorkStealingExecutor &operator=(const WorkStealingExecutor &) = delete;
+
+	void parallelFor(size_t size, const std::function<void(size_t i)> &f);
+
+	/**
+	 * @brief Returns the stats accumulated since the last call and resets them.
+	 */
+	WorkStealingStats collectStats();
+
+private:
+	struct Job;
+
+	void run(Job &job, uint32_t slotId);
+
+	ThreadPool &threadPool;
+
+	std::atomic_uint64_t loops = 0;
+	std::atomic_uint64_t chunks = 0;
+	std::atomic_uint64_t steals = 0;
+	std::atomic_uint64_t idleMicros = 0;
+};
@@ -112,6 +112,9 @@ void GameFunctions::init(lua_State* L) {
 
 	Lua::registerMethod(L, "Game", "getMonstersByRace", GameFunctions::luaGameGetMonstersByRace);
 	Lua::registerMethod(L, "Game", "getMonstersByBestiaryStars", GameFunctions::luaGameGetMonstersByBestiaryStars);
+
+	Lua::registerMethod(L, "Game", "getDispatcherReport", GameFunctions::luaGameGetDispatcherReport);
+	Lua::registerMethod(L, "Game", "resetDispatcherProfile", GameFunctions::luaGameResetDispatcherProfile);
 }
 
 // Game
@@ -1086,3 +1089,17 @@ int GameFunctions::luaGameGetMonstersByBestiaryStars(lua_State* L) {
 	}
 	return 1;
 }
+
+int GameFunctions::luaGameGetDispatcherReport(lua_State* L) {
+	// Game.getDispatcherReport([limit = 20])
+	const auto limit = Lua::getNumber<uint32_t>(L, 1, DispatcherProfiler::DEFAULT_REPORT_LIMIT);
+	Lua::pushString(L, g_dispatcher().getProfiler().report(limit));
+	return 1;
+}
+
+int GameFunctions::luaGameResetDispatcherProfile(lua_State* L) {
+	// Game.resetDispatcherProfile()
+	g_dispatcher().getProfiler().reset();
+	Lua::pushBoolean(L, true);
+	return 1;
+}
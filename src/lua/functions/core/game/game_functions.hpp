@@ -94,4 +94,7 @@ private:
 
 	static int luaGameGetMonstersByRace(lua_State* L);
 	static int luaGameGetMonstersByBestiaryStars(lua_State* L);
+
+	static int luaGameGetDispatcherReport(lua_State* L);
+	static int luaGameResetDispatcherProfile(lua_State* L);
 };
@@ -20,7 +20,9 @@
 #include "lua/callbacks/event_callback.hpp"
 #include "lua/callbacks/events_callbacks.hpp"
 #include "map/spectators.hpp"
+#include "server/network/message/shared_packet.hpp"
 #include "utils/astarnodes.hpp"
+#include "utils/slab_allocator.hpp"
 
 void Map::load(std::string_view identifier, const Position &pos) {
 	try {
@@ -159,10 +161,14 @@ void Map::loadHouseInfo() {
 }
 
 bool Map::save() {
+	return save(*IOMapSerialize::snapshotHouses());
+}
+
+bool Map::save(const HouseSaveSnapshot &snapshot) {
 	const uint8_t maxTries = 6;
 
 	for (uint8_t tries = 0; tries < maxTries; tries++) {
-		if (IOMapSerialize::saveHouseInfo() && IOMapSerialize::saveHouseItems()) {
+		if (IOMapSerialize::saveHouses(snapshot)) {
 			return true;
 		}
 	}
@@ -174,9 +180,9 @@ std::shared_ptr<Tile> Map::getOrCreateTile(uint16_t x, uint16_t y, uint8_t z, bo
 	auto tile = getTile(x, y, z);
 	if (!tile) {
 		if (isDynamic) {
-			tile = std::make_shared<DynamicTile>(x, y, z);
+			tile = makeSlabShared<DynamicTile>(x, y, z);
 		} else {
-			tile = std::make_shared<StaticTile>(x, y, z);
+			tile = makeSlabShared<StaticTile>(x, y, z);
 		}
 
 		setTile(x, y, z, tile);
@@ -449,13 +455,14 @@ void Map::moveCreature(const std::shared_ptr<Creature> &creature, const std::sha
 	}
 
 	// Enviar atualizações para os clientes
+	BroadcastPacket broadcast;
 	size_t i = 0;
 	for (const auto &spectator : playersSpectators) {
 		// Usar o stackpos correto para cada jogador
 		const int32_t stackpos = oldStackPosVector[i++];
 		if (stackpos != -1) {
 			const auto &player = spectator->getPlayer();
-			player->sendCreatureMove(creature, newPos, newTile->getStackposOfCreature(player, creature), oldPos, stackpos, teleport);
+			player->sendCreatureMove(creature, newPos, newTile->getStackposOfCreature(player, creature), oldPos, stackpos, teleport, broadcast);
 		}
 	}
 
@@ -754,10 +761,26 @@ uint32_t Map::clean() const {
 	return count;
 }
 
-/**
- * Implementação otimizada do algoritmo de pathfinding
- */
-bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Position &targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
+bool Map::findPath(const std::shared_ptr<Creature> &creature, const Position &startPos, const Position &targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
+	// The condition is what decides the result, only cache searches whose heuristic aims at the same place
+	if (targetPos != pathCondition.getTargetPos()) {
+		std::vector<PathCache::SectorVersion> sectors;
+		return searchPath(creature, startPos, targetPos, dirList, pathCondition, fpp, sectors);
+	}
+
+	const PathCacheKey key(creature ? creature->getID() : 0, startPos, targetPos, fpp);
+	if (const auto cached = pathCache.lookup(key, dirList, OTSYS_TIME())) {
+		return *cached;
+	}
+
+	const auto previousSize = dirList.size();
+	std::vector<PathCache::SectorVersion> sectors;
+	const bool found = searchPath(creature, startPos, targetPos, dirList, pathCondition, fpp, sectors);
+	pathCache.store(key, std::span(dirList).subspan(previousSize), found, std::move(sectors), OTSYS_TIME());
+	return found;
+}
+
+bool Map::searchPath(const std::shared_ptr<Creature> &creature, const Position &startPosition, const Position &targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp, std::vector<PathCache::SectorVersion> &sectors) {
 	// Cache estático para evitar alocações repetidas em chamadas sucessivas
 	static constexpr std::array<std::array<int_fast32_t, 2>, 8> allNeighbors = { { { { -1, 0 } }, { { 0, 1 } }, { { 1, 0 } }, { { 0, -1 } }, { { -1, -1 } }, { { 1, -1 } }, { { 1, 1 } }, { { -1, 1 } } } };
 
@@ -772,21 +795,42 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 
 	const bool withoutCreature = creature == nullptr;
 
-	Position pos = withoutCreature ? targetPos : creature->getPosition();
+	Position pos = startPosition;
 	Position endPos;
 
+	// Sectors the search reads tiles from, for the cache to validate the result against.
+	// Each version is taken before the first tile of its sector is read, a change during the search then invalidates the entry
+	sectors.clear();
+	int32_t lastSectorX = -1;
+	int32_t lastSectorY = -1;
+	const auto noteSector = [&](int32_t x, int32_t y) {
+		const int32_t sx = x & ~SECTOR_MASK;
+		const int32_t sy = y & ~SECTOR_MASK;
+		if (sx == lastSectorX && sy == lastSectorY) {
+			return;
+		}
+		lastSectorX = sx;
+		lastSectorY = sy;
+
+		const auto sector = getMapSector(sx, sy);
+		if (sector && std::ranges::none_of(sectors, [sector](const auto &entry) { return entry.sector == sector; })) {
+			sectors.push_back({ sector, sector->getTileVersion() });
+		}
+	};
+
 	// Inicializar nós A* com a posição inicial
-	const auto &startTile = getTile(pos.x, pos.y, pos.z);
+	noteSector(pos.x, pos.y);
+	const auto &startTile = withoutCreature ? getTile(pos.x, pos.y, pos.z) : creature->getTile();
 	if (!startTile) {
 		return false;
 	}
 
-	AStarNodes nodes(pos.x, pos.y, AStarNodes::getTileWalkCost(creature, startTile));
+	auto &nodes = AStarNodes::acquire(pos.x, pos.y, AStarNodes::getTileWalkCost(creature, startTile));
 
 	int32_t bestMatch = 0;
 
-	const auto &startPos = pos;
-	const auto &actualTargetPos = withoutCreature ? pathCondition.getTargetPos() : targetPos;
+	const Position startPos = pos;
+	const auto &actualTargetPos = targetPos;
 
 	// Calcular distância inicial para heurística
 	const int_fast32_t sX = std::abs(actualTargetPos.getX() - pos.getX());
@@ -869,6 +913,8 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 				continue;
 			}
 
+			noteSector(pos.x, pos.y);
+
 			// Verificar custo do tile
 			int_fast32_t extraCost;
 			AStarNode* neighborNode = nodes.getNodeByPosition(pos.x, pos.y);
@@ -971,221 +1017,21 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 	return true;
 }
 
-// Implementação das outras funções de pathfinding que chamam a principal
+bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Position &targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
+	// Sem criatura, targetPos é a posição de partida
+	if (!creature) {
+		return findPath(nullptr, targetPos, pathCondition.getTargetPos(), dirList, pathCondition, fpp);
+	}
+	return findPath(creature, creature->getPosition(), targetPos, dirList, pathCondition, fpp);
+}
+
 bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
 	return getPathMatching(creature, creature->getPosition(), dirList, pathCondition, fpp);
 }
 
 bool Map::getPathMatchingCond(const std::shared_ptr<Creature> &creature, const Position &targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
-	// Esta implementação é quase idêntica à getPathMatching, mas com pequenas diferenças na lógica
-	// Implementação otimizada com recursos C++23
-
 	if (!creature) {
 		return false;
 	}
-
-	Position pos = creature->getPosition();
-	Position endPos;
-
-	const auto &tile = creature->getTile();
-	if (!tile) {
-		return false;
-	}
-
-	AStarNodes nodes(pos.x, pos.y, AStarNodes::getTileWalkCost(creature, tile));
-
-	int32_t bestMatch = 0;
-
-	const Position startPos = pos;
-
-	// Calcular distância inicial para heurística
-	const int_fast32_t sX = std::abs(targetPos.getX() - pos.getX());
-	const int_fast32_t sY = std::abs(targetPos.getY() - pos.getY());
-
-	// Array para vizinhos por direção (substituindo vetores estáticos)
-	// Usando arrays constexpr para melhor otimização em tempo de compilação
-	static constexpr std::array<std::array<int_fast32_t, 2>, 8> allNeighbors = { { { { -1, 0 } }, { { 0, 1 } }, { { 1, 0 } }, { { 0, -1 } }, { { -1, -1 } }, { { 1, -1 } }, { { 1, 1 } }, { { -1, 1 } } } };
-
-	static constexpr std::array<std::array<std::array<int_fast32_t, 2>, 5>, 8> dirNeighbors = { { { { { { -1, 0 } }, { { 0, 1 } }, { { 1, 0 } }, { { 1, 1 } }, { { -1, 1 } } } },
-		                                                                                          { { { { -1, 0 } }, { { 0, 1 } }, { { 0, -1 } }, { { -1, -1 } }, { { -1, 1 } } } },
-		                                                                                          { { { { -1, 0 } }, { { 1, 0 } }, { { 0, -1 } }, { { -1, -1 } }, { { 1, -1 } } } },
-		                                                                                          { { { { 0, 1 } }, { { 1, 0 } }, { { 0, -1 } }, { { 1, -1 } }, { { 1, 1 } } } },
-		                                                                                          { { { { 1, 0 } }, { { 0, -1 } }, { { -1, -1 } }, { { 1, -1 } }, { { 1, 1 } } } },
-		                                                                                          { { { { -1, 0 } }, { { 0, -1 } }, { { -1, -1 } }, { { 1, -1 } }, { { -1, 1 } } } },
-		                                                                                          { { { { 0, 1 } }, { { 1, 0 } }, { { 1, -1 } }, { { 1, 1 } }, { { -1, 1 } } } },
-		                                                                                          { { { { -1, 0 } }, { { 0, 1 } }, { { -1, -1 } }, { { 1, 1 } }, { { -1, 1 } } } } } };
-
-	uint_fast16_t cntDirs = 0;
-
-	const AStarNode* found = nullptr;
-	do {
-		AStarNode* n = nodes.getBestNode();
-		if (!n) {
-			if (found) {
-				break;
-			}
-			return false;
-		}
-
-		const int_fast32_t x = n->x;
-		const int_fast32_t y = n->y;
-		pos.x = x;
-		pos.y = y;
-
-		if (pathCondition(startPos, pos, fpp, bestMatch)) {
-			found = n;
-			endPos = pos;
-			if (bestMatch == 0) {
-				break;
-			}
-		}
-
-		++cntDirs;
-
-		// Determinar vizinhos a explorar com base na direção do movimento
-		uint_fast32_t dirCount;
-		const std::array<int_fast32_t, 2>* neighbors;
-
-		if (n->parent) {
-			// Determinar direção com base no nó pai
-			const int_fast32_t offset_x = n->parent->x - x;
-			const int_fast32_t offset_y = n->parent->y - y;
-
-			int dirIndex;
-			if (offset_y == 0) {
-				dirIndex = offset_x == -1 ? DIRECTION_WEST : DIRECTION_EAST;
-			} else if (offset_x == 0) {
-				dirIndex = offset_y == -1 ? DIRECTION_NORTH : DIRECTION_SOUTH;
-			} else if (offset_y == -1) {
-				dirIndex = offset_x == -1 ? DIRECTION_NORTHWEST : DIRECTION_NORTHEAST;
-			} else {
-				dirIndex = offset_x == -1 ? DIRECTION_SOUTHWEST : DIRECTION_SOUTHEAST;
-			}
-
-			neighbors = dirNeighbors[dirIndex].data();
-			dirCount = 5;
-		} else {
-			// Sem direção preferida, usar todos os vizinhos
-			neighbors = allNeighbors.data();
-			dirCount = 8;
-		}
-
-		const int_fast32_t f = n->f;
-
-		// Explorar todos os vizinhos selecionados
-		for (uint_fast32_t i = 0; i < dirCount; ++i) {
-			pos.x = x + neighbors[i][0];
-			pos.y = y + neighbors[i][1];
-
-			// Verificação de distância máxima
-			if (fpp.maxSearchDist != 0 && (Position::getDistanceX(startPos, pos) > fpp.maxSearchDist || Position::getDistanceY(startPos, pos) > fpp.maxSearchDist)) {
-				continue;
-			}
-
-			// Verificar condição de manter distância
-			if (fpp.keepDistance && !pathCondition.isInRange(startPos, pos, fpp)) {
-				continue;
-			}
-
-			// Obter o custo para este tile
-			int_fast32_t extraCost;
-			AStarNode* neighborNode = nodes.getNodeByPosition(pos.x, pos.y);
-
-			if (neighborNode) {
-				extraCost = neighborNode->c;
-			} else {
-				const auto &nextTile = Map::canWalkTo(creature, pos);
-				if (!nextTile) {
-					continue;
-				}
-				extraCost = AStarNodes::getTileWalkCost(creature, nextTile);
-			}
-
-			// Calcular o custo total para este caminho
-			const int_fast32_t cost = AStarNodes::getMapWalkCost(n, pos);
-			const int_fast32_t newf = f + cost + extraCost;
-
-			if (neighborNode) {
-				// Verificar se este caminho é melhor que o existente
-				if (neighborNode->f <= newf) {
-					continue;
-				}
-
-				// Atualizar o nó com o melhor caminho
-				neighborNode->f = newf;
-				neighborNode->parent = n;
-				nodes.openNode(neighborNode);
-			} else {
-				// Criar um novo nó
-				const int_fast32_t dX = std::abs(targetPos.getX() - pos.getX());
-				const int_fast32_t dY = std::abs(targetPos.getY() - pos.getY());
-
-				// Heurística mais otimizada para o custo estimado até o destino
-				const int_fast32_t heuristic = ((dX - sX) << 3) + ((dY - sY) << 3) + (std::max(dX, dY) << 3);
-
-				if (!nodes.createOpenNode(n, pos.x, pos.y, newf, heuristic, extraCost)) {
-					if (found) {
-						break;
-					}
-					return false;
-				}
-			}
-		}
-
-		// Finalizar exploração deste nó
-		nodes.closeNode(n);
-	} while (fpp.maxSearchDist != 0 || nodes.getClosedNodes() < 100);
-
-	// Sem caminho encontrado
-	if (!found) {
-		return false;
-	}
-
-	// Reconstruir o caminho a partir do nó final
-	int_fast32_t prevx = endPos.x;
-	int_fast32_t prevy = endPos.y;
-
-	// Reservar espaço para evitar realocações
-	dirList.reserve(cntDirs);
-
-	// Traçar caminho de volta para a origem
-	found = found->parent;
-	while (found) {
-		pos.x = found->x;
-		pos.y = found->y;
-
-		const int_fast32_t dx = pos.getX() - prevx;
-		const int_fast32_t dy = pos.getY() - prevy;
-
-		prevx = pos.x;
-		prevy = pos.y;
-
-		// Adicionar direção correta com base nas diferenças de coordenadas
-		// Usando estrutura de decisão eficiente
-		if (dx == 1) {
-			if (dy == 1) {
-				dirList.emplace_back(DIRECTION_NORTHWEST);
-			} else if (dy == -1) {
-				dirList.emplace_back(DIRECTION_SOUTHWEST);
-			} else {
-				dirList.emplace_back(DIRECTION_WEST);
-			}
-		} else if (dx == -1) {
-			if (dy == 1) {
-				dirList.emplace_back(DIRECTION_NORTHEAST);
-			} else if (dy == -1) {
-				dirList.emplace_back(DIRECTION_SOUTHEAST);
-			} else {
-				dirList.emplace_back(DIRECTION_EAST);
-			}
-		} else if (dy == 1) {
-			dirList.emplace_back(DIRECTION_NORTH);
-		} else if (dy == -1) {
-			dirList.emplace_back(DIRECTION_SOUTH);
-		}
-
-		found = found->parent;
-	}
-
-	return true;
+	return findPath(creature, creature->getPosition(), targetPos, dirList, pathCondition, fpp);
 }
@@ -14,6 +14,7 @@
 #include "map/house/house.hpp"
 #include "creatures/monsters/spawns/spawn_monster.hpp"
 #include "creatures/npcs/spawns/spawn_npc.hpp"
+#include "map/utils/pathcache.hpp"
 
 class Creature;
 class Player;
@@ -22,6 +23,7 @@ class Tile;
 class Map;
 
 struct FindPathParams;
+struct HouseSaveSnapshot;
 class FrozenPathingConditionCall;
 
 /**
@@ -93,6 +95,12 @@ public:
 	 */
 	[[nodiscard]] static bool save();
 
+	/**
+	 * Save house data serialized earlier, from any thread
+	 * @return Whether the save was successful
+	 */
+	[[nodiscard]] static bool save(const HouseSaveSnapshot &snapshot);
+
 	/**
 	 * Get a single tile
 	 * @param x X coordinate
@@ -245,6 +253,13 @@ public:
 		return getPathMatching(nullptr, startPos, dirList, pathCondition, fpp);
 	}
 
+	/**
+	 * Cache of recent path searches, shared by all the getPathMatching variants
+	 */
+	[[nodiscard]] PathCache &getPathCache() {
+		return pathCache;
+	}
+
 	// Waypoints map
 	std::map<std::string, Position> waypoints;
 
@@ -260,6 +275,24 @@ public:
 	std::array<Houses, MAX_CUSTOM_MAPS> housesCustomMaps;
 
 private:
+	/**
+	 * A* search shared by all the getPathMatching variants, results are served from the path cache when still valid
+	 * @param creature Creature walking the path, nullptr to only check that tiles exist
+	 * @param startPos Start position
+	 * @param targetPos Position the heuristic aims for
+	 * @param dirList Direction list to be filled
+	 * @param pathCondition Path condition
+	 * @param fpp Path finding parameters
+	 * @return Whether a path was found
+	 */
+	[[nodiscard]] bool findPath(const std::shared_ptr<Creature> &creature, const Position &startPos, const Position &targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp);
+	/**
+	 * Runs the actual search, also reporting the sectors covering the explored area for the cache
+	 */
+	[[nodiscard]] bool searchPath(const std::shared_ptr<Creature> &creature, const Position &startPos, const Position &targetPos, std::vector<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp, std::vector<PathCache::SectorVersion> &sectors);
+
+	PathCache pathCache;
+
 	/**
 	 * Set a tile at a specific position
 	 * @param x X coordinate
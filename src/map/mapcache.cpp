@@ -21,6 +21,7 @@
 #include "items/item.hpp"
 #include "map/map.hpp"
 #include "utils/hash.hpp"
+#include "utils/slab_allocator.hpp"
 
 static phmap::flat_hash_map<size_t, std::shared_ptr<BasicItem>> items;
 static phmap::flat_hash_map<size_t, std::shared_ptr<BasicTile>> tiles;
@@ -148,15 +149,20 @@ std::shared_ptr<Item> MapCache::createItem(std::shared_ptr<BasicItem> &&basicIte
 	return item;
 }
 
-std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::shared_ptr<Floor> &floor, uint16_t x, uint16_t y) {
-	const auto &cachedTile = floor->getTileCache(x, y);
+std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(Floor* floor, uint16_t x, uint16_t y) {
+	if (!floor->getTileCache(x, y)) {
+		return floor->getTile(x, y);
+	}
+
+	std::unique_lock l(floor->getMutex());
+
+	// Outro thread pode ter criado o tile enquanto esperávamos
+	const auto cachedTile = floor->getTileCache(x, y);
 	const auto oldTile = floor->getTile(x, y);
 	if (!cachedTile) {
 		return oldTile;
 	}
 
-	std::unique_lock l(floor->getMutex());
-
 	const uint8_t z = floor->getZ();
 	const auto map = static_cast<Map*>(this);
 
@@ -176,7 +182,7 @@ std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::shared_ptr<F
 
 	if (cachedTile->isHouse()) {
 		if (const auto &house = map->houses.getHouse(cachedTile->houseId)) {
-			tile = std::make_shared<HouseTile>(pos, house);
+			tile = makeSlabShared<HouseTile>(pos, house);
 			tile->safeCall([tile] {
 				tile->getHouse()->addTile(tile->static_self_cast<HouseTile>());
 			});
@@ -184,9 +190,9 @@ std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::shared_ptr<F
 			g_logger().error("[{}] house not found for houseId {}", std::source_location::current().function_name(), cachedTile->houseId);
 		}
 	} else if (cachedTile->isStatic) {
-		tile = std::make_shared<StaticTile>(pos);
+		tile = makeSlabShared<StaticTile>(pos);
 	} else {
-		tile = std::make_shared<DynamicTile>(pos);
+		tile = makeSlabShared<DynamicTile>(pos);
 	}
 
 	if (cachedTile->ground != nullptr) {
@@ -205,6 +211,8 @@ std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::shared_ptr<F
 	}
 
 	tile->setFlag(static_cast<TileFlags_t>(cachedTile->flags));
+	// Until its items change, the tile shares their encoding with every tile loaded with the same ones
+	tile->setStaticItems(true);
 
 	tile->safeCall([tile, pos, movedOldCreatureList = std::move(oldCreatureList)]() {
 		for (const auto &creature : movedOldCreatureList) {
@@ -250,7 +258,62 @@ MapSector* MapCache::createMapSector(const uint32_t x, const uint32_t y) {
 	}
 
 	MapSector::newSector = true;
-	return &mapSectors[index];
+	++MapSector::sectorsGeneration;
+	const auto sector = &mapSectors[index];
+
+	// Sectors created after the grid was built must be found through it as well
+	const uint32_t gridX = x / SECTOR_SIZE - denseGrid.baseX;
+	const uint32_t gridY = y / SECTOR_SIZE - denseGrid.baseY;
+	if (gridX < denseGrid.width && gridY < denseGrid.height) {
+		denseGrid.sectors[gridY * denseGrid.width + gridX] = sector;
+	}
+
+	return sector;
+}
+
+bool MapCache::buildDenseGrid() {
+	denseGrid = {};
+	if (mapSectors.empty()) {
+		return false;
+	}
+
+	uint32_t minX = std::numeric_limits<uint32_t>::max();
+	uint32_t minY = std::numeric_limits<uint32_t>::max();
+	uint32_t maxX = 0;
+	uint32_t maxY = 0;
+	for (const auto &index : mapSectors | std::views::keys) {
+		const uint32_t sectorX = index & 0xFFFF;
+		const uint32_t sectorY = index >> 16;
+		minX = std::min(minX, sectorX);
+		minY = std::min(minY, sectorY);
+		maxX = std::max(maxX, sectorX);
+		maxY = std::max(maxY, sectorY);
+	}
+
+	const size_t width = maxX - minX + 1;
+	const size_t height = maxY - minY + 1;
+	const size_t cells = width * height;
+	const auto occupancy = static_cast<double>(mapSectors.size()) / static_cast<double>(cells);
+	if (cells > DENSE_GRID_MAX_SECTORS || occupancy < DENSE_GRID_MIN_OCCUPANCY) {
+		g_logger().debug("Map sectors kept in a hash map, {}x{} grid would be {:.0f}% occupied", width, height, occupancy * 100);
+		return false;
+	}
+
+	std::vector<MapSector*> sectors(cells, nullptr);
+	for (auto &[index, sector] : mapSectors) {
+		sectors[((index >> 16) - minY) * width + ((index & 0xFFFF) - minX)] = &sector;
+	}
+
+	denseGrid = {
+		.sectors = std::move(sectors),
+		.baseX = minX,
+		.baseY = minY,
+		.width = static_cast<uint32_t>(width),
+		.height = static_cast<uint32_t>(height),
+	};
+
+	g_logger().debug("Map sectors indexed by a {}x{} dense grid, {:.0f}% occupied ({} KB)", width, height, occupancy * 100, cells * sizeof(MapSector*) / 1024);
+	return true;
 }
 
 MapSector* MapCache::getBestMapSector(uint32_t x, uint32_t y) {
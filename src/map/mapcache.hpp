@@ -108,21 +108,57 @@ public:
 	 * \returns A pointer to that map sector.
 	 */
 	[[nodiscard]] MapSector* getMapSector(const uint32_t x, const uint32_t y) {
-		const auto it = mapSectors.find(x / SECTOR_SIZE | y / SECTOR_SIZE << 16);
-		return it != mapSectors.end() ? &it->second : nullptr;
+		return const_cast<MapSector*>(std::as_const(*this).getMapSector(x, y));
 	}
 
 	[[nodiscard]] const MapSector* getMapSector(const uint32_t x, const uint32_t y) const {
+		// Unsigned wrap makes anything left or above the grid fail the bounds check too
+		const uint32_t gridX = x / SECTOR_SIZE - denseGrid.baseX;
+		const uint32_t gridY = y / SECTOR_SIZE - denseGrid.baseY;
+		if (gridX < denseGrid.width && gridY < denseGrid.height) {
+			return denseGrid.sectors[gridY * denseGrid.width + gridX];
+		}
+
 		const auto it = mapSectors.find(x / SECTOR_SIZE | y / SECTOR_SIZE << 16);
 		return it != mapSectors.end() ? &it->second : nullptr;
 	}
 
+	/**
+	 * Indexes the sectors with a flat grid covering their bounding box,
+	 * when the map is dense enough for it to be worth the memory.
+	 * Lookups inside the grid skip the hash map, the ones outside still go through it.
+	 * \returns Whether the grid is in use.
+	 */
+	bool buildDenseGrid();
+
+	[[nodiscard]] bool hasDenseGrid() const {
+		return !denseGrid.sectors.empty();
+	}
+
+	[[nodiscard]] size_t getSectorCount() const {
+		return mapSectors.size();
+	}
+
+	// Below this share of populated sectors in the bounding box the hash map is kept
+	static constexpr double DENSE_GRID_MIN_OCCUPANCY = 0.25;
+	static constexpr size_t DENSE_GRID_MAX_SECTORS = 1 << 22;
+
 protected:
-	std::shared_ptr<Tile> getOrCreateTileFromCache(const std::shared_ptr<Floor> &floor, uint16_t x, uint16_t y);
+	std::shared_ptr<Tile> getOrCreateTileFromCache(Floor* floor, uint16_t x, uint16_t y);
 
 	std::unordered_map<uint32_t, MapSector> mapSectors;
 
 private:
+	struct DenseGrid {
+		std::vector<MapSector*> sectors;
+		uint32_t baseX = 0;
+		uint32_t baseY = 0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+	};
+
+	DenseGrid denseGrid;
+
 	void parseItemAttr(const std::shared_ptr<BasicItem> &basicItem, const std::shared_ptr<Item> &item) const;
 	std::shared_ptr<Item> createItem(const std::shared_ptr<BasicItem> &basicItem, Position position);
 
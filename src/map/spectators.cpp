@@ -13,15 +13,46 @@
 #include "game/game.hpp"
 
 // Pré-alocação para o cache de espectadores para evitar rehashing
-phmap::flat_hash_map<Position, SpectatorsCache> Spectators::spectatorsCache { 256 };
+phmap::flat_hash_map<SpectatorsCacheKey, SpectatorsCache> Spectators::spectatorsCache { 256 };
 
 void Spectators::clearCache() {
 	spectatorsCache.clear();
 }
 
+void Spectators::invalidate(const Position &pos) {
+	if (const auto sector = g_game().map.getMapSector(pos.x, pos.y)) {
+		sector->touch();
+	}
+}
+
+bool Spectators::isValid(const SpectatorsCache &cache) {
+	if (cache.sectorsGeneration != MapSector::getSectorsGeneration()) {
+		return false;
+	}
+
+	return std::ranges::all_of(cache.sectors, [](const auto &sector) {
+		return sector.sector->getVersion() == sector.version;
+	});
+}
+
+void Spectators::pruneCache() {
+	phmap::erase_if(spectatorsCache, [](const auto &entry) {
+		return !isValid(entry.second);
+	});
+}
+
+void Spectators::trimCache() {
+	pruneCache();
+
+	// Everything is still valid, start over rather than paying for an LRU on every lookup
+	if (spectatorsCache.size() >= MAX_CACHE_ENTRIES) {
+		spectatorsCache.clear();
+	}
+}
+
 Spectators Spectators::insert(const std::shared_ptr<Creature> &creature) {
 	if (creature) {
-		creatures.emplace_back(creature);
+		mutableList().emplace_back(creature);
 	}
 	return *this;
 }
@@ -32,11 +63,15 @@ Spectators Spectators::insertAll(const CreatureVector &list) {
 	}
 
 	// Caso especial para lista vazia - apenas copiar
-	if (creatures.empty()) {
+	if (empty()) {
+		shared.reset();
 		creatures = list;
 		return *this;
 	}
 
+	// Garantir que a lista é nossa antes de juntar
+	mutableList();
+
 	// Pré-alocar para evitar múltiplas realocações
 	creatures.reserve(creatures.size() + list.size());
 
@@ -69,69 +104,7 @@ Spectators Spectators::insertAll(const CreatureVector &list) {
 	return *this;
 }
 
-bool Spectators::checkCache(const SpectatorsCache::FloorData &specData, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, const Position &centerPos, bool checkDistance, bool multifloor, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
-	const auto &list = multifloor || !specData.floor ? specData.multiFloor : specData.floor;
-
-	if (!list || list->empty()) {
-		return false;
-	}
-
-	if (!multifloor && !specData.floor) {
-		// Force check the distance of creatures as we only need to pick up creatures from the Floor(centerPos.z)
-		checkDistance = true;
-	}
-
-	if (checkDistance) {
-		// Pré-alocar para evitar realocações durante o loop
-		const size_t estimatedSize = list->size() / 2; // Estimativa conservadora
-		if (creatures.capacity() < estimatedSize) {
-			creatures.reserve(estimatedSize);
-		}
-
-		// Verificações rápidas para filtrar criaturas
-		for (const auto &creature : *list) {
-			const auto &specPos = creature->getPosition();
-
-			// Otimização de branch prediction - verificar a condição mais frequente primeiro
-			if (!multifloor && specPos.z != centerPos.z) {
-				continue;
-			}
-
-			// Verificar se está dentro dos limites XY
-			const int dx = centerPos.x - specPos.x;
-			const int dy = centerPos.y - specPos.y;
-
-			if (dx < minRangeX || dx > maxRangeX || dy < minRangeY || dy > maxRangeY) {
-				continue;
-			}
-
-			// Filtrar por tipo de criatura
-			if (onlyPlayers) {
-				if (!creature->getPlayer()) {
-					continue;
-				}
-			} else if (onlyMonsters) {
-				if (!creature->getMonster()) {
-					continue;
-				}
-			} else if (onlyNpcs) {
-				if (!creature->getNpc()) {
-					continue;
-				}
-			}
-
-			// Passou por todas as verificações, adicionar à lista
-			creatures.emplace_back(creature);
-		}
-	} else {
-		// Sem verificação de distância, adicionar tudo
-		insertAll(*list);
-	}
-
-	return true;
-}
-
-CreatureVector Spectators::getSpectators(const Position &centerPos, bool multifloor, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
+CreatureVector Spectators::getSpectators(const Position &centerPos, bool multifloor, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY, std::vector<SpectatorsCache::SectorVersion>* sectors) {
 	// Cálculo otimizado para limites Z
 	uint8_t minRangeZ = centerPos.z;
 	uint8_t maxRangeZ = centerPos.z;
@@ -179,10 +152,28 @@ CreatureVector Spectators::getSpectators(const Position &centerPos, bool multifl
 	CreatureVector spectators;
 	spectators.reserve(64); // Valor típico para um setor com players
 
-	// Cache local para setores já processados para evitar processamento duplicado
-	phmap::flat_hash_set<const MapSector*> processedSectors;
+	// Setores já processados, com a versão lida de cada um para validar o cache depois
+	std::vector<SpectatorsCache::SectorVersion> localSectors;
+	auto &processedSectors = sectors ? *sectors : localSectors;
+	processedSectors.clear();
 	processedSectors.reserve(16); // Típico número de setores para um campo de visão normal
 
+	// Os offsets são comparados em 16 bits sem sinal, como as coordenadas do mapa
+	const SectorCreatureQuery query {
+		.baseX = static_cast<uint16_t>(min_x + centerPos.z),
+		.baseY = static_cast<uint16_t>(min_y + centerPos.z),
+		.width = static_cast<uint16_t>(width),
+		.height = static_cast<uint16_t>(height),
+		.minZ = minRangeZ,
+		.depth = static_cast<uint16_t>(depth),
+		.kinds = onlyPlayers ? SectorCreatures::KIND_PLAYER : onlyMonsters ? SectorCreatures::KIND_MONSTER
+			: onlyNpcs                                                     ? SectorCreatures::KIND_NPC
+																		   : SectorCreatures::KIND_ALL,
+	};
+
+	std::vector<uint32_t> matches;
+	matches.reserve(64);
+
 	// Busca em setores otimizada
 	const MapSector* startSector = g_game().map.getMapSector(startx1, starty1);
 	const MapSector* sectorS = startSector;
@@ -192,38 +183,17 @@ CreatureVector Spectators::getSpectators(const Position &centerPos, bool multifl
 		for (int32_t nx = startx1; nx <= endx2; nx += SECTOR_SIZE) {
 			if (sectorE) {
 				// Evitar processamento duplicado (pode ocorrer em certos padrões de mapa)
-				if (processedSectors.insert(sectorE).second) {
-					// Selecionar a lista apropriada apenas uma vez
-					const auto &nodeList = onlyPlayers ? sectorE->player_list : onlyMonsters ? sectorE->monster_list
-						: onlyNpcs                                                           ? sectorE->npc_list
-																							 : sectorE->creature_list;
-
-					// Verificar se a lista não está vazia antes de processá-la
-					if (!nodeList.empty()) {
-						// Pré-alocar mais espaço se necessário
-						if (spectators.size() + nodeList.size() > spectators.capacity()) {
-							spectators.reserve(spectators.capacity() + nodeList.size());
-						}
-
-						for (const auto &creature : nodeList) {
-							const auto &cpos = creature->getPosition();
-
-							// Verificação rápida de profundidade primeiro (branch prediction otimizada)
-							const uint32_t zDiff = static_cast<uint32_t>(static_cast<int32_t>(cpos.z) - minRangeZ);
-							if (zDiff > depth) {
-								continue;
-							}
-
-							const int_fast16_t offsetZ = Position::getOffsetZ(centerPos, cpos);
-
-							// Calcular offsets uma única vez e verificar limites
-							const uint32_t offsetX = cpos.x - offsetZ - min_x;
-							const uint32_t offsetY = cpos.y - offsetZ - min_y;
-
-							if (offsetX <= width && offsetY <= height) {
-								spectators.emplace_back(creature);
-							}
-						}
+				const auto processed = std::ranges::any_of(processedSectors, [sectorE](const auto &sector) {
+					return sector.sector == sectorE;
+				});
+				if (!processed) {
+					processedSectors.push_back({ sectorE, sectorE->getVersion() });
+
+					// Filtra pelo espelho compacto do setor, só as criaturas aceitas são tocadas
+					matches.clear();
+					filterSectorCreatures(sectorE->creature_index, query, matches);
+					for (const auto index : matches) {
+						spectators.emplace_back(sectorE->creature_list[index]);
 					}
 				}
 
@@ -252,81 +222,47 @@ Spectators Spectators::find(const Position &centerPos, bool multifloor, bool onl
 
 	// Fast path - ignorar cache se solicitado
 	if (!useCache) {
-		insertAll(getSpectators(centerPos, multifloor, onlyPlayers, onlyMonsters, onlyNpcs, minRangeX, maxRangeX, minRangeY, maxRangeY));
-		return *this;
-	}
-
-	// Verificar cache existente
-	auto it = spectatorsCache.find(centerPos);
-	const bool cacheFound = it != spectatorsCache.end();
-
-	if (cacheFound) {
-		auto &cache = it->second;
-
-		// Verificar se o cache atual abrange os ranges solicitados
-		if (minRangeX >= cache.minRangeX && maxRangeX <= cache.maxRangeX && minRangeY >= cache.minRangeY && maxRangeY <= cache.maxRangeY) {
-
-			const bool checkDistance = minRangeX != cache.minRangeX || maxRangeX != cache.maxRangeX || minRangeY != cache.minRangeY || maxRangeY != cache.maxRangeY;
-
-			// Tentativa 1: Verificar cache específico (players/monsters/npcs)
-			if (onlyPlayers || onlyMonsters || onlyNpcs) {
-				const auto &creaturesCache = onlyPlayers ? cache.players : onlyMonsters ? cache.monsters
-					: onlyNpcs                                                          ? cache.npcs
-																						: cache.creatures;
-
-				if (checkCache(creaturesCache, onlyPlayers, onlyMonsters, onlyNpcs, centerPos, checkDistance, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
-					return *this;
-				}
-
-				// Tentativa 2: Usar o cache de todas as criaturas com filtro
-				if (checkCache(cache.creatures, onlyPlayers, onlyMonsters, onlyNpcs, centerPos, true, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
-					return *this;
-				}
-			} else if (checkCache(cache.creatures, false, false, false, centerPos, checkDistance, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
-				// Tentativa 3: Para todas as criaturas, usar o cache geral
-				return *this;
-			}
+		auto spectators = getSpectators(centerPos, multifloor, onlyPlayers, onlyMonsters, onlyNpcs, minRangeX, maxRangeX, minRangeY, maxRangeY);
+		if (empty()) {
+			shared.reset();
+			creatures = std::move(spectators);
 		} else {
-			// O cache existe mas não cobre o range solicitado - expandir o cache
-			cache.minRangeX = minRangeX = std::min<int32_t>(minRangeX, cache.minRangeX);
-			cache.minRangeY = minRangeY = std::min<int32_t>(minRangeY, cache.minRangeY);
-			cache.maxRangeX = maxRangeX = std::max<int32_t>(maxRangeX, cache.maxRangeX);
-			cache.maxRangeY = maxRangeY = std::max<int32_t>(maxRangeY, cache.maxRangeY);
+			insertAll(spectators);
 		}
+		return *this;
 	}
 
-	// Cache miss ou cache inválido - computar novos espectadores
-	const auto &spectators = getSpectators(centerPos, multifloor, onlyPlayers, onlyMonsters, onlyNpcs, minRangeX, maxRangeX, minRangeY, maxRangeY);
-
-	// Criar ou atualizar cache
-	auto &cache = cacheFound ? it->second : spectatorsCache.try_emplace(centerPos, SpectatorsCache { .minRangeX = minRangeX, .maxRangeX = maxRangeX, .minRangeY = minRangeY, .maxRangeY = maxRangeY }).first->second;
-
-	// Atualizar cache específico (players/monsters/npcs ou geral)
-	auto &creaturesCache = onlyPlayers ? cache.players : onlyMonsters ? cache.monsters
-		: onlyNpcs                                                    ? cache.npcs
-																	  : cache.creatures;
-
-	// Atualizar lista floor ou multifloor
-	auto &creatureList = (multifloor ? creaturesCache.multiFloor : creaturesCache.floor);
-
-	if (!creatureList) {
-		creatureList.emplace();
-		creatureList->reserve(spectators.size() + 16); // Adicionar margem para crescimento
-	} else {
-		creatureList->clear();
-
-		// Redimensionar se necessário para evitar realocações futuras
-		if (creatureList->capacity() < spectators.size()) {
-			creatureList->reserve(spectators.size() + 16);
+	const SpectatorsCacheKey key {
+		.centerPos = centerPos,
+		.minRangeX = minRangeX,
+		.maxRangeX = maxRangeX,
+		.minRangeY = minRangeY,
+		.maxRangeY = maxRangeY,
+		.multifloor = multifloor,
+		.filter = static_cast<uint8_t>(onlyPlayers ? FILTER_PLAYERS : onlyMonsters ? FILTER_MONSTERS : onlyNpcs ? FILTER_NPCS : FILTER_NONE),
+	};
+
+	auto it = spectatorsCache.find(key);
+	if (it == spectatorsCache.end()) {
+		if (spectatorsCache.size() >= MAX_CACHE_ENTRIES) {
+			trimCache();
 		}
+		it = spectatorsCache.try_emplace(key).first;
 	}
 
-	// Copiar espectadores para o cache
-	if (!spectators.empty()) {
-		creatureList->insert(creatureList->end(), spectators.begin(), spectators.end());
+	// Only the sectors the lookup walked are checked, a change anywhere else in the map keeps the entry alive
+	auto &cache = it->second;
+	if (!cache.creatures || !isValid(cache)) {
+		cache.sectorsGeneration = MapSector::getSectorsGeneration();
+		cache.creatures = std::make_shared<const CreatureVector>(getSpectators(centerPos, multifloor, onlyPlayers, onlyMonsters, onlyNpcs, minRangeX, maxRangeX, minRangeY, maxRangeY, &cache.sectors));
+	}
 
-		// Atualizar nossa lista de espectadores
-		insertAll(spectators);
+	if (empty()) {
+		// Share the cached result instead of copying every creature
+		creatures.clear();
+		shared = cache.creatures;
+	} else {
+		insertAll(*cache.creatures);
 	}
 
 	return *this;
@@ -334,13 +270,14 @@ Spectators Spectators::find(const Position &centerPos, bool multifloor, bool onl
 
 Spectators Spectators::excludeMaster() const {
 	auto specs = Spectators();
-	if (creatures.empty()) {
+	const auto &spectators = list();
+	if (spectators.empty()) {
 		return specs;
 	}
 
-	specs.creatures.reserve(creatures.size());
+	specs.creatures.reserve(spectators.size());
 
-	for (const auto &c : creatures) {
+	for (const auto &c : spectators) {
 		if (c->getMonster() != nullptr && !c->getMaster()) {
 			specs.insert(c);
 		}
@@ -351,13 +288,14 @@ Spectators Spectators::excludeMaster() const {
 
 Spectators Spectators::excludePlayerMaster() const {
 	auto specs = Spectators();
-	if (creatures.empty()) {
+	const auto &spectators = list();
+	if (spectators.empty()) {
 		return specs;
 	}
 
-	specs.creatures.reserve(creatures.size());
+	specs.creatures.reserve(spectators.size());
 
-	for (const auto &c : creatures) {
+	for (const auto &c : spectators) {
 		if ((c->getMonster() != nullptr && !c->getMaster()) || (!c->getMaster() || !c->getMaster()->getPlayer())) {
 			specs.insert(c);
 		}
@@ -367,16 +305,22 @@ Spectators Spectators::excludePlayerMaster() const {
 }
 
 Spectators Spectators::filter(bool onlyPlayers, bool onlyMonsters, bool onlyNpcs) const {
+	// Sem filtro, o resultado pode continuar compartilhado
+	if (!onlyPlayers && !onlyMonsters && !onlyNpcs) {
+		return *this;
+	}
+
 	auto specs = Spectators();
-	if (creatures.empty()) {
+	const auto &spectators = list();
+	if (spectators.empty()) {
 		return specs;
 	}
 
 	// Estimativa de tamanho para pré-alocação
-	specs.creatures.reserve(onlyPlayers || onlyMonsters || onlyNpcs ? creatures.size() / 2 : creatures.size());
+	specs.creatures.reserve(onlyPlayers || onlyMonsters || onlyNpcs ? spectators.size() / 2 : spectators.size());
 
 	// Loop otimizado com branch prediction favorável
-	for (const auto &c : creatures) {
+	for (const auto &c : spectators) {
 		if (onlyPlayers) {
 			if (c->getPlayer() != nullptr) {
 				specs.insert(c);
@@ -9,60 +9,80 @@
 
 #pragma once
 
+#include "game/movement/position.hpp"
+
 class Creature;
 class Player;
 class Monster;
 class Npc;
-struct Position;
 
 // Forward declaration para CreatureVector
 using CreatureVector = std::vector<std::shared_ptr<Creature>>;
 
-struct SpectatorsCache {
-	struct FloorData {
-		std::optional<CreatureVector> floor;
-		std::optional<CreatureVector> multiFloor;
-
-		// Inicializador que pré-aloca para evitar realocações frequentes
-		void initialize() {
-			if (!floor) {
-				floor.emplace();
-			}
-			if (!multiFloor) {
-				multiFloor.emplace();
-			}
-
-			floor->reserve(64); // Tamanho típico para espectadores no mesmo nível
-			multiFloor->reserve(128); // Tamanho típico para espectadores em múltiplos níveis
-		}
-	};
+class MapSector;
 
+/**
+ * @brief Identifies a spectators lookup: the area around a position plus the creature filter.
+ */
+struct SpectatorsCacheKey {
+	Position centerPos;
 	int32_t minRangeX { 0 };
 	int32_t maxRangeX { 0 };
 	int32_t minRangeY { 0 };
 	int32_t maxRangeY { 0 };
+	bool multifloor { false };
+	uint8_t filter { 0 };
 
-	FloorData creatures;
-	FloorData monsters;
-	FloorData npcs;
-	FloorData players;
-
-	// Timestamp de última atualização para possível invalidação de cache por tempo
-	uint64_t lastUpdate { 0 };
-
-	// Inicializador que configura todas as estruturas de dados
-	void initialize() {
-		creatures.initialize();
-		monsters.initialize();
-		npcs.initialize();
-		players.initialize();
-		lastUpdate = std::chrono::steady_clock::now().time_since_epoch().count();
-	}
+	bool operator==(const SpectatorsCacheKey &other) const = default;
+};
+
+namespace std {
+	template <>
+	struct hash<SpectatorsCacheKey> {
+		[[nodiscard]] std::size_t operator()(const SpectatorsCacheKey &key) const noexcept {
+			// Ranges are tiny, a byte each is enough to tell them apart
+			uint64_t bits = static_cast<uint8_t>(key.minRangeX);
+			bits |= static_cast<uint64_t>(static_cast<uint8_t>(key.maxRangeX)) << 8;
+			bits |= static_cast<uint64_t>(static_cast<uint8_t>(key.minRangeY)) << 16;
+			bits |= static_cast<uint64_t>(static_cast<uint8_t>(key.maxRangeY)) << 24;
+			bits |= static_cast<uint64_t>(key.multifloor) << 32;
+			bits |= static_cast<uint64_t>(key.filter) << 40;
+
+			const auto seed = std::hash<Position> {}(key.centerPos);
+			return seed ^ (std::hash<uint64_t> {}(bits) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+		}
+	};
+}
+
+/**
+ * @brief Result of a spectators lookup together with the version of every sector it was built from.
+ * The entry stays valid for as long as none of those sectors changed.
+ */
+struct SpectatorsCache {
+	struct SectorVersion {
+		const MapSector* sector = nullptr;
+		uint32_t version = 0;
+	};
+
+	std::vector<SectorVersion> sectors;
+	std::shared_ptr<const CreatureVector> creatures;
+	uint32_t sectorsGeneration { 0 };
 };
 
 class Spectators {
 public:
 	static void clearCache();
+	/**
+	 * @brief Drops cached lookups whose sectors changed since, so the creatures they hold
+	 * (dead monsters, players that logged out) are released without waiting for the key to come back.
+	 */
+	static void pruneCache();
+
+	/**
+	 * @brief Marks the sector holding the position as changed, cached lookups
+	 * covering it are recomputed the next time they are requested.
+	 */
+	static void invalidate(const Position &pos);
 
 	template <typename T>
 		requires std::is_base_of_v<Creature, T>
@@ -89,48 +109,83 @@ public:
 	Spectators insertAll(const CreatureVector &list);
 
 	Spectators join(const Spectators &anotherSpectators) {
-		return insertAll(anotherSpectators.creatures);
+		return insertAll(anotherSpectators.list());
 	}
 
-	// Métodos inlined para melhor performance
 	[[nodiscard]] inline bool contains(const std::shared_ptr<Creature> &creature) const {
-		return std::ranges::find(creatures, creature) != creatures.end();
+		return std::ranges::find(list(), creature) != list().end();
 	}
 
 	inline bool erase(const std::shared_ptr<Creature> &creature) {
-		return std::erase(creatures, creature) > 0;
+		if (!contains(creature)) {
+			return false;
+		}
+		return std::erase(mutableList(), creature) > 0;
 	}
 
 	[[nodiscard]] inline bool empty() const noexcept {
-		return creatures.empty();
+		return list().empty();
 	}
 
 	[[nodiscard]] inline size_t size() const noexcept {
-		return creatures.size();
+		return list().size();
 	}
 
 	[[nodiscard]] inline auto begin() const noexcept {
-		return creatures.begin();
+		return list().begin();
 	}
 
 	[[nodiscard]] inline auto end() const noexcept {
-		return creatures.end();
+		return list().end();
 	}
 
-	[[nodiscard]] inline const auto &data() const noexcept {
-		return creatures;
+	[[nodiscard]] inline const CreatureVector &data() const noexcept {
+		return list();
+	}
+
+	/**
+	 * @brief Non-owning view of the spectators, valid for as long as this object lives.
+	 */
+	[[nodiscard]] inline std::span<const std::shared_ptr<Creature>> view() const noexcept {
+		return list();
 	}
 
 private:
-	// Pré-alocado com tamanho inicial para evitar rehashing frequente
-	static phmap::flat_hash_map<Position, SpectatorsCache> spectatorsCache;
+	enum Filter : uint8_t {
+		FILTER_NONE,
+		FILTER_PLAYERS,
+		FILTER_MONSTERS,
+		FILTER_NPCS,
+	};
+
+	// Bounds the number of cached lookups, stale entries are dropped first once it is reached
+	static constexpr size_t MAX_CACHE_ENTRIES = 8192;
+
+	static phmap::flat_hash_map<SpectatorsCacheKey, SpectatorsCache> spectatorsCache;
+
+	static bool isValid(const SpectatorsCache &cache);
+	static void trimCache();
 
 	Spectators find(const Position &centerPos, bool multifloor = false, bool onlyPlayers = false, bool onlyMonsters = false, bool onlyNpcs = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0, bool useCache = true);
-	CreatureVector getSpectators(const Position &centerPos, bool multifloor = false, bool onlyPlayers = false, bool onlyMonsters = false, bool onlyNpcs = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0);
+	static CreatureVector getSpectators(const Position &centerPos, bool multifloor = false, bool onlyPlayers = false, bool onlyMonsters = false, bool onlyNpcs = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0, std::vector<SpectatorsCache::SectorVersion>* sectors = nullptr);
 
 	Spectators filter(bool onlyPlayers, bool onlyMonsters, bool onlyNpcs) const;
 
-	bool checkCache(const SpectatorsCache::FloorData &specData, bool onlyPlayers, bool onlyMonsters, bool onlyNpcs, const Position &centerPos, bool checkDistance, bool multifloor, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY);
+	[[nodiscard]] inline const CreatureVector &list() const noexcept {
+		return shared ? *shared : creatures;
+	}
+
+	// Copies a shared cached result before it gets modified
+	CreatureVector &mutableList() {
+		if (shared) {
+			creatures = *shared;
+			shared.reset();
+		}
+		return creatures;
+	}
 
 	CreatureVector creatures;
+
+	// Cached result shared with the spectators cache, no creature is copied until it is modified
+	std::shared_ptr<const CreatureVector> shared;
 };
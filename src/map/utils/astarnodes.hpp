@@ -19,9 +19,23 @@ struct AStarNode {
 	uint16_t x, y;
 };
 
+/**
+ * @brief Node storage for a single A* search.
+ *
+ * Every thread owns one arena that is reset and reused by each search it runs, so nothing is
+ * allocated or zeroed per call. Open nodes are kept in a binary heap ordered by (f + g, index),
+ * and positions are looked up through a small open addressing table whose slots are
+ * invalidated by bumping a stamp instead of being cleared.
+ */
 class AStarNodes {
 public:
-	AStarNodes(uint32_t x, uint32_t y, int_fast32_t extraCost);
+	static constexpr int32_t MAX_NODES = 512;
+
+	/**
+	 * @brief Returns the arena of the calling thread, reset for a search starting at (x, y).
+	 * @note The arena is shared by every search on this thread, a search must finish before another one starts.
+	 */
+	static AStarNodes &acquire(uint32_t x, uint32_t y, int_fast32_t extraCost);
 
 	bool createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_fast32_t f, int_fast32_t heuristic, int_fast32_t extraCost);
 	AStarNode* getBestNode();
@@ -34,20 +48,39 @@ public:
 	static int_fast32_t getTileWalkCost(const std::shared_ptr<Creature> &creature, const std::shared_ptr<Tile> &tile);
 
 private:
-	static constexpr int32_t MAX_NODES = 512;
+	AStarNodes() = default;
+
+	void reset(uint32_t x, uint32_t y, int_fast32_t extraCost);
+	void pushOpen(int32_t index);
+	void indexNode(uint32_t key, int32_t index);
+
+	struct OpenEntry {
+		int_fast32_t cost;
+		int32_t index;
+	};
+
+	// Twice the node limit keeps the probe sequences short
+	static constexpr uint32_t TABLE_BITS = 10;
+	static constexpr uint32_t TABLE_SIZE = 1 << TABLE_BITS;
+
+	// Fibonacci hashing, the high bits of the product mix both coordinates
+	static uint32_t getSlot(uint32_t key) {
+		return (key * 0x9E3779B1u) >> (32 - TABLE_BITS);
+	}
+
 	static constexpr int32_t MAP_NORMALWALKCOST = 10;
 	static constexpr int32_t MAP_PREFERDIAGONALWALKCOST = 14;
 	static constexpr int32_t MAP_DIAGONALWALKCOST = 25;
 
-#if defined(__SSE2__)
-	alignas(16) uint32_t nodesTable[MAX_NODES] {};
-	alignas(64) int32_t calculatedNodes[MAX_NODES] {};
 	AStarNode nodes[MAX_NODES];
-#else
-	AStarNode nodes[MAX_NODES];
-	uint32_t nodesTable[MAX_NODES];
-#endif
-	int32_t closedNodes;
-	int32_t curNode;
 	bool openNodes[MAX_NODES];
+	std::vector<OpenEntry> openList;
+
+	uint32_t tableKeys[TABLE_SIZE] {};
+	uint32_t tableStamps[TABLE_SIZE] {};
+	int16_t tableNodes[TABLE_SIZE] {};
+	uint32_t stamp = 0;
+
+	int32_t closedNodes = 0;
+	int32_t curNode = 0;
 };
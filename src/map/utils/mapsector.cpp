@@ -12,16 +12,103 @@
 #include "creatures/creature.hpp"
 
 bool MapSector::newSector = false;
+uint32_t MapSector::sectorsGeneration = 0;
+
+namespace {
+	uint8_t getCreatureKind(const std::shared_ptr<Creature> &c) {
+		if (c->getPlayer()) {
+			return SectorCreatures::KIND_PLAYER;
+		} else if (c->getMonster()) {
+			return SectorCreatures::KIND_MONSTER;
+		} else if (c->getNpc()) {
+			return SectorCreatures::KIND_NPC;
+		}
+		return SectorCreatures::KIND_OTHER;
+	}
+}
+
+void filterSectorCreaturesScalar(const SectorCreatures &creatures, const SectorCreatureQuery &query, std::vector<uint32_t> &out, size_t begin) {
+	const auto size = creatures.size();
+	for (size_t i = begin; i < size; ++i) {
+		const auto z = creatures.z[i];
+		const auto offsetX = static_cast<uint16_t>(creatures.x[i] + z - query.baseX);
+		const auto offsetY = static_cast<uint16_t>(creatures.y[i] + z - query.baseY);
+		const auto offsetZ = static_cast<uint16_t>(z - query.minZ);
+		if ((creatures.kind[i] & query.kinds) != 0 && offsetZ <= query.depth && offsetX <= query.width && offsetY <= query.height) {
+			out.emplace_back(static_cast<uint32_t>(i));
+		}
+	}
+}
+
+void filterSectorCreatures(const SectorCreatures &creatures, const SectorCreatureQuery &query, std::vector<uint32_t> &out) {
+	const auto size = creatures.size();
+	size_t i = 0;
+
+#if defined(__AVX2__)
+	// a <= limit, unsigned, is the same as saturating(a - limit) == 0
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i baseX = _mm256_set1_epi16(static_cast<int16_t>(query.baseX));
+	const __m256i baseY = _mm256_set1_epi16(static_cast<int16_t>(query.baseY));
+	const __m256i minZ = _mm256_set1_epi16(static_cast<int16_t>(query.minZ));
+	const __m256i width = _mm256_set1_epi16(static_cast<int16_t>(query.width));
+	const __m256i height = _mm256_set1_epi16(static_cast<int16_t>(query.height));
+	const __m256i depth = _mm256_set1_epi16(static_cast<int16_t>(query.depth));
+	const __m256i kinds = _mm256_set1_epi16(query.kinds);
+
+	for (; i + 16 <= size; i += 16) {
+		const __m256i z = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&creatures.z[i]));
+		const __m256i x = _mm256_sub_epi16(_mm256_add_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&creatures.x[i])), z), baseX);
+		const __m256i y = _mm256_sub_epi16(_mm256_add_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&creatures.y[i])), z), baseY);
+		const __m256i kind = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&creatures.kind[i])));
+
+		__m256i outside = _mm256_or_si256(_mm256_subs_epu16(x, width), _mm256_subs_epu16(y, height));
+		outside = _mm256_or_si256(outside, _mm256_subs_epu16(_mm256_sub_epi16(z, minZ), depth));
+		const __m256i match = _mm256_andnot_si256(_mm256_cmpeq_epi16(_mm256_and_si256(kind, kinds), zero), _mm256_cmpeq_epi16(outside, zero));
+
+		// Two mask bits per 16-bit lane, keep the low one
+		auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(match)) & 0x55555555u;
+		while (mask != 0) {
+			out.emplace_back(static_cast<uint32_t>(i + (mm_ctz(mask) >> 1)));
+			mask &= mask - 1;
+		}
+	}
+#elif defined(__SSE2__)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i baseX = _mm_set1_epi16(static_cast<int16_t>(query.baseX));
+	const __m128i baseY = _mm_set1_epi16(static_cast<int16_t>(query.baseY));
+	const __m128i minZ = _mm_set1_epi16(static_cast<int16_t>(query.minZ));
+	const __m128i width = _mm_set1_epi16(static_cast<int16_t>(query.width));
+	const __m128i height = _mm_set1_epi16(static_cast<int16_t>(query.height));
+	const __m128i depth = _mm_set1_epi16(static_cast<int16_t>(query.depth));
+	const __m128i kinds = _mm_set1_epi16(query.kinds);
+
+	for (; i + 8 <= size; i += 8) {
+		const __m128i z = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&creatures.z[i]));
+		const __m128i x = _mm_sub_epi16(_mm_add_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&creatures.x[i])), z), baseX);
+		const __m128i y = _mm_sub_epi16(_mm_add_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&creatures.y[i])), z), baseY);
+		const __m128i kind = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&creatures.kind[i])), zero);
+
+		__m128i outside = _mm_or_si128(_mm_subs_epu16(x, width), _mm_subs_epu16(y, height));
+		outside = _mm_or_si128(outside, _mm_subs_epu16(_mm_sub_epi16(z, minZ), depth));
+		const __m128i match = _mm_andnot_si128(_mm_cmpeq_epi16(_mm_and_si128(kind, kinds), zero), _mm_cmpeq_epi16(outside, zero));
+
+		auto mask = static_cast<uint32_t>(_mm_movemask_epi8(match)) & 0x5555u;
+		while (mask != 0) {
+			out.emplace_back(static_cast<uint32_t>(i + (mm_ctz(mask) >> 1)));
+			mask &= mask - 1;
+		}
+	}
+#endif
+
+	filterSectorCreaturesScalar(creatures, query, out, i);
+}
 
 void MapSector::addCreature(const std::shared_ptr<Creature> &c) {
+	touch();
 	creature_list.emplace_back(c);
-	if (c->getPlayer()) {
-		player_list.emplace_back(c);
-	} else if (c->getMonster()) {
-		monster_list.emplace_back(c);
-	} else if (c->getNpc()) {
-		npc_list.emplace_back(c);
-	}
+
+	const auto &pos = c->getPosition();
+	creature_index.push(pos.x, pos.y, pos.z, getCreatureKind(c), c->getID());
 }
 
 void MapSector::removeCreature(const std::shared_ptr<Creature> &c) {
@@ -32,38 +119,18 @@ void MapSector::removeCreature(const std::shared_ptr<Creature> &c) {
 	}
 
 	assert(iter != creature_list.end());
+	creature_index.swapPop(static_cast<size_t>(std::distance(creature_list.begin(), iter)));
 	*iter = creature_list.back();
 	creature_list.pop_back();
+	touch();
+}
 
-	if (c->getPlayer()) {
-		iter = std::ranges::find(player_list, c);
-		if (iter == player_list.end()) {
-			g_logger().error("[{}]: Player not found in player_list!", __FUNCTION__);
-			return;
-		}
-
-		assert(iter != player_list.end());
-		*iter = player_list.back();
-		player_list.pop_back();
-	} else if (c->getMonster()) {
-		iter = std::ranges::find(monster_list, c);
-		if (iter == monster_list.end()) {
-			g_logger().error("[{}]: Monster not found in player_list!", __FUNCTION__);
-			return;
-		}
-
-		assert(iter != monster_list.end());
-		*iter = monster_list.back();
-		monster_list.pop_back();
-	} else if (c->getNpc()) {
-		iter = std::ranges::find(npc_list, c);
-		if (iter == npc_list.end()) {
-			g_logger().error("[{}]: NPC not found in player_list!", __FUNCTION__);
-			return;
-		}
+void MapSector::updateCreature(const std::shared_ptr<Creature> &c, const Position &pos) {
+	touch();
 
-		assert(iter != npc_list.end());
-		*iter = npc_list.back();
-		npc_list.pop_back();
+	// Creatures are only added to the sector once they are already on a tile
+	const auto iter = std::ranges::find(creature_list, c);
+	if (iter != creature_list.end()) {
+		creature_index.set(static_cast<size_t>(std::distance(creature_list.begin(), iter)), pos.x, pos.y, pos.z, c->getID());
 	}
 }
@@ -14,32 +14,32 @@
 class Creature;
 class Tile;
 struct BasicTile;
+struct Position;
 
+/**
+ * @brief Tiles of one floor of a sector.
+ * Reads never lock: every slot is an atomic shared pointer, so lookups from
+ * pathfinding, sight checks and map descriptions only pay for the reference count.
+ * Writers (map loading and tiles being created from the cache) serialize on the floor mutex.
+ */
 struct Floor {
 	explicit Floor(uint8_t z) :
 		z(z) { }
 
 	std::shared_ptr<Tile> getTile(uint16_t x, uint16_t y) const {
-		std::shared_lock<std::shared_mutex> sl(mutex);
-		return tiles[x & SECTOR_MASK][y & SECTOR_MASK].first;
+		return tiles[x & SECTOR_MASK][y & SECTOR_MASK].load(std::memory_order_acquire);
 	}
 
 	void setTile(uint16_t x, uint16_t y, std::shared_ptr<Tile> tile) {
-		tiles[x & SECTOR_MASK][y & SECTOR_MASK].first = std::move(tile);
+		tiles[x & SECTOR_MASK][y & SECTOR_MASK].store(std::move(tile), std::memory_order_release);
 	}
 
 	std::shared_ptr<BasicTile> getTileCache(uint16_t x, uint16_t y) const {
-		std::shared_lock<std::shared_mutex> sl(mutex);
-		return tiles[x & SECTOR_MASK][y & SECTOR_MASK].second;
+		return tileCache[x & SECTOR_MASK][y & SECTOR_MASK].load(std::memory_order_acquire);
 	}
 
-	void setTileCache(uint16_t x, uint16_t y, const std::shared_ptr<BasicTile> &newTile) {
-		tiles[x & SECTOR_MASK][y & SECTOR_MASK].second = newTile;
-	}
-
-	const auto &getTiles() const {
-		std::shared_lock<std::shared_mutex> sl(mutex);
-		return tiles;
+	void setTileCache(uint16_t x, uint16_t y, std::shared_ptr<BasicTile> newTile) {
+		tileCache[x & SECTOR_MASK][y & SECTOR_MASK].store(std::move(newTile), std::memory_order_release);
 	}
 
 	uint8_t getZ() const {
@@ -51,13 +51,97 @@ struct Floor {
 	}
 
 private:
-	std::pair<std::shared_ptr<Tile>, std::shared_ptr<BasicTile>> tiles[SECTOR_SIZE][SECTOR_SIZE] = {};
+	// Kept apart, most lookups only ever want the tile
+	std::atomic<std::shared_ptr<Tile>> tiles[SECTOR_SIZE][SECTOR_SIZE];
+	std::atomic<std::shared_ptr<BasicTile>> tileCache[SECTOR_SIZE][SECTOR_SIZE];
 
-	mutable std::shared_mutex mutex;
+	mutable std::mutex mutex;
 
 	uint8_t z { 0 };
 };
 
+/**
+ * @brief Packed mirror of the creatures of a sector, in the same order as its creature list.
+ * Keeps positions and kinds in flat arrays so range queries run over contiguous memory
+ * instead of dereferencing every creature.
+ * Coordinates are kept unsigned, as in Position.
+ */
+struct SectorCreatures {
+	enum Kind : uint8_t {
+		KIND_PLAYER = 1 << 0,
+		KIND_MONSTER = 1 << 1,
+		KIND_NPC = 1 << 2,
+		KIND_OTHER = 1 << 3,
+		KIND_ALL = 0xFF,
+	};
+
+	void push(uint16_t posX, uint16_t posY, uint16_t posZ, uint8_t creatureKind, uint32_t creatureId) {
+		x.emplace_back(posX);
+		y.emplace_back(posY);
+		z.emplace_back(posZ);
+		kind.emplace_back(creatureKind);
+		id.emplace_back(creatureId);
+	}
+
+	void set(size_t index, uint16_t posX, uint16_t posY, uint16_t posZ, uint32_t creatureId) {
+		x[index] = posX;
+		y[index] = posY;
+		z[index] = posZ;
+		id[index] = creatureId;
+	}
+
+	// Mirrors the swap-and-pop removal of the creature list
+	void swapPop(size_t index) {
+		x[index] = x.back();
+		y[index] = y.back();
+		z[index] = z.back();
+		kind[index] = kind.back();
+		id[index] = id.back();
+		x.pop_back();
+		y.pop_back();
+		z.pop_back();
+		kind.pop_back();
+		id.pop_back();
+	}
+
+	[[nodiscard]] size_t size() const {
+		return x.size();
+	}
+
+	std::vector<uint16_t> x;
+	std::vector<uint16_t> y;
+	std::vector<uint16_t> z;
+	std::vector<uint8_t> kind;
+	// Last known id, creatures are placed on the map before they get one
+	std::vector<uint32_t> id;
+};
+
+/**
+ * @brief Range and kind filter applied to SectorCreatures.
+ * A creature matches when its kind is in kinds, (z - minZ) <= depth and, once shifted by
+ * its floor offset, (x + z - baseX) <= width and (y + z - baseY) <= height, all in unsigned 16-bit math.
+ */
+struct SectorCreatureQuery {
+	uint16_t baseX = 0;
+	uint16_t baseY = 0;
+	uint16_t width = 0;
+	uint16_t height = 0;
+	uint16_t minZ = 0;
+	uint16_t depth = 0;
+	uint8_t kinds = SectorCreatures::KIND_ALL;
+};
+
+/**
+ * @brief Appends to out the index of every creature matching the query,
+ * using AVX2 or SSE2 when available.
+ */
+void filterSectorCreatures(const SectorCreatures &creatures, const SectorCreatureQuery &query, std::vector<uint32_t> &out);
+
+/**
+ * @brief Portable version of filterSectorCreatures, also used for the tail of the vectorized loops.
+ */
+void filterSectorCreaturesScalar(const SectorCreatures &creatures, const SectorCreatureQuery &query, std::vector<uint32_t> &out, size_t begin = 0);
+
 class MapSector {
 public:
 	MapSector() = default;
@@ -67,47 +151,100 @@ public:
 	MapSector(const MapSector &&) = delete;
 	MapSector &operator=(const MapSector &&) = delete;
 
-	std::shared_ptr<Floor> createFloor(uint32_t z) {
+	Floor* createFloor(uint32_t z) {
 		if (z >= MAP_MAX_LAYERS) {
 			g_logger().error("Attempt to create floor on invalid coordinate: {}", z);
 			return nullptr;
 		}
+
+		if (const auto floor = floors[z].load(std::memory_order_acquire)) {
+			return floor;
+		}
+
 		std::scoped_lock lock(floors_mutex);
-		if (!floors[z]) {
-			floors[z] = std::make_shared<Floor>(static_cast<uint8_t>(z));
+		if (!ownedFloors[z]) {
+			ownedFloors[z] = std::make_unique<Floor>(static_cast<uint8_t>(z));
+			floors[z].store(ownedFloors[z].get(), std::memory_order_release);
 		}
-		return floors[z];
+		return ownedFloors[z].get();
 	}
 
-	std::shared_ptr<Floor> getFloor(uint8_t z) {
+	/**
+	 * @brief Returns the floor without locking.
+	 * Floors are only ever created, never replaced or destroyed while the sector lives.
+	 */
+	Floor* getFloor(uint8_t z) const {
 		if (z >= MAP_MAX_LAYERS) {
 			g_logger().error("Attempt to get floor on invalid coordinate: {}", z);
 			return nullptr;
 		}
-		std::scoped_lock lock(floors_mutex);
-		return floors[z];
+		return floors[z].load(std::memory_order_acquire);
 	}
 
 	void addCreature(const std::shared_ptr<Creature> &c);
 
 	void removeCreature(const std::shared_ptr<Creature> &c);
 
+	/**
+	 * @brief Refreshes the mirrored position of a creature that moved inside this sector.
+	 */
+	void updateCreature(const std::shared_ptr<Creature> &c, const Position &pos);
+
+	/**
+	 * @brief Marks the creatures of this sector as changed.
+	 * Called whenever a creature enters, leaves or moves inside the sector,
+	 * cached spectator results covering it are recomputed on their next lookup.
+	 */
+	void touch() {
+		++version;
+		touchTiles();
+	}
+
+	[[nodiscard]] uint32_t getVersion() const {
+		return version;
+	}
+
+	/**
+	 * @brief Marks the walkability of this sector as changed, either because a tile
+	 * changed its blocking flags or because a creature entered, left or moved.
+	 * Cached paths crossing the sector are recomputed on their next lookup.
+	 * Readable from any thread, path searches run on the thread pool.
+	 */
+	void touchTiles() {
+		tileVersion.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	[[nodiscard]] uint32_t getTileVersion() const {
+		return tileVersion.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Bumped every time a sector is created, so cached lookups that
+	 * skipped a missing sector know they have to walk the map again.
+	 */
+	[[nodiscard]] static uint32_t getSectorsGeneration() {
+		return sectorsGeneration;
+	}
+
 private:
 	static bool newSector;
+	static uint32_t sectorsGeneration;
 
 	MapSector* sectorS = nullptr;
 	MapSector* sectorE = nullptr;
 
 	std::vector<std::shared_ptr<Creature>> creature_list;
-	std::vector<std::shared_ptr<Creature>> player_list;
-	std::vector<std::shared_ptr<Creature>> monster_list;
-	std::vector<std::shared_ptr<Creature>> npc_list;
+	SectorCreatures creature_index;
 
-	mutable std::mutex floors_mutex;
+	// Only taken to create a floor, lookups read the published pointers
+	std::mutex floors_mutex;
 
-	std::shared_ptr<Floor> floors[MAP_MAX_LAYERS] = {};
+	std::atomic<Floor*> floors[MAP_MAX_LAYERS] = {};
+	std::unique_ptr<Floor> ownedFloors[MAP_MAX_LAYERS];
 
 	uint32_t floorBits = 0;
+	uint32_t version = 0;
+	std::atomic_uint32_t tileVersion = 0;
 
 	friend class Spectators;
 	friend class MapCache;
@@ -0,0 +1,78 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "map/utils/pathcache.hpp"
+
+#include "creatures/creatures_definitions.hpp"
+#include "map/utils/mapsector.hpp"
+
+PathCacheKey::PathCacheKey(uint32_t creatureId, const Position &startPos, const Position &targetPos, const FindPathParams &fpp) :
+	startPos(startPos), targetPos(targetPos), creatureId(creatureId), maxSearchDist(fpp.maxSearchDist), minTargetDist(fpp.minTargetDist), maxTargetDist(fpp.maxTargetDist),
+	flags(static_cast<uint8_t>(fpp.fullPathSearch | fpp.clearSight << 1 | fpp.allowDiagonal << 2 | fpp.keepDistance << 3)) { }
+
+bool PathCache::isValid(const Entry &entry, int64_t now) {
+	if (entry.expiresAt < now) {
+		return false;
+	}
+
+	return std::ranges::all_of(entry.sectors, [](const auto &sector) {
+		return sector.sector->getTileVersion() == sector.version;
+	});
+}
+
+std::optional<bool> PathCache::lookup(const PathCacheKey &key, std::vector<Direction> &dirList, int64_t now) {
+	auto &shard = getShard(key);
+	std::scoped_lock lock(shard.mutex);
+
+	const auto it = shard.entries.find(key);
+	if (it == shard.entries.end()) {
+		misses.fetch_add(1, std::memory_order_relaxed);
+		return std::nullopt;
+	}
+
+	if (!isValid(it->second, now)) {
+		shard.entries.erase(it);
+		misses.fetch_add(1, std::memory_order_relaxed);
+		return std::nullopt;
+	}
+
+	const auto &entry = it->second;
+	dirList.insert(dirList.end(), entry.path.begin(), entry.path.end());
+	hits.fetch_add(1, std::memory_order_relaxed);
+	return entry.found;
+}
+
+void PathCache::store(const PathCacheKey &key, std::span<const Direction> path, bool found, std::vector<SectorVersion> &&sectors, int64_t now) {
+	auto &shard = getShard(key);
+	std::scoped_lock lock(shard.mutex);
+
+	if (shard.entries.size() >= MAX_ENTRIES_PER_SHARD) {
+		phmap::erase_if(shard.entries, [now](const auto &entry) {
+			return !isValid(entry.second, now);
+		});
+
+		// Everything is still fresh, start over rather than tracking recency on every lookup
+		if (shard.entries.size() >= MAX_ENTRIES_PER_SHARD) {
+			shard.entries.clear();
+		}
+	}
+
+	auto &entry = shard.entries[key];
+	entry.path.assign(path.begin(), path.end());
+	entry.sectors = std::move(sectors);
+	entry.expiresAt = now + ENTRY_TTL_MS;
+	entry.found = found;
+}
+
+void PathCache::clear() {
+	for (auto &shard : shards) {
+		std::scoped_lock lock(shard.mutex);
+		shard.entries.clear();
+	}
+}
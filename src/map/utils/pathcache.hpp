@@ -0,0 +1,112 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/movement/position.hpp"
+
+class MapSector;
+struct FindPathParams;
+
+/**
+ * @brief Identifies a path search: who walks, from where, towards what and how.
+ */
+struct PathCacheKey {
+	Position startPos;
+	Position targetPos;
+	uint32_t creatureId = 0;
+	int32_t maxSearchDist = 0;
+	int32_t minTargetDist = 0;
+	int32_t maxTargetDist = 0;
+	uint8_t flags = 0;
+
+	PathCacheKey() = default;
+	PathCacheKey(uint32_t creatureId, const Position &startPos, const Position &targetPos, const FindPathParams &fpp);
+
+	bool operator==(const PathCacheKey &other) const = default;
+};
+
+namespace std {
+	template <>
+	struct hash<PathCacheKey> {
+		[[nodiscard]] std::size_t operator()(const PathCacheKey &key) const noexcept {
+			auto seed = std::hash<Position> {}(key.startPos);
+			const auto mix = [&seed](uint64_t value) {
+				seed ^= std::hash<uint64_t> {}(value) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+			};
+			mix(std::hash<Position> {}(key.targetPos));
+			mix(static_cast<uint64_t>(key.creatureId) << 8 | key.flags);
+			mix(static_cast<uint64_t>(static_cast<uint16_t>(key.maxSearchDist)) << 32 | static_cast<uint64_t>(static_cast<uint16_t>(key.minTargetDist)) << 16 | static_cast<uint16_t>(key.maxTargetDist));
+			return seed;
+		}
+	};
+}
+
+/**
+ * @brief Short-lived cache of path search results.
+ *
+ * Each entry remembers the tile version of every sector covered by the area the search explored,
+ * and is dropped as soon as one of them changed or its time to live expired.
+ * Failed searches are cached as well, they are the most expensive ones.
+ * The cache is split in shards with their own lock, searches run concurrently on the thread pool.
+ */
+class PathCache {
+public:
+	static constexpr int64_t ENTRY_TTL_MS = 1000;
+	static constexpr size_t MAX_ENTRIES_PER_SHARD = 2048;
+
+	struct SectorVersion {
+		const MapSector* sector = nullptr;
+		uint32_t version = 0;
+	};
+
+	/**
+	 * @brief Appends the cached path to dirList.
+	 * @return std::nullopt on a miss, otherwise whether a path exists.
+	 */
+	std::optional<bool> lookup(const PathCacheKey &key, std::vector<Direction> &dirList, int64_t now);
+
+	void store(const PathCacheKey &key, std::span<const Direction> path, bool found, std::vector<SectorVersion> &&sectors, int64_t now);
+
+	void clear();
+
+	[[nodiscard]] uint64_t getHits() const {
+		return hits.load(std::memory_order_relaxed);
+	}
+
+	[[nodiscard]] uint64_t getMisses() const {
+		return misses.load(std::memory_order_relaxed);
+	}
+
+private:
+	struct Entry {
+		std::vector<Direction> path;
+		std::vector<SectorVersion> sectors;
+		int64_t expiresAt = 0;
+		bool found = false;
+	};
+
+	struct Shard {
+		std::mutex mutex;
+		phmap::flat_hash_map<PathCacheKey, Entry> entries;
+	};
+
+	static constexpr size_t SHARDS = 16;
+
+	static bool isValid(const Entry &entry, int64_t now);
+
+	Shard &getShard(const PathCacheKey &key) {
+		// High bits, the low ones are what the shard tables use
+		return shards[(std::hash<PathCacheKey> {}(key) >> 32) % SHARDS];
+	}
+
+	std::array<Shard, SHARDS> shards;
+	std::atomic_uint64_t hits = 0;
+	std::atomic_uint64_t misses = 0;
+};
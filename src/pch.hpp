@@ -25,6 +25,7 @@
 // STL Includes
 // --------------------
 
+#include <bit>
 #include <bitset>
 #include <charconv>
 #include <filesystem>
@@ -40,6 +41,7 @@
 #include <regex>
 #include <set>
 #include <thread>
+#include <future>
 #include <vector>
 #include <variant>
 #include <numeric>
@@ -0,0 +1,209 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "security/xtea.hpp"
+
+#include "utils/simd.hpp"
+
+namespace {
+	constexpr uint32_t DELTA = 0x61C88647;
+
+	uint32_t mix(uint32_t v) {
+		return ((v << 4) ^ (v >> 5)) + v;
+	}
+
+#if defined(__AVX2__)
+	constexpr size_t LANES = 8;
+	using lane_t = __m256i;
+
+	lane_t broadcast(uint32_t value) {
+		return _mm256_set1_epi32(static_cast<int32_t>(value));
+	}
+
+	lane_t mix(lane_t v) {
+		return _mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v, 4), _mm256_srli_epi32(v, 5)), v);
+	}
+
+	lane_t add(lane_t a, lane_t b) {
+		return _mm256_add_epi32(a, b);
+	}
+
+	lane_t sub(lane_t a, lane_t b) {
+		return _mm256_sub_epi32(a, b);
+	}
+
+	lane_t mixKey(lane_t v, lane_t key) {
+		return _mm256_xor_si256(mix(v), key);
+	}
+
+	// Shuffles and unpacks work within 128-bit halves, so the blocks end up out of order in the lanes, store puts them back
+	void load(const uint8_t* data, lane_t &v0, lane_t &v1) {
+		const auto a = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)));
+		const auto b = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32)));
+		v0 = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+		v1 = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+	}
+
+	void store(uint8_t* data, lane_t v0, lane_t v1) {
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data), _mm256_unpacklo_epi32(v0, v1));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + 32), _mm256_unpackhi_epi32(v0, v1));
+	}
+#elif defined(__SSE2__)
+	constexpr size_t LANES = 4;
+	using lane_t = __m128i;
+
+	lane_t broadcast(uint32_t value) {
+		return _mm_set1_epi32(static_cast<int32_t>(value));
+	}
+
+	lane_t mix(lane_t v) {
+		return _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v, 4), _mm_srli_epi32(v, 5)), v);
+	}
+
+	lane_t add(lane_t a, lane_t b) {
+		return _mm_add_epi32(a, b);
+	}
+
+	lane_t sub(lane_t a, lane_t b) {
+		return _mm_sub_epi32(a, b);
+	}
+
+	lane_t mixKey(lane_t v, lane_t key) {
+		return _mm_xor_si128(mix(v), key);
+	}
+
+	// Splits interleaved blocks into their first and second words, one block per lane
+	void load(const uint8_t* data, lane_t &v0, lane_t &v1) {
+		const auto a = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+		const auto b = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)));
+		v0 = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+		v1 = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+	}
+
+	void store(uint8_t* data, lane_t v0, lane_t v1) {
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data), _mm_unpacklo_epi32(v0, v1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data + 16), _mm_unpackhi_epi32(v0, v1));
+	}
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+	constexpr size_t STRIDE = LANES * xtea::BLOCK_SIZE;
+
+	// A plain array, std::array would drop the vector type alignment attributes
+	struct LaneKeys {
+		lane_t keys[xtea::ROUNDS * 2];
+	};
+
+	LaneKeys broadcastKeys(const xtea::round_keys_t &keys) {
+		LaneKeys lanes;
+		for (size_t i = 0; i < keys.size(); ++i) {
+			lanes.keys[i] = broadcast(keys[i]);
+		}
+		return lanes;
+	}
+#endif
+}
+
+namespace xtea {
+	round_keys_t expandEncryptionKey(const key_t &key) {
+		round_keys_t keys;
+		uint32_t sum = 0;
+		for (size_t i = 0; i < ROUNDS; ++i) {
+			keys[i * 2] = sum + key[sum & 3];
+			sum -= DELTA;
+			keys[i * 2 + 1] = sum + key[(sum >> 11) & 3];
+		}
+		return keys;
+	}
+
+	round_keys_t expandDecryptionKey(const key_t &key) {
+		round_keys_t keys;
+		uint32_t sum = 0xC6EF3720;
+		for (size_t i = 0; i < ROUNDS; ++i) {
+			keys[i * 2] = sum + key[(sum >> 11) & 3];
+			sum += DELTA;
+			keys[i * 2 + 1] = sum + key[sum & 3];
+		}
+		return keys;
+	}
+
+	void encryptScalar(uint8_t* data, size_t length, const round_keys_t &keys, size_t begin) {
+		for (size_t pos = begin; pos + BLOCK_SIZE <= length; pos += BLOCK_SIZE) {
+			uint32_t v0;
+			uint32_t v1;
+			std::memcpy(&v0, data + pos, sizeof(v0));
+			std::memcpy(&v1, data + pos + 4, sizeof(v1));
+
+			for (size_t i = 0; i < ROUNDS; ++i) {
+				v0 += mix(v1) ^ keys[i * 2];
+				v1 += mix(v0) ^ keys[i * 2 + 1];
+			}
+
+			std::memcpy(data + pos, &v0, sizeof(v0));
+			std::memcpy(data + pos + 4, &v1, sizeof(v1));
+		}
+	}
+
+	void decryptScalar(uint8_t* data, size_t length, const round_keys_t &keys, size_t begin) {
+		for (size_t pos = begin; pos + BLOCK_SIZE <= length; pos += BLOCK_SIZE) {
+			uint32_t v0;
+			uint32_t v1;
+			std::memcpy(&v0, data + pos, sizeof(v0));
+			std::memcpy(&v1, data + pos + 4, sizeof(v1));
+
+			for (size_t i = 0; i < ROUNDS; ++i) {
+				v1 -= mix(v0) ^ keys[i * 2];
+				v0 -= mix(v1) ^ keys[i * 2 + 1];
+			}
+
+			std::memcpy(data + pos, &v0, sizeof(v0));
+			std::memcpy(data + pos + 4, &v1, sizeof(v1));
+		}
+	}
+
+	void encrypt(uint8_t* data, size_t length, const round_keys_t &keys) {
+		size_t pos = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+		if (length >= STRIDE) {
+			const auto lanes = broadcastKeys(keys);
+			for (; pos + STRIDE <= length; pos += STRIDE) {
+				lane_t v0;
+				lane_t v1;
+				load(data + pos, v0, v1);
+				for (size_t i = 0; i < ROUNDS; ++i) {
+					v0 = add(v0, mixKey(v1, lanes.keys[i * 2]));
+					v1 = add(v1, mixKey(v0, lanes.keys[i * 2 + 1]));
+				}
+				store(data + pos, v0, v1);
+			}
+		}
+#endif
+		encryptScalar(data, length, keys, pos);
+	}
+
+	void decrypt(uint8_t* data, size_t length, const round_keys_t &keys) {
+		size_t pos = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+		if (length >= STRIDE) {
+			const auto lanes = broadcastKeys(keys);
+			for (; pos + STRIDE <= length; pos += STRIDE) {
+				lane_t v0;
+				lane_t v1;
+				load(data + pos, v0, v1);
+				for (size_t i = 0; i < ROUNDS; ++i) {
+					v1 = sub(v1, mixKey(v0, lanes.keys[i * 2]));
+					v0 = sub(v0, mixKey(v1, lanes.keys[i * 2 + 1]));
+				}
+				store(data + pos, v0, v1);
+			}
+		}
+#endif
+		decryptScalar(data, length, keys, pos);
+	}
+}
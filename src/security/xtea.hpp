@@ -0,0 +1,41 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * XTEA in ECB mode, as spoken by the client: 32 cycles over 8-byte blocks.
+ *
+ * Blocks are independent, so the vectorized paths run 4 (SSE2) or 8 (AVX2) of
+ * them at once, one block per 32-bit lane, and the scalar path finishes the tail.
+ * Both paths produce the same bytes, the scalar one is kept as the reference.
+ */
+namespace xtea {
+	constexpr size_t BLOCK_SIZE = 8;
+	constexpr size_t ROUNDS = 32;
+
+	using key_t = std::array<uint32_t, 4>;
+	// The key mixed with the running sum, two per cycle, in the order they are applied
+	using round_keys_t = std::array<uint32_t, ROUNDS * 2>;
+
+	round_keys_t expandEncryptionKey(const key_t &key);
+	round_keys_t expandDecryptionKey(const key_t &key);
+
+	/**
+	 * @brief Transforms the data in place, the length must be a multiple of BLOCK_SIZE.
+	 */
+	void encrypt(uint8_t* data, size_t length, const round_keys_t &keys);
+	void decrypt(uint8_t* data, size_t length, const round_keys_t &keys);
+
+	/**
+	 * @brief Scalar transforms of the blocks from the begin offset onwards.
+	 */
+	void encryptScalar(uint8_t* data, size_t length, const round_keys_t &keys, size_t begin = 0);
+	void decryptScalar(uint8_t* data, size_t length, const round_keys_t &keys, size_t begin = 0);
+}
@@ -11,6 +11,7 @@
 
 #include "config/configmanager.hpp"
 #include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
 #include "server/network/message/outputmessage.hpp"
 #include "server/network/protocol/protocol.hpp"
 #include "game/scheduling/dispatcher.hpp"
@@ -82,6 +83,8 @@ void Connection::closeSocket() {
 		return;
 	}
 
+	reportWriteStats();
+
 	try {
 		readTimer.cancel();
 		writeTimer.cancel();
@@ -340,12 +343,25 @@ void Connection::internalWorker() {
 		return;
 	}
 
-	const auto &outputMessage = messageQueue.front();
+	// Everything queued while the previous write was in flight goes out in a single write
+	const auto limit = std::min(messageQueue.size(), CONNECTION_WRITE_BATCH_MESSAGES);
+	size_t bytes = 0;
+	for (size_t i = 0; i < limit && bytes < CONNECTION_WRITE_BATCH_BYTES; ++i) {
+		bytes += messageQueue[i]->getLength();
+		writeBatch.emplace_back(messageQueue[i]);
+	}
+	if (writeBatch.size() < messageQueue.size()) {
+		++writeStats.cappedBatches;
+	}
+
+	// Only this write chain touches writeBatch, send() just appends to the queue meanwhile
 	lock.unlock();
-	protocol->onSendMessage(outputMessage);
+	for (const auto &outputMessage : writeBatch) {
+		protocol->onSendMessage(outputMessage);
+	}
 	lock.lock();
 
-	internalSend(outputMessage);
+	internalSend();
 }
 
 uint32_t Connection::getIP() {
@@ -364,42 +380,72 @@ uint32_t Connection::getIP() {
 	return ip;
 }
 
-void Connection::internalSend(const OutputMessage_ptr &outputMessage) {
+ConnectionWriteStats Connection::getWriteStats() {
+	std::scoped_lock lock(connectionLock);
+	return writeStats;
+}
+
+void Connection::internalSend() {
+	writeBuffers.clear();
+	for (const auto &outputMessage : writeBatch) {
+		writeBuffers.emplace_back(outputMessage->getOutputBuffer(), outputMessage->getLength());
+	}
+
 	writeTimer.expires_from_now(std::chrono::seconds(CONNECTION_WRITE_TIMEOUT));
 	writeTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
 
 	try {
-		asio::async_write(socket, asio::buffer(outputMessage->getOutputBuffer(), outputMessage->getLength()), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->onWriteOperation(error); });
+		asio::async_write(socket, writeBuffers, [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->onWriteOperation(error, N); });
 	} catch (const std::system_error &e) {
 		g_logger().error("[Connection::internalSend] - Exception in async_write: {}", e.what());
 		close(FORCE_CLOSE);
 	}
 }
 
-void Connection::onWriteOperation(const std::error_code &error) {
+void Connection::onWriteOperation(const std::error_code &error, std::size_t bytesTransferred) {
 	std::unique_lock lock(connectionLock);
 	writeTimer.cancel();
 
 	if (error) {
 		g_logger().error("[Connection::onWriteOperation] - Write error: {}", error.message());
 		messageQueue.clear();
+		writeBatch.clear();
 		close(FORCE_CLOSE);
 		return;
 	}
 
-	messageQueue.pop_front();
+	const auto written = writeBatch.size();
+	messageQueue.pop_front(written);
+	writeBatch.clear();
+
+	++writeStats.batches;
+	writeStats.messages += written;
+	writeStats.bytes += bytesTransferred;
+	writeStats.maxBatchMessages = std::max(writeStats.maxBatchMessages, static_cast<uint32_t>(written));
+	if (writeStats.batches - reportedWriteStats.batches >= CONNECTION_WRITE_STATS_INTERVAL) {
+		reportWriteStats();
+	}
 
 	if (!messageQueue.empty()) {
-		const auto &outputMessage = messageQueue.front();
 		lock.unlock();
-		protocol->onSendMessage(outputMessage);
-		lock.lock();
-		internalSend(outputMessage);
+		internalWorker();
 	} else if (connectionState == CONNECTION_STATE_CLOSED) {
 		closeSocket();
 	}
 }
 
+void Connection::reportWriteStats() {
+	if (writeStats.batches == reportedWriteStats.batches) {
+		return;
+	}
+
+	g_metrics().addCounter("connection_write_batches", static_cast<double>(writeStats.batches - reportedWriteStats.batches));
+	g_metrics().addCounter("connection_write_messages", static_cast<double>(writeStats.messages - reportedWriteStats.messages));
+	g_metrics().addCounter("connection_write_bytes", static_cast<double>(writeStats.bytes - reportedWriteStats.bytes));
+	g_metrics().addCounter("connection_write_capped_batches", static_cast<double>(writeStats.cappedBatches - reportedWriteStats.cappedBatches));
+	reportedWriteStats = writeStats;
+}
+
 void Connection::handleTimeout(ConnectionWeak_ptr connectionWeak, const std::error_code &error) {
 	if (error == asio::error::operation_aborted) {
 		return;
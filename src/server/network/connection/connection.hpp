@@ -12,9 +12,16 @@
 #include "declarations.hpp"
 // TODO: Remove circular includes (maybe shared_ptr?)
 #include "server/network/message/networkmessage.hpp"
+#include "utils/ring_buffer.hpp"
 
 static constexpr int32_t CONNECTION_WRITE_TIMEOUT = 30;
 static constexpr int32_t CONNECTION_READ_TIMEOUT = 30;
+// A write batch stops once it holds this many bytes, a single larger message is still sent whole
+static constexpr size_t CONNECTION_WRITE_BATCH_BYTES = 64 * 1024;
+// asio hands at most 64 buffers to each writev call
+static constexpr size_t CONNECTION_WRITE_BATCH_MESSAGES = 64;
+// Write stats are published to the metrics every this many batches, and on close
+static constexpr uint64_t CONNECTION_WRITE_STATS_INTERVAL = 256;
 
 class Protocol;
 using Protocol_ptr = std::shared_ptr<Protocol>;
@@ -30,6 +37,15 @@ using ServicePort_ptr = std::shared_ptr<ServicePort>;
 using ConstServicePort_ptr = std::shared_ptr<const ServicePort>;
 class NetworkMessage;
 
+struct ConnectionWriteStats {
+	uint64_t batches = 0;
+	uint64_t messages = 0;
+	uint64_t bytes = 0;
+	// Batches that left messages queued because they hit a cap
+	uint64_t cappedBatches = 0;
+	uint32_t maxBatchMessages = 0;
+};
+
 class ConnectionManager {
 public:
 	ConnectionManager() = default;
@@ -68,18 +84,21 @@ public:
 
 	uint32_t getIP();
 
+	ConnectionWriteStats getWriteStats();
+
 private:
 	void parseProxyIdentification(const std::error_code &error);
 	void parseHeader(const std::error_code &error);
 	void parsePacket(const std::error_code &error);
 
-	void onWriteOperation(const std::error_code &error);
+	void onWriteOperation(const std::error_code &error, std::size_t bytesTransferred);
 
 	static void handleTimeout(ConnectionWeak_ptr connectionWeak, const std::error_code &error);
 
 	void closeSocket();
 	void internalWorker();
-	void internalSend(const OutputMessage_ptr &outputMessage);
+	void internalSend();
+	void reportWriteStats();
 
 	asio::ip::tcp::socket &getSocket() {
 		return socket;
@@ -90,7 +109,12 @@ private:
 
 	std::recursive_mutex connectionLock;
 
-	std::list<OutputMessage_ptr> messageQueue;
+	// Messages stay queued until written, the first writeBatch.size() ones are being written
+	RingBuffer<OutputMessage_ptr> messageQueue;
+	std::vector<OutputMessage_ptr> writeBatch;
+	std::vector<asio::const_buffer> writeBuffers;
+	ConnectionWriteStats writeStats;
+	ConnectionWriteStats reportedWriteStats;
 
 	ConstServicePort_ptr service_port;
 	Protocol_ptr protocol;
@@ -11,6 +11,7 @@
 
 #include "server/network/message/networkmessage.hpp"
 #include "server/network/connection/connection.hpp"
+#include "server/network/message/shared_packet.hpp"
 
 class Protocol;
 
@@ -56,6 +57,13 @@ public:
 		info.position += msgLen;
 	}
 
+	void append(const SharedPacket &packet) {
+		const auto bytes = packet.getBytes();
+		std::ranges::copy(bytes, buffer.begin() + info.position);
+		info.length += packet.getLength();
+		info.position += packet.getLength();
+	}
+
 private:
 	template <typename T>
 	void add_header(T addHeader) {
@@ -0,0 +1,80 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "server/network/message/networkmessage.hpp"
+
+/**
+ * @brief Immutable copy of an encoded packet body, shared by every protocol it is sent to.
+ */
+class SharedPacket {
+public:
+	explicit SharedPacket(const NetworkMessage &msg) :
+		bytes(msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION, msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION + msg.getLength()) { }
+
+	[[nodiscard]] std::span<const uint8_t> getBytes() const {
+		return bytes;
+	}
+
+	[[nodiscard]] NetworkMessage::MsgSize_t getLength() const {
+		return static_cast<NetworkMessage::MsgSize_t>(bytes.size());
+	}
+
+private:
+	const std::vector<uint8_t> bytes;
+};
+
+using SharedPacket_ptr = std::shared_ptr<const SharedPacket>;
+
+/**
+ * @brief Encodes a broadcast once per variant and hands the same packet to every viewer.
+ *
+ * Most viewers of a broadcast receive identical bytes; the few things that change them,
+ * such as the client protocol version or a viewer dependent stack position, are folded
+ * into a variant key and each variant is encoded the first time a viewer asks for it.
+ * Meant to live on the stack for the duration of a single broadcast, on the dispatcher thread.
+ */
+class BroadcastPacket {
+public:
+	BroadcastPacket() = default;
+
+	// Ensures that we don't accidentally copy it
+	BroadcastPacket(const BroadcastPacket &) = delete;
+	BroadcastPacket &operator=(const BroadcastPacket &) = delete;
+
+	/**
+	 * @brief Returns the packet for the variant, encoding it with encode(NetworkMessage &) on first use.
+	 */
+	template <typename Encoder>
+	SharedPacket_ptr get(uint32_t variant, Encoder &&encode) {
+		for (const auto &[key, packet] : variants) {
+			if (key == variant) {
+				return packet;
+			}
+		}
+
+		NetworkMessage msg;
+		encode(msg);
+		++encodings;
+		return variants.emplace_back(variant, std::make_shared<const SharedPacket>(msg)).second;
+	}
+
+	/**
+	 * @brief Returns how many times a packet was encoded, one per variant in use.
+	 */
+	[[nodiscard]] uint32_t getEncodings() const {
+		return encodings;
+	}
+
+private:
+	// A handful at most, a linear scan beats hashing
+	std::vector<std::pair<uint32_t, SharedPacket_ptr>> variants;
+	uint32_t encodings = 0;
+};
@@ -0,0 +1,338 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "server/network/protocol/packet_compressor.hpp"
+
+#include "config/configmanager.hpp"
+#include "lib/metrics/metrics.hpp"
+
+namespace {
+	// Sequences shorter than this are cheaper to send as literals than as matches
+	constexpr size_t DICTIONARY_SHINGLE = 8;
+	constexpr size_t DICTIONARY_SEGMENT = 64;
+
+	uint64_t readShingle(const uint8_t* data) {
+		uint64_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+}
+
+PacketCompressor::Options PacketCompressor::Options::fromConfig() {
+	Options options;
+	options.level = std::min(g_configManager().getNumber(COMPRESSION_LEVEL), Z_BEST_COMPRESSION);
+	options.adaptive = g_configManager().getBoolean(COMPRESSION_ADAPTIVE);
+	options.nanosPerSavedByte = std::max(1, g_configManager().getNumber(COMPRESSION_NANOS_PER_SAVED_BYTE));
+
+	const auto &path = g_configManager().getString(COMPRESSION_DICTIONARY);
+	if (path.empty()) {
+		return options;
+	}
+
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		g_logger().error("[PacketCompressor::Options::fromConfig] - Failed to open compression dictionary: {}", path);
+		return options;
+	}
+
+	options.dictionary.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	if (options.dictionary.size() > MAX_DICTIONARY_SIZE) {
+		g_logger().warn("[PacketCompressor::Options::fromConfig] - Compression dictionary {} has {} bytes, only the last {} are used", path, options.dictionary.size(), MAX_DICTIONARY_SIZE);
+		options.dictionary.erase(options.dictionary.begin(), options.dictionary.end() - MAX_DICTIONARY_SIZE);
+	}
+	return options;
+}
+
+PacketCompressor::PacketCompressor(Options newOptions) :
+	options(std::move(newOptions)), classes(256 * SIZE_CLASSES), buffer(NETWORKMESSAGE_MAXSIZE) {
+	if (options.level <= 0) {
+		return;
+	}
+
+	std::vector<int32_t> levels { options.level };
+	if (options.adaptive && options.level > Z_BEST_SPEED) {
+		levels.insert(levels.begin(), Z_BEST_SPEED);
+	}
+
+	for (const auto level : levels) {
+		auto stream = std::make_unique<z_stream>();
+		if (deflateInit2(stream.get(), level, Z_DEFLATED, -15, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
+			g_logger().error("[PacketCompressor] - Zlib deflateInit2 error: {}", (stream->msg ? stream->msg : " unknown error"));
+			continue;
+		}
+
+		if (!options.dictionary.empty() && deflateSetDictionary(stream.get(), options.dictionary.data(), static_cast<uInt>(options.dictionary.size())) != Z_OK) {
+			g_logger().error("[PacketCompressor] - Zlib deflateSetDictionary error: {}", (stream->msg ? stream->msg : " unknown error"));
+			deflateEnd(stream.get());
+			continue;
+		}
+
+		candidates.emplace_back(level, std::move(stream));
+	}
+}
+
+PacketCompressor::~PacketCompressor() {
+	for (auto &candidate : candidates) {
+		deflateEnd(candidate.stream.get());
+	}
+}
+
+std::span<const uint8_t> PacketCompressor::compress(const uint8_t* data, size_t length) {
+	if (candidates.empty() || length < minLength() || length > buffer.size()) {
+		return {};
+	}
+
+	const auto opcode = data[0];
+	auto &packetClass = classes[classIndex(opcode, length)];
+	auto &opcodeStats = stats[opcode];
+	++opcodeStats.messages;
+	opcodeStats.inputBytes += length;
+
+	if (++sinceReport >= REPORT_INTERVAL) {
+		reportStats();
+	}
+
+	const auto index = pick(packetClass);
+	if (index == SKIP) {
+		return {};
+	}
+
+	auto &candidate = candidates[index];
+	auto* stream = candidate.stream.get();
+	const auto start = std::chrono::steady_clock::now();
+
+	stream->next_in = const_cast<Bytef*>(data);
+	stream->avail_in = static_cast<uInt>(length);
+	stream->next_out = buffer.data();
+	stream->avail_out = static_cast<uInt>(buffer.size());
+
+	// Anything short of the end of the stream did not fit in the buffer, so it would not have saved anything
+	const bool finished = deflate(stream, Z_FINISH) == Z_STREAM_END;
+	const size_t compressedSize = stream->total_out;
+	const bool reset = resetStream(candidate);
+
+	const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	const size_t saved = finished && compressedSize < length ? length - compressedSize : 0;
+	learn(packetClass, index, length, saved, nanos);
+
+	opcodeStats.cpuNanos += static_cast<uint64_t>(nanos);
+	opcodeStats.savedBytes += saved;
+
+	if (!reset) {
+		// A stream left with stale state or without its dictionary would corrupt every message after this one
+		g_logger().error("[PacketCompressor::compress] - Zlib deflateReset error, disabling compression: {}", (stream->msg ? stream->msg : " unknown error"));
+		for (auto &failed : candidates) {
+			deflateEnd(failed.stream.get());
+		}
+		candidates.clear();
+		return {};
+	}
+
+	if (saved == 0) {
+		return {};
+	}
+
+	++opcodeStats.compressed;
+	return { buffer.data(), compressedSize };
+}
+
+int32_t PacketCompressor::getLevel(uint8_t opcode, size_t length) const {
+	if (candidates.empty() || length < minLength()) {
+		return 0;
+	}
+	if (!options.adaptive) {
+		return candidates.front().level;
+	}
+
+	const auto &packetClass = classes[classIndex(opcode, length)];
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		if (packetClass.estimates[i].samples < WARMUP_SAMPLES) {
+			return candidates[i].level;
+		}
+	}
+	return packetClass.choice == SKIP ? 0 : candidates[packetClass.choice].level;
+}
+
+size_t PacketCompressor::classIndex(uint8_t opcode, size_t length) {
+	size_t sizeClass = SIZE_CLASSES - 1;
+	if (length < 256) {
+		sizeClass = 0;
+	} else if (length < 1024) {
+		sizeClass = 1;
+	} else if (length < 4096) {
+		sizeClass = 2;
+	}
+	return static_cast<size_t>(opcode) * SIZE_CLASSES + sizeClass;
+}
+
+uint8_t PacketCompressor::pick(PacketClass &packetClass) const {
+	if (!options.adaptive) {
+		return 0;
+	}
+
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		if (packetClass.estimates[i].samples < WARMUP_SAMPLES) {
+			return static_cast<uint8_t>(i);
+		}
+	}
+
+	if (++packetClass.messages % EXPLORE_INTERVAL == 0) {
+		return static_cast<uint8_t>(packetClass.explore++ % candidates.size());
+	}
+	return packetClass.choice;
+}
+
+void PacketCompressor::learn(PacketClass &packetClass, uint8_t candidate, size_t length, size_t saved, int64_t nanos) const {
+	const auto savedPerByte = static_cast<double>(saved) / static_cast<double>(length);
+	const auto nanosPerByte = static_cast<double>(nanos) / static_cast<double>(length);
+
+	auto &estimate = packetClass.estimates[candidate];
+	if (estimate.samples == 0) {
+		estimate.savedPerByte = savedPerByte;
+		estimate.nanosPerByte = nanosPerByte;
+	} else if (estimate.samples < WARMUP_SAMPLES) {
+		// The first runs of a stream touch cold memory, the fastest of them is the closest to the steady state
+		estimate.savedPerByte += (savedPerByte - estimate.savedPerByte) / (estimate.samples + 1);
+		estimate.nanosPerByte = std::min(estimate.nanosPerByte, nanosPerByte);
+	} else {
+		// Moving average over roughly the last 8 samples, a preempted run must not get a class stuck skipping
+		estimate.savedPerByte += (savedPerByte - estimate.savedPerByte) / 8.0;
+		estimate.nanosPerByte += (std::min(nanosPerByte, estimate.nanosPerByte * 4.0) - estimate.nanosPerByte) / 8.0;
+	}
+	++estimate.samples;
+
+	double bestScore = 0;
+	packetClass.choice = SKIP;
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		const auto &current = packetClass.estimates[i];
+		if (current.samples == 0) {
+			continue;
+		}
+
+		const auto score = current.savedPerByte - current.nanosPerByte / options.nanosPerSavedByte;
+		if (score > bestScore) {
+			bestScore = score;
+			packetClass.choice = static_cast<uint8_t>(i);
+		}
+	}
+}
+
+bool PacketCompressor::resetStream(Candidate &candidate) const {
+	if (deflateReset(candidate.stream.get()) != Z_OK) {
+		return false;
+	}
+
+	// Raw deflate streams forget their dictionary on reset
+	return options.dictionary.empty() || deflateSetDictionary(candidate.stream.get(), options.dictionary.data(), static_cast<uInt>(options.dictionary.size())) == Z_OK;
+}
+
+void PacketCompressor::reportStats() {
+	sinceReport = 0;
+	for (size_t opcode = 0; opcode < stats.size(); ++opcode) {
+		const auto &current = stats[opcode];
+		auto &reported = reportedStats[opcode];
+		if (current.messages == reported.messages) {
+			continue;
+		}
+
+		const std::map<std::string, std::string> attrs { { "opcode", fmt::format("0x{:02X}", opcode) } };
+		g_metrics().addCounter("packet_compression_messages", static_cast<double>(current.messages - reported.messages), attrs);
+		g_metrics().addCounter("packet_compression_compressed", static_cast<double>(current.compressed - reported.compressed), attrs);
+		g_metrics().addCounter("packet_compression_input_bytes", static_cast<double>(current.inputBytes - reported.inputBytes), attrs);
+		g_metrics().addCounter("packet_compression_saved_bytes", static_cast<double>(current.savedBytes - reported.savedBytes), attrs);
+		g_metrics().addCounter("packet_compression_cpu_us", static_cast<double>(current.cpuNanos - reported.cpuNanos) / 1000.0, attrs);
+		reported = current;
+	}
+}
+
+std::vector<uint8_t> PacketCompressor::buildDictionary(const std::vector<std::span<const uint8_t>> &samples, size_t maxSize) {
+	maxSize = std::min(maxSize, MAX_DICTIONARY_SIZE);
+
+	// Counted once per sample, a sequence repeated within a single packet says little about the others
+	std::unordered_map<uint64_t, uint32_t> counts;
+	std::unordered_set<uint64_t> seen;
+	for (const auto &sample : samples) {
+		seen.clear();
+		for (size_t pos = 0; pos + DICTIONARY_SHINGLE <= sample.size(); ++pos) {
+			const auto shingle = readShingle(sample.data() + pos);
+			if (seen.insert(shingle).second) {
+				++counts[shingle];
+			}
+		}
+	}
+
+	// Sequences found in a single sample are worth nothing to the others
+	const auto weight = [&counts](const uint8_t* data) -> uint64_t {
+		const auto it = counts.find(readShingle(data));
+		return it != counts.end() && it->second > 1 ? it->second : 0;
+	};
+
+	struct Segment {
+		std::span<const uint8_t> bytes;
+		uint64_t score = 0;
+	};
+
+	std::vector<Segment> selected;
+	size_t total = 0;
+	const auto epochs = std::max<size_t>(1, std::min(samples.size(), maxSize / DICTIONARY_SEGMENT));
+	for (bool progress = true; progress && total < maxSize;) {
+		progress = false;
+		for (size_t epoch = 0; epoch < epochs && total < maxSize; ++epoch) {
+			Segment best;
+			for (size_t i = epoch; i < samples.size(); i += epochs) {
+				const auto &sample = samples[i];
+				const auto segmentSize = std::min(DICTIONARY_SEGMENT, sample.size());
+				if (segmentSize < DICTIONARY_SHINGLE) {
+					continue;
+				}
+
+				// Sliding sum over the shingles that start inside the segment
+				const auto shingles = segmentSize - DICTIONARY_SHINGLE + 1;
+				uint64_t score = 0;
+				for (size_t pos = 0; pos < shingles; ++pos) {
+					score += weight(sample.data() + pos);
+				}
+
+				for (size_t begin = 0;; ++begin) {
+					if (score > best.score) {
+						best = { sample.subspan(begin, segmentSize), score };
+					}
+					if (begin + segmentSize >= sample.size()) {
+						break;
+					}
+					score += weight(sample.data() + begin + shingles);
+					score -= weight(sample.data() + begin);
+				}
+			}
+
+			if (best.score == 0) {
+				continue;
+			}
+
+			// Covered sequences stop counting, the next epochs look for others
+			for (size_t pos = 0; pos + DICTIONARY_SHINGLE <= best.bytes.size(); ++pos) {
+				counts[readShingle(best.bytes.data() + pos)] = 0;
+			}
+
+			best.bytes = best.bytes.first(std::min(best.bytes.size(), maxSize - total));
+			total += best.bytes.size();
+			selected.emplace_back(best);
+			progress = true;
+		}
+	}
+
+	std::ranges::stable_sort(selected, {}, &Segment::score);
+
+	std::vector<uint8_t> dictionary;
+	dictionary.reserve(total);
+	for (const auto &segment : selected) {
+		dictionary.insert(dictionary.end(), segment.bytes.begin(), segment.bytes.end());
+	}
+	return dictionary;
+}
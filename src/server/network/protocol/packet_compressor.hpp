@@ -0,0 +1,132 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * @brief Deflates outgoing game messages, choosing a level, or no compression at all, per packet class.
+ *
+ * A packet class is the opcode a message starts with plus the magnitude of its length.
+ * For every class the compressor keeps moving averages of the bytes saved and the CPU
+ * spent per input byte at each candidate level, and uses the level whose savings are
+ * worth its CPU at the configured rate, or sends the message as is when none of them is.
+ * Every EXPLORE_INTERVAL messages a class tries another candidate so the averages keep
+ * following the traffic.
+ *
+ * Not thread safe, Protocol keeps one per thread like it kept its z_stream.
+ */
+class PacketCompressor {
+public:
+	struct Options {
+		// Fixed level when the policy is not adaptive, the strongest candidate when it is, 0 disables compression
+		int32_t level = 6;
+		bool adaptive = true;
+		// How many nanoseconds of CPU saving a byte of egress is worth
+		double nanosPerSavedByte = 50.0;
+		// Preset dictionary, clients must prime their inflate stream with the same bytes
+		std::vector<uint8_t> dictionary;
+
+		static Options fromConfig();
+	};
+
+	struct Stats {
+		uint64_t messages = 0;
+		uint64_t compressed = 0;
+		uint64_t inputBytes = 0;
+		uint64_t savedBytes = 0;
+		uint64_t cpuNanos = 0;
+	};
+
+	// Below this a message is never compressed with a fixed level, as before the adaptive policy
+	static constexpr size_t MIN_LENGTH = 128;
+	// The adaptive policy tries shorter messages, it stops compressing a class whose savings don't pay off
+	static constexpr size_t ADAPTIVE_MIN_LENGTH = 64;
+	// Deflate only looks this far back, longer dictionaries are truncated to their end
+	static constexpr size_t MAX_DICTIONARY_SIZE = 32 * 1024;
+	static constexpr uint32_t WARMUP_SAMPLES = 4;
+	static constexpr uint32_t EXPLORE_INTERVAL = 64;
+	static constexpr uint32_t REPORT_INTERVAL = 4096;
+
+	explicit PacketCompressor(Options options);
+	~PacketCompressor();
+
+	// Ensures that we don't accidentally copy it
+	PacketCompressor(const PacketCompressor &) = delete;
+	PacketCompressor &operator=(const PacketCompressor &) = delete;
+
+	/**
+	 * @brief Deflates the message body with the level its class calls for.
+	 * @return The raw deflate stream, valid until the next call, or an empty span when
+	 * the message should go out uncompressed.
+	 */
+	std::span<const uint8_t> compress(const uint8_t* data, size_t length);
+
+	/**
+	 * @brief Returns the level the next message of this opcode and length would use, 0 when it would be skipped.
+	 */
+	[[nodiscard]] int32_t getLevel(uint8_t opcode, size_t length) const;
+
+	/**
+	 * @brief Returns the totals of the messages starting with this opcode.
+	 */
+	[[nodiscard]] const Stats &getStats(uint8_t opcode) const {
+		return stats[opcode];
+	}
+
+	/**
+	 * @brief Builds a preset dictionary out of the byte sequences shared by the most samples.
+	 *
+	 * Samples are split in as many epochs as the dictionary has segments, and each epoch
+	 * contributes its segment with the most frequent, not yet covered, sequences. The best
+	 * segments go last, where deflate reaches them with the shortest distances.
+	 */
+	static std::vector<uint8_t> buildDictionary(const std::vector<std::span<const uint8_t>> &samples, size_t maxSize);
+
+private:
+	static constexpr size_t MAX_CANDIDATES = 2;
+	static constexpr size_t SIZE_CLASSES = 4;
+	static constexpr uint8_t SKIP = std::numeric_limits<uint8_t>::max();
+
+	struct Candidate {
+		int32_t level;
+		std::unique_ptr<z_stream> stream;
+	};
+
+	struct Estimate {
+		double savedPerByte = 0;
+		double nanosPerByte = 0;
+		uint32_t samples = 0;
+	};
+
+	struct PacketClass {
+		std::array<Estimate, MAX_CANDIDATES> estimates {};
+		uint32_t messages = 0;
+		uint8_t explore = 0;
+		uint8_t choice = 0;
+	};
+
+	static size_t classIndex(uint8_t opcode, size_t length);
+
+	size_t minLength() const {
+		return options.adaptive ? ADAPTIVE_MIN_LENGTH : MIN_LENGTH;
+	}
+
+	uint8_t pick(PacketClass &packetClass) const;
+	void learn(PacketClass &packetClass, uint8_t candidate, size_t length, size_t saved, int64_t nanos) const;
+	bool resetStream(Candidate &candidate) const;
+	void reportStats();
+
+	const Options options;
+	std::vector<Candidate> candidates;
+	std::vector<PacketClass> classes;
+	std::array<Stats, 256> stats {};
+	std::array<Stats, 256> reportedStats {};
+	uint32_t sinceReport = 0;
+	std::vector<uint8_t> buffer;
+};
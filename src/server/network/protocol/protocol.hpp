@@ -10,6 +10,7 @@
 #pragma once
 
 #include "server/server_definitions.hpp"
+#include "security/xtea.hpp"
 
 class OutputMessage;
 using OutputMessage_ptr = std::shared_ptr<OutputMessage>;
@@ -59,7 +60,10 @@ protected:
 		encryptionEnabled = true;
 	}
 	void setXTEAKey(const uint32_t* newKey) {
-		std::ranges::copy(newKey, newKey + 4, this->key.begin());
+		xtea::key_t key;
+		std::ranges::copy(newKey, newKey + 4, key.begin());
+		encryptionKeys = xtea::expandEncryptionKey(key);
+		decryptionKeys = xtea::expandDecryptionKey(key);
 	}
 
 	void setChecksumMethod(ChecksumMethods_t method) {
@@ -75,18 +79,6 @@ protected:
 	virtual void release() { }
 
 private:
-	struct ZStream {
-		ZStream() noexcept;
-
-		~ZStream() {
-			deflateEnd(stream.get());
-		}
-
-		std::unique_ptr<z_stream> stream;
-		std::array<char, NETWORKMESSAGE_MAXSIZE> buffer {};
-	};
-
-	void XTEA_transform(uint8_t* buffer, size_t messageLength, bool encrypt) const;
 	void XTEA_encrypt(OutputMessage &msg) const;
 	bool XTEA_decrypt(NetworkMessage &msg) const;
 	bool compression(OutputMessage &msg) const;
@@ -94,7 +86,8 @@ private:
 	OutputMessage_ptr outputBuffer;
 
 	const ConnectionWeak_ptr connectionPtr;
-	std::array<uint32_t, 4> key = {};
+	xtea::round_keys_t encryptionKeys = {};
+	xtea::round_keys_t decryptionKeys = {};
 	uint32_t serverSequenceNumber = 0;
 	uint32_t clientSequenceNumber = 0;
 	std::underlying_type_t<ChecksumMethods_t> checksumMethod = CHECKSUM_METHOD_NONE;
@@ -40,9 +40,11 @@
 #include "io/ioprey.hpp"
 #include "items/items_classification.hpp"
 #include "items/weapons/weapons.hpp"
+#include "lib/metrics/metrics.hpp"
 #include "lua/creature/creatureevent.hpp"
 #include "lua/modules/modules.hpp"
 #include "server/network/message/outputmessage.hpp"
+#include "server/network/protocol/tile_encoding.hpp"
 #include "utils/tools.hpp"
 #include "creatures/players/vocations/vocation.hpp"
 
@@ -478,6 +480,12 @@ void ProtocolGame::release() {
 		player = nullptr;
 	}
 
+	if (viewportSnapshot.getHits() + viewportSnapshot.getMisses() > 0) {
+		g_metrics().addCounter("viewport_snapshot_hits", static_cast<double>(viewportSnapshot.getHits()));
+		g_metrics().addCounter("viewport_snapshot_misses", static_cast<double>(viewportSnapshot.getMisses()));
+	}
+	viewportSnapshot.clear();
+
 	OutputMessagePool::getInstance().removeProtocolFromAutosend(shared_from_this());
 	Protocol::release();
 }
@@ -923,6 +931,12 @@ void ProtocolGame::writeToOutputBuffer(NetworkMessage &msg) {
 	});
 }
 
+void ProtocolGame::writeToOutputBuffer(const SharedPacket_ptr &packet) {
+	g_dispatcher().safeCall([self = getThis(), packet] {
+		self->getOutputBuffer(packet->getLength())->append(*packet);
+	});
+}
+
 void ProtocolGame::parsePacket(NetworkMessage &msg) {
 	if (!acceptPackets || g_game().getGameState() == GAME_STATE_SHUTDOWN || msg.getLength() <= 0) {
 		return;
@@ -1411,6 +1425,49 @@ void ProtocolGame::parseHotkeyEquip(NetworkMessage &msg) {
 }
 
 void ProtocolGame::GetTileDescription(const std::shared_ptr<Tile> &tile, NetworkMessage &msg) {
+	// Creatures depend on what this client already knows, the items only on the tile version
+	const CreatureVector* creatures = tile->getCreatures();
+	if (creatures && !creatures->empty()) {
+		encodeTileDescription(tile, msg);
+		return;
+	}
+
+	const auto version = tile->getVersion();
+	if (const auto bytes = viewportSnapshot.find(tile->getPosition(), version)) {
+		msg.addBytes(reinterpret_cast<const char*>(bytes->data()), bytes->size());
+		return;
+	}
+
+	// Near the end of the buffer the encoding may come out truncated, it must not be reused
+	const bool complete = msg.canAdd(ViewportSnapshot::MAX_TILE_BYTES) && TileItemsEncoding::isStable(*tile);
+	const auto start = msg.getBufferPosition();
+	encodeTileDescription(tile, msg);
+	if (complete) {
+		viewportSnapshot.store(tile->getPosition(), version, { msg.getBuffer() + start, static_cast<size_t>(msg.getBufferPosition() - start) });
+	}
+}
+
+void ProtocolGame::encodeTileDescription(const std::shared_ptr<Tile> &tile, NetworkMessage &msg) {
+	// The player's own tile may have to make room for the player, it goes item by item.
+	// OTCR items carry their shader, a per-item attribute the shared encoding does not cover
+	if (!oldProtocol && !isOTCR && tile->getPosition() != player->getPosition()) {
+		if (const auto* encoding = getStaticItemsEncoding(tile)) {
+			const auto top = encoding->getTop();
+			msg.addBytes(reinterpret_cast<const char*>(top.data()), top.size());
+
+			int32_t count = encoding->getTopCount();
+			if (count == TileItemsEncoding::MAX_STACK || addTileCreatures(tile, msg, count)) {
+				return;
+			}
+
+			const auto down = encoding->getDown(TileItemsEncoding::MAX_STACK - count);
+			if (!down.empty()) {
+				msg.addBytes(reinterpret_cast<const char*>(down.data()), down.size());
+			}
+			return;
+		}
+	}
+
 	if (oldProtocol) {
 		msg.add<uint16_t>(0x00); // Env effects
 	}
@@ -1438,31 +1495,8 @@ void ProtocolGame::GetTileDescription(const std::shared_ptr<Tile> &tile, Network
 		}
 	}
 
-	const CreatureVector* creatures = tile->getCreatures();
-	if (creatures) {
-		bool playerAdded = false;
-		for (auto creature : std::ranges::reverse_view(*creatures)) {
-			if (!player->canSeeCreature(creature)) {
-				continue;
-			}
-
-			if (tile->getPosition() == player->getPosition() && count == 9 && !playerAdded) {
-				creature = player;
-			}
-
-			if (creature->getID() == player->getID()) {
-				playerAdded = true;
-			}
-
-			bool known;
-			uint32_t removedKnown;
-			checkCreatureAsKnown(creature->getID(), known, removedKnown);
-			AddCreature(msg, creature, known, removedKnown);
-
-			if (++count == 10) {
-				return;
-			}
-		}
+	if (addTileCreatures(tile, msg, count)) {
+		return;
 	}
 
 	if (items) {
@@ -1476,6 +1510,86 @@ void ProtocolGame::GetTileDescription(const std::shared_ptr<Tile> &tile, Network
 	}
 }
 
+bool ProtocolGame::addTileCreatures(const std::shared_ptr<Tile> &tile, NetworkMessage &msg, int32_t &count) {
+	const CreatureVector* creatures = tile->getCreatures();
+	if (!creatures) {
+		return false;
+	}
+
+	bool playerAdded = false;
+	for (auto creature : std::ranges::reverse_view(*creatures)) {
+		if (!player->canSeeCreature(creature)) {
+			continue;
+		}
+
+		if (tile->getPosition() == player->getPosition() && count == 9 && !playerAdded) {
+			creature = player;
+		}
+
+		if (creature->getID() == player->getID()) {
+			playerAdded = true;
+		}
+
+		bool known;
+		uint32_t removedKnown;
+		checkCreatureAsKnown(creature->getID(), known, removedKnown);
+		AddCreature(msg, creature, known, removedKnown);
+
+		if (++count == 10) {
+			return true;
+		}
+	}
+	return false;
+}
+
+const TileItemsEncoding* ProtocolGame::getStaticItemsEncoding(const std::shared_ptr<Tile> &tile) {
+	if (!tile->hasStaticItems()) {
+		return nullptr;
+	}
+	if (const auto* encoding = tile->getStaticEncoding()) {
+		return encoding;
+	}
+	if (!TileItemsEncoding::isStable(*tile)) {
+		tile->setStaticItems(false);
+		return nullptr;
+	}
+
+	// The bytes of items lying on the map are the same for every stock client on the current protocol,
+	// encodeTileDescription never gets here for OTCR
+	static thread_local NetworkMessage scratch;
+	scratch.reset();
+
+	TileItemsEncoding encoding;
+	const auto encode = [this](const std::shared_ptr<Item> &item) {
+		const auto start = scratch.getBufferPosition();
+		AddItem(scratch, item);
+		return std::span<const uint8_t>(scratch.getBuffer() + start, scratch.getBufferPosition() - start);
+	};
+
+	bool fits = true;
+	if (const auto &ground = tile->getGround()) {
+		fits = encoding.addTopItem(encode(ground));
+	}
+
+	// Whatever is past a full stack never reaches the client
+	if (const TileItemVector* items = tile->getItemList()) {
+		for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); fits && it != end && encoding.getTopCount() < TileItemsEncoding::MAX_STACK; ++it) {
+			fits = encoding.addTopItem(encode(*it));
+		}
+		for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); fits && it != end && encoding.getDownCount() < TileItemsEncoding::MAX_STACK; ++it) {
+			fits = encoding.addDownItem(encode(*it));
+		}
+	}
+
+	if (!fits) {
+		tile->setStaticItems(false);
+		return nullptr;
+	}
+
+	tile->setStaticEncoding(TileItemsEncoding::intern(encoding));
+	return tile->getStaticEncoding();
+}
+
 void ProtocolGame::GetMapDescription(int32_t x, int32_t y, int32_t z, int32_t width, int32_t height, NetworkMessage &msg) {
 	int32_t skip = -1;
 	int32_t startz, endz, zstep;
@@ -6278,8 +6392,7 @@ void ProtocolGame::sendCreatureTurn(const std::shared_ptr<Creature> &creature, u
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendCreatureSay(const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, const Position* pos /* = nullptr*/) {
-	NetworkMessage msg;
+void ProtocolGame::encodeCreatureSay(NetworkMessage &msg, const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, const Position &pos, bool oldProtocol) {
 	msg.addByte(0xAA);
 
 	static uint32_t statementId = 0;
@@ -6304,16 +6417,23 @@ void ProtocolGame::sendCreatureSay(const std::shared_ptr<Creature> &creature, Sp
 		msg.addByte(type);
 	}
 
-	if (pos) {
-		msg.addPosition(*pos);
-	} else {
-		msg.addPosition(creature->getPosition());
-	}
-
+	msg.addPosition(pos);
 	msg.addString(text);
+}
+
+void ProtocolGame::sendCreatureSay(const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, const Position* pos /* = nullptr*/) {
+	NetworkMessage msg;
+	encodeCreatureSay(msg, creature, type, text, pos ? *pos : creature->getPosition(), oldProtocol);
 	writeToOutputBuffer(msg);
 }
 
+void ProtocolGame::sendCreatureSay(const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, const Position* pos, BroadcastPacket &broadcast) {
+	// Every viewer of a broadcast shares the same statement id
+	writeToOutputBuffer(broadcast.get(oldProtocol, [&](NetworkMessage &msg) {
+		encodeCreatureSay(msg, creature, type, text, pos ? *pos : creature->getPosition(), oldProtocol);
+	}));
+}
+
 void ProtocolGame::sendToChannel(const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, uint16_t channelId) {
 	NetworkMessage msg;
 	msg.addByte(0xAA);
@@ -6429,11 +6549,7 @@ void ProtocolGame::sendPingBack() {
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendDistanceShoot(const Position &from, const Position &to, uint16_t type) {
-	if (oldProtocol && type > 0xFF) {
-		return;
-	}
-	NetworkMessage msg;
+void ProtocolGame::encodeDistanceShoot(NetworkMessage &msg, const Position &from, const Position &to, uint16_t type, bool oldProtocol) {
 	if (oldProtocol) {
 		msg.addByte(0x85);
 		msg.addPosition(from);
@@ -6448,9 +6564,26 @@ void ProtocolGame::sendDistanceShoot(const Position &from, const Position &to, u
 		msg.addByte(static_cast<uint8_t>(static_cast<int8_t>(static_cast<int32_t>(to.y) - static_cast<int32_t>(from.y))));
 		msg.addByte(MAGIC_EFFECTS_END_LOOP);
 	}
+}
+
+void ProtocolGame::sendDistanceShoot(const Position &from, const Position &to, uint16_t type) {
+	if (oldProtocol && type > 0xFF) {
+		return;
+	}
+	NetworkMessage msg;
+	encodeDistanceShoot(msg, from, to, type, oldProtocol);
 	writeToOutputBuffer(msg);
 }
 
+void ProtocolGame::sendDistanceShoot(const Position &from, const Position &to, uint16_t type, BroadcastPacket &broadcast) {
+	if (oldProtocol && type > 0xFF) {
+		return;
+	}
+	writeToOutputBuffer(broadcast.get(oldProtocol, [&](NetworkMessage &msg) {
+		encodeDistanceShoot(msg, from, to, type, oldProtocol);
+	}));
+}
+
 void ProtocolGame::sendRestingStatus(uint8_t protection) {
 	if (oldProtocol || !player) {
 		return;
@@ -6496,12 +6629,7 @@ void ProtocolGame::sendRestingStatus(uint8_t protection) {
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type) {
-	if (!canSee(pos) || (oldProtocol && type > 0xFF)) {
-		return;
-	}
-
-	NetworkMessage msg;
+void ProtocolGame::encodeMagicEffect(NetworkMessage &msg, const Position &pos, uint16_t type, bool oldProtocol) {
 	if (oldProtocol) {
 		msg.addByte(0x83);
 		msg.addPosition(pos);
@@ -6513,9 +6641,28 @@ void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type) {
 		msg.add<uint16_t>(type);
 		msg.addByte(MAGIC_EFFECTS_END_LOOP);
 	}
+}
+
+void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type) {
+	if (!canSee(pos) || (oldProtocol && type > 0xFF)) {
+		return;
+	}
+
+	NetworkMessage msg;
+	encodeMagicEffect(msg, pos, type, oldProtocol);
 	writeToOutputBuffer(msg);
 }
 
+void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type, BroadcastPacket &broadcast) {
+	if (!canSee(pos) || (oldProtocol && type > 0xFF)) {
+		return;
+	}
+
+	writeToOutputBuffer(broadcast.get(oldProtocol, [&](NetworkMessage &msg) {
+		encodeMagicEffect(msg, pos, type, oldProtocol);
+	}));
+}
+
 void ProtocolGame::removeMagicEffect(const Position &pos, uint16_t type) {
 	if (oldProtocol && type > 0xFF) {
 		return;
@@ -6531,12 +6678,7 @@ void ProtocolGame::removeMagicEffect(const Position &pos, uint16_t type) {
 	writeToOutputBuffer(msg);
 }
 
-void ProtocolGame::sendCreatureHealth(const std::shared_ptr<Creature> &creature) {
-	if (creature->isHealthHidden()) {
-		return;
-	}
-
-	NetworkMessage msg;
+void ProtocolGame::encodeCreatureHealth(NetworkMessage &msg, const std::shared_ptr<Creature> &creature) {
 	msg.addByte(0x8C);
 	msg.add<uint32_t>(creature->getID());
 	if (creature->isHealthHidden()) {
@@ -6544,10 +6686,28 @@ void ProtocolGame::sendCreatureHealth(const std::shared_ptr<Creature> &creature)
 	} else {
 		msg.addByte(static_cast<uint8_t>(std::min<double>(100, std::ceil((static_cast<double>(creature->getHealth()) / std::max<int32_t>(creature->getMaxHealth(), 1)) * 100))));
 	}
+}
 
+void ProtocolGame::sendCreatureHealth(const std::shared_ptr<Creature> &creature) {
+	if (creature->isHealthHidden()) {
+		return;
+	}
+
+	NetworkMessage msg;
+	encodeCreatureHealth(msg, creature);
 	writeToOutputBuffer(msg);
 }
 
+void ProtocolGame::sendCreatureHealth(const std::shared_ptr<Creature> &creature, BroadcastPacket &broadcast) {
+	if (creature->isHealthHidden()) {
+		return;
+	}
+
+	writeToOutputBuffer(broadcast.get(0, [&](NetworkMessage &msg) {
+		encodeCreatureHealth(msg, creature);
+	}));
+}
+
 void ProtocolGame::sendPartyCreatureUpdate(const std::shared_ptr<Creature> &target) {
 	if (!player || oldProtocol) {
 		return;
@@ -7016,10 +7176,7 @@ void ProtocolGame::sendMoveCreature(const std::shared_ptr<Creature> &creature, c
 			sendAddCreature(creature, newPos, newStackPos, false);
 		} else {
 			NetworkMessage msg;
-			msg.addByte(0x6D);
-			msg.addPosition(oldPos);
-			msg.addByte(static_cast<uint8_t>(oldStackPos));
-			msg.addPosition(newPos);
+			encodeCreatureStep(msg, oldPos, oldStackPos, newPos);
 			writeToOutputBuffer(msg);
 		}
 	} else if (canSee(oldPos)) {
@@ -7029,6 +7186,26 @@ void ProtocolGame::sendMoveCreature(const std::shared_ptr<Creature> &creature, c
 	}
 }
 
+void ProtocolGame::sendMoveCreature(const std::shared_ptr<Creature> &creature, const Position &newPos, int32_t newStackPos, const Position &oldPos, int32_t oldStackPos, bool teleport, BroadcastPacket &broadcast) {
+	// Only a plain step seen from both ends is the same for every viewer, given the stack position it leaves
+	const bool floorChange = oldPos.z == MAP_INIT_SURFACE_LAYER && newPos.z >= MAP_INIT_SURFACE_LAYER + 1;
+	if (creature == player || teleport || floorChange || oldStackPos >= 10 || !canSee(oldPos) || !canSee(newPos)) {
+		sendMoveCreature(creature, newPos, newStackPos, oldPos, oldStackPos, teleport);
+		return;
+	}
+
+	writeToOutputBuffer(broadcast.get(static_cast<uint32_t>(oldStackPos), [&](NetworkMessage &msg) {
+		encodeCreatureStep(msg, oldPos, oldStackPos, newPos);
+	}));
+}
+
+void ProtocolGame::encodeCreatureStep(NetworkMessage &msg, const Position &oldPos, int32_t oldStackPos, const Position &newPos) {
+	msg.addByte(0x6D);
+	msg.addPosition(oldPos);
+	msg.addByte(static_cast<uint8_t>(oldStackPos));
+	msg.addPosition(newPos);
+}
+
 void ProtocolGame::sendInventoryItem(Slots_t slot, const std::shared_ptr<Item> &item) {
 	NetworkMessage msg;
 	if (item) {
@@ -10,6 +10,8 @@
 #pragma once
 
 #include "server/network/protocol/protocol.hpp"
+#include "server/network/message/shared_packet.hpp"
+#include "server/network/protocol/viewport_snapshot.hpp"
 #include "game/movement/position.hpp"
 #include "utils/utils_definitions.hpp"
 
@@ -38,6 +40,7 @@ class Game;
 class House;
 class Container;
 class Tile;
+class TileItemsEncoding;
 class Connection;
 class ProtocolGame;
 class PreySlot;
@@ -111,6 +114,13 @@ public:
 		return version;
 	}
 
+	// Packets broadcast to many viewers, encoded the same way whether they are shared or not
+	static void encodeMagicEffect(NetworkMessage &msg, const Position &pos, uint16_t type, bool oldProtocol);
+	static void encodeDistanceShoot(NetworkMessage &msg, const Position &from, const Position &to, uint16_t type, bool oldProtocol);
+	static void encodeCreatureHealth(NetworkMessage &msg, const std::shared_ptr<Creature> &creature);
+	static void encodeCreatureSay(NetworkMessage &msg, const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, const Position &pos, bool oldProtocol);
+	static void encodeCreatureStep(NetworkMessage &msg, const Position &oldPos, int32_t oldStackPos, const Position &newPos);
+
 private:
 	ProtocolGame_ptr getThis() {
 		return std::static_pointer_cast<ProtocolGame>(shared_from_this());
@@ -118,6 +128,7 @@ private:
 	void connect(const std::string &playerName, OperatingSystem_t operatingSystem);
 	void disconnectClient(const std::string &message) const;
 	void writeToOutputBuffer(NetworkMessage &msg);
+	void writeToOutputBuffer(const SharedPacket_ptr &packet);
 
 	void release() override;
 
@@ -308,10 +319,13 @@ private:
 
 	void sendAllowBugReport();
 	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type);
+	void sendDistanceShoot(const Position &from, const Position &to, uint16_t type, BroadcastPacket &broadcast);
 	void sendMagicEffect(const Position &pos, uint16_t type);
+	void sendMagicEffect(const Position &pos, uint16_t type, BroadcastPacket &broadcast);
 	void removeMagicEffect(const Position &pos, uint16_t type);
 	void sendRestingStatus(uint8_t protection);
 	void sendCreatureHealth(const std::shared_ptr<Creature> &creature);
+	void sendCreatureHealth(const std::shared_ptr<Creature> &creature, BroadcastPacket &broadcast);
 	void sendPartyCreatureUpdate(const std::shared_ptr<Creature> &target);
 	void sendPartyCreatureShield(const std::shared_ptr<Creature> &target);
 	void sendPartyCreatureSkull(const std::shared_ptr<Creature> &target);
@@ -325,6 +339,7 @@ private:
 	void sendPingBack();
 	void sendCreatureTurn(const std::shared_ptr<Creature> &creature, uint32_t stackpos);
 	void sendCreatureSay(const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, const Position* pos = nullptr);
+	void sendCreatureSay(const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, const Position* pos, BroadcastPacket &broadcast);
 
 	// Unjust Panel
 	void sendUnjustifiedPoints(const uint8_t &dayProgress, const uint8_t &dayLeft, const uint8_t &weekProgress, const uint8_t &weekLeft, const uint8_t &monthProgress, const uint8_t &monthLeft, const uint8_t &skullDuration);
@@ -430,6 +445,7 @@ private:
 
 	void sendAddCreature(const std::shared_ptr<Creature> &creature, const Position &pos, int32_t stackpos, bool isLogin);
 	void sendMoveCreature(const std::shared_ptr<Creature> &creature, const Position &newPos, int32_t newStackPos, const Position &oldPos, int32_t oldStackPos, bool teleport);
+	void sendMoveCreature(const std::shared_ptr<Creature> &creature, const Position &newPos, int32_t newStackPos, const Position &oldPos, int32_t oldStackPos, bool teleport, BroadcastPacket &broadcast);
 
 	// containers
 	void sendAddContainerItem(uint8_t cid, uint16_t slot, const std::shared_ptr<Item> &item);
@@ -460,8 +476,13 @@ private:
 	void parseHotkeyEquip(NetworkMessage &msg);
 
 	// Help functions
-	// translate a tile to clientreadable format
+	// translate a tile to clientreadable format, reusing the bytes from the viewport snapshot when unchanged
 	void GetTileDescription(const std::shared_ptr<Tile> &tile, NetworkMessage &msg);
+	void encodeTileDescription(const std::shared_ptr<Tile> &tile, NetworkMessage &msg);
+	// returns true once the stack is full
+	bool addTileCreatures(const std::shared_ptr<Tile> &tile, NetworkMessage &msg, int32_t &count);
+	// the items of a tile still as loaded from the map, encoded once for every stock client connection
+	const TileItemsEncoding* getStaticItemsEncoding(const std::shared_ptr<Tile> &tile);
 
 	// translate a floor to clientreadable format
 	void GetFloorDescription(NetworkMessage &msg, int32_t x, int32_t y, int32_t z, int32_t width, int32_t height, int32_t offset, int32_t &skip);
@@ -530,6 +551,7 @@ private:
 	friend class PlayerAttachedEffects;
 
 	std::unordered_set<uint32_t> knownCreatureSet;
+	ViewportSnapshot viewportSnapshot;
 	std::shared_ptr<Player> player = nullptr;
 
 	uint32_t eventConnect = 0;
@@ -0,0 +1,92 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "server/network/protocol/tile_encoding.hpp"
+
+#include "items/item.hpp"
+#include "items/tile.hpp"
+#include "utils/hash.hpp"
+
+namespace {
+	struct EncodingHash {
+		size_t operator()(const TileItemsEncoding &encoding) const {
+			return encoding.hash();
+		}
+	};
+
+	struct InternPool {
+		std::mutex mutex;
+		// Node based, the instances handed out never move
+		std::unordered_set<TileItemsEncoding, EncodingHash> encodings;
+	};
+
+	InternPool &getInternPool() {
+		static InternPool pool;
+		return pool;
+	}
+}
+
+const TileItemsEncoding* TileItemsEncoding::intern(const TileItemsEncoding &encoding) {
+	auto &pool = getInternPool();
+	std::scoped_lock lock(pool.mutex);
+	return &*pool.encodings.emplace(encoding).first;
+}
+
+size_t TileItemsEncoding::getInternedCount() {
+	auto &pool = getInternPool();
+	std::scoped_lock lock(pool.mutex);
+	return pool.encodings.size();
+}
+
+bool TileItemsEncoding::isStable(const std::shared_ptr<Item> &item) {
+	const ItemType &it = Item::items[item->getID()];
+	return !it.expire && !it.expireStop && !it.clockExpire;
+}
+
+bool TileItemsEncoding::isStable(const Tile &tile) {
+	if (const auto &ground = tile.getGround(); ground && !isStable(ground)) {
+		return false;
+	}
+
+	const TileItemVector* items = tile.getItemList();
+	return !items || std::ranges::all_of(*items, [](const std::shared_ptr<Item> &item) { return isStable(item); });
+}
+
+bool TileItemsEncoding::addTopItem(std::span<const uint8_t> item) {
+	if (downCount != 0 || topCount == MAX_STACK || !append(item)) {
+		return false;
+	}
+	topLength = length;
+	++topCount;
+	return true;
+}
+
+bool TileItemsEncoding::addDownItem(std::span<const uint8_t> item) {
+	if (downCount == MAX_STACK || !append(item)) {
+		return false;
+	}
+	downEnds[downCount++] = length;
+	return true;
+}
+
+bool TileItemsEncoding::append(std::span<const uint8_t> item) {
+	if (item.size() > static_cast<size_t>(MAX_BYTES - length)) {
+		return false;
+	}
+	std::ranges::copy(item, bytes.begin() + length);
+	length += static_cast<uint8_t>(item.size());
+	return true;
+}
+
+size_t TileItemsEncoding::hash() const {
+	size_t seed = std::hash<std::string_view> {}(std::string_view(reinterpret_cast<const char*>(bytes.data()), length));
+	stdext::hash_combine(seed, topLength);
+	stdext::hash_combine(seed, downCount);
+	return seed;
+}
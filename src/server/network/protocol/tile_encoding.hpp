@@ -0,0 +1,87 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class Item;
+class Tile;
+
+/**
+ * @brief Item stack of a tile as the current protocol sends it, shared by every tile loaded with the same stack.
+ *
+ * Most of the map keeps the ground and decorations it was loaded with, and their bytes don't
+ * depend on who looks at them, so describing such a tile comes down to copying these around
+ * its creatures: the ground and top items go before them, the down items after them for as
+ * long as the client has room left in the stack.
+ */
+class TileItemsEncoding {
+public:
+	// Things the client keeps of a single tile
+	static constexpr uint8_t MAX_STACK = 10;
+	// Ground, borders and a few decorations; kept inline, taller stacks are encoded every time
+	static constexpr uint8_t MAX_BYTES = 32;
+
+	/**
+	 * @brief Returns the instance holding the same bytes, kept for as long as the server runs.
+	 * Tiles sharing a stack share an instance, so the pool grows with the distinct stacks of the map.
+	 */
+	static const TileItemsEncoding* intern(const TileItemsEncoding &encoding);
+	static size_t getInternedCount();
+
+	/**
+	 * @brief Whether the item encodes to the same bytes for as long as it is left alone.
+	 * Items counting down send the time they have left, which goes stale on its own.
+	 */
+	static bool isStable(const std::shared_ptr<Item> &item);
+	static bool isStable(const Tile &tile);
+
+	/**
+	 * @brief Appends the bytes of one more item, false once they don't fit.
+	 * Ground and top items must all be added before the first down item.
+	 */
+	bool addTopItem(std::span<const uint8_t> item);
+	bool addDownItem(std::span<const uint8_t> item);
+
+	[[nodiscard]] std::span<const uint8_t> getTop() const {
+		return { bytes.data(), topLength };
+	}
+
+	[[nodiscard]] uint8_t getTopCount() const {
+		return topCount;
+	}
+
+	[[nodiscard]] uint8_t getDownCount() const {
+		return downCount;
+	}
+
+	/**
+	 * @brief Returns the first down items, as many as there is room for.
+	 */
+	[[nodiscard]] std::span<const uint8_t> getDown(size_t room) const {
+		const auto count = std::min<size_t>(room, downCount);
+		const size_t end = count == 0 ? topLength : downEnds[count - 1];
+		return { bytes.data() + topLength, end - topLength };
+	}
+
+	[[nodiscard]] size_t hash() const;
+	// Whatever is past the end of the stack stays zeroed, so the arrays compare as a whole
+	bool operator==(const TileItemsEncoding &other) const = default;
+
+private:
+	bool append(std::span<const uint8_t> item);
+
+	// Everything a description copies sits in one place
+	std::array<uint8_t, MAX_BYTES> bytes {};
+	// Where each down item ends in bytes
+	std::array<uint8_t, MAX_STACK> downEnds {};
+	uint8_t length = 0;
+	uint8_t topLength = 0;
+	uint8_t topCount = 0;
+	uint8_t downCount = 0;
+};
@@ -0,0 +1,94 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/movement/position.hpp"
+
+/**
+ * @brief Per connection copy of the tile encodings last sent to the client, by tile version.
+ *
+ * The client clears every tile a map description covers, so logins, teleports and floor
+ * changes can't leave unchanged tiles out of the packet; what they can skip is encoding
+ * them again. A tile without creatures encodes to the same bytes for as long as it keeps
+ * its version, so those are kept in a direct-mapped table indexed by position, with room
+ * for one viewport of every floor but the ones four floors apart.
+ */
+class ViewportSnapshot {
+public:
+	static constexpr size_t SLOTS = 2048;
+	// Ground, borders and a few decorations, taller stacks are encoded every time
+	static constexpr size_t MAX_TILE_BYTES = 27;
+
+	ViewportSnapshot() = default;
+
+	// Ensures that we don't accidentally copy it
+	ViewportSnapshot(const ViewportSnapshot &) = delete;
+	ViewportSnapshot &operator=(const ViewportSnapshot &) = delete;
+
+	/**
+	 * @brief Returns the bytes stored for the tile, if it still has the version they were encoded at.
+	 */
+	std::optional<std::span<const uint8_t>> find(const Position &pos, uint32_t version) {
+		if (entries) {
+			const auto &entry = (*entries)[slot(pos)];
+			if (entry.version == version) {
+				++hits;
+				return std::span<const uint8_t>(entry.bytes.data(), entry.length);
+			}
+		}
+		++misses;
+		return std::nullopt;
+	}
+
+	void store(const Position &pos, uint32_t version, std::span<const uint8_t> bytes) {
+		if (bytes.size() > MAX_TILE_BYTES) {
+			return;
+		}
+
+		if (!entries) {
+			entries = std::make_unique<std::array<Entry, SLOTS>>();
+		}
+
+		auto &entry = (*entries)[slot(pos)];
+		entry.version = version;
+		entry.length = static_cast<uint8_t>(bytes.size());
+		std::ranges::copy(bytes, entry.bytes.begin());
+	}
+
+	void clear() {
+		entries.reset();
+	}
+
+	[[nodiscard]] uint64_t getHits() const {
+		return hits;
+	}
+
+	[[nodiscard]] uint64_t getMisses() const {
+		return misses;
+	}
+
+private:
+	struct Entry {
+		// Tile versions start at 1, an empty slot never matches
+		uint32_t version = 0;
+		uint8_t length = 0;
+		std::array<uint8_t, MAX_TILE_BYTES> bytes;
+	};
+
+	// 32 columns, 16 rows and 4 floors, wider than the 18x14 viewport so a single floor never collides with itself
+	static size_t slot(const Position &pos) {
+		return (pos.x & 31) | ((pos.y & 15) << 5) | ((pos.z & 3) << 9);
+	}
+
+	// Allocated on the first store, status and login connections never use it
+	std::unique_ptr<std::array<Entry, SLOTS>> entries;
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+};
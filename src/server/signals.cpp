@@ -27,6 +27,7 @@ Signals::Signals(asio::io_service &service) :
 	set.add(SIGTERM);
 #ifndef _WIN32
 	set.add(SIGUSR1);
+	set.add(SIGUSR2);
 	set.add(SIGHUP);
 #else
 	// This must be a blocking call as Windows calls it in a new thread and terminates
@@ -69,6 +70,9 @@ void Signals::dispatchSignalHandler(int signal) {
 		case SIGUSR1: // Saves game state
 			g_dispatcher().addEvent(sigusr1Handler, __FUNCTION__);
 			break;
+		case SIGUSR2: // Dumps the dispatcher profile
+			g_dispatcher().addEvent(sigusr2Handler, __FUNCTION__);
+			break;
 #else
 		case SIGBREAK: // Shuts the server down
 			g_dispatcher().addEvent(sigbreakHandler, __FUNCTION__);
@@ -100,6 +104,11 @@ void Signals::sigusr1Handler() {
 	g_saveManager().scheduleAll();
 }
 
+void Signals::sigusr2Handler() {
+	// Dispatcher thread
+	g_logger().info("SIGUSR2 received, dumping the dispatcher profile...\n{}", g_dispatcher().getProfiler().report());
+}
+
 void Signals::sighupHandler() {
 	// Dispatcher thread
 	g_logger().info("SIGHUP received, reloading config files...");
@@ -66,3 +66,106 @@ public:
 		::operator delete(p);
 	}
 };
+
+/**
+ * @brief Bounded lock-free multi-producer, single-consumer ring buffer.
+ *
+ * Each cell carries a sequence number telling whether it is free to be written
+ * or ready to be read (Dmitry Vyukov's bounded queue), so producers only contend
+ * on a single fetch of the write cursor and the consumer never takes a lock.
+ * Unlike atomic_queue, elements do not need to be default constructible.
+ *
+ * @tparam T The type of the elements, must be movable.
+ * @tparam CAPACITY The number of cells, must be a power of two.
+ */
+template <typename T, size_t CAPACITY>
+class MpscRing {
+	static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0, "MpscRing capacity must be a power of two");
+
+public:
+	MpscRing() noexcept {
+		for (size_t i = 0; i < CAPACITY; ++i) {
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	~MpscRing() {
+		consume([](T &&) { });
+	}
+
+	// Ensures that we don't accidentally copy it
+	MpscRing(const MpscRing &) = delete;
+	MpscRing &operator=(const MpscRing &) = delete;
+
+	/**
+	 * @brief Constructs an element in place at the back of the ring.
+	 * @return false if the ring is full, in which case nothing is constructed.
+	 */
+	template <typename... Args>
+	bool try_emplace(Args &&... args) {
+		auto pos = writePos.load(std::memory_order_relaxed);
+		Cell* cell;
+		while (true) {
+			cell = &cells[pos & (CAPACITY - 1)];
+			const auto sequence = cell->sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+			if (diff == 0) {
+				if (writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (diff < 0) {
+				return false;
+			} else {
+				pos = writePos.load(std::memory_order_relaxed);
+			}
+		}
+
+		std::construct_at(cell->get(), std::forward<Args>(args)...);
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * @brief Moves every ready element, in order, into the given callback.
+	 * Must only be called from the consumer thread.
+	 * @return The number of consumed elements.
+	 */
+	template <typename F>
+	size_t consume(F &&f) {
+		size_t consumed = 0;
+		while (true) {
+			auto &cell = cells[readPos & (CAPACITY - 1)];
+			if (cell.sequence.load(std::memory_order_acquire) != readPos + 1) {
+				return consumed;
+			}
+
+			f(std::move(*cell.get()));
+			std::destroy_at(cell.get());
+			cell.sequence.store(readPos + CAPACITY, std::memory_order_release);
+			++readPos;
+			++consumed;
+		}
+	}
+
+	[[nodiscard]] bool empty() const {
+		return cells[readPos & (CAPACITY - 1)].sequence.load(std::memory_order_acquire) != readPos + 1;
+	}
+
+	static constexpr size_t capacity() {
+		return CAPACITY;
+	}
+
+private:
+	struct Cell {
+		std::atomic_size_t sequence;
+		alignas(T) std::byte storage[sizeof(T)];
+
+		T* get() {
+			return std::launder(reinterpret_cast<T*>(storage));
+		}
+	};
+
+	std::array<Cell, CAPACITY> cells;
+	alignas(64) std::atomic_size_t writePos = 0;
+	alignas(64) size_t readPos = 0;
+};
@@ -0,0 +1,140 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * @brief Growable FIFO over a single power-of-two array.
+ *
+ * Pushing at the back and popping at the front never allocate once the buffer
+ * has grown to the working size, and elements can be read by position, which is
+ * what a queue drained in batches needs. Not thread-safe.
+ *
+ * @tparam T The type of the elements, must be movable.
+ */
+template <typename T>
+class RingBuffer {
+public:
+	static constexpr size_t MIN_CAPACITY = 8;
+
+	RingBuffer() = default;
+
+	explicit RingBuffer(size_t initialCapacity) {
+		reserve(initialCapacity);
+	}
+
+	~RingBuffer() {
+		clear();
+		if (slots) {
+			allocator.deallocate(slots, mask + 1);
+		}
+	}
+
+	// Ensures that we don't accidentally copy it
+	RingBuffer(const RingBuffer &) = delete;
+	RingBuffer &operator=(const RingBuffer &) = delete;
+
+	template <typename... Args>
+	T &emplace_back(Args &&... args) {
+		if (count == capacity()) {
+			grow(count == 0 ? MIN_CAPACITY : count * 2);
+		}
+
+		auto* slot = &slots[(head + count) & mask];
+		std::construct_at(slot, std::forward<Args>(args)...);
+		++count;
+		return *slot;
+	}
+
+	void push_back(const T &value) {
+		emplace_back(value);
+	}
+
+	void push_back(T &&value) {
+		emplace_back(std::move(value));
+	}
+
+	/**
+	 * @brief Destroys the first n elements, n must not be greater than size().
+	 */
+	void pop_front(size_t n = 1) {
+		assert(n <= count);
+		for (size_t i = 0; i < n; ++i) {
+			std::destroy_at(&slots[(head + i) & mask]);
+		}
+		head = (head + n) & mask;
+		count -= n;
+	}
+
+	void clear() {
+		pop_front(count);
+		head = 0;
+	}
+
+	void reserve(size_t minCapacity) {
+		if (minCapacity > capacity()) {
+			grow(std::bit_ceil(std::max(minCapacity, MIN_CAPACITY)));
+		}
+	}
+
+	[[nodiscard]] T &front() {
+		assert(count > 0);
+		return slots[head];
+	}
+
+	[[nodiscard]] const T &front() const {
+		assert(count > 0);
+		return slots[head];
+	}
+
+	[[nodiscard]] T &operator[](size_t index) {
+		assert(index < count);
+		return slots[(head + index) & mask];
+	}
+
+	[[nodiscard]] const T &operator[](size_t index) const {
+		assert(index < count);
+		return slots[(head + index) & mask];
+	}
+
+	[[nodiscard]] size_t size() const {
+		return count;
+	}
+
+	[[nodiscard]] bool empty() const {
+		return count == 0;
+	}
+
+	[[nodiscard]] size_t capacity() const {
+		return slots ? mask + 1 : 0;
+	}
+
+private:
+	void grow(size_t newCapacity) {
+		auto* grown = allocator.allocate(newCapacity);
+		for (size_t i = 0; i < count; ++i) {
+			auto &element = slots[(head + i) & mask];
+			std::construct_at(&grown[i], std::move(element));
+			std::destroy_at(&element);
+		}
+
+		if (slots) {
+			allocator.deallocate(slots, mask + 1);
+		}
+		slots = grown;
+		mask = newCapacity - 1;
+		head = 0;
+	}
+
+	[[no_unique_address]] std::allocator<T> allocator;
+	T* slots = nullptr;
+	size_t mask = 0;
+	size_t head = 0;
+	size_t count = 0;
+};
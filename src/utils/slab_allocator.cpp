@@ -0,0 +1,157 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "utils/slab_allocator.hpp"
+
+#include "lib/metrics/metrics.hpp"
+
+namespace {
+	using SizeClasses = std::array<SlabSizeClass*, SlabSizeClass::CLASSES>;
+
+	SizeClasses createSizeClasses() {
+		SizeClasses classes;
+		for (size_t i = 0; i < classes.size(); ++i) {
+			classes[i] = new SlabSizeClass((i + 1) * SlabSizeClass::GRANULARITY);
+		}
+		return classes;
+	}
+
+	// Never destroyed: objects held by other statics may still be released after main returns
+	const SizeClasses &sizeClasses() {
+		static const auto* classes = new SizeClasses(createSizeClasses());
+		return *classes;
+	}
+
+	size_t classIndex(size_t size) {
+		return (size + SlabSizeClass::GRANULARITY - 1) / SlabSizeClass::GRANULARITY - 1;
+	}
+}
+
+SlabSizeClass &SlabSizeClass::get(size_t size) {
+	return *sizeClasses()[classIndex(size)];
+}
+
+SlabSizeClass::LocalMagazines::~LocalMagazines() {
+	const auto &classes = sizeClasses();
+	for (size_t i = 0; i < magazines.size(); ++i) {
+		if (magazines[i].count > 0) {
+			classes[i]->flush(magazines[i], magazines[i].count);
+		}
+	}
+}
+
+SlabSizeClass::Magazine &SlabSizeClass::localMagazine(size_t classIndex) {
+	thread_local LocalMagazines local;
+	return local.magazines[classIndex];
+}
+
+void* SlabSizeClass::allocate() {
+	auto &magazine = localMagazine(classIndex(blockSize));
+	if (!magazine.head) {
+		refill(magazine);
+	}
+
+	auto* block = magazine.head;
+	magazine.head = block->next;
+	--magazine.count;
+	live.fetch_add(1, std::memory_order_relaxed);
+	return block;
+}
+
+void SlabSizeClass::deallocate(void* p) noexcept {
+	auto &magazine = localMagazine(classIndex(blockSize));
+	auto* block = static_cast<FreeBlock*>(p);
+	block->next = magazine.head;
+	magazine.head = block;
+	++magazine.count;
+	live.fetch_sub(1, std::memory_order_relaxed);
+
+	// Threads that only free, like the ones releasing decayed items, hand their blocks back
+	if (magazine.count >= BATCH * 2) {
+		flush(magazine, BATCH);
+	}
+}
+
+void SlabSizeClass::refill(Magazine &magazine) {
+	std::scoped_lock lock(mutex);
+	while (magazine.count < BATCH) {
+		if (!freeList) {
+			carveSlab();
+		}
+
+		auto* block = freeList;
+		freeList = block->next;
+		block->next = magazine.head;
+		magazine.head = block;
+		++magazine.count;
+	}
+}
+
+void SlabSizeClass::flush(Magazine &magazine, uint32_t count) noexcept {
+	std::scoped_lock lock(mutex);
+	for (; count > 0 && magazine.head; --count) {
+		auto* block = magazine.head;
+		magazine.head = block->next;
+		--magazine.count;
+		block->next = freeList;
+		freeList = block;
+	}
+}
+
+void SlabSizeClass::carveSlab() {
+	const auto blocks = SLAB_BYTES / blockSize;
+	auto &slab = slabs.emplace_back(std::make_unique_for_overwrite<std::byte[]>(blocks * blockSize));
+
+	// Linked back to front, so the first blocks handed out are the first ones in memory
+	for (auto i = blocks; i > 0; --i) {
+		auto* block = reinterpret_cast<FreeBlock*>(slab.get() + (i - 1) * blockSize);
+		block->next = freeList;
+		freeList = block;
+	}
+	reserved.fetch_add(blocks, std::memory_order_relaxed);
+}
+
+SlabStats SlabSizeClass::getStats() const {
+	const auto liveBlocks = live.load(std::memory_order_relaxed);
+	const auto reservedBlocks = reserved.load(std::memory_order_relaxed);
+
+	std::scoped_lock lock(mutex);
+	return {
+		.blockSize = blockSize,
+		.live = liveBlocks,
+		.free = reservedBlocks > liveBlocks ? reservedBlocks - liveBlocks : 0,
+		.slabs = slabs.size(),
+	};
+}
+
+std::vector<SlabStats> SlabSizeClass::collectStats() {
+	std::vector<SlabStats> stats;
+	for (const auto* sizeClass : sizeClasses()) {
+		if (sizeClass->reserved.load(std::memory_order_relaxed) > 0) {
+			stats.emplace_back(sizeClass->getStats());
+		}
+	}
+	return stats;
+}
+
+void SlabSizeClass::reportMetrics() {
+	for (auto* sizeClass : sizeClasses()) {
+		if (sizeClass->reserved.load(std::memory_order_relaxed) == 0) {
+			continue;
+		}
+
+		// Up-down counters take deltas, only what changed since the last report is sent
+		const auto stats = sizeClass->getStats();
+		const std::map<std::string, std::string> attrs { { "size", std::to_string(stats.blockSize) } };
+		g_metrics().addUpDownCounter("slab_live_blocks", static_cast<int>(static_cast<int64_t>(stats.live) - static_cast<int64_t>(sizeClass->reportedLive)), attrs);
+		g_metrics().addUpDownCounter("slab_free_blocks", static_cast<int>(static_cast<int64_t>(stats.free) - static_cast<int64_t>(sizeClass->reportedFree)), attrs);
+		sizeClass->reportedLive = stats.live;
+		sizeClass->reportedFree = stats.free;
+	}
+}
@@ -0,0 +1,153 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+struct SlabStats {
+	size_t blockSize = 0;
+	uint64_t live = 0;
+	uint64_t free = 0;
+	uint64_t slabs = 0;
+};
+
+/**
+ * @brief Fixed-size blocks carved out of large slabs, one instance per 16 byte size class.
+ *
+ * Blocks are handed out from a small thread-local cache, which is refilled from and
+ * flushed back to the shared free list in batches, so the lock is only taken once every
+ * few dozen allocations. Slabs are never returned to the system: the memory of objects
+ * that die is reused by the next ones of the same size, which keeps millions of small
+ * map objects tightly packed instead of scattered across the heap.
+ */
+class SlabSizeClass {
+public:
+	static constexpr size_t GRANULARITY = 16;
+	static constexpr size_t MAX_BLOCK_SIZE = 1024;
+	static constexpr size_t CLASSES = MAX_BLOCK_SIZE / GRANULARITY;
+	static constexpr size_t SLAB_BYTES = 64 * 1024;
+	static constexpr uint32_t BATCH = 32;
+
+	static constexpr bool fits(size_t size, size_t alignment) {
+		return size > 0 && size <= MAX_BLOCK_SIZE && alignment <= GRANULARITY;
+	}
+
+	/**
+	 * @brief Returns the size class serving blocks of the given size, which must fit.
+	 */
+	static SlabSizeClass &get(size_t size);
+
+	/**
+	 * @brief Returns the stats of every size class that ever allocated a slab.
+	 */
+	static std::vector<SlabStats> collectStats();
+
+	/**
+	 * @brief Publishes live and free block counts per size class to the metrics subsystem.
+	 */
+	static void reportMetrics();
+
+	explicit SlabSizeClass(size_t blockSize) :
+		blockSize(blockSize) { }
+
+	// Ensures that we don't accidentally copy it
+	SlabSizeClass(const SlabSizeClass &) = delete;
+	SlabSizeClass &operator=(const SlabSizeClass &) = delete;
+
+	void* allocate();
+	void deallocate(void* p) noexcept;
+
+	[[nodiscard]] SlabStats getStats() const;
+
+private:
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	struct Magazine {
+		FreeBlock* head = nullptr;
+		uint32_t count = 0;
+	};
+
+	struct LocalMagazines {
+		std::array<Magazine, CLASSES> magazines;
+
+		~LocalMagazines();
+	};
+
+	static Magazine &localMagazine(size_t classIndex);
+
+	void refill(Magazine &magazine);
+	void flush(Magazine &magazine, uint32_t count) noexcept;
+	void carveSlab();
+
+	const size_t blockSize;
+
+	mutable std::mutex mutex;
+	FreeBlock* freeList = nullptr;
+	std::vector<std::unique_ptr<std::byte[]>> slabs;
+
+	std::atomic_uint64_t live = 0;
+	std::atomic_uint64_t reserved = 0;
+	uint64_t reportedLive = 0;
+	uint64_t reportedFree = 0;
+};
+
+/**
+ * @brief Standard allocator drawing single objects from the slab size classes.
+ * Meant for std::allocate_shared: the object and its control block share a single block,
+ * and the rebound control block type picks the matching size class.
+ * Arrays and anything too large or over-aligned go to the global heap.
+ */
+template <typename T>
+class SlabAllocator {
+public:
+	using value_type = T;
+
+	template <typename U>
+	struct rebind {
+		using other = SlabAllocator<U>;
+	};
+
+	SlabAllocator() noexcept = default;
+
+	template <typename U>
+	explicit SlabAllocator(const SlabAllocator<U> &) noexcept { }
+
+	T* allocate(std::size_t n) {
+		if constexpr (SlabSizeClass::fits(sizeof(T), alignof(T))) {
+			if (n == 1) {
+				return static_cast<T*>(SlabSizeClass::get(sizeof(T)).allocate());
+			}
+		}
+		return static_cast<T*>(::operator new(n * sizeof(T), static_cast<std::align_val_t>(alignof(T))));
+	}
+
+	void deallocate(T* p, std::size_t n) const noexcept {
+		if constexpr (SlabSizeClass::fits(sizeof(T), alignof(T))) {
+			if (n == 1) {
+				SlabSizeClass::get(sizeof(T)).deallocate(p);
+				return;
+			}
+		}
+		::operator delete(p, static_cast<std::align_val_t>(alignof(T)));
+	}
+
+	template <typename U>
+	bool operator==(const SlabAllocator<U> &) const noexcept {
+		return true;
+	}
+};
+
+/**
+ * @brief Same as std::make_shared, with the object and its control block taken from a slab.
+ */
+template <typename T, typename... Args>
+std::shared_ptr<T> makeSlabShared(Args &&... args) {
+	return std::allocate_shared<T>(SlabAllocator<T>(), std::forward<Args>(args)...);
+}
@@ -16,6 +16,7 @@
 #include "utils/const.hpp"
 #include "config/configmanager.hpp"
 #include "game/movement/position.hpp"
+#include "utils/simd.hpp"
 
 #include "absl/debugging/stacktrace.h"
 #include "absl/debugging/symbolize.h"
@@ -1012,28 +1013,110 @@ std::string getSkillName(uint8_t skillid) {
 	}
 }
 
+namespace {
+	constexpr uint32_t ADLER_BASE = 65521;
+	// Largest run of bytes whose sums cannot overflow 32 bits before taking the modulo
+	constexpr size_t ADLER_NMAX = 5552;
+
+	void adlerUpdateScalar(uint32_t &a, uint32_t &b, const uint8_t* data, size_t length) {
+		while (length > 0) {
+			size_t tmp = length > ADLER_NMAX ? ADLER_NMAX : length;
+			length -= tmp;
+
+			do {
+				a += *data++;
+				b += a;
+			} while (--tmp);
+
+			a %= ADLER_BASE;
+			b %= ADLER_BASE;
+		}
+	}
+
+#if defined(__AVX2__) || defined(__SSE2__)
+	constexpr size_t ADLER_BLOCK = 32;
+
+	template <typename Lanes>
+	uint64_t sumLanes(const Lanes &lanes) {
+		std::array<uint32_t, sizeof(Lanes) / sizeof(uint32_t)> values;
+		std::memcpy(values.data(), &lanes, sizeof(lanes));
+		return std::accumulate(values.begin(), values.end(), uint64_t { 0 });
+	}
+
+	/**
+	 * Over a run of 32-byte blocks, a grows by the sum of the bytes and b by
+	 * length * a + 32 * (the byte sums before each block) + (32 - i) * byte i of
+	 * each block, so both are accumulated in vectors and folded once per run.
+	 */
+	void adlerUpdateVector(uint32_t &a, uint32_t &b, const uint8_t* data, size_t length) {
+	#if defined(__AVX2__)
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i ones = _mm256_set1_epi16(1);
+		const __m256i weights = _mm256_set_epi8(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32);
+		__m256i sums = zero;
+		__m256i previousSums = zero;
+		__m256i weightedSums = zero;
+		for (size_t i = 0; i < length; i += ADLER_BLOCK) {
+			const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+			previousSums = _mm256_add_epi32(previousSums, sums);
+			sums = _mm256_add_epi32(sums, _mm256_sad_epu8(bytes, zero));
+			weightedSums = _mm256_add_epi32(weightedSums, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, weights), ones));
+		}
+	#else
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i weights0 = _mm_set_epi16(25, 26, 27, 28, 29, 30, 31, 32);
+		const __m128i weights1 = _mm_set_epi16(17, 18, 19, 20, 21, 22, 23, 24);
+		const __m128i weights2 = _mm_set_epi16(9, 10, 11, 12, 13, 14, 15, 16);
+		const __m128i weights3 = _mm_set_epi16(1, 2, 3, 4, 5, 6, 7, 8);
+		__m128i sums = zero;
+		__m128i previousSums = zero;
+		__m128i weightedSums = zero;
+		for (size_t i = 0; i < length; i += ADLER_BLOCK) {
+			const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+			const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 16));
+			previousSums = _mm_add_epi32(previousSums, sums);
+			sums = _mm_add_epi32(sums, _mm_add_epi32(_mm_sad_epu8(low, zero), _mm_sad_epu8(high, zero)));
+
+			__m128i weighted = _mm_madd_epi16(_mm_unpacklo_epi8(low, zero), weights0);
+			weighted = _mm_add_epi32(weighted, _mm_madd_epi16(_mm_unpackhi_epi8(low, zero), weights1));
+			weighted = _mm_add_epi32(weighted, _mm_madd_epi16(_mm_unpacklo_epi8(high, zero), weights2));
+			weighted = _mm_add_epi32(weighted, _mm_madd_epi16(_mm_unpackhi_epi8(high, zero), weights3));
+			weightedSums = _mm_add_epi32(weightedSums, weighted);
+		}
+	#endif
+
+		b = static_cast<uint32_t>((b + static_cast<uint64_t>(a) * length + ADLER_BLOCK * sumLanes(previousSums) + sumLanes(weightedSums)) % ADLER_BASE);
+		a = static_cast<uint32_t>((a + sumLanes(sums)) % ADLER_BASE);
+	}
+#endif
+}
+
 uint32_t adlerChecksum(const uint8_t* data, size_t length) {
 	if (length > NETWORKMESSAGE_MAXSIZE) {
 		return 0;
 	}
 
-	constexpr uint16_t adler = 65521;
-
 	uint32_t a = 1, b = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+	constexpr size_t run = ADLER_NMAX / ADLER_BLOCK * ADLER_BLOCK;
+	while (length >= ADLER_BLOCK) {
+		const auto n = std::min(length, run) / ADLER_BLOCK * ADLER_BLOCK;
+		adlerUpdateVector(a, b, data, n);
+		data += n;
+		length -= n;
+	}
+#endif
+	adlerUpdateScalar(a, b, data, length);
+	return (b << 16) | a;
+}
 
-	while (length > 0) {
-		size_t tmp = length > 5552 ? 5552 : length;
-		length -= tmp;
-
-		do {
-			a += *data++;
-			b += a;
-		} while (--tmp);
-
-		a %= adler;
-		b %= adler;
+uint32_t adlerChecksumScalar(const uint8_t* data, size_t length) {
+	if (length > NETWORKMESSAGE_MAXSIZE) {
+		return 0;
 	}
 
+	uint32_t a = 1, b = 0;
+	adlerUpdateScalar(a, b, data, length);
 	return (b << 16) | a;
 }
 
@@ -119,6 +119,8 @@ SpawnType_t getSpawnType(const std::string &strValue);
 std::string getSkillName(uint8_t skillid);
 
 uint32_t adlerChecksum(const uint8_t* data, size_t len);
+// Byte at a time reference of adlerChecksum
+uint32_t adlerChecksumScalar(const uint8_t* data, size_t len);
 
 std::string ucfirst(std::string str);
 std::string ucwords(std::string str);
@@ -0,0 +1,129 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "database/database.hpp"
+#include "utils/benchmark.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// Same local database the integration tests use, see tests/docker-compose.yaml
+	struct DbConfig {
+		std::string host = "127.0.0.1";
+		std::string user = "root";
+		std::string password = "root";
+		std::string database = "otservbr-global";
+		uint32_t port = 3306;
+		std::string sock;
+	};
+
+	constexpr uint32_t playerId = 1;
+	constexpr int logins = 500;
+
+	// Gives the sample player the rows a seasoned character has, DBInsert would go through g_database()
+	void seedPlayer(Database &db) {
+		std::string storages;
+		for (uint32_t key = 10'000; key < 10'800; ++key) {
+			storages += fmt::format("{}({},{},{})", storages.empty() ? "" : ",", playerId, key, key * 7);
+		}
+		db.executeQuery(fmt::format("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES {}", storages));
+
+		std::string items;
+		const std::string attributes(24, '\x0f');
+		for (int32_t sid = 101; sid < 401; ++sid) {
+			items += fmt::format("{}({},{},{},{},{},{})", items.empty() ? "" : ",", playerId, sid < 111 ? sid - 100 : 103, sid, 3031, sid % 100, db.escapeBlob(attributes.data(), static_cast<uint32_t>(attributes.size())));
+		}
+		db.executeQuery(fmt::format("INSERT INTO `player_items` (`player_id`, `pid`, `sid`, `itemtype`, `count`, `attributes`) VALUES {}", items));
+
+		for (int spell = 0; spell < 40; ++spell) {
+			db.executeStatement("INSERT INTO `player_spells` (`player_id`, `name`) VALUES (?, ?)", { playerId, fmt::format("spell {}", spell) });
+		}
+	}
+
+	// The child table reads of a login as they were written before prepared statements
+	uint64_t loadWithQueries(Database &db) {
+		uint64_t checksum = 0;
+		if (const auto result = db.storeQuery(fmt::format("SELECT `id`, `account_id`, `group_id`, `deletion` FROM `players` WHERE `name` = {}", db.escapeString("Rook Sample")))) {
+			checksum += result->getNumber<uint32_t>("id") + result->getNumber<uint32_t>("account_id");
+		}
+		if (const auto result = db.storeQuery(fmt::format("SELECT `key`, `value` FROM `player_storage` WHERE `player_id` = {}", playerId))) {
+			do {
+				checksum += result->getNumber<uint32_t>("key") + result->getNumber<int32_t>("value");
+			} while (result->next());
+		}
+		if (const auto result = db.storeQuery(fmt::format("SELECT pid, sid, itemtype, count, attributes FROM player_items WHERE player_id = {} ORDER BY sid DESC", playerId))) {
+			do {
+				unsigned long size;
+				result->getStream("attributes", size);
+				checksum += result->getNumber<uint32_t>("pid") + result->getNumber<uint32_t>("sid") + result->getNumber<uint16_t>("itemtype") + result->getNumber<uint16_t>("count") + size;
+			} while (result->next());
+		}
+		if (const auto result = db.storeQuery(fmt::format("SELECT `player_id`, `name` FROM `player_spells` WHERE `player_id` = {}", playerId))) {
+			do {
+				checksum += result->getString("name").size();
+			} while (result->next());
+		}
+		return checksum;
+	}
+
+	uint64_t loadWithStatements(Database &db) {
+		uint64_t checksum = 0;
+		if (const auto result = db.storeStatement("SELECT `id`, `account_id`, `group_id`, `deletion` FROM `players` WHERE `name` = ?", { "Rook Sample" })) {
+			checksum += result->getNumber<uint32_t>(0) + result->getNumber<uint32_t>(1);
+		}
+		if (const auto result = db.storeStatement("SELECT `key`, `value` FROM `player_storage` WHERE `player_id` = ?", { playerId })) {
+			do {
+				checksum += result->getNumber<uint32_t>(0) + result->getNumber<int32_t>(1);
+			} while (result->next());
+		}
+		if (const auto result = db.storeStatement("SELECT `pid`, `sid`, `itemtype`, `count`, `attributes` FROM `player_items` WHERE `player_id` = ? ORDER BY `sid` DESC", { playerId })) {
+			do {
+				unsigned long size;
+				result->getStream(4, size);
+				checksum += result->getNumber<uint32_t>(0) + result->getNumber<uint32_t>(1) + result->getNumber<uint16_t>(2) + result->getNumber<uint16_t>(3) + size;
+			} while (result->next());
+		}
+		if (const auto result = db.storeStatement("SELECT `name` FROM `player_spells` WHERE `player_id` = ?", { playerId })) {
+			do {
+				checksum += result->getString(0).size();
+			} while (result->next());
+		}
+		return checksum;
+	}
+
+	template <typename Load>
+	uint64_t run(std::string_view name, Database &db, Load &&load) {
+		uint64_t checksum = load(db);
+
+		Benchmark bm;
+		for (int i = 0; i < logins; ++i) {
+			bm.start();
+			checksum += load(db);
+			bm.end();
+		}
+
+		fmt::print("{:<20} {:>8.3f} ms avg, {:>8.3f} ms min, {:>8.3f} ms max per login\n", name, bm.avg(), bm.min(), bm.max());
+		return checksum;
+	}
+}
+
+suite<"database"> playerLoadBench = [] {
+	test("Player login load with text queries vs prepared statements") = [] {
+		Database db {};
+		DbConfig dbConfig {};
+		if (!db.connect(&dbConfig.host, &dbConfig.user, &dbConfig.password, &dbConfig.database, dbConfig.port, &dbConfig.sock)) {
+			fmt::print("No database at {}:{}, skipping the player load benchmark\n", dbConfig.host, dbConfig.port);
+			return;
+		}
+
+		db.executeQuery("BEGIN");
+		seedPlayer(db);
+
+		const auto queries = run("text queries", db, loadWithQueries);
+		const auto statements = run("prepared statements", db, loadWithStatements);
+		expect(eq(queries, statements));
+
+		db.executeQuery("ROLLBACK");
+	};
+};
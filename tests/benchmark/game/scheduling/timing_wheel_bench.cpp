@@ -0,0 +1,140 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/timing_wheel.hpp"
+#include "utils/tools.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr uint32_t TICK_MS = 50;
+
+	// Mirrors the layout the Dispatcher used before the timing wheel.
+	class BTreeScheduler {
+	public:
+		void insert(const std::shared_ptr<Task> &task) {
+			refs.emplace(task->getId(), task);
+			tasks.insert(task);
+		}
+
+		void cancel(const std::shared_ptr<Task> &task) {
+			auto it = refs.find(task->getId());
+			if (it != refs.end()) {
+				it->second->cancel();
+				refs.erase(it);
+			}
+		}
+
+		size_t advance(int64_t now) {
+			size_t fired = 0;
+			auto it = tasks.begin();
+			while (it != tasks.end() && (*it)->getTime() <= now) {
+				if (!(*it)->isCanceled()) {
+					refs.erase((*it)->getId());
+					++fired;
+				}
+				++it;
+			}
+			tasks.erase(tasks.begin(), it);
+			return fired;
+		}
+
+	private:
+		struct Compare {
+			bool operator()(const std::shared_ptr<Task> &a, const std::shared_ptr<Task> &b) const {
+				return a->getTime() < b->getTime();
+			}
+		};
+
+		phmap::btree_multiset<std::shared_ptr<Task>, Compare> tasks;
+		phmap::flat_hash_map<uint64_t, std::shared_ptr<Task>> refs;
+	};
+
+	class WheelScheduler {
+	public:
+		explicit WheelScheduler(int64_t now) {
+			wheel.rebase(now);
+		}
+
+		void insert(const std::shared_ptr<Task> &task) {
+			wheel.insert(task);
+		}
+
+		void cancel(const std::shared_ptr<Task> &task) {
+			wheel.erase(task.get());
+		}
+
+		size_t advance(int64_t now) {
+			size_t fired = 0;
+			wheel.advance(now, [&fired](std::shared_ptr<Task> &&) { ++fired; });
+			return fired;
+		}
+
+	private:
+		TimingWheel wheel;
+	};
+
+	/**
+	 * Replays a server-like mix: short creature timers that are often cancelled,
+	 * medium decay timers and a few long-lived events, advancing in 50 ms ticks.
+	 */
+	template <typename Scheduler>
+	std::pair<double, size_t> replay(Scheduler &scheduler, uint32_t ticks, uint32_t insertsPerTick) {
+		std::mt19937 rng(1337);
+		std::uniform_int_distribution<uint32_t> kind(0, 99);
+		std::uniform_int_distribution<uint32_t> shortDelay(50, 2'000);
+		std::uniform_int_distribution<uint32_t> decayDelay(10'000, 300'000);
+		std::uniform_int_distribution<uint32_t> longDelay(600'000, 7'200'000);
+
+		std::vector<std::shared_ptr<Task>> cancellable;
+		cancellable.reserve(insertsPerTick * 4);
+
+		size_t fired = 0;
+		Benchmark bm;
+		for (uint32_t tick = 0; tick < ticks; ++tick) {
+			const auto elapsed = tick * TICK_MS;
+			for (uint32_t i = 0; i < insertsPerTick; ++i) {
+				const auto roll = kind(rng);
+				const auto delay = roll < 70 ? shortDelay(rng) : roll < 95 ? decayDelay(rng) : longDelay(rng);
+				auto task = std::make_shared<Task>([] {}, "TimingWheelBench", elapsed + delay);
+				scheduler.insert(task);
+				if (roll < 40) {
+					cancellable.emplace_back(std::move(task));
+				}
+			}
+
+			// Walks and attacks get interrupted all the time
+			for (const auto &task : cancellable) {
+				scheduler.cancel(task);
+			}
+			cancellable.clear();
+
+			fired += scheduler.advance(OTSYS_TIME() + elapsed);
+		}
+
+		return { bm.duration(), fired };
+	}
+}
+
+suite<"scheduling"> timingWheelBench = [] {
+	test("TimingWheel vs btree_multiset insert/cancel mix") = [] {
+		UPDATE_OTSYS_TIME();
+
+		for (const auto insertsPerTick : { 100u, 1'000u, 5'000u }) {
+			constexpr uint32_t ticks = 2'000;
+
+			BTreeScheduler btree;
+			const auto [btreeMs, btreeFired] = replay(btree, ticks, insertsPerTick);
+
+			WheelScheduler wheel(OTSYS_TIME());
+			const auto [wheelMs, wheelFired] = replay(wheel, ticks, insertsPerTick);
+
+			expect(eq(btreeFired, wheelFired));
+			fmt::print(
+				"inserts/tick {:>5}: btree {:>9.2f} ms, wheel {:>9.2f} ms ({:.2f}x), fired {}\n",
+				insertsPerTick, btreeMs, wheelMs, btreeMs / wheelMs, wheelFired
+			);
+		}
+	};
+};
@@ -0,0 +1,182 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "items/tile.hpp"
+#include "map/map.hpp"
+#include "utils/benchmark.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr uint16_t AREA_BASE = 1'000;
+	constexpr uint16_t AREA_SIZE = 512;
+	constexpr uint8_t AREA_FLOOR = 7;
+
+	// Mirrors the sector layout Map::getTile went through before the lock-free floors.
+	class LegacyMap {
+	public:
+		struct Floor {
+			std::pair<std::shared_ptr<Tile>, std::shared_ptr<BasicTile>> tiles[SECTOR_SIZE][SECTOR_SIZE] = {};
+			mutable std::shared_mutex mutex;
+		};
+
+		struct Sector {
+			std::shared_ptr<Floor> floors[MAP_MAX_LAYERS] = {};
+			mutable std::mutex floorsMutex;
+		};
+
+		void setTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<Tile> &tile) {
+			auto &sector = sectors[x / SECTOR_SIZE | y / SECTOR_SIZE << 16];
+			if (!sector.floors[z]) {
+				sector.floors[z] = std::make_shared<Floor>();
+			}
+			sector.floors[z]->tiles[x & SECTOR_MASK][y & SECTOR_MASK].first = tile;
+		}
+
+		std::shared_ptr<Tile> getTile(uint16_t x, uint16_t y, uint8_t z) {
+			const auto it = sectors.find(x / SECTOR_SIZE | y / SECTOR_SIZE << 16);
+			if (it == sectors.end()) {
+				return nullptr;
+			}
+
+			std::shared_ptr<Floor> floor;
+			{
+				std::scoped_lock lock(it->second.floorsMutex);
+				floor = it->second.floors[z];
+			}
+			if (!floor) {
+				return nullptr;
+			}
+
+			// getTileCache and getTile, each under its own shared lock
+			std::shared_ptr<BasicTile> cachedTile;
+			{
+				std::shared_lock lock(floor->mutex);
+				cachedTile = floor->tiles[x & SECTOR_MASK][y & SECTOR_MASK].second;
+			}
+
+			std::shared_lock lock(floor->mutex);
+			return cachedTile ? nullptr : floor->tiles[x & SECTOR_MASK][y & SECTOR_MASK].first;
+		}
+
+	private:
+		std::unordered_map<uint32_t, Sector> sectors;
+	};
+
+	/**
+	 * Every thread plays a batch of monsters thinking at once: each one looks up
+	 * the tiles of its viewport, as sight checks and path searches do.
+	 */
+	template <typename GetTile>
+	std::pair<double, size_t> think(uint32_t threads, uint32_t monstersPerThread, GetTile &&getTile) {
+		std::atomic_size_t found = 0;
+		Benchmark bm;
+		{
+			std::vector<std::jthread> workers;
+			for (uint32_t thread = 0; thread < threads; ++thread) {
+				workers.emplace_back([&, thread] {
+					std::mt19937 rng(thread + 1);
+					std::uniform_int_distribution<uint16_t> center(AREA_BASE + 8, AREA_BASE + AREA_SIZE - 9);
+
+					size_t local = 0;
+					for (uint32_t monster = 0; monster < monstersPerThread; ++monster) {
+						const auto centerX = center(rng);
+						const auto centerY = center(rng);
+						for (int32_t dy = -6; dy <= 6; ++dy) {
+							for (int32_t dx = -8; dx <= 8; ++dx) {
+								local += getTile(static_cast<uint16_t>(centerX + dx), static_cast<uint16_t>(centerY + dy), AREA_FLOOR) != nullptr;
+							}
+						}
+					}
+					found.fetch_add(local, std::memory_order_relaxed);
+				});
+			}
+		}
+		return { bm.duration(), found.load() };
+	}
+}
+
+suite<"map"> mapBench = [] {
+	test("Map::getTile lock-free floors vs shared_mutex floors") = [] {
+		Map map;
+		LegacyMap legacy;
+		for (uint16_t x = AREA_BASE; x < AREA_BASE + AREA_SIZE; ++x) {
+			for (uint16_t y = AREA_BASE; y < AREA_BASE + AREA_SIZE; ++y) {
+				const auto tile = std::make_shared<DynamicTile>(x, y, AREA_FLOOR);
+				map.setTile(x, y, AREA_FLOOR, tile);
+				legacy.setTile(x, y, AREA_FLOOR, tile);
+			}
+		}
+
+		constexpr uint32_t monstersPerThread = 20'000;
+		const auto hardwareThreads = std::max<uint32_t>(1, std::thread::hardware_concurrency());
+		for (const auto threads : { 1u, 4u, hardwareThreads }) {
+			const auto [legacyMs, legacyFound] = think(threads, monstersPerThread, [&legacy](uint16_t x, uint16_t y, uint8_t z) {
+				return legacy.getTile(x, y, z);
+			});
+			const auto [lockFreeMs, lockFreeFound] = think(threads, monstersPerThread, [&map](uint16_t x, uint16_t y, uint8_t z) {
+				return map.getTile(x, y, z);
+			});
+
+			expect(eq(legacyFound, lockFreeFound));
+			const auto lookups = static_cast<double>(lockFreeFound);
+			fmt::print(
+				"threads {:>3}: shared_mutex {:>8.2f} ms ({:>6.1f} M lookups/s), lock-free {:>8.2f} ms ({:>6.1f} M lookups/s), {:.2f}x\n",
+				threads, legacyMs, lookups / legacyMs / 1'000, lockFreeMs, lookups / lockFreeMs / 1'000, legacyMs / lockFreeMs
+			);
+		}
+	};
+
+	test("MapCache::getMapSector hash map vs dense grid") = [] {
+		// Roughly the footprint of a global map, with water and void left out
+		constexpr uint32_t baseX = 31'000;
+		constexpr uint32_t baseY = 31'000;
+		constexpr uint32_t width = 2'560;
+		constexpr uint32_t height = 2'048;
+
+		std::mt19937 rng(3);
+		std::uniform_int_distribution<uint32_t> holes(0, 9);
+
+		MapCache cache;
+		for (uint32_t x = baseX; x < baseX + width; x += SECTOR_SIZE) {
+			for (uint32_t y = baseY; y < baseY + height; y += SECTOR_SIZE) {
+				if (holes(rng) >= 3) {
+					cache.createMapSector(x, y);
+				}
+			}
+		}
+
+		std::uniform_int_distribution<uint32_t> coordX(baseX, baseX + width - 1);
+		std::uniform_int_distribution<uint32_t> coordY(baseY, baseY + height - 1);
+		std::vector<std::pair<uint32_t, uint32_t>> positions(1 << 16);
+		for (auto &[x, y] : positions) {
+			x = coordX(rng);
+			y = coordY(rng);
+		}
+
+		constexpr uint32_t rounds = 200;
+		const auto lookup = [&] {
+			size_t found = 0;
+			Benchmark bm;
+			for (uint32_t round = 0; round < rounds; ++round) {
+				for (const auto &[x, y] : positions) {
+					found += cache.getMapSector(x, y) != nullptr;
+				}
+			}
+			return std::make_pair(bm.duration(), found);
+		};
+
+		const auto [hashMs, hashFound] = lookup();
+		expect(cache.buildDenseGrid() >> fatal);
+		const auto [gridMs, gridFound] = lookup();
+
+		expect(eq(hashFound, gridFound));
+		const auto lookups = static_cast<double>(positions.size()) * rounds;
+		fmt::print(
+			"sectors {:>6}: hash map {:>6.2f} ns/lookup, dense grid {:>6.2f} ns/lookup ({:.2f}x), grid {} KB\n",
+			cache.getSectorCount(), hashMs * 1e6 / lookups, gridMs * 1e6 / lookups, hashMs / gridMs,
+			(width / SECTOR_SIZE) * (height / SECTOR_SIZE) * sizeof(MapSector*) / 1024
+		);
+	};
+};
@@ -0,0 +1,202 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "map/utils/astarnodes.hpp"
+#include "utils/benchmark.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr int32_t GRID_SIZE = 256;
+
+	// Node table the way every search used to build it: on the stack, with linear scans
+	class LegacyNodes {
+	public:
+		LegacyNodes(uint32_t x, uint32_t y, int_fast32_t extraCost) {
+			nodes[0] = { nullptr, 0, 0, extraCost, static_cast<uint16_t>(x), static_cast<uint16_t>(y) };
+			nodesTable[0] = (x << 16) | y;
+			openNodes[0] = true;
+		}
+
+		bool createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_fast32_t f, int_fast32_t heuristic, int_fast32_t extraCost) {
+			if (curNode >= AStarNodes::MAX_NODES) {
+				return false;
+			}
+			const int32_t index = curNode++;
+			openNodes[index] = true;
+			nodes[index] = { parent, f, heuristic, extraCost, static_cast<uint16_t>(x), static_cast<uint16_t>(y) };
+			nodesTable[index] = (x << 16) | y;
+			return true;
+		}
+
+		AStarNode* getBestNode() {
+			int32_t bestCost = std::numeric_limits<int32_t>::max();
+			int32_t best = -1;
+			for (int32_t i = 0; i < curNode; ++i) {
+				if (openNodes[i] && nodes[i].f + nodes[i].g < bestCost) {
+					bestCost = nodes[i].f + nodes[i].g;
+					best = i;
+				}
+			}
+			return best != -1 ? &nodes[best] : nullptr;
+		}
+
+		void closeNode(const AStarNode* node) {
+			openNodes[node - nodes] = false;
+			++closedNodes;
+		}
+
+		void openNode(const AStarNode* node) {
+			closedNodes -= openNodes[node - nodes] ? 0 : 1;
+			openNodes[node - nodes] = true;
+		}
+
+		int32_t getClosedNodes() const {
+			return closedNodes;
+		}
+
+		AStarNode* getNodeByPosition(uint32_t x, uint32_t y) {
+			const uint32_t key = (x << 16) | y;
+			for (int32_t i = 0; i < curNode; ++i) {
+				if (nodesTable[i] == key) {
+					return &nodes[i];
+				}
+			}
+			return nullptr;
+		}
+
+	private:
+		AStarNode nodes[AStarNodes::MAX_NODES];
+		uint32_t nodesTable[AStarNodes::MAX_NODES] {};
+		bool openNodes[AStarNodes::MAX_NODES] {};
+		int32_t closedNodes = 0;
+		int32_t curNode = 1;
+	};
+
+	struct Grid {
+		explicit Grid(std::mt19937 &rng) {
+			std::uniform_int_distribution<int32_t> roll(0, 99);
+			for (auto &cell : blocked) {
+				cell = roll(rng) < 22 ? 1 : 0;
+			}
+		}
+
+		[[nodiscard]] bool isBlocked(int32_t x, int32_t y) const {
+			return x < 0 || y < 0 || x >= GRID_SIZE || y >= GRID_SIZE || blocked[y * GRID_SIZE + x] != 0;
+		}
+
+		std::vector<uint8_t> blocked = std::vector<uint8_t>(GRID_SIZE * GRID_SIZE);
+	};
+
+	// Same expansion loop Map::searchPath runs, on a plain grid, stopping next to the target
+	template <typename Nodes>
+	size_t search(Nodes &nodes, const Grid &grid, int32_t startX, int32_t startY, int32_t targetX, int32_t targetY) {
+		static constexpr std::array<std::array<int32_t, 2>, 8> neighbors = { { { -1, 0 }, { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } } };
+
+		const int32_t sX = std::abs(targetX - startX);
+		const int32_t sY = std::abs(targetY - startY);
+		const AStarNode* found = nullptr;
+		do {
+			AStarNode* n = nodes.getBestNode();
+			if (!n) {
+				break;
+			}
+
+			if (std::max(std::abs(n->x - targetX), std::abs(n->y - targetY)) <= 1) {
+				found = n;
+				break;
+			}
+
+			for (const auto &[dx, dy] : neighbors) {
+				const int32_t x = n->x + dx;
+				const int32_t y = n->y + dy;
+				if (grid.isBlocked(x, y)) {
+					continue;
+				}
+
+				const int32_t newf = n->f + ((std::abs(dx) + std::abs(dy) - 1) * 25) + 10;
+				if (AStarNode* neighbor = nodes.getNodeByPosition(x, y)) {
+					if (neighbor->f > newf) {
+						neighbor->f = newf;
+						neighbor->parent = n;
+						nodes.openNode(neighbor);
+					}
+					continue;
+				}
+
+				const int32_t dX = std::abs(targetX - x);
+				const int32_t dY = std::abs(targetY - y);
+				const int32_t heuristic = ((dX - sX) << 3) + ((dY - sY) << 3) + (std::max(dX, dY) << 3);
+				if (!nodes.createOpenNode(n, x, y, newf, heuristic, 0)) {
+					break;
+				}
+			}
+			nodes.closeNode(n);
+		} while (nodes.getClosedNodes() < 100);
+
+		size_t length = 0;
+		for (; found; found = found->parent) {
+			++length;
+		}
+		return length;
+	}
+
+	struct Chase {
+		int32_t startX, startY, targetX, targetY;
+	};
+
+	// A target wandering around and a follower a few steps behind it, replanning every step
+	std::vector<Chase> makeChases(const Grid &grid, std::mt19937 &rng, size_t count) {
+		std::uniform_int_distribution<int32_t> coord(16, GRID_SIZE - 17);
+		std::uniform_int_distribution<int32_t> step(-1, 1);
+		std::uniform_int_distribution<int32_t> lag(2, 7);
+
+		std::vector<Chase> chases;
+		chases.reserve(count);
+		int32_t targetX = coord(rng);
+		int32_t targetY = coord(rng);
+		while (chases.size() < count) {
+			const auto x = std::clamp(targetX + step(rng), 8, GRID_SIZE - 9);
+			const auto y = std::clamp(targetY + step(rng), 8, GRID_SIZE - 9);
+			if (!grid.isBlocked(x, y)) {
+				targetX = x;
+				targetY = y;
+			}
+
+			const auto startX = targetX + lag(rng) * (step(rng) | 1);
+			const auto startY = targetY + lag(rng) * (step(rng) | 1);
+			if (!grid.isBlocked(startX, startY)) {
+				chases.push_back({ startX, startY, targetX, targetY });
+			}
+		}
+		return chases;
+	}
+}
+
+suite<"map"> aStarNodesBench = [] {
+	test("AStarNodes arena vs stack node table") = [] {
+		std::mt19937 rng(2024);
+		const Grid grid(rng);
+		const auto chases = makeChases(grid, rng, 50'000);
+
+		size_t legacyLength = 0;
+		Benchmark bm;
+		for (const auto &chase : chases) {
+			LegacyNodes nodes(chase.startX, chase.startY, 0);
+			legacyLength += search(nodes, grid, chase.startX, chase.startY, chase.targetX, chase.targetY);
+		}
+		const auto legacyMs = bm.duration();
+
+		size_t arenaLength = 0;
+		bm.start();
+		for (const auto &chase : chases) {
+			auto &nodes = AStarNodes::acquire(chase.startX, chase.startY, 0);
+			arenaLength += search(nodes, grid, chase.startX, chase.startY, chase.targetX, chase.targetY);
+		}
+		const auto arenaMs = bm.duration();
+
+		expect(eq(legacyLength, arenaLength));
+		fmt::print("{} chase searches: stack table {:.2f} ms, arena + heap {:.2f} ms ({:.2f}x)\n", chases.size(), legacyMs, arenaMs, legacyMs / arenaMs);
+	};
+};
@@ -0,0 +1,89 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "map/utils/mapsector.hpp"
+#include "utils/benchmark.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// Stand-in for the creature objects the old loop had to dereference
+	struct FakeCreature {
+		uint16_t x;
+		uint16_t y;
+		uint16_t z;
+		uint8_t kind;
+		std::array<uint8_t, 512> payload {};
+	};
+}
+
+suite<"map"> mapSectorBench = [] {
+	test("filterSectorCreatures vs pointer chasing") = [] {
+		constexpr uint32_t rounds = 20'000;
+
+		for (const size_t count : { 300u, 1'000u, 4'000u }) {
+			std::mt19937 rng(7);
+			std::uniform_int_distribution<uint16_t> coord(990, 1040);
+			std::uniform_int_distribution<uint16_t> floor(5, 9);
+			std::uniform_int_distribution<uint16_t> kind(0, 2);
+
+			SectorCreatures creatures;
+			std::vector<std::shared_ptr<FakeCreature>> objects;
+			for (size_t i = 0; i < count; ++i) {
+				const auto object = std::make_shared<FakeCreature>(FakeCreature { .x = coord(rng), .y = coord(rng), .z = floor(rng), .kind = static_cast<uint8_t>(1 << kind(rng)) });
+				creatures.push(object->x, object->y, object->z, object->kind, static_cast<uint32_t>(i));
+				objects.emplace_back(object);
+			}
+			std::ranges::shuffle(objects, rng);
+
+			const SectorCreatureQuery query {
+				.baseX = 1'015 - 8 + 7,
+				.baseY = 1'015 - 6 + 7,
+				.width = 17,
+				.height = 13,
+				.minZ = 5,
+				.depth = 4,
+				.kinds = SectorCreatures::KIND_PLAYER,
+			};
+
+			size_t chased = 0;
+			Benchmark bm;
+			for (uint32_t round = 0; round < rounds; ++round) {
+				for (const auto &object : objects) {
+					const auto offsetX = static_cast<uint16_t>(object->x + object->z - query.baseX);
+					const auto offsetY = static_cast<uint16_t>(object->y + object->z - query.baseY);
+					const auto offsetZ = static_cast<uint16_t>(object->z - query.minZ);
+					chased += (object->kind & query.kinds) != 0 && offsetZ <= query.depth && offsetX <= query.width && offsetY <= query.height;
+				}
+			}
+			const auto chaseMs = bm.duration();
+
+			std::vector<uint32_t> result;
+			size_t scalar = 0;
+			bm.start();
+			for (uint32_t round = 0; round < rounds; ++round) {
+				result.clear();
+				filterSectorCreaturesScalar(creatures, query, result);
+				scalar += result.size();
+			}
+			const auto scalarMs = bm.duration();
+
+			size_t vectorized = 0;
+			bm.start();
+			for (uint32_t round = 0; round < rounds; ++round) {
+				result.clear();
+				filterSectorCreatures(creatures, query, result);
+				vectorized += result.size();
+			}
+			const auto vectorizedMs = bm.duration();
+
+			expect(eq(chased, scalar));
+			expect(eq(scalar, vectorized));
+			fmt::print(
+				"creatures {:>5}: pointer chase {:>8.2f} ms, scalar SoA {:>8.2f} ms, simd SoA {:>8.2f} ms ({:.2f}x)\n",
+				count, chaseMs, scalarMs, vectorizedMs, chaseMs / vectorizedMs
+			);
+		}
+	};
+};
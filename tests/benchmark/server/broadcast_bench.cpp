@@ -0,0 +1,118 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/network/message/outputmessage.hpp"
+#include "server/network/message/shared_packet.hpp"
+#include "server/network/protocol/protocolgame.hpp"
+#include "utils/benchmark.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	using Encoder = std::function<void(NetworkMessage &)>;
+
+	// Viewers are OutputMessages, flushed like Protocol::getOutputBuffer does once they are full
+	struct Viewers {
+		explicit Viewers(uint32_t count) {
+			for (uint32_t i = 0; i < count; ++i) {
+				outputs.emplace_back(std::make_shared<OutputMessage>());
+			}
+		}
+
+		OutputMessage &get(size_t viewer, size_t size) {
+			auto &output = *outputs[viewer];
+			if (output.getLength() + size > MAX_PROTOCOL_BODY_LENGTH) {
+				bytes += output.getLength();
+				output.reset();
+			}
+			return output;
+		}
+
+		uint64_t total() const {
+			auto sum = bytes;
+			for (const auto &output : outputs) {
+				sum += output->getLength();
+			}
+			return sum;
+		}
+
+		std::vector<std::shared_ptr<OutputMessage>> outputs;
+		uint64_t bytes = 0;
+	};
+
+	// Mirrors ProtocolGame::writeToOutputBuffer(NetworkMessage &): one encoding per viewer, moved into the call
+	double perViewer(Viewers &viewers, const std::vector<Encoder> &events) {
+		Benchmark bm;
+		for (const auto &encode : events) {
+			for (size_t viewer = 0; viewer < viewers.outputs.size(); ++viewer) {
+				NetworkMessage msg;
+				encode(msg);
+				std::function<void(void)> write = [&viewers, viewer, msg = std::move(msg)] {
+					viewers.get(viewer, msg.getLength()).append(msg);
+				};
+				write();
+			}
+		}
+		return bm.duration();
+	}
+
+	// Mirrors ProtocolGame::writeToOutputBuffer(const SharedPacket_ptr &): one encoding per broadcast
+	double shared(Viewers &viewers, const std::vector<Encoder> &events) {
+		Benchmark bm;
+		for (const auto &encode : events) {
+			BroadcastPacket broadcast;
+			for (size_t viewer = 0; viewer < viewers.outputs.size(); ++viewer) {
+				std::function<void(void)> write = [&viewers, viewer, packet = broadcast.get(0, encode)] {
+					viewers.get(viewer, packet->getLength()).append(*packet);
+				};
+				write();
+			}
+		}
+		return bm.duration();
+	}
+}
+
+suite<"server"> broadcastBench = [] {
+	test("Broadcast per-viewer encoding vs shared packets") = [] {
+		constexpr uint32_t eventCount = 2'000;
+
+		std::mt19937 rng(1337);
+		std::uniform_int_distribution<uint16_t> coordinate(1000, 1100);
+		std::uniform_int_distribution<uint16_t> effect(1, 250);
+		std::uniform_int_distribution<uint32_t> kind(0, 2);
+
+		// Steps, spell effects and projectiles, the bulk of what a crowded screen receives
+		std::vector<Encoder> events;
+		for (uint32_t i = 0; i < eventCount; ++i) {
+			const Position from(coordinate(rng), coordinate(rng), 7);
+			const Position to(from.x + 1, from.y, 7);
+			const auto type = effect(rng);
+			switch (kind(rng)) {
+				case 0:
+					events.emplace_back([from, to](NetworkMessage &msg) { ProtocolGame::encodeCreatureStep(msg, from, 1, to); });
+					break;
+				case 1:
+					events.emplace_back([from, type](NetworkMessage &msg) { ProtocolGame::encodeMagicEffect(msg, from, type, false); });
+					break;
+				default:
+					events.emplace_back([from, to, type](NetworkMessage &msg) { ProtocolGame::encodeDistanceShoot(msg, from, to, type, false); });
+					break;
+			}
+		}
+
+		for (const auto viewerCount : { 1u, 10u, 50u, 200u }) {
+			Viewers perViewerOutputs(viewerCount);
+			const auto perViewerMs = perViewer(perViewerOutputs, events);
+
+			Viewers sharedOutputs(viewerCount);
+			const auto sharedMs = shared(sharedOutputs, events);
+
+			expect(eq(perViewerOutputs.total(), sharedOutputs.total()));
+			fmt::print(
+				"viewers {:>3}: per viewer {:>9.2f} ms, shared {:>9.2f} ms ({:.2f}x), {} bytes each\n",
+				viewerCount, perViewerMs, sharedMs, perViewerMs / sharedMs, sharedOutputs.total()
+			);
+		}
+	};
+};
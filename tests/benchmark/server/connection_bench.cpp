@@ -0,0 +1,213 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/network/connection/connection.hpp"
+#include "utils/benchmark.hpp"
+#include "utils/ring_buffer.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	using Message_ptr = std::shared_ptr<const std::vector<uint8_t>>;
+
+	// Mirrors the write path the Connection used before vectored writes: one async_write per message
+	class PerMessageWriter : public std::enable_shared_from_this<PerMessageWriter> {
+	public:
+		explicit PerMessageWriter(asio::ip::tcp::socket &&initSocket) :
+			socket(std::move(initSocket)) { }
+
+		void send(const Message_ptr &message) {
+			std::scoped_lock lock(mutex);
+			const auto noPendingWrite = queue.empty();
+			queue.emplace_back(message);
+			if (noPendingWrite) {
+				asio::post(socket.get_executor(), [self = shared_from_this()] { self->write(); });
+			}
+		}
+
+		uint64_t writes = 0;
+
+	private:
+		void write() {
+			std::scoped_lock lock(mutex);
+			asio::async_write(socket, asio::buffer(*queue.front()), [self = shared_from_this()](const std::error_code &error, std::size_t) { self->onWrite(error); });
+		}
+
+		void onWrite(const std::error_code &error) {
+			std::scoped_lock lock(mutex);
+			++writes;
+			queue.pop_front();
+			if (!error && !queue.empty()) {
+				write();
+			}
+		}
+
+		asio::ip::tcp::socket socket;
+		std::recursive_mutex mutex;
+		std::list<Message_ptr> queue;
+	};
+
+	// Same batching rules as Connection::internalWorker
+	class BatchWriter : public std::enable_shared_from_this<BatchWriter> {
+	public:
+		explicit BatchWriter(asio::ip::tcp::socket &&initSocket) :
+			socket(std::move(initSocket)) { }
+
+		void send(const Message_ptr &message) {
+			std::scoped_lock lock(mutex);
+			const auto noPendingWrite = queue.empty();
+			queue.emplace_back(message);
+			if (noPendingWrite) {
+				asio::post(socket.get_executor(), [self = shared_from_this()] { self->write(); });
+			}
+		}
+
+		uint64_t writes = 0;
+
+	private:
+		void write() {
+			std::scoped_lock lock(mutex);
+			const auto limit = std::min(queue.size(), CONNECTION_WRITE_BATCH_MESSAGES);
+			size_t bytes = 0;
+			buffers.clear();
+			for (size_t i = 0; i < limit && bytes < CONNECTION_WRITE_BATCH_BYTES; ++i) {
+				bytes += queue[i]->size();
+				buffers.emplace_back(asio::buffer(*queue[i]));
+			}
+			asio::async_write(socket, buffers, [self = shared_from_this()](const std::error_code &error, std::size_t) { self->onWrite(error); });
+		}
+
+		void onWrite(const std::error_code &error) {
+			std::scoped_lock lock(mutex);
+			++writes;
+			queue.pop_front(buffers.size());
+			if (!error && !queue.empty()) {
+				write();
+			}
+		}
+
+		asio::ip::tcp::socket socket;
+		std::recursive_mutex mutex;
+		RingBuffer<Message_ptr> queue;
+		std::vector<asio::const_buffer> buffers;
+	};
+
+	// A game client that only drains what the server sends
+	class SimulatedClient : public std::enable_shared_from_this<SimulatedClient> {
+	public:
+		SimulatedClient(asio::ip::tcp::socket &&initSocket, std::atomic_uint64_t &initReceived) :
+			socket(std::move(initSocket)), received(initReceived) { }
+
+		void read() {
+			socket.async_read_some(asio::buffer(buffer), [self = shared_from_this()](const std::error_code &error, std::size_t bytes) {
+				self->received.fetch_add(bytes, std::memory_order_relaxed);
+				if (!error) {
+					self->read();
+				}
+			});
+		}
+
+		void close() {
+			std::error_code error;
+			socket.close(error);
+		}
+
+	private:
+		asio::ip::tcp::socket socket;
+		std::array<uint8_t, 64 * 1024> buffer {};
+		std::atomic_uint64_t &received;
+	};
+
+	/**
+	 * Connects the clients over loopback, then plays game ticks from the calling thread:
+	 * every tick queues a burst of small packets of typical sizes for every client while
+	 * a single io thread writes them, like the service port does.
+	 */
+	template <typename Writer>
+	std::pair<double, uint64_t> run(uint32_t clients, uint32_t ticks, uint32_t packetsPerTick) {
+		std::mt19937 rng(1337);
+		std::uniform_int_distribution<uint32_t> packetSize(16, 600);
+		std::vector<Message_ptr> packets;
+		for (uint32_t i = 0; i < 256; ++i) {
+			packets.emplace_back(std::make_shared<const std::vector<uint8_t>>(packetSize(rng), static_cast<uint8_t>(i)));
+		}
+
+		asio::io_context serverIo;
+		asio::io_context clientIo;
+		asio::ip::tcp::acceptor acceptor(serverIo, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+		std::atomic_uint64_t received = 0;
+
+		std::vector<std::shared_ptr<Writer>> writers;
+		std::vector<std::shared_ptr<SimulatedClient>> simulatedClients;
+		for (uint32_t i = 0; i < clients; ++i) {
+			asio::ip::tcp::socket clientSocket(clientIo);
+			clientSocket.connect(acceptor.local_endpoint());
+			clientSocket.set_option(asio::ip::tcp::no_delay(true));
+			simulatedClients.emplace_back(std::make_shared<SimulatedClient>(std::move(clientSocket), received));
+
+			auto serverSocket = acceptor.accept();
+			serverSocket.set_option(asio::ip::tcp::no_delay(true));
+			writers.emplace_back(std::make_shared<Writer>(std::move(serverSocket)));
+		}
+		for (const auto &client : simulatedClients) {
+			client->read();
+		}
+
+		auto serverWork = asio::make_work_guard(serverIo);
+		auto clientWork = asio::make_work_guard(clientIo);
+		std::jthread serverThread([&serverIo] { serverIo.run(); });
+		std::jthread clientThread([&clientIo] { clientIo.run(); });
+
+		uint64_t expected = 0;
+		size_t next = 0;
+		Benchmark bm;
+		for (uint32_t tick = 0; tick < ticks; ++tick) {
+			for (const auto &writer : writers) {
+				for (uint32_t i = 0; i < packetsPerTick; ++i) {
+					const auto &packet = packets[next++ & (packets.size() - 1)];
+					expected += packet->size();
+					writer->send(packet);
+				}
+			}
+		}
+
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+		while (received.load(std::memory_order_relaxed) < expected && std::chrono::steady_clock::now() < deadline) {
+			std::this_thread::yield();
+		}
+		const auto elapsed = bm.duration();
+		expect(eq(received.load(), expected));
+
+		serverWork.reset();
+		serverIo.stop();
+		serverThread.join();
+		uint64_t writes = 0;
+		for (const auto &writer : writers) {
+			writes += writer->writes;
+		}
+		for (const auto &client : simulatedClients) {
+			asio::post(clientIo, [client] { client->close(); });
+		}
+		clientWork.reset();
+		clientThread.join();
+		return { elapsed, writes };
+	}
+}
+
+suite<"server"> connectionBench = [] {
+	test("Connection per-message writes vs vectored batches over loopback") = [] {
+		constexpr uint32_t ticks = 200;
+
+		for (const auto &[clients, packetsPerTick] : { std::pair { 10u, 40u }, std::pair { 100u, 20u }, std::pair { 300u, 10u } }) {
+			const auto [singleMs, singleWrites] = run<PerMessageWriter>(clients, ticks, packetsPerTick);
+			const auto [batchMs, batchWrites] = run<BatchWriter>(clients, ticks, packetsPerTick);
+
+			const auto messages = static_cast<double>(clients) * ticks * packetsPerTick;
+			fmt::print(
+				"clients {:>3}, packets/tick {:>2}: per message {:>8.2f} ms ({} writes), batched {:>8.2f} ms ({} writes, {:.1f} msgs/write) ({:.2f}x)\n",
+				clients, packetsPerTick, singleMs, singleWrites, batchMs, batchWrites, messages / static_cast<double>(batchWrites), singleMs / batchMs
+			);
+		}
+	};
+};
@@ -0,0 +1,102 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/network/protocol/packet_compressor.hpp"
+#include "utils/benchmark.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	struct Traffic {
+		std::vector<std::vector<uint8_t>> packets;
+		uint64_t bytes = 0;
+	};
+
+	// Roughly what a crowded screen sends: many small moves and effects, chat, and now and then a map slice
+	Traffic makeTraffic(std::mt19937 &rng, uint32_t count) {
+		std::uniform_int_distribution<uint32_t> kind(0, 99);
+		std::uniform_int_distribution<uint32_t> byte(0, 255);
+
+		Traffic traffic;
+		for (uint32_t i = 0; i < count; ++i) {
+			std::vector<uint8_t> packet;
+			const auto roll = kind(rng);
+			if (roll < 60) {
+				// Creature steps and magic effects, coordinates change, the opcodes around them do not
+				while (packet.size() < 96) {
+					packet.insert(packet.end(), { 0x6D, static_cast<uint8_t>(byte(rng)), 0x03, 0x07, 0x01, static_cast<uint8_t>(byte(rng)), 0x03, 0x07 });
+					packet.insert(packet.end(), { 0x83, static_cast<uint8_t>(byte(rng)), 0x03, 0x07, 0x03, 0x0D, 0x00 });
+				}
+			} else if (roll < 85) {
+				// Chat, a fixed header and mostly random text
+				packet.insert(packet.end(), { 0xAA, 0x00, 0x00, 0x00, 0x00, 0x0B, 0x00, 'A', ' ', 'P', 'l', 'a', 'y', 'e', 'r', 0x00, 0x00, 0x01 });
+				for (uint32_t c = 0; c < 80; ++c) {
+					packet.emplace_back(static_cast<uint8_t>('a' + byte(rng) % 26));
+				}
+			} else if (roll < 95) {
+				// Already dense, nothing to gain
+				packet.resize(300);
+				std::ranges::generate(packet, [&] { return static_cast<uint8_t>(byte(rng)); });
+				packet[0] = 0xA0;
+			} else {
+				// Map slices, runs of the same grounds and items
+				packet.emplace_back(0x65);
+				while (packet.size() < 4'000) {
+					packet.insert(packet.end(), { 0x10, static_cast<uint8_t>(byte(rng) % 6), 0x00, 0xFF, 0x01, 0x00, 0xFF });
+				}
+			}
+			traffic.bytes += packet.size();
+			traffic.packets.emplace_back(std::move(packet));
+		}
+		return traffic;
+	}
+
+	PacketCompressor::Options makeOptions(bool adaptive, std::vector<uint8_t> dictionary = {}) {
+		PacketCompressor::Options options;
+		options.level = 6;
+		options.adaptive = adaptive;
+		options.dictionary = std::move(dictionary);
+		return options;
+	}
+
+	void run(std::string_view name, const Traffic &traffic, PacketCompressor::Options options) {
+		PacketCompressor compressor(std::move(options));
+		uint64_t sent = 0;
+
+		Benchmark bm;
+		for (const auto &packet : traffic.packets) {
+			const auto compressed = compressor.compress(packet.data(), packet.size());
+			sent += compressed.empty() ? packet.size() : compressed.size();
+		}
+		const auto ms = bm.duration();
+
+		fmt::print(
+			"{:<22} {:>10} -> {:>10} bytes ({:>5.1f}%), {:>8.2f} ms\n",
+			name, traffic.bytes, sent, 100.0 * static_cast<double>(sent) / static_cast<double>(traffic.bytes), ms
+		);
+		for (const uint8_t opcode : { 0x6D, 0xAA, 0xA0, 0x65 }) {
+			const auto &stats = compressor.getStats(opcode);
+			fmt::print(
+				"  opcode 0x{:02X}: {:>6} of {:>6} compressed, {:>9} bytes saved, {:>8.2f} ms cpu\n",
+				opcode, stats.compressed, stats.messages, stats.savedBytes, static_cast<double>(stats.cpuNanos) / 1'000'000.0
+			);
+		}
+	}
+}
+
+suite<"server"> packetCompressorBench = [] {
+	test("Packet compression fixed level vs adaptive policy vs preset dictionary") = [] {
+		std::mt19937 rng(1337);
+		const auto training = makeTraffic(rng, 2'000);
+		const auto traffic = makeTraffic(rng, 50'000);
+
+		const std::vector<std::span<const uint8_t>> samples(training.packets.begin(), training.packets.end());
+		const auto dictionary = PacketCompressor::buildDictionary(samples, 4'096);
+
+		run("fixed level 6", traffic, makeOptions(false));
+		run("adaptive", traffic, makeOptions(true));
+		run("adaptive + dictionary", traffic, makeOptions(true, dictionary));
+		expect(!dictionary.empty());
+	};
+};
@@ -0,0 +1,57 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "security/xtea.hpp"
+#include "utils/benchmark.hpp"
+#include "utils/tools.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// Enough passes over each size for the timings to settle
+	constexpr size_t bytesPerRun = 256 * 1024 * 1024;
+
+	template <typename Transform>
+	double megabytesPerSecond(std::vector<uint8_t> &buffer, size_t length, Transform &&transform) {
+		const auto passes = std::max<size_t>(1, bytesPerRun / length);
+		Benchmark bm;
+		for (size_t i = 0; i < passes; ++i) {
+			transform(buffer.data(), length);
+		}
+		const auto seconds = std::max(bm.duration(), 0.001) / 1000.0;
+		return static_cast<double>(passes * length) / (1024.0 * 1024.0) / seconds;
+	}
+}
+
+suite<"server"> protocolBench = [] {
+	test("XTEA and adler32 throughput, scalar vs vectorized") = [] {
+		std::mt19937 rng(1337);
+		xtea::key_t key;
+		std::ranges::generate(key, [&rng] { return static_cast<uint32_t>(rng()); });
+		const auto encryptionKeys = xtea::expandEncryptionKey(key);
+		const auto decryptionKeys = xtea::expandDecryptionKey(key);
+
+		std::vector<uint8_t> buffer(NETWORKMESSAGE_MAXSIZE);
+		std::ranges::generate(buffer, [&rng] { return static_cast<uint8_t>(rng()); });
+
+		// From a single walk packet up to a full map description
+		for (const size_t length : std::array<size_t, 4> { 64, 512, 4'096, 24'576 }) {
+			const auto encryptScalar = megabytesPerSecond(buffer, length, [&](uint8_t* data, size_t size) { xtea::encryptScalar(data, size, encryptionKeys); });
+			const auto encrypt = megabytesPerSecond(buffer, length, [&](uint8_t* data, size_t size) { xtea::encrypt(data, size, encryptionKeys); });
+			const auto decryptScalar = megabytesPerSecond(buffer, length, [&](uint8_t* data, size_t size) { xtea::decryptScalar(data, size, decryptionKeys); });
+			const auto decrypt = megabytesPerSecond(buffer, length, [&](uint8_t* data, size_t size) { xtea::decrypt(data, size, decryptionKeys); });
+
+			// Summed and printed so the checksums are not optimized away
+			uint32_t checksum = 0;
+			const auto adlerScalar = megabytesPerSecond(buffer, length, [&](uint8_t* data, size_t size) { checksum += adlerChecksumScalar(data, size); });
+			const auto adler = megabytesPerSecond(buffer, length, [&](uint8_t* data, size_t size) { checksum += adlerChecksum(data, size); });
+			expect(eq(adlerChecksum(buffer.data(), length), adlerChecksumScalar(buffer.data(), length)));
+
+			fmt::print(
+				"{:>6} bytes: encrypt {:>8.1f} -> {:>8.1f} MB/s, decrypt {:>8.1f} -> {:>8.1f} MB/s, adler32 {:>8.1f} -> {:>8.1f} MB/s ({:08x})\n",
+				length, encryptScalar, encrypt, decryptScalar, decrypt, adlerScalar, adler, checksum
+			);
+		}
+	};
+};
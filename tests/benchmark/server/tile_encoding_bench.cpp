@@ -0,0 +1,218 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "items/items.hpp"
+#include "server/network/message/networkmessage.hpp"
+#include "server/network/protocol/tile_encoding.hpp"
+#include "utils/benchmark.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr uint16_t ITEM_TYPES = 20'000;
+	// Every floor of a 18x14 viewport above ground
+	constexpr uint32_t VIEWPORT_TILES = 18 * 14 * 8;
+
+	// What ProtocolGame::AddItem reads from an item lying on the map, each tile owns its own like Tile does
+	struct MapItem {
+		uint16_t id;
+		uint8_t count;
+	};
+
+	struct MapTile {
+		std::shared_ptr<MapItem> ground;
+		std::vector<std::shared_ptr<MapItem>> top;
+		std::vector<std::shared_ptr<MapItem>> down;
+		const TileItemsEncoding* encoding = nullptr;
+	};
+
+	// Mirrors the current protocol branch of ProtocolGame::AddItem, for the kinds of items maps are made of
+	void addItem(NetworkMessage &msg, const std::vector<ItemType> &types, const std::shared_ptr<MapItem> &item) {
+		const ItemType &it = types[item->id];
+		msg.add<uint16_t>(it.id);
+		if (it.stackable) {
+			msg.addByte(item->count);
+		}
+		if (it.isSplash() || it.isFluidContainer()) {
+			msg.addByte(item->count);
+		}
+		if (it.isContainer()) {
+			msg.addByte(0x00);
+		}
+		if (it.isPodium) {
+			msg.add<uint16_t>(0);
+			msg.add<uint16_t>(0);
+			msg.add<uint16_t>(0);
+			msg.addByte(2);
+			msg.addByte(0x01);
+		}
+		if (types[item->id].upgradeClassification > 0) {
+			msg.addByte(0);
+		}
+		if (it.expire || it.expireStop || it.clockExpire) {
+			msg.add<uint32_t>(it.decayTime);
+			msg.addByte(0x01);
+		}
+		if (it.wearOut) {
+			msg.add<uint32_t>(it.charges);
+			msg.addByte(0x01);
+		}
+		if (it.isWrapKit) {
+			msg.add<uint16_t>(0x00);
+		}
+	}
+
+	// Mirrors ProtocolGame::encodeTileDescription without creatures
+	void addTileItems(NetworkMessage &msg, const std::vector<ItemType> &types, const MapTile &tile) {
+		int32_t count = 0;
+		if (const auto ground = tile.ground) {
+			addItem(msg, types, ground);
+			++count;
+		}
+		for (const auto &item : tile.top) {
+			addItem(msg, types, item);
+			if (++count == TileItemsEncoding::MAX_STACK) {
+				return;
+			}
+		}
+		for (const auto &item : tile.down) {
+			addItem(msg, types, item);
+			if (++count == TileItemsEncoding::MAX_STACK) {
+				return;
+			}
+		}
+	}
+
+	std::vector<ItemType> makeItemTypes(std::mt19937 &rng) {
+		std::uniform_int_distribution<uint32_t> kind(0, 99);
+		std::vector<ItemType> types(ITEM_TYPES);
+		for (uint16_t id = 0; id < ITEM_TYPES; ++id) {
+			auto &type = types[id];
+			type.id = id;
+			const auto roll = kind(rng);
+			if (roll < 10) {
+				type.stackable = true;
+			} else if (roll < 13) {
+				type.group = ITEM_GROUP_SPLASH;
+			} else if (roll < 18) {
+				type.group = ITEM_GROUP_CONTAINER;
+			} else if (roll < 20) {
+				type.wearOut = true;
+				type.charges = 100;
+			}
+		}
+		return types;
+	}
+
+	// Grounds, borders and decorations drawn from small palettes, the way mapped areas repeat themselves
+	std::vector<MapTile> makeMap(std::mt19937 &rng, uint32_t tileCount) {
+		std::uniform_int_distribution<uint32_t> percent(0, 99);
+		std::uniform_int_distribution<uint16_t> ground(100, 120);
+		std::uniform_int_distribution<uint16_t> border(1'000, 1'040);
+		std::uniform_int_distribution<uint16_t> decoration(2'000, 2'300);
+		std::uniform_int_distribution<uint16_t> anything(0, ITEM_TYPES - 1);
+
+		std::vector<MapTile> tiles(tileCount);
+		for (auto &tile : tiles) {
+			tile.ground = std::make_shared<MapItem>(ground(rng), 1);
+			if (percent(rng) < 40) {
+				tile.top.emplace_back(std::make_shared<MapItem>(border(rng), 1));
+			}
+			if (percent(rng) < 15) {
+				tile.top.emplace_back(std::make_shared<MapItem>(border(rng), 1));
+			}
+			if (percent(rng) < 25) {
+				tile.down.emplace_back(std::make_shared<MapItem>(decoration(rng), 1));
+			}
+			if (percent(rng) < 5) {
+				tile.down.emplace_back(std::make_shared<MapItem>(anything(rng), static_cast<uint8_t>(1 + percent(rng))));
+			}
+		}
+		return tiles;
+	}
+
+	// What ProtocolGame::getStaticItemsEncoding does the first time each tile is described
+	void intern(std::vector<MapTile> &tiles, const std::vector<ItemType> &types) {
+		NetworkMessage scratch;
+		const auto encode = [&](const std::shared_ptr<MapItem> &item) {
+			scratch.reset();
+			addItem(scratch, types, item);
+			return std::span<const uint8_t>(scratch.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION, scratch.getLength());
+		};
+
+		for (auto &tile : tiles) {
+			TileItemsEncoding encoding;
+			bool fits = encoding.addTopItem(encode(tile.ground));
+			for (const auto &item : tile.top) {
+				fits = fits && encoding.addTopItem(encode(item));
+			}
+			for (const auto &item : tile.down) {
+				fits = fits && encoding.addDownItem(encode(item));
+			}
+			tile.encoding = fits ? TileItemsEncoding::intern(encoding) : nullptr;
+		}
+	}
+
+	// Mirrors ProtocolGame::GetMapDescription without creatures: item by item, or the copies of the static encodings
+	template <typename Describe>
+	std::pair<double, uint64_t> describe(const std::vector<MapTile> &tiles, uint32_t viewports, Describe &&describeTile) {
+		NetworkMessage msg;
+		uint64_t bytes = 0;
+		Benchmark bm;
+		for (uint32_t viewport = 0; viewport < viewports; ++viewport) {
+			const auto first = (viewport * VIEWPORT_TILES) % (tiles.size() - VIEWPORT_TILES);
+			for (uint32_t i = 0; i < VIEWPORT_TILES; ++i) {
+				describeTile(msg, tiles[first + i]);
+				msg.addByte(0x00);
+				msg.addByte(0xFF);
+			}
+			bytes += msg.getLength();
+			msg.reset();
+		}
+		return { bm.duration(), bytes };
+	}
+}
+
+suite<"server"> tileEncodingBench = [] {
+	test("Map description item by item vs static tile encodings") = [] {
+		std::mt19937 rng(1337);
+		const auto types = makeItemTypes(rng);
+
+		// A city, where everyone online keeps describing the same streets, then the whole of a global map
+		for (const uint32_t tileCount : { 1u << 16, 1u << 20 }) {
+			auto tiles = makeMap(rng, tileCount);
+			intern(tiles, types);
+
+			constexpr uint32_t viewports = 20'000;
+			const auto [itemMs, itemBytes] = describe(tiles, viewports, [&types](NetworkMessage &msg, const MapTile &tile) {
+				addTileItems(msg, types, tile);
+			});
+			const auto [staticMs, staticBytes] = describe(tiles, viewports, [&types](NetworkMessage &msg, const MapTile &tile) {
+				if (!tile.encoding) {
+					addTileItems(msg, types, tile);
+					return;
+				}
+
+				const auto top = tile.encoding->getTop();
+				msg.addBytes(reinterpret_cast<const char*>(top.data()), top.size());
+				const auto down = tile.encoding->getDown(TileItemsEncoding::MAX_STACK - tile.encoding->getTopCount());
+				if (!down.empty()) {
+					msg.addBytes(reinterpret_cast<const char*>(down.data()), down.size());
+				}
+			});
+
+			std::unordered_set<const TileItemsEncoding*> stacks;
+			for (const auto &tile : tiles) {
+				stacks.emplace(tile.encoding);
+			}
+
+			expect(eq(itemBytes, staticBytes));
+			fmt::print(
+				"{:>8} tiles, {:>6} stacks: item by item {:>8.2f} ms ({:>6.1f} MB/s), static encodings {:>8.2f} ms ({:>6.1f} MB/s), {:.2f}x\n",
+				tiles.size(), stacks.size(), itemMs, static_cast<double>(itemBytes) / 1'000.0 / itemMs,
+				staticMs, static_cast<double>(staticBytes) / 1'000.0 / staticMs, itemMs / staticMs
+			);
+		}
+	};
+};
@@ -0,0 +1,117 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/task.hpp"
+#include "utils/lockfree.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr size_t INBOX_CAPACITY = 512;
+	constexpr uint32_t TASKS_PER_PRODUCER = 200'000;
+
+	// Mirrors the per-thread inbox the Dispatcher used before the lock-free rings
+	struct MutexInbox {
+		std::vector<Task> tasks;
+		std::mutex mutex;
+
+		void push(std::function<void(void)> &&f) {
+			std::scoped_lock lock(mutex);
+			tasks.emplace_back(0, std::move(f), "LockfreeBench");
+		}
+
+		void merge(std::vector<Task> &out) {
+			std::scoped_lock lock(mutex);
+			out.insert(out.end(), make_move_iterator(tasks.begin()), make_move_iterator(tasks.end()));
+			tasks.clear();
+		}
+	};
+
+	struct RingInbox {
+		MpscRing<Task, INBOX_CAPACITY> ring;
+		std::vector<Task> spill;
+		std::atomic_bool hasSpilled = false;
+		std::atomic_uint64_t spilled = 0;
+		std::mutex spillMutex;
+
+		void push(std::function<void(void)> &&f) {
+			if (hasSpilled.load(std::memory_order_acquire) || !ring.try_emplace(0u, std::move(f), "LockfreeBench")) {
+				std::scoped_lock lock(spillMutex);
+				spill.emplace_back(0, std::move(f), "LockfreeBench");
+				hasSpilled.store(true, std::memory_order_release);
+				spilled.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		void merge(std::vector<Task> &out) {
+			ring.consume([&out](Task &&task) { out.emplace_back(std::move(task)); });
+			if (hasSpilled.load(std::memory_order_acquire)) {
+				std::scoped_lock lock(spillMutex);
+				out.insert(out.end(), make_move_iterator(spill.begin()), make_move_iterator(spill.end()));
+				spill.clear();
+				hasSpilled.store(false, std::memory_order_release);
+			}
+		}
+	};
+
+	/**
+	 * N producer threads push tasks into their own inbox while a single
+	 * thread keeps merging every inbox, like the dispatcher loop does.
+	 */
+	template <typename Inbox>
+	double contend(uint32_t producers, uint64_t &spilled) {
+		std::vector<std::unique_ptr<Inbox>> inboxes;
+		for (uint32_t i = 0; i < producers; ++i) {
+			inboxes.emplace_back(std::make_unique<Inbox>());
+		}
+
+		std::atomic_uint32_t finished = 0;
+		std::vector<Task> merged;
+		merged.reserve(4096);
+
+		Benchmark bm;
+		std::vector<std::jthread> threads;
+		for (uint32_t i = 0; i < producers; ++i) {
+			threads.emplace_back([&inbox = *inboxes[i], &finished] {
+				for (uint32_t j = 0; j < TASKS_PER_PRODUCER; ++j) {
+					inbox.push([] {});
+				}
+				finished.fetch_add(1, std::memory_order_release);
+			});
+		}
+
+		size_t total = 0;
+		while (total < static_cast<size_t>(producers) * TASKS_PER_PRODUCER) {
+			for (const auto &inbox : inboxes) {
+				inbox->merge(merged);
+			}
+			total += merged.size();
+			merged.clear();
+		}
+		const auto duration = bm.duration();
+
+		if constexpr (requires(Inbox &inbox) { inbox.spilled; }) {
+			for (const auto &inbox : inboxes) {
+				spilled += inbox->spilled.load();
+			}
+		}
+
+		return duration;
+	}
+}
+
+suite<"utils"> lockfreeBench = [] {
+	test("MpscRing inbox vs mutex inbox under producer contention") = [] {
+		for (const auto producers : { 1u, 4u, 8u, 16u }) {
+			uint64_t spilled = 0;
+			const auto mutexMs = contend<MutexInbox>(producers, spilled);
+			const auto ringMs = contend<RingInbox>(producers, spilled);
+
+			fmt::print(
+				"producers {:>2}: mutex {:>9.2f} ms, ring {:>9.2f} ms ({:.2f}x), spilled {}\n",
+				producers, mutexMs, ringMs, mutexMs / ringMs, spilled
+			);
+		}
+	};
+};
@@ -41,8 +41,11 @@ protected:
 	std::optional<ValueWrapper> load(const std::string &key) override {
 		return std::nullopt;
 	}
-	bool save(const std::string &key, const ValueWrapper &value) override {
-		return false;
+	std::vector<std::pair<std::string, ValueWrapper>> loadAll(const std::string &prefix) override {
+		return {};
+	}
+	bool saveBatch(std::span<const std::pair<std::string, ValueWrapper>> batch) override {
+		return true;
 	}
 };
 
@@ -1,5 +1,8 @@
 #include <boost/ut.hpp>
 
+#include <atomic>
+#include <thread>
+
 #include "account/account_repository_db.hpp"
 #include "database/database.hpp"
 #include "lib/logging/in_memory_logger.hpp"
@@ -160,4 +163,57 @@ int main() {
 		// sessionExpires is not saved
 		expect(eq(acc2->sessionExpires, 0));
 	});
+
+	test("Database pool runs concurrent load and save storms") = [&dbConfig] {
+		constexpr size_t poolSize = 8;
+		constexpr uint32_t workerCount = 16;
+		constexpr int32_t rounds = 100;
+		constexpr uint32_t firstKey = 990000;
+
+		Database pool {};
+		expect(pool.connect(&dbConfig.host, &dbConfig.user, &dbConfig.password, &dbConfig.database, dbConfig.port, &dbConfig.sock, poolSize) >> fatal);
+		expect(eq(pool.getPoolSize(), poolSize));
+
+		std::atomic<uint32_t> failures = 0;
+		{
+			std::vector<std::jthread> workers;
+			for (uint32_t worker = 0; worker < workerCount; ++worker) {
+				workers.emplace_back([&pool, &failures, worker] {
+					// Each worker owns one storage key of one of the sample players
+					const uint32_t playerId = worker % 6 + 1;
+					const uint32_t key = firstKey + worker;
+					for (int32_t round = 0; round < rounds; ++round) {
+						const bool saved = pool.executeStatement("DELETE FROM `player_storage` WHERE `player_id` = ? AND `key` = ?", { playerId, key })
+							&& pool.executeStatement("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES (?, ?, ?)", { playerId, key, round });
+						const auto player = pool.storeQuery(fmt::format("SELECT `id`, `name` FROM `players` WHERE `id` = {}", playerId));
+						const auto storage = pool.storeStatement("SELECT `value` FROM `player_storage` WHERE `player_id` = ? AND `key` = ?", { playerId, key });
+						if (!saved || !player || !storage || storage->getNumber<int32_t>(0) != round) {
+							++failures;
+						}
+					}
+				});
+			}
+		}
+
+		expect(eq(failures.load(), 0));
+		expect(pool.executeStatement("DELETE FROM `player_storage` WHERE `key` >= ? AND `key` < ?", { firstKey, firstKey + workerCount }));
+	};
+
+	test("DBSession keeps session state across queries of a pooled database") = [&dbConfig] {
+		Database db {};
+		expect(db.connect(&dbConfig.host, &dbConfig.user, &dbConfig.password, &dbConfig.database, dbConfig.port, &dbConfig.sock, 4) >> fatal);
+
+		DBSession session(db);
+		expect(static_cast<bool>(session) >> fatal);
+		expect(db.executeQuery("SET @canary_session = 42"));
+
+		// Without the pin, the connection that ran the SET is the next one handed out
+		std::jthread([&db] {
+			db.executeQuery("SET @canary_session = 7");
+		}).join();
+
+		const auto result = db.storeQuery("SELECT @canary_session AS `value`");
+		expect(static_cast<bool>(result) >> fatal);
+		expect(eq(result->getNumber<int32_t>("value"), 42));
+	};
 }
@@ -0,0 +1,72 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "database/database_table_image.hpp"
+
+using namespace boost::ut;
+
+suite<"database"> tableImageTest = [] {
+	const std::vector<DBTableImage::Row> storage {
+		{ "10000", "1" },
+		{ "10001", "2" },
+		{ "10002", "3" },
+	};
+
+	test("Untracked table is rewritten") = [&storage] {
+		DBTableImage image;
+		const auto changes = image.diff(storage, true);
+		expect(changes.rewrite);
+		expect(changes.upserts.empty());
+		expect(changes.deletes.empty());
+	};
+
+	test("Unchanged rows write nothing") = [&storage] {
+		DBTableImage image;
+		image.commit(storage, true);
+		expect(image.diff(storage, true).empty());
+	};
+
+	test("Changed, added and removed rows are told apart") = [&storage] {
+		DBTableImage image;
+		image.commit(storage, true);
+
+		const std::vector<DBTableImage::Row> rows {
+			{ "10000", "1" },
+			{ "10001", "5" },
+			{ "10003", "4" },
+		};
+		const auto changes = image.diff(rows, true);
+		expect(!changes.rewrite);
+		expect(changes.upserts == std::vector<size_t> { 1, 2 });
+		expect(changes.deletes == std::vector<std::string> { "10002" });
+	};
+
+	test("Tables without a key are rewritten on any change") = [&storage] {
+		DBTableImage image;
+		image.commit(storage, false);
+		expect(image.diff(storage, false).empty());
+
+		auto reordered = storage;
+		std::swap(reordered.front(), reordered.back());
+		const auto changes = image.diff(reordered, false);
+		expect(changes.rewrite);
+		expect(changes.upserts.empty());
+	};
+
+	test("Reset forces a rewrite") = [&storage] {
+		DBTableImage image;
+		image.commit(storage, true);
+		image.reset();
+		expect(!image.isTracked());
+		expect(image.diff(storage, true).rewrite);
+	};
+};
@@ -0,0 +1,64 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/dispatcher_profiler.hpp"
+
+using namespace boost::ut;
+using namespace std::chrono_literals;
+
+suite<"game"> dispatcherProfilerTest = [] {
+	test("DispatcherProfiler merges every thread per context and group") = [] {
+		DispatcherProfiler profiler(3);
+		for (uint32_t i = 1; i <= 100; ++i) {
+			profiler.record(0, "Game::checkCreatures", TaskGroup::Serial, 10us, std::chrono::microseconds(i));
+		}
+		profiler.record(1, "Dispatcher::asyncEvent", TaskGroup::GenericParallel, 0us, 50us);
+		profiler.record(2, "Dispatcher::asyncEvent", TaskGroup::GenericParallel, 0us, 70us);
+		profiler.record(0, "Dispatcher::asyncEvent", TaskGroup::Serial, 5us, 1us);
+
+		const auto profiles = profiler.collect();
+		expect(eq(profiles.size(), 3u) >> fatal);
+
+		const auto &slowest = profiles.front();
+		expect(eq(slowest.context, std::string("Game::checkCreatures")));
+		expect(eq(slowest.execution.count, 100u));
+		expect(eq(slowest.execution.total, 5'050'000u));
+		expect(eq(slowest.execution.max, 100'000u));
+		expect(slowest.execution.percentile(0.99) >= 99'000 * 7 / 8);
+		expect(eq(slowest.queue.max, 10'000u));
+
+		const auto &parallel = profiles[1];
+		expect(parallel.group == TaskGroup::GenericParallel);
+		expect(eq(parallel.execution.count, 2u));
+		expect(eq(parallel.execution.max, 70'000u));
+	};
+
+	test("DispatcherProfiler keeps the worst tick and skips idle ones") = [] {
+		DispatcherProfiler profiler(2);
+		profiler.endTick(1, 5ms);
+		expect(eq(profiler.getTickStats().count, 0u));
+
+		profiler.record(0, "Game::checkCreatures", TaskGroup::Serial, 0us, 3ms);
+		profiler.record(1, "Dispatcher::asyncEvent", TaskGroup::GenericParallel, 0us, 1ms);
+		profiler.endTick(2, 4ms);
+
+		profiler.record(0, "GlobalEvents::think", TaskGroup::Serial, 0us, 1ms);
+		profiler.endTick(3, 2ms);
+
+		expect(eq(profiler.getTickStats().count, 2u));
+		const auto &worst = profiler.getWorstTick();
+		expect(eq(worst.cycle, 2u));
+		expect(eq(worst.tasks, 2u));
+		expect(eq(worst.slowestContext, std::string("Game::checkCreatures")));
+		expect(eq(worst.groups[static_cast<uint8_t>(TaskGroup::GenericParallel)], 1'000'000u));
+
+		const auto report = profiler.report(1);
+		expect(report.find("Game::checkCreatures") != std::string::npos);
+		expect(report.find("GlobalEvents::think") == std::string::npos);
+
+		profiler.reset();
+		expect(profiler.collect().empty());
+		expect(eq(profiler.getTickStats().count, 0u));
+	};
+};
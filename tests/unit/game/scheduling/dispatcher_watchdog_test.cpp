@@ -0,0 +1,86 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/dispatcher_watchdog.hpp"
+#include "injection_fixture.hpp"
+
+using namespace boost::ut;
+using namespace std::chrono_literals;
+
+namespace {
+	// Follows a heartbeat set by the test instead of a dispatcher, and samples no stacks
+	class TestDispatcherWatchdog final : public DispatcherWatchdog {
+	public:
+		~TestDispatcherWatchdog() override {
+			// The watch thread calls the overrides below, it must end before they go away
+			stop();
+		}
+
+		using DispatcherWatchdog::watch;
+
+		void beginTick(std::chrono::steady_clock::time_point startedAt) {
+			tickStartedAt.store(std::chrono::duration_cast<std::chrono::nanoseconds>(startedAt.time_since_epoch()).count());
+		}
+
+		void endTick() {
+			tickStartedAt.store(0);
+		}
+
+	protected:
+		int64_t getTickStartedAt() const override {
+			return tickStartedAt.load();
+		}
+
+		uint64_t getTickCycle() const override {
+			return 42;
+		}
+
+		SlowTick sample(uint64_t cycle, std::chrono::milliseconds elapsed) override {
+			return { cycle, elapsed, "TestDispatcherWatchdog", "", "" };
+		}
+
+	private:
+		std::atomic_int64_t tickStartedAt = 0;
+	};
+}
+
+suite<"scheduling"> dispatcherWatchdogTest = [] {
+	InjectionFixture injectionFixture {};
+
+	test("DispatcherWatchdog logs a tick that runs over budget once") = [&injectionFixture] {
+		auto &logger = injectionFixture.logger();
+		TestDispatcherWatchdog watchdog;
+		watchdog.watch(20ms);
+
+		watchdog.beginTick(std::chrono::steady_clock::now());
+		std::this_thread::sleep_for(150ms);
+		watchdog.endTick();
+		watchdog.stop();
+
+		expect(eq(watchdog.getSlowTicks(), 1u));
+		expect(eq(logger.logs.size(), 1u) >> fatal);
+		expect(eq(logger.logs[0].level, std::string("warning")));
+		expect(logger.logs[0].message.find("cycle 42") != std::string::npos);
+		expect(logger.logs[0].message.find("task: TestDispatcherWatchdog") != std::string::npos);
+	};
+
+	test("DispatcherWatchdog skips healthy ticks and the tick it started in") = [&injectionFixture] {
+		auto &logger = injectionFixture.logger();
+		TestDispatcherWatchdog watchdog;
+		// Started from inside a tick that has already run for a long time, like the one that loads the server
+		watchdog.beginTick(std::chrono::steady_clock::now() - 10s);
+		watchdog.watch(20ms);
+		std::this_thread::sleep_for(60ms);
+
+		for (int i = 0; i < 5; ++i) {
+			watchdog.beginTick(std::chrono::steady_clock::now());
+			std::this_thread::sleep_for(2ms);
+			watchdog.endTick();
+		}
+		watchdog.stop();
+
+		expect(eq(watchdog.getSlowTicks(), 0u));
+		expect(logger.logs.empty());
+	};
+};
@@ -0,0 +1,127 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/pathfinding_service.hpp"
+#include "utils/tools.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// Solves every request with a single step and records the order they were solved in
+	class TestPathfindingService final : public PathfindingService {
+	public:
+		std::vector<Position> solvedTargets;
+		std::vector<Position> urgentTargets;
+		std::chrono::steady_clock::duration solveTime {};
+		uint32_t scheduled = 0;
+
+	protected:
+		void solve(Request &request) override {
+			if (solveTime.count() > 0) {
+				std::this_thread::sleep_for(solveTime);
+			}
+			solvedTargets.emplace_back(request.key.targetPos);
+			request.found = true;
+			request.dirList.emplace_back(DIRECTION_NORTH);
+		}
+
+		bool isUrgent(const Request &request) override {
+			return std::ranges::find(urgentTargets, request.key.targetPos) != urgentTargets.end();
+		}
+
+		void parallelFor(size_t size, const std::function<void(size_t i)> &f) override {
+			for (size_t i = 0; i < size; ++i) {
+				f(i);
+			}
+		}
+
+		void scheduleProcess(uint32_t) override {
+			++scheduled;
+		}
+	};
+
+	PathCacheKey makeKey(uint32_t creatureId, const Position &targetPos) {
+		FindPathParams fpp;
+		return { creatureId, Position(100, 100, 7), targetPos, fpp };
+	}
+}
+
+suite<"scheduling"> pathfindingServiceTest = [] {
+	test("PathfindingService coalesces identical pending requests") = [] {
+		UPDATE_OTSYS_TIME();
+		TestPathfindingService service;
+
+		uint32_t delivered = 0;
+		const auto callback = [&delivered](bool found, const std::vector<Direction> &dirList) {
+			expect(found);
+			expect(eq(dirList.size(), 1));
+			++delivered;
+		};
+
+		expect(service.submit(makeKey(1, Position(105, 100, 7)), {}, {}, callback));
+		expect(!service.submit(makeKey(1, Position(105, 100, 7)), {}, {}, callback));
+		expect(service.submit(makeKey(2, Position(105, 100, 7)), {}, {}, callback));
+		expect(eq(service.getPendingCount(), 2));
+		expect(eq(service.scheduled, 1));
+
+		expect(eq(service.process(), 0));
+		expect(eq(service.solvedTargets.size(), 2));
+		expect(eq(delivered, 3));
+		expect(eq(service.getPendingCount(), 0));
+
+		const auto stats = service.collectStats();
+		expect(eq(stats.requests, 3));
+		expect(eq(stats.coalesced, 1));
+		expect(eq(stats.solved, 2));
+	};
+
+	test("PathfindingService solves creatures near players first") = [] {
+		UPDATE_OTSYS_TIME();
+		TestPathfindingService service;
+		service.urgentTargets = { Position(103, 100, 7) };
+
+		for (uint16_t i = 1; i <= 3; ++i) {
+			service.submit(makeKey(i, Position(100 + i, 100, 7)), {}, {}, [](bool, const std::vector<Direction> &) { });
+		}
+
+		service.process();
+		expect(eq(service.solvedTargets.size(), 3) >> fatal);
+		expect(service.solvedTargets[0] == Position(103, 100, 7));
+		expect(service.solvedTargets[1] == Position(101, 100, 7));
+		expect(service.solvedTargets[2] == Position(102, 100, 7));
+	};
+
+	test("PathfindingService defers what does not fit in the tick budget") = [] {
+		UPDATE_OTSYS_TIME();
+		TestPathfindingService service;
+		service.solveTime = std::chrono::microseconds(100);
+
+		const auto total = PathfindingService::BATCH_SIZE * 3;
+		uint32_t delivered = 0;
+		for (uint32_t i = 0; i < total; ++i) {
+			service.submit(makeKey(i + 1, Position(101, 100, 7)), {}, {}, [&delivered](bool, const std::vector<Direction> &) { ++delivered; });
+		}
+
+		// A zero budget still solves one batch per tick
+		expect(eq(service.process(std::chrono::steady_clock::duration::zero()), total - PathfindingService::BATCH_SIZE));
+		expect(eq(delivered, PathfindingService::BATCH_SIZE));
+		expect(eq(service.scheduled, 2));
+
+		while (service.process(std::chrono::steady_clock::duration::zero()) > 0) { }
+		expect(eq(delivered, total));
+		expect(gt(service.collectStats().deferred, 0));
+	};
+
+	test("PathfindingService starts a new search once a request was delivered") = [] {
+		UPDATE_OTSYS_TIME();
+		TestPathfindingService service;
+
+		const auto key = makeKey(1, Position(105, 100, 7));
+		expect(service.submit(key, {}, {}, [](bool, const std::vector<Direction> &) { }));
+		service.process();
+		expect(service.submit(key, {}, {}, [](bool, const std::vector<Direction> &) { }));
+		service.process();
+		expect(eq(service.solvedTargets.size(), 2));
+	};
+};
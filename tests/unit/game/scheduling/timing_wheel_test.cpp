@@ -0,0 +1,120 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/timing_wheel.hpp"
+#include "utils/tools.hpp"
+
+using namespace boost::ut;
+
+suite<"scheduling"> timingWheelTest = [] {
+	const auto makeTask = [](uint32_t delay) {
+		return std::make_shared<Task>([] {}, "TimingWheelTest", delay);
+	};
+
+	const auto expireAll = [](TimingWheel &wheel, int64_t now) {
+		std::vector<std::shared_ptr<Task>> expired;
+		wheel.advance(now, [&expired](std::shared_ptr<Task> &&task) { expired.emplace_back(std::move(task)); });
+		return expired;
+	};
+
+	test("TimingWheel fires tasks in time order across all tiers") = [&] {
+		UPDATE_OTSYS_TIME();
+		const auto now = OTSYS_TIME();
+
+		TimingWheel wheel;
+		wheel.rebase(now);
+
+		const std::vector<uint32_t> delays { 5'000'000, 70'000, 1'500, 0, 10, 70'000, 999 };
+		for (const auto delay : delays) {
+			wheel.insert(makeTask(delay));
+		}
+		expect(eq(wheel.size(), delays.size()));
+
+		expect(eq(expireAll(wheel, now - 1).size(), 0));
+
+		const auto expired = expireAll(wheel, now + 5'000'000);
+		expect(eq(expired.size(), delays.size()) >> fatal);
+		expect(std::ranges::is_sorted(expired, {}, &Task::getTime));
+		expect(wheel.empty());
+	};
+
+	test("TimingWheel holds the longest delays without a spill list") = [&] {
+		UPDATE_OTSYS_TIME();
+		const auto now = OTSYS_TIME();
+
+		TimingWheel wheel;
+		// A wheel lagging behind the clock sees the longest delay past its range
+		wheel.rebase(now - 10'000);
+
+		const auto longest = makeTask(std::numeric_limits<uint32_t>::max());
+		const auto soon = makeTask(1'000);
+		wheel.insert(longest);
+		wheel.insert(soon);
+
+		const auto first = expireAll(wheel, now + 1'000);
+		expect(eq(first.size(), 1) >> fatal);
+		expect(first.front() == soon);
+
+		expect(eq(expireAll(wheel, longest->getTime() - 1).size(), 0));
+		expect(eq(wheel.getNextTime(), longest->getTime()));
+		expect(eq(expireAll(wheel, longest->getTime()).size(), 1));
+		expect(wheel.empty());
+	};
+
+	test("TimingWheel does not fire tasks before their time") = [&] {
+		UPDATE_OTSYS_TIME();
+		const auto now = OTSYS_TIME();
+
+		TimingWheel wheel;
+		wheel.rebase(now);
+		wheel.insert(makeTask(2'000));
+
+		expect(eq(expireAll(wheel, now + 1'999).size(), 0));
+		expect(eq(wheel.getNextTime(), now + 2'000));
+		expect(eq(expireAll(wheel, now + 2'000).size(), 1));
+	};
+
+	test("TimingWheel erase unlinks the task") = [&] {
+		UPDATE_OTSYS_TIME();
+		const auto now = OTSYS_TIME();
+
+		TimingWheel wheel;
+		wheel.rebase(now);
+
+		const auto kept = makeTask(100);
+		const auto removed = makeTask(100);
+		wheel.insert(kept);
+		wheel.insert(removed);
+
+		expect(wheel.erase(removed.get()));
+		expect(!wheel.erase(removed.get()));
+		expect(eq(wheel.size(), 1));
+
+		const auto expired = expireAll(wheel, now + 100);
+		expect(eq(expired.size(), 1) >> fatal);
+		expect(expired.front() == kept);
+	};
+
+	test("TimingWheel allows erasing from the expiration callback") = [&] {
+		UPDATE_OTSYS_TIME();
+		const auto now = OTSYS_TIME();
+
+		TimingWheel wheel;
+		wheel.rebase(now);
+
+		const auto first = makeTask(50);
+		const auto second = makeTask(50);
+		wheel.insert(first);
+		wheel.insert(second);
+
+		size_t fired = 0;
+		wheel.advance(now + 50, [&](std::shared_ptr<Task> &&) {
+			++fired;
+			wheel.erase(second.get());
+		});
+
+		expect(eq(fired, 1));
+		expect(wheel.empty());
+	};
+};
@@ -0,0 +1,161 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "kv/kv.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr size_t threads = 4;
+	constexpr size_t operations = 20'000;
+	constexpr size_t keyCount = 4'000;
+	// Well below the key space, so the clock hand keeps evicting
+	constexpr size_t capacity = 512;
+
+	// The in-memory test logger is not thread safe
+	class NullLogger final : public Logger {
+	public:
+		void setLevel(const std::string &) const override { }
+		std::string getLevel() const override {
+			return "INFO";
+		}
+		void info(const std::string &) const override { }
+		void warn(const std::string &) const override { }
+		void error(const std::string &) const override { }
+		void critical(const std::string &) const override { }
+		void debug(const std::string &) const override { }
+		void trace(const std::string &) const override { }
+	};
+
+	// Keeps what was flushed, so evicted keys load back like they would from the database
+	class KVBacked final : public KVStore {
+	public:
+		explicit KVBacked(Logger &logger) :
+			KVStore(logger, capacity) { }
+
+	protected:
+		std::optional<ValueWrapper> load(const std::string &key) override {
+			std::scoped_lock lock(mutex);
+			const auto it = rows.find(key);
+			return it != rows.end() ? std::make_optional(it->second) : std::nullopt;
+		}
+
+		std::vector<std::pair<std::string, ValueWrapper>> loadAll(const std::string &prefix) override {
+			std::scoped_lock lock(mutex);
+			std::vector<std::pair<std::string, ValueWrapper>> values;
+			for (const auto &[key, value] : rows) {
+				if (key.starts_with(prefix)) {
+					values.emplace_back(key, value);
+				}
+			}
+			return values;
+		}
+
+		std::vector<std::string> loadPrefix(const std::string &prefix = "") override {
+			std::scoped_lock lock(mutex);
+			std::vector<std::string> keys;
+			for (const auto &[key, _] : rows) {
+				if (key.starts_with(prefix)) {
+					keys.emplace_back(key.substr(prefix.size()));
+				}
+			}
+			return keys;
+		}
+
+		bool saveBatch(std::span<const std::pair<std::string, ValueWrapper>> batch) override {
+			// Stands in for the database round trip, readers keep going while the batch is in flight
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			std::scoped_lock lock(mutex);
+			for (const auto &[key, value] : batch) {
+				if (value.isDeleted()) {
+					rows.erase(key);
+				} else {
+					rows.insert_or_assign(key, value);
+				}
+			}
+			return true;
+		}
+
+	private:
+		std::mutex mutex;
+		phmap::flat_hash_map<std::string, ValueWrapper> rows;
+	};
+
+	std::string stressKey(size_t index) {
+		return fmt::format("stress.{}", index);
+	}
+
+	template <typename Work>
+	void runThreads(Work &&work) {
+		std::vector<std::thread> workers;
+		workers.reserve(threads);
+		for (size_t thread = 0; thread < threads; ++thread) {
+			workers.emplace_back(work, thread);
+		}
+		for (auto &worker : workers) {
+			worker.join();
+		}
+	}
+}
+
+suite<"kv"> kvStressTest = [] {
+	test("Concurrent gets and sets through the sharded cache") = [] {
+		NullLogger logger;
+		KVBacked kv(logger);
+		std::atomic<size_t> wrong = 0;
+
+		// Every key only ever holds its own index and is never removed: once a thread wrote a key,
+		// reading nothing back is a lost write and reading anything else a torn one
+		runThreads([&kv, &wrong](size_t thread) {
+			std::mt19937 random(static_cast<uint32_t>(thread));
+			std::vector<bool> written(keyCount);
+			// Most reads go to a hot tenth of the keys, like the players that stay online
+			std::uniform_int_distribution<size_t> hot(0, keyCount / 10 - 1);
+			std::uniform_int_distribution<size_t> any(0, keyCount - 1);
+			for (size_t operation = 0; operation < operations; ++operation) {
+				const auto index = random() % 4 == 0 ? any(random) : hot(random);
+				if (random() % 5 == 0) {
+					kv.set(stressKey(index), static_cast<int>(index));
+					written[index] = true;
+					continue;
+				}
+				const auto value = kv.get(stressKey(index));
+				if (value ? value->get<int>() != static_cast<int>(index) : written[index]) {
+					++wrong;
+				}
+			}
+		});
+
+		const auto stats = kv.getCacheStats();
+		expect(eq(wrong.load(), size_t { 0 }));
+		expect(stats.evictions > 0);
+		expect(stats.entries <= capacity);
+
+		// Every key written once, whether it is cached, pending or already flushed and evicted
+		runThreads([&kv](size_t thread) {
+			for (size_t index = thread; index < keyCount; index += threads) {
+				kv.set(stressKey(index), static_cast<int>(index));
+			}
+		});
+		runThreads([&kv, &wrong](size_t thread) {
+			for (size_t index = thread; index < keyCount; index += threads) {
+				const auto value = kv.get(stressKey(index));
+				if (!value || value->get<int>() != static_cast<int>(index)) {
+					++wrong;
+				}
+			}
+		});
+		expect(eq(wrong.load(), size_t { 0 }));
+		expect(kv.saveAll());
+		expect(eq(kv.pendingWrites(), size_t { 0 }));
+	};
+};
@@ -14,6 +14,42 @@
 #include "utils/tools.hpp"
 #include "injection_fixture.hpp"
 
+namespace {
+	// One entry per shard, backed by only what saveBatch wrote
+	class KVFlushProbe final : public KVStore {
+	public:
+		explicit KVFlushProbe(Logger &logger) :
+			KVStore(logger, KVStore::SHARDS) { }
+
+		// Runs inside the next saveBatch, before its rows are stored
+		std::function<void(void)> duringWrite;
+
+	protected:
+		std::optional<ValueWrapper> load(const std::string &key) override {
+			const auto it = rows.find(key);
+			return it != rows.end() ? std::make_optional(it->second) : std::nullopt;
+		}
+		std::vector<std::pair<std::string, ValueWrapper>> loadAll(const std::string &) override {
+			return {};
+		}
+		std::vector<std::string> loadPrefix(const std::string & = "") override {
+			return {};
+		}
+		bool saveBatch(std::span<const std::pair<std::string, ValueWrapper>> batch) override {
+			if (duringWrite) {
+				std::exchange(duringWrite, nullptr)();
+			}
+			for (const auto &[key, value] : batch) {
+				rows.insert_or_assign(key, value);
+			}
+			return true;
+		}
+
+	private:
+		phmap::flat_hash_map<std::string, ValueWrapper> rows;
+	};
+}
+
 suite<"kv"> kvTest = [] {
 	InjectionFixture injectionFixture {};
 
@@ -125,4 +161,47 @@ suite<"kv"> kvTest = [] {
 			  kv.remove("key2");
 			  expect(!kv.get("key2").has_value());
 		  };
+
+	test("Changes stay pending until they are written") = [&injectionFixture] {
+		auto [kv] = injectionFixture.get<KVStore>();
+		expect(kv.saveAll());
+		kv.set("pending", 1);
+		kv.set("pending", 2);
+		kv.set("pending2", 3);
+		expect(eq(kv.pendingWrites(), size_t { 2 }));
+		expect(kv.saveAll());
+		expect(eq(kv.pendingWrites(), size_t { 0 }));
+		expect(eq(kv.get("pending")->get<int>(), 2));
+	};
+
+	test("Removed keys are not listed") = [&injectionFixture] {
+		auto [kv] = injectionFixture.get<KVStore>();
+		kv.set("listed.key1", 1);
+		kv.set("listed.key2", 2);
+		kv.remove("listed.key1");
+		const auto keys = kv.keys("listed.");
+		expect(eq(keys.size(), size_t { 1 }));
+		expect(keys.contains("key2"));
+	};
+
+	test("Evicted changes stay readable while their write is in flight") = [&injectionFixture] {
+		KVFlushProbe kv(injectionFixture.logger());
+		kv.set("probe", 1);
+		// Enough keys that one lands in the shard of "probe" and evicts it
+		for (int i = 0; i < 200; ++i) {
+			kv.set(fmt::format("filler.{}", i), i);
+		}
+
+		std::optional<ValueWrapper> during;
+		kv.duringWrite = [&kv, &during] {
+			during = kv.get("probe");
+		};
+		expect(kv.saveAll());
+		expect(eq(during.has_value(), true) >> fatal);
+		expect(eq(during->get<int>(), 1));
+
+		const auto after = kv.get("probe");
+		expect(eq(after.has_value(), true) >> fatal);
+		expect(eq(after->get<int>(), 1));
+	};
 };
@@ -0,0 +1,73 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/metrics/latency_recorder.hpp"
+
+using namespace boost::ut;
+using namespace metrics;
+
+namespace {
+	const LatencyStats* findStats(const std::vector<LatencyStats> &stats, LatencyKind kind, std::string_view scope) {
+		const auto it = std::ranges::find_if(stats, [&](const LatencyStats &entry) {
+			return entry.kind == kind && entry.scope == scope;
+		});
+		return it != stats.end() ? &*it : nullptr;
+	}
+}
+
+suite<"lib"> latencyRecorderTest = [] {
+	test("LatencyBuckets covers every value with a bounded relative error") = [] {
+		uint32_t previous = 0;
+		for (uint64_t ns = 1; ns < LatencyBuckets::MAX_VALUE; ns += ns / 7 + 1) {
+			const auto index = LatencyBuckets::indexOf(ns);
+			expect(index >= previous);
+			expect(index < LatencyBuckets::COUNT);
+			expect(LatencyBuckets::lowerBound(index) <= ns && ns <= LatencyBuckets::upperBound(index));
+			const auto width = LatencyBuckets::upperBound(index) - LatencyBuckets::lowerBound(index) + 1;
+			expect(width * LatencyBuckets::SUB_BUCKETS <= std::max<uint64_t>(ns, LatencyBuckets::SUB_BUCKETS));
+			previous = index;
+		}
+		expect(eq(LatencyBuckets::indexOf(std::numeric_limits<uint64_t>::max()), LatencyBuckets::COUNT - 1));
+	};
+
+	test("LatencyRecorder interns literals and dynamic names to the same id") = [] {
+		static constexpr const char* literal = "latency_recorder_test::intern";
+		const auto id = LatencyRecorder::intern(LatencyKind::Method, literal);
+		expect(eq(LatencyRecorder::intern(LatencyKind::Method, literal), id));
+		expect(eq(LatencyRecorder::intern(LatencyKind::Method, std::string("latency_recorder_test::intern")), id));
+		expect(LatencyRecorder::intern(LatencyKind::Task, literal) != id);
+	};
+
+	test("LatencyRecorder aggregates the shards of every thread in windows") = [] {
+		const auto id = LatencyRecorder::intern(LatencyKind::Query, std::string_view("latency_recorder_test::aggregate"));
+		LatencyRecorder::aggregate();
+
+		std::vector<std::jthread> threads;
+		for (uint32_t thread = 0; thread < 4; ++thread) {
+			threads.emplace_back([id] {
+				for (uint32_t i = 1; i <= 100; ++i) {
+					LatencyRecorder::record(id, std::chrono::microseconds(i));
+				}
+			});
+		}
+		threads.clear();
+
+		const auto first = LatencyRecorder::aggregate();
+		const auto* stats = findStats(first, LatencyKind::Query, "latency_recorder_test::aggregate");
+		expect((stats != nullptr) >> fatal);
+		expect(eq(stats->count, 400u));
+		expect(eq(stats->totalCount, 400u));
+		expect(eq(stats->sum, 20'200.0));
+		expect(stats->p50 >= 50 * 0.875 && stats->p50 <= 50 * 1.125);
+		expect(stats->p99 >= 99 * 0.875 && stats->p99 <= 100 * 1.125);
+		expect(stats->max >= 100.0 && stats->max <= 100 * 1.125);
+
+		// Nothing recorded since, so the window is empty but the totals stay
+		const auto second = LatencyRecorder::aggregate();
+		stats = findStats(second, LatencyKind::Query, "latency_recorder_test::aggregate");
+		expect((stats != nullptr) >> fatal);
+		expect(eq(stats->count, 0u));
+		expect(eq(stats->totalCount, 400u));
+	};
+};
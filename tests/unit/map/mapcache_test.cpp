@@ -0,0 +1,67 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "map/mapcache.hpp"
+
+using namespace boost::ut;
+
+suite<"map"> mapCacheTest = [] {
+	test("MapCache dense grid finds the same sectors as the hash map") = [] {
+		MapCache cache;
+		std::vector<std::pair<uint32_t, uint32_t>> created;
+		for (uint32_t x = 1'000; x < 1'320; x += SECTOR_SIZE) {
+			for (uint32_t y = 2'000; y < 2'160; y += SECTOR_SIZE) {
+				// Leave some holes, as water and void areas do
+				if ((x / SECTOR_SIZE + y / SECTOR_SIZE) % 5 != 0) {
+					cache.createMapSector(x, y);
+					created.emplace_back(x, y);
+				}
+			}
+		}
+
+		std::vector<const MapSector*> expected;
+		for (uint32_t x = 960; x < 1'360; x += 7) {
+			for (uint32_t y = 1'960; y < 2'200; y += 7) {
+				expected.emplace_back(cache.getMapSector(x, y));
+			}
+		}
+
+		expect(cache.buildDenseGrid() >> fatal);
+
+		size_t i = 0;
+		for (uint32_t x = 960; x < 1'360; x += 7) {
+			for (uint32_t y = 1'960; y < 2'200; y += 7) {
+				expect(cache.getMapSector(x, y) == expected[i++]);
+			}
+		}
+	};
+
+	test("MapCache dense grid sees sectors created after it was built") = [] {
+		MapCache cache;
+		for (uint32_t x = 0; x <= 64; x += SECTOR_SIZE) {
+			for (uint32_t y = 0; y <= 64; y += SECTOR_SIZE) {
+				if (x != 32 || y != 32) {
+					cache.createMapSector(x, y);
+				}
+			}
+		}
+		expect(cache.buildDenseGrid() >> fatal);
+
+		expect(cache.getMapSector(32, 32) == nullptr);
+		const auto inside = cache.createMapSector(32, 32);
+		expect(cache.getMapSector(40, 40) == inside);
+
+		const auto outside = cache.createMapSector(4'000, 4'000);
+		expect(cache.getMapSector(4'000, 4'000) == outside);
+	};
+
+	test("MapCache keeps the hash map for sparse maps") = [] {
+		MapCache cache;
+		cache.createMapSector(0, 0);
+		cache.createMapSector(30'000, 30'000);
+		expect(!cache.buildDenseGrid());
+		expect(!cache.hasDenseGrid());
+		expect(cache.getMapSector(30'000, 30'000) != nullptr);
+	};
+};
@@ -0,0 +1,80 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "map/utils/astarnodes.hpp"
+
+using namespace boost::ut;
+
+suite<"map"> aStarNodesTest = [] {
+	test("AStarNodes returns open nodes by cost, oldest first on ties") = [] {
+		auto &nodes = AStarNodes::acquire(100, 100, 0);
+		AStarNode* start = nodes.getBestNode();
+		expect(start != nullptr);
+		nodes.closeNode(start);
+
+		expect(nodes.createOpenNode(start, 101, 100, 30, 10, 0));
+		expect(nodes.createOpenNode(start, 100, 101, 20, 5, 0));
+		expect(nodes.createOpenNode(start, 99, 100, 10, 15, 0));
+
+		AStarNode* best = nodes.getBestNode();
+		expect(best != nullptr && best->x == 100 && best->y == 101);
+		nodes.closeNode(best);
+
+		best = nodes.getBestNode();
+		expect(best != nullptr && best->x == 99 && best->y == 100);
+		nodes.closeNode(best);
+
+		best = nodes.getBestNode();
+		expect(best != nullptr && best->x == 101 && best->y == 100);
+		nodes.closeNode(best);
+
+		expect(nodes.getBestNode() == nullptr);
+		expect(eq(nodes.getClosedNodes(), 4));
+	};
+
+	test("AStarNodes reopens a closed node with its new cost") = [] {
+		auto &nodes = AStarNodes::acquire(10, 10, 0);
+		AStarNode* start = nodes.getBestNode();
+		nodes.closeNode(start);
+
+		expect(nodes.createOpenNode(start, 11, 10, 50, 0, 0));
+		expect(nodes.createOpenNode(start, 12, 10, 40, 0, 0));
+
+		AStarNode* node = nodes.getNodeByPosition(11, 10);
+		expect(node != nullptr);
+		node->f = 5;
+		nodes.openNode(node);
+
+		expect(nodes.getBestNode() == node);
+		nodes.closeNode(node);
+		expect(nodes.getBestNode() == nodes.getNodeByPosition(12, 10));
+	};
+
+	test("AStarNodes is reset between searches") = [] {
+		auto &first = AStarNodes::acquire(500, 500, 0);
+		expect(first.createOpenNode(nullptr, 501, 500, 10, 0, 0));
+		expect(first.getNodeByPosition(501, 500) != nullptr);
+
+		auto &second = AStarNodes::acquire(700, 700, 3);
+		expect(&first == &second);
+		expect(second.getNodeByPosition(501, 500) == nullptr);
+		expect(eq(second.getClosedNodes(), 0));
+
+		AStarNode* start = second.getNodeByPosition(700, 700);
+		expect(start != nullptr && start->c == 3);
+	};
+
+	test("AStarNodes stops at the node limit") = [] {
+		auto &nodes = AStarNodes::acquire(0, 0, 0);
+		for (int32_t i = 1; i < AStarNodes::MAX_NODES; ++i) {
+			expect(nodes.createOpenNode(nullptr, static_cast<uint32_t>(i), 7, i, 0, 0)) << "node" << i;
+		}
+		expect(!nodes.createOpenNode(nullptr, 9999, 7, 0, 0, 0));
+
+		for (int32_t i = 1; i < AStarNodes::MAX_NODES; ++i) {
+			const auto node = nodes.getNodeByPosition(static_cast<uint32_t>(i), 7);
+			expect(node != nullptr && node->f == i) << "node" << i;
+		}
+	};
+};
@@ -0,0 +1,98 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "map/utils/mapsector.hpp"
+
+using namespace boost::ut;
+
+suite<"map"> mapSectorTest = [] {
+	// Same math Spectators used to run on every creature position
+	const auto referenceFilter = [](const SectorCreatures &creatures, int32_t minX, int32_t minY, int32_t centerZ, const SectorCreatureQuery &query) {
+		std::vector<uint32_t> result;
+		for (size_t i = 0; i < creatures.size(); ++i) {
+			const uint32_t zDiff = static_cast<uint32_t>(creatures.z[i] - query.minZ);
+			const int32_t offsetZ = centerZ - creatures.z[i];
+			const uint32_t offsetX = creatures.x[i] - offsetZ - minX;
+			const uint32_t offsetY = creatures.y[i] - offsetZ - minY;
+			if ((creatures.kind[i] & query.kinds) != 0 && zDiff <= query.depth && offsetX <= query.width && offsetY <= query.height) {
+				result.emplace_back(static_cast<uint32_t>(i));
+			}
+		}
+		return result;
+	};
+
+	test("filterSectorCreatures matches the scalar reference") = [&] {
+		std::mt19937 rng(42);
+		std::uniform_int_distribution<uint16_t> coord(980, 1050);
+		std::uniform_int_distribution<uint16_t> floor(0, 15);
+		std::uniform_int_distribution<uint16_t> kind(0, 3);
+
+		for (const size_t count : { 0u, 1u, 7u, 8u, 15u, 16u, 17u, 63u, 300u, 1'001u }) {
+			SectorCreatures creatures;
+			for (size_t i = 0; i < count; ++i) {
+				creatures.push(coord(rng), coord(rng), floor(rng), static_cast<uint8_t>(1 << kind(rng)), static_cast<uint32_t>(i));
+			}
+
+			for (const uint8_t kinds : { uint8_t { SectorCreatures::KIND_ALL }, uint8_t { SectorCreatures::KIND_PLAYER }, uint8_t { SectorCreatures::KIND_MONSTER } }) {
+				constexpr int32_t centerX = 1'015;
+				constexpr int32_t centerY = 1'015;
+				constexpr int32_t centerZ = 7;
+				const int32_t minX = centerX - 8;
+				const int32_t minY = centerY - 6;
+				const SectorCreatureQuery query {
+					.baseX = static_cast<uint16_t>(minX + centerZ),
+					.baseY = static_cast<uint16_t>(minY + centerZ),
+					.width = 17,
+					.height = 13,
+					.minZ = 5,
+					.depth = 4,
+					.kinds = kinds,
+				};
+
+				std::vector<uint32_t> result;
+				filterSectorCreatures(creatures, query, result);
+				expect(result == referenceFilter(creatures, minX, minY, centerZ, query)) << "count" << count << "kinds" << kinds;
+			}
+		}
+	};
+
+	test("filterSectorCreatures handles coordinates near the map edge") = [&] {
+		SectorCreatures creatures;
+		for (uint16_t i = 0; i < 32; ++i) {
+			creatures.push(i, i, 7, SectorCreatures::KIND_PLAYER, i);
+		}
+
+		// The view starts before x/y 0, offsets must wrap exactly like the 32-bit math did
+		constexpr int32_t minX = -8;
+		constexpr int32_t minY = -6;
+		const SectorCreatureQuery query {
+			.baseX = static_cast<uint16_t>(minX + 7),
+			.baseY = static_cast<uint16_t>(minY + 7),
+			.width = 17,
+			.height = 13,
+			.minZ = 7,
+			.depth = 0,
+		};
+
+		std::vector<uint32_t> result;
+		filterSectorCreatures(creatures, query, result);
+		expect(result == referenceFilter(creatures, minX, minY, 7, query));
+		expect(eq(result.size(), 8u));
+	};
+
+	test("SectorCreatures::swapPop mirrors the creature list removal") = [] {
+		SectorCreatures creatures;
+		creatures.push(1, 1, 7, SectorCreatures::KIND_PLAYER, 1);
+		creatures.push(2, 2, 7, SectorCreatures::KIND_MONSTER, 2);
+		creatures.push(3, 3, 7, SectorCreatures::KIND_NPC, 3);
+
+		creatures.swapPop(0);
+
+		expect(eq(creatures.size(), 2u));
+		expect(eq(creatures.id[0], 3u));
+		expect(eq(creatures.x[0], uint16_t { 3 }));
+		expect(eq(creatures.kind[0], uint8_t { SectorCreatures::KIND_NPC }));
+		expect(eq(creatures.id[1], 2u));
+	};
+};
@@ -0,0 +1,58 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "creatures/creatures_definitions.hpp"
+#include "map/utils/mapsector.hpp"
+#include "map/utils/pathcache.hpp"
+
+using namespace boost::ut;
+
+suite<"map"> pathCacheTest = [] {
+	const FindPathParams fpp;
+	const PathCacheKey key(7, Position(100, 100, 7), Position(105, 103, 7), fpp);
+	const std::vector<Direction> path { DIRECTION_EAST, DIRECTION_SOUTHEAST, DIRECTION_EAST };
+
+	test("PathCache serves a stored path while its sectors are unchanged") = [&] {
+		PathCache cache;
+		MapSector sector;
+		cache.store(key, path, true, { { &sector, sector.getTileVersion() } }, 1'000);
+
+		std::vector<Direction> dirList;
+		const auto found = cache.lookup(key, dirList, 1'500);
+		expect(found.has_value() && *found);
+		expect(dirList == path);
+		expect(eq(cache.getHits(), 1u));
+	};
+
+	test("PathCache drops entries when a covered sector changes") = [&] {
+		PathCache cache;
+		MapSector sector;
+		cache.store(key, path, true, { { &sector, sector.getTileVersion() } }, 1'000);
+
+		sector.touchTiles();
+
+		std::vector<Direction> dirList;
+		expect(!cache.lookup(key, dirList, 1'100).has_value());
+		expect(dirList.empty());
+		expect(eq(cache.getMisses(), 1u));
+	};
+
+	test("PathCache expires entries and keeps failed searches") = [&] {
+		PathCache cache;
+		cache.store(key, {}, false, {}, 1'000);
+
+		std::vector<Direction> dirList;
+		const auto found = cache.lookup(key, dirList, 1'000 + PathCache::ENTRY_TTL_MS);
+		expect(found.has_value() && !*found);
+		expect(!cache.lookup(key, dirList, 1'001 + PathCache::ENTRY_TTL_MS).has_value());
+	};
+
+	test("PathCacheKey tells walkers and parameters apart") = [&] {
+		FindPathParams other;
+		other.keepDistance = true;
+		expect(key != PathCacheKey(8, Position(100, 100, 7), Position(105, 103, 7), fpp));
+		expect(key != PathCacheKey(7, Position(100, 100, 7), Position(105, 103, 7), other));
+		expect(key == PathCacheKey(7, Position(100, 100, 7), Position(105, 103, 7), fpp));
+	};
+};
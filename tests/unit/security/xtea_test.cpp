@@ -0,0 +1,83 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "security/xtea.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// The transform Protocol used before the vectorized one, block by block
+	void referenceTransform(uint8_t* buffer, size_t messageLength, const xtea::key_t &key, bool encrypt) {
+		constexpr uint32_t delta = 0x61C88647;
+		std::array<std::array<uint32_t, 2>, 32> precachedControlSum;
+		uint32_t sum = encrypt ? 0 : 0xC6EF3720;
+		for (size_t i = 0; i < 32; ++i) {
+			if (encrypt) {
+				precachedControlSum[i][0] = sum + key[sum & 3];
+				sum -= delta;
+				precachedControlSum[i][1] = sum + key[(sum >> 11) & 3];
+			} else {
+				precachedControlSum[i][0] = sum + key[(sum >> 11) & 3];
+				sum += delta;
+				precachedControlSum[i][1] = sum + key[sum & 3];
+			}
+		}
+
+		for (size_t readPos = 0; readPos < messageLength; readPos += 8) {
+			uint32_t vData0;
+			uint32_t vData1;
+			std::memcpy(&vData0, buffer + readPos, 4);
+			std::memcpy(&vData1, buffer + readPos + 4, 4);
+			for (size_t i = 0; i < 32; ++i) {
+				if (encrypt) {
+					vData0 += ((vData1 << 4 ^ vData1 >> 5) + vData1) ^ precachedControlSum[i][0];
+					vData1 += ((vData0 << 4 ^ vData0 >> 5) + vData0) ^ precachedControlSum[i][1];
+				} else {
+					vData1 -= ((vData0 << 4 ^ vData0 >> 5) + vData0) ^ precachedControlSum[i][0];
+					vData0 -= ((vData1 << 4 ^ vData1 >> 5) + vData1) ^ precachedControlSum[i][1];
+				}
+			}
+			std::memcpy(buffer + readPos, &vData0, 4);
+			std::memcpy(buffer + readPos + 4, &vData1, 4);
+		}
+	}
+}
+
+suite<"security"> xteaTest = [] {
+	test("xtea matches the previous transform for every length") = [] {
+		std::mt19937 rng(1337);
+		xtea::key_t key;
+		std::ranges::generate(key, [&rng] { return static_cast<uint32_t>(rng()); });
+		const auto encryptionKeys = xtea::expandEncryptionKey(key);
+		const auto decryptionKeys = xtea::expandDecryptionKey(key);
+
+		// Covers empty, tails shorter than a vector stride and whole packets
+		std::vector<size_t> lengths;
+		for (size_t length = 0; length <= 256; length += xtea::BLOCK_SIZE) {
+			lengths.emplace_back(length);
+		}
+		lengths.insert(lengths.end(), { 1'024, 4'096 + 24, 24'584 });
+
+		for (const auto length : lengths) {
+			std::vector<uint8_t> plain(length);
+			std::ranges::generate(plain, [&rng] { return static_cast<uint8_t>(rng()); });
+
+			auto expected = plain;
+			referenceTransform(expected.data(), length, key, true);
+
+			auto encrypted = plain;
+			xtea::encrypt(encrypted.data(), length, encryptionKeys);
+			expect(encrypted == expected) << "encrypt, length " << length;
+
+			auto scalar = plain;
+			xtea::encryptScalar(scalar.data(), length, encryptionKeys);
+			expect(scalar == expected) << "encryptScalar, length " << length;
+
+			referenceTransform(expected.data(), length, key, false);
+			xtea::decrypt(encrypted.data(), length, decryptionKeys);
+			expect(encrypted == expected) << "decrypt, length " << length;
+			expect(encrypted == plain) << "round trip, length " << length;
+		}
+	};
+};
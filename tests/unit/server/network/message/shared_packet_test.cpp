@@ -0,0 +1,53 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/network/message/outputmessage.hpp"
+#include "server/network/message/shared_packet.hpp"
+#include "server/network/protocol/protocolgame.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	std::vector<uint8_t> bodyOf(const NetworkMessage &msg) {
+		const auto* body = msg.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION;
+		return { body, body + msg.getLength() };
+	}
+}
+
+suite<"networkmessage"> sharedPacketTest = [] {
+	test("BroadcastPacket encodes each variant once") = [] {
+		const Position pos(100, 200, 7);
+		BroadcastPacket broadcast;
+
+		const auto modern = broadcast.get(0, [&](NetworkMessage &msg) { ProtocolGame::encodeMagicEffect(msg, pos, 13, false); });
+		const auto old = broadcast.get(1, [&](NetworkMessage &msg) { ProtocolGame::encodeMagicEffect(msg, pos, 13, true); });
+		for (uint32_t viewer = 0; viewer < 100; ++viewer) {
+			expect(broadcast.get(viewer % 2, [](NetworkMessage &) { expect(false) << "variant encoded twice"; }) == (viewer % 2 == 0 ? modern : old));
+		}
+		expect(eq(broadcast.getEncodings(), 2u));
+
+		NetworkMessage direct;
+		ProtocolGame::encodeMagicEffect(direct, pos, 13, false);
+		const auto bytes = modern->getBytes();
+		expect(eq(std::vector<uint8_t>(bytes.begin(), bytes.end()), bodyOf(direct)));
+		expect(modern->getLength() != old->getLength());
+	};
+
+	test("OutputMessage appends shared packets like network messages") = [] {
+		NetworkMessage step;
+		ProtocolGame::encodeCreatureStep(step, Position(100, 200, 7), 2, Position(101, 200, 7));
+		const SharedPacket shared(step);
+
+		OutputMessage fromMessage;
+		fromMessage.append(step);
+		fromMessage.append(step);
+
+		OutputMessage fromShared;
+		fromShared.append(shared);
+		fromShared.append(shared);
+
+		expect(eq(fromShared.getLength(), fromMessage.getLength()));
+		expect(eq(bodyOf(fromShared), bodyOf(fromMessage)));
+	};
+};
@@ -0,0 +1,163 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/network/protocol/packet_compressor.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// What the client does with a compressed message
+	std::vector<uint8_t> inflateRaw(std::span<const uint8_t> compressed, const std::vector<uint8_t> &dictionary = {}) {
+		z_stream stream {};
+		inflateInit2(&stream, -15);
+		if (!dictionary.empty()) {
+			inflateSetDictionary(&stream, dictionary.data(), static_cast<uInt>(dictionary.size()));
+		}
+
+		std::vector<uint8_t> output(NETWORKMESSAGE_MAXSIZE);
+		stream.next_in = const_cast<Bytef*>(compressed.data());
+		stream.avail_in = static_cast<uInt>(compressed.size());
+		stream.next_out = output.data();
+		stream.avail_out = static_cast<uInt>(output.size());
+		const auto ret = inflate(&stream, Z_FINISH);
+		output.resize(ret == Z_STREAM_END ? stream.total_out : 0);
+		inflateEnd(&stream);
+		return output;
+	}
+
+	// A map description like body, long runs of the same few ground and item ids
+	std::vector<uint8_t> repetitivePacket(std::mt19937 &rng, size_t length) {
+		std::vector<uint8_t> packet { 0x64 };
+		while (packet.size() < length) {
+			const auto id = static_cast<uint8_t>(rng() % 4);
+			packet.insert(packet.end(), { 0x10, id, 0x00, 0xFF, 0x01 });
+		}
+		packet.resize(length);
+		return packet;
+	}
+
+	PacketCompressor::Options makeOptions(bool adaptive, double nanosPerSavedByte = 50.0, std::vector<uint8_t> dictionary = {}) {
+		PacketCompressor::Options options;
+		options.level = 6;
+		options.adaptive = adaptive;
+		options.nanosPerSavedByte = nanosPerSavedByte;
+		options.dictionary = std::move(dictionary);
+		return options;
+	}
+
+	std::vector<uint8_t> randomPacket(std::mt19937 &rng, uint8_t opcode, size_t length) {
+		std::vector<uint8_t> packet(length);
+		std::ranges::generate(packet, [&rng] { return static_cast<uint8_t>(rng()); });
+		packet[0] = opcode;
+		return packet;
+	}
+}
+
+suite<"protocol"> packetCompressorTest = [] {
+	test("PacketCompressor output inflates back to the message") = [] {
+		std::mt19937 rng(1337);
+		PacketCompressor compressor(makeOptions(false));
+
+		for (const size_t length : { 128, 300, 5'000, 40'000 }) {
+			const auto packet = repetitivePacket(rng, length);
+			const auto compressed = compressor.compress(packet.data(), packet.size());
+			expect(!compressed.empty() && compressed.size() < packet.size()) << "length " << length;
+			expect(inflateRaw(compressed) == packet) << "length " << length;
+		}
+
+		const auto &stats = compressor.getStats(0x64);
+		expect(eq(stats.messages, 4u));
+		expect(eq(stats.compressed, 4u));
+	};
+
+	test("PacketCompressor leaves short and incompressible messages alone") = [] {
+		std::mt19937 rng(1337);
+		PacketCompressor compressor(makeOptions(false));
+
+		const auto small = repetitivePacket(rng, PacketCompressor::MIN_LENGTH - 1);
+		expect(compressor.compress(small.data(), small.size()).empty());
+
+		// Only the adaptive policy goes below the fixed threshold
+		const PacketCompressor adaptive(makeOptions(true));
+		expect(eq(compressor.getLevel(0x64, PacketCompressor::ADAPTIVE_MIN_LENGTH), 0));
+		expect(adaptive.getLevel(0x64, PacketCompressor::ADAPTIVE_MIN_LENGTH) > 0);
+		expect(eq(adaptive.getLevel(0x64, PacketCompressor::ADAPTIVE_MIN_LENGTH - 1), 0));
+
+		const auto noise = randomPacket(rng, 0x6A, 1'000);
+		expect(compressor.compress(noise.data(), noise.size()).empty());
+		expect(eq(compressor.getStats(0x6A).compressed, 0u));
+		expect(eq(compressor.getStats(0x6A).savedBytes, 0u));
+	};
+
+	test("PacketCompressor adapts the level to each packet class") = [] {
+		std::mt19937 rng(1337);
+		PacketCompressor compressor(makeOptions(true, 1'000'000));
+
+		for (uint32_t i = 0; i < 200; ++i) {
+			const auto map = repetitivePacket(rng, 2'000);
+			const auto compressed = compressor.compress(map.data(), map.size());
+			if (!compressed.empty()) {
+				expect(inflateRaw(compressed) == map);
+			}
+
+			const auto noise = randomPacket(rng, 0x6A, 2'000);
+			expect(compressor.compress(noise.data(), noise.size()).empty());
+		}
+
+		expect(compressor.getLevel(0x64, 2'000) > 0);
+		expect(eq(compressor.getLevel(0x6A, 2'000), 0));
+		// Classes are learned on their own, another size of the same opcode is still warming up
+		expect(eq(compressor.getLevel(0x6A, 100), 1));
+		expect(compressor.getStats(0x64).savedBytes > 0u);
+	};
+
+	test("PacketCompressor skips classes whose savings are not worth the CPU") = [] {
+		std::mt19937 rng(1337);
+		// A byte saved is worth almost nothing, no level pays for itself
+		PacketCompressor compressor(makeOptions(true, 0.001));
+
+		uint32_t compressedCount = 0;
+		for (uint32_t i = 0; i < 1'000; ++i) {
+			const auto map = repetitivePacket(rng, 2'000);
+			compressedCount += compressor.compress(map.data(), map.size()).empty() ? 0 : 1;
+		}
+
+		expect(eq(compressor.getLevel(0x64, 2'000), 0));
+		// Warming up plus one message every explore interval
+		expect(compressedCount <= 2 * PacketCompressor::WARMUP_SAMPLES + 1'000 / PacketCompressor::EXPLORE_INTERVAL) << compressedCount;
+	};
+
+	test("PacketCompressor primes every message with the preset dictionary") = [] {
+		std::mt19937 rng(1337);
+		const std::vector<uint8_t> header { 0x0A, 0x14, 0x1E, 0x28, 0x32, 0x3C, 0x46, 0x50, 0x5A, 0x64, 0x6E, 0x78, 0x82, 0x8C, 0x96, 0xA0 };
+
+		// Each packet shares a header with the others and nothing with itself
+		std::vector<std::vector<uint8_t>> packets;
+		for (uint32_t i = 0; i < 64; ++i) {
+			auto packet = randomPacket(rng, 0xB4, PacketCompressor::MIN_LENGTH);
+			std::ranges::copy(header, packet.begin() + 16);
+			packets.emplace_back(std::move(packet));
+		}
+
+		const std::vector<std::span<const uint8_t>> samples(packets.begin(), packets.end());
+		const auto dictionary = PacketCompressor::buildDictionary(samples, 1'024);
+		expect(!dictionary.empty() && dictionary.size() <= 1'024u);
+		expect(std::ranges::search(dictionary, header).begin() != dictionary.end());
+
+		PacketCompressor plain(makeOptions(false));
+		PacketCompressor primed(makeOptions(false, 50.0, dictionary));
+		size_t plainBytes = 0;
+		size_t primedBytes = 0;
+		for (const auto &packet : packets) {
+			const auto withoutDictionary = plain.compress(packet.data(), packet.size());
+			plainBytes += withoutDictionary.empty() ? packet.size() : withoutDictionary.size();
+
+			const auto withDictionary = primed.compress(packet.data(), packet.size());
+			expect(!withDictionary.empty());
+			expect(inflateRaw(withDictionary, dictionary) == packet);
+			primedBytes += withDictionary.size();
+		}
+		expect(primedBytes < plainBytes) << primedBytes << " vs " << plainBytes;
+	};
+};
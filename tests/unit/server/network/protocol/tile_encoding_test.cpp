@@ -0,0 +1,67 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/network/protocol/tile_encoding.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// Ground, a border on top and a few things lying on it, two bytes each
+	TileItemsEncoding makeEncoding(uint8_t ground, uint8_t downItems) {
+		TileItemsEncoding encoding;
+		encoding.addTopItem(std::vector<uint8_t> { 0x66, ground });
+		encoding.addTopItem(std::vector<uint8_t> { 0x70, 0x11 });
+		for (uint8_t i = 0; i < downItems; ++i) {
+			encoding.addDownItem(std::vector<uint8_t> { 0x80, i });
+		}
+		return encoding;
+	}
+}
+
+suite<"protocol"> tileEncodingTest = [] {
+	test("TileItemsEncoding keeps the top items ahead of the creatures") = [] {
+		const auto encoding = makeEncoding(0x01, 3);
+
+		expect(eq(encoding.getTopCount(), 2));
+		expect(std::ranges::equal(encoding.getTop(), std::vector<uint8_t> { 0x66, 0x01, 0x70, 0x11 }));
+		expect(eq(encoding.getDownCount(), 3u));
+	};
+
+	test("TileItemsEncoding hands out only the down items there is room for") = [] {
+		const auto encoding = makeEncoding(0x01, 3);
+
+		expect(encoding.getDown(0).empty());
+		expect(std::ranges::equal(encoding.getDown(1), std::vector<uint8_t> { 0x80, 0x00 }));
+		expect(std::ranges::equal(encoding.getDown(2), std::vector<uint8_t> { 0x80, 0x00, 0x80, 0x01 }));
+		expect(eq(encoding.getDown(TileItemsEncoding::MAX_STACK).size(), 6u));
+	};
+
+	test("TileItemsEncoding refuses stacks that don't fit inline") = [] {
+		auto encoding = makeEncoding(0x01, 1);
+		expect(!encoding.addTopItem(std::vector<uint8_t> { 0x70, 0x12 })) << "top item after a down item";
+
+		const std::vector<uint8_t> podium(TileItemsEncoding::MAX_BYTES, 0x22);
+		expect(!encoding.addDownItem(podium));
+		expect(eq(encoding.getDownCount(), 1));
+		expect(eq(encoding.getDown(TileItemsEncoding::MAX_STACK).size(), 2u));
+	};
+
+	test("TileItemsEncoding shares one instance per distinct stack") = [] {
+		const auto* first = TileItemsEncoding::intern(makeEncoding(0x01, 2));
+		const auto* same = TileItemsEncoding::intern(makeEncoding(0x01, 2));
+		const auto* otherGround = TileItemsEncoding::intern(makeEncoding(0x02, 2));
+
+		expect(first == same);
+		expect(first != otherGround);
+		expect(*first == makeEncoding(0x01, 2));
+
+		// Same bytes split differently around the creatures is another stack
+		TileItemsEncoding allOnTop;
+		allOnTop.addTopItem(std::vector<uint8_t> { 0x66, 0x01 });
+		allOnTop.addTopItem(std::vector<uint8_t> { 0x70, 0x11 });
+		allOnTop.addTopItem(std::vector<uint8_t> { 0x80, 0x00 });
+		allOnTop.addTopItem(std::vector<uint8_t> { 0x80, 0x01 });
+		expect(TileItemsEncoding::intern(allOnTop) != first);
+	};
+};
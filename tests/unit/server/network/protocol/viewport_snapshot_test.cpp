@@ -0,0 +1,60 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/network/protocol/viewport_snapshot.hpp"
+
+using namespace boost::ut;
+
+suite<"protocol"> viewportSnapshotTest = [] {
+	test("ViewportSnapshot reuses bytes only for the version they were stored at") = [] {
+		ViewportSnapshot snapshot;
+		const Position pos(1000, 1000, 7);
+		const std::vector<uint8_t> ground { 0x66, 0x01 };
+
+		expect(!snapshot.find(pos, 1).has_value());
+		snapshot.store(pos, 1, ground);
+
+		const auto bytes = snapshot.find(pos, 1);
+		expect(bytes.has_value() && std::ranges::equal(*bytes, ground));
+		expect(!snapshot.find(pos, 2).has_value());
+		expect(eq(snapshot.getHits(), 1u));
+		expect(eq(snapshot.getMisses(), 2u));
+	};
+
+	test("ViewportSnapshot keeps empty tiles and skips tall ones") = [] {
+		ViewportSnapshot snapshot;
+		const Position empty(1000, 1000, 7);
+		const Position tall(1001, 1000, 7);
+
+		snapshot.store(empty, 1, {});
+		expect(snapshot.find(empty, 1).has_value());
+		expect(snapshot.find(empty, 1)->empty());
+
+		const std::vector<uint8_t> stack(ViewportSnapshot::MAX_TILE_BYTES + 1, 0x11);
+		snapshot.store(tall, 2, stack);
+		expect(!snapshot.find(tall, 2).has_value());
+	};
+
+	test("ViewportSnapshot holds a whole viewport floor without collisions") = [] {
+		ViewportSnapshot snapshot;
+		uint32_t version = 1;
+		for (uint16_t x = 1000; x < 1018; ++x) {
+			for (uint16_t y = 1000; y < 1014; ++y) {
+				snapshot.store(Position(x, y, 7), version++, std::vector<uint8_t> { static_cast<uint8_t>(x), static_cast<uint8_t>(y) });
+			}
+		}
+
+		version = 1;
+		for (uint16_t x = 1000; x < 1018; ++x) {
+			for (uint16_t y = 1000; y < 1014; ++y) {
+				const auto bytes = snapshot.find(Position(x, y, 7), version++);
+				expect(bytes.has_value() && std::ranges::equal(*bytes, std::vector<uint8_t> { static_cast<uint8_t>(x), static_cast<uint8_t>(y) }));
+			}
+		}
+		expect(eq(snapshot.getMisses(), 0u));
+
+		snapshot.clear();
+		expect(!snapshot.find(Position(1000, 1000, 7), 1).has_value());
+	};
+};
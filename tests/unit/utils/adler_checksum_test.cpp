@@ -0,0 +1,33 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/tools.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> adlerChecksumTest = [] {
+	test("adlerChecksum matches the known value") = [] {
+		constexpr std::string_view text = "Wikipedia";
+		const auto* data = reinterpret_cast<const uint8_t*>(text.data());
+		expect(eq(adlerChecksum(data, text.size()), 0x11E60398u));
+		expect(eq(adlerChecksumScalar(data, text.size()), 0x11E60398u));
+	};
+
+	test("adlerChecksum matches the scalar one for every length") = [] {
+		std::mt19937 rng(1337);
+		std::vector<uint8_t> random(NETWORKMESSAGE_MAXSIZE);
+		std::ranges::generate(random, [&rng] { return static_cast<uint8_t>(rng()); });
+		// All ones is the worst case for the intermediate sums
+		const std::vector<uint8_t> saturated(NETWORKMESSAGE_MAXSIZE, 0xFF);
+
+		for (const auto* data : std::array<const uint8_t*, 2> { random.data(), saturated.data() }) {
+			for (size_t length = 0; length <= 300; ++length) {
+				expect(eq(adlerChecksum(data, length), adlerChecksumScalar(data, length))) << "length " << length;
+			}
+			for (const size_t length : std::array<size_t, 6> { 5'535, 5'552, 5'553, 11'104, 20'000, NETWORKMESSAGE_MAXSIZE }) {
+				expect(eq(adlerChecksum(data, length), adlerChecksumScalar(data, length))) << "length " << length;
+			}
+		}
+	};
+};
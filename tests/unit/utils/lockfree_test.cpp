@@ -0,0 +1,60 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/lockfree.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> mpscRingTest = [] {
+	test("MpscRing keeps push order and rejects pushes when full") = [] {
+		MpscRing<std::string, 4> ring;
+		expect(ring.empty());
+
+		for (const auto &value : { "a", "b", "c", "d" }) {
+			expect(ring.try_emplace(value));
+		}
+		expect(!ring.try_emplace("e"));
+
+		std::vector<std::string> consumed;
+		expect(eq(ring.consume([&consumed](std::string &&value) { consumed.emplace_back(std::move(value)); }), 4u));
+		expect(eq(consumed, std::vector<std::string> { "a", "b", "c", "d" }));
+		expect(ring.empty());
+
+		expect(ring.try_emplace("e"));
+		expect(!ring.empty());
+	};
+
+	test("MpscRing delivers every element from concurrent producers") = [] {
+		constexpr uint32_t producers = 4;
+		constexpr uint32_t perProducer = 10'000;
+
+		MpscRing<uint32_t, 64> ring;
+		std::vector<uint32_t> lastSeen(producers, 0);
+		size_t consumed = 0;
+		bool ordered = true;
+
+		std::vector<std::jthread> threads;
+		for (uint32_t producer = 0; producer < producers; ++producer) {
+			threads.emplace_back([&ring, producer] {
+				for (uint32_t i = 1; i <= perProducer; ++i) {
+					while (!ring.try_emplace(producer * perProducer * 10 + i)) {
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+
+		while (consumed < producers * perProducer) {
+			consumed += ring.consume([&](uint32_t &&value) {
+				const auto producer = value / (perProducer * 10);
+				const auto sequence = value % (perProducer * 10);
+				ordered = ordered && sequence == lastSeen[producer] + 1;
+				lastSeen[producer] = sequence;
+			});
+		}
+
+		expect(ordered);
+		expect(eq(consumed, producers * perProducer));
+	};
+};
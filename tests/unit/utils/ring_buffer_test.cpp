@@ -0,0 +1,50 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/ring_buffer.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> ringBufferTest = [] {
+	test("RingBuffer keeps push order across wrap-arounds and growth") = [] {
+		RingBuffer<std::string> ring;
+		expect(ring.empty());
+
+		uint32_t pushed = 0;
+		uint32_t popped = 0;
+		for (uint32_t round = 0; round < 50; ++round) {
+			// Pushes more than it pops so the buffer grows while wrapped
+			for (uint32_t i = 0; i < 5; ++i) {
+				ring.emplace_back(std::to_string(pushed++));
+			}
+			for (uint32_t i = 0; i < 3; ++i) {
+				expect(eq(ring.front(), std::to_string(popped++)));
+				ring.pop_front();
+			}
+		}
+
+		expect(eq(ring.size(), size_t { pushed - popped }));
+		expect(eq(std::popcount(ring.capacity()), 1));
+		for (size_t i = 0; i < ring.size(); ++i) {
+			expect(eq(ring[i], std::to_string(popped + i)));
+		}
+
+		ring.pop_front(ring.size());
+		expect(ring.empty());
+	};
+
+	test("RingBuffer releases what it holds") = [] {
+		auto tracked = std::make_shared<int>(0);
+		{
+			RingBuffer<std::shared_ptr<int>> ring(4);
+			expect(eq(ring.capacity(), RingBuffer<std::shared_ptr<int>>::MIN_CAPACITY));
+			for (uint32_t i = 0; i < 20; ++i) {
+				ring.push_back(tracked);
+			}
+			ring.pop_front(5);
+			expect(eq(tracked.use_count(), 16));
+		}
+		expect(eq(tracked.use_count(), 1));
+	};
+};
@@ -0,0 +1,76 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/slab_allocator.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	struct SlabObject : std::enable_shared_from_this<SlabObject> {
+		explicit SlabObject(uint32_t value) :
+			value(value) { }
+
+		uint32_t value;
+		std::array<uint8_t, 200> payload {};
+	};
+}
+
+suite<"utils"> slabAllocatorTest = [] {
+	test("makeSlabShared constructs objects that work like make_shared ones") = [] {
+		const auto object = makeSlabShared<SlabObject>(42u);
+		expect(eq(object->value, 42u));
+		expect(object->shared_from_this() == object);
+
+		const std::weak_ptr<SlabObject> weak = object;
+		expect(!weak.expired());
+	};
+
+	test("SlabSizeClass counts live blocks and reuses freed ones") = [] {
+		auto &sizeClass = SlabSizeClass::get(48);
+		const auto before = sizeClass.getStats();
+
+		std::vector<void*> blocks;
+		for (uint32_t i = 0; i < 100; ++i) {
+			blocks.emplace_back(sizeClass.allocate());
+		}
+		expect(eq(sizeClass.getStats().live, before.live + 100));
+		expect(std::ranges::all_of(blocks, [](void* block) { return reinterpret_cast<uintptr_t>(block) % SlabSizeClass::GRANULARITY == 0; }));
+
+		for (auto* block : blocks) {
+			sizeClass.deallocate(block);
+		}
+		const auto after = sizeClass.getStats();
+		expect(eq(after.live, before.live));
+		expect(ge(after.free, 100));
+
+		// Nothing new is carved while freed blocks are available
+		for (auto &block : blocks) {
+			block = sizeClass.allocate();
+		}
+		expect(eq(sizeClass.getStats().slabs, after.slabs));
+		for (auto* block : blocks) {
+			sizeClass.deallocate(block);
+		}
+	};
+
+	test("SlabSizeClass takes back blocks freed on other threads") = [] {
+		auto &sizeClass = SlabSizeClass::get(64);
+		const auto before = sizeClass.getStats();
+
+		std::vector<void*> blocks;
+		for (uint32_t i = 0; i < 1'000; ++i) {
+			blocks.emplace_back(sizeClass.allocate());
+		}
+
+		std::jthread([&] {
+			for (auto* block : blocks) {
+				sizeClass.deallocate(block);
+			}
+		}).join();
+
+		const auto after = sizeClass.getStats();
+		expect(eq(after.live, before.live));
+		expect(ge(after.free, 1'000));
+	};
+};